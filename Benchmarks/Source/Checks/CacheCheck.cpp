@@ -0,0 +1,101 @@
+#include "CacheCheck.h"
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "MemoryManager/Cache.h"
+
+namespace CacheCheck
+{
+	// Stand in for a texture or mesh: a number of bytes, and a flag set when the cache deletes it
+	struct Block
+	{
+		Block(size_t size, bool* deleted) : size(size), deleted(deleted) {}
+		~Block() { *deleted = true; }
+
+		size_t size;
+		bool* deleted;
+	};
+
+	// Stand in for a model or material that keeps blocks alive
+	struct Owner
+	{
+	};
+
+	// Size of each block
+	const size_t BLOCK_SIZE = 1024;
+
+	// Prints a check that failed
+	// @param - bool for if the check passed
+	// @param - const std::string& for what was checked
+	// @return - bool for if the check passed
+	bool Check(bool passed, const std::string& description)
+	{
+		if (!passed)
+		{
+			std::cout << "Cache check failed: " << description << "\n";
+		}
+		return passed;
+	}
+
+	bool Run()
+	{
+		bool passed = true;
+
+		Cache<Block> blocks(nullptr, [](const Block* block) { return block->size; });
+		Cache<Owner> owners(nullptr);
+
+		// Blocks 0-5 are stored in order, so block 0 is the least recently used
+		const size_t NUM_BLOCKS = 6;
+		bool deleted[NUM_BLOCKS] = {};
+		std::vector<Block*> stored;
+		for (size_t i = 0; i < NUM_BLOCKS; ++i)
+		{
+			stored.emplace_back(new Block(BLOCK_SIZE, &deleted[i]));
+			blocks.StoreCache(AssetId::Intern("block" + std::to_string(i)), stored.back());
+		}
+
+		// Block 0 is held directly, like a game holding a texture it draws with
+		AssetHandle<Block> heldBlock = blocks.Acquire(stored[0]);
+
+		// Block 1 is held by an owner, like a model holding its meshes
+		Owner* owner = new Owner();
+		AssetHandle<Owner> ownerHandle = owners.StoreCache(AssetId::Intern("owner"), owner);
+		AssetHandle<Block> ownedBlock = blocks.Acquire(stored[1]);
+		owners.AddDependency(ownerHandle, [&blocks, ownedBlock]() { blocks.Release(ownedBlock); });
+		AssetHandle<Owner> heldOwner = owners.Acquire(owner);
+
+		// Block 5 is used again, so it's the most recently used
+		blocks.Get("block5");
+
+		// Room for four blocks: two unreferenced blocks have to go, starting with the least recently used
+		blocks.SetBudget(4 * BLOCK_SIZE);
+		owners.Trim();
+		blocks.Trim();
+
+		passed &= Check(!deleted[0], "block held directly survives");
+		passed &= Check(!deleted[1], "block held by a held owner survives");
+		passed &= Check(deleted[2] && deleted[3], "least recently used unreferenced blocks are deleted");
+		passed &= Check(!deleted[4] && !deleted[5], "blocks that fit in the budget are kept");
+		passed &= Check(blocks.GetSize() == 4 * BLOCK_SIZE, "cache fits its budget after trimming");
+		passed &= Check(blocks.Get("block2") == nullptr, "deleted block can't be found by name");
+		passed &= Check(blocks.Get(heldBlock) == stored[0], "handle to a held block still finds it");
+
+		// Once everything is released, a smaller budget deletes them all
+		blocks.Release(heldBlock);
+		owners.Release(heldOwner);
+		owners.SetBudget(1);
+		owners.Trim();
+		passed &= Check(owners.GetNumAssets() == 1, "owners count as 0 bytes, so trimming never deletes them");
+		owners.Delete("owner");
+		passed &= Check(owners.GetNumAssets() == 0 && blocks.GetRefCount("block1") == 0 && !deleted[1], "deleting the owner releases its block");
+
+		blocks.SetBudget(1);
+		blocks.Trim();
+		passed &= Check(blocks.GetNumAssets() == 0, "released blocks are deleted");
+		passed &= Check(deleted[0] && deleted[1] && deleted[4] && deleted[5], "every block is deleted once nothing holds it");
+		passed &= Check(blocks.Get(heldBlock) == nullptr, "handle to a deleted block is stale");
+
+		return passed;
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace CacheCheck
+{
+	// Fills a cache past its budget and trims it, checking that the assets something holds a reference to
+	// (directly, or through an asset that depends on them) survive and the unreferenced ones are deleted
+	// least recently used first. No OpenGL context is needed.
+	// @return - bool for if every check passed
+	bool Run();
+}
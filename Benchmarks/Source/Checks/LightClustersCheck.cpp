@@ -0,0 +1,233 @@
+#include "LightClustersCheck.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Graphics/LightClusters.h"
+
+namespace LightClustersCheck
+{
+	// Camera the clusters are built for
+	const float FOV = glm::radians(70.0f);
+	const float ASPECT_RATIO = 16.0f / 9.0f;
+	const float NEAR_PLANE = 0.1f;
+	const float FAR_PLANE = 500.0f;
+
+	// Number of random points and lights tested
+	const int NUM_POINTS = 10000;
+	const int NUM_LIGHTS = 200;
+	const int POINTS_PER_LIGHT = 200;
+
+	// Number of jobs the slices are split between, like Lights::SetBuffer()
+	const unsigned int NUM_JOBS = 4;
+
+	// Prints a check that failed
+	// @param - bool for if the check passed
+	// @param - const std::string& for what was checked
+	// @return - bool for if the check passed
+	bool Check(bool passed, const std::string& description)
+	{
+		if (!passed)
+		{
+			std::cout << "Light clusters check failed: " << description << "\n";
+		}
+		return passed;
+	}
+
+	// Tests if a point is inside a box, with a little room for rounding
+	// @param - const glm::vec3& for the point
+	// @param - const BoundingBox& for the box
+	// @return - bool for if the point is inside
+	bool Contains(const glm::vec3& point, const BoundingBox& box)
+	{
+		glm::vec3 epsilon = glm::max(glm::abs(box.max - box.min) * 1e-4f, glm::vec3(1e-5f));
+		return glm::all(glm::greaterThanEqual(point, box.min - epsilon)) && glm::all(glm::lessThanEqual(point, box.max + epsilon));
+	}
+
+	// Tests if a sphere overlaps a box the same way the clusters do, without narrowing down the clusters first
+	// @param - const ClusterLight& for the light
+	// @param - const BoundingBox& for the box
+	// @return - bool for if they overlap
+	bool Overlaps(const ClusterLight& light, const BoundingBox& box)
+	{
+		glm::vec3 offset = glm::clamp(light.position, box.min, box.max) - light.position;
+		return glm::dot(offset, offset) <= light.radius * light.radius;
+	}
+
+	// Gets the lights binned into a cluster, sorted
+	// @param - const LightClusters& for the packed clusters
+	// @param - unsigned int for the cluster
+	// @return - std::vector<unsigned int> for the light indices
+	std::vector<unsigned int> GetLights(const LightClusters& clusters, unsigned int cluster)
+	{
+		const ClusterRange& range = clusters.GetRanges()[cluster];
+		auto first = clusters.GetLightIndices().begin() + range.offset;
+		std::vector<unsigned int> lights(first, first + range.count);
+		std::sort(lights.begin(), lights.end());
+		return lights;
+	}
+
+	// Finds the cluster a view space point is in the same way the shaders do
+	// @param - const LightClusters& for the clusters
+	// @param - const glm::vec3& for the point
+	// @param - unsigned int& for the cluster
+	// @return - bool for if the point is in the view frustum
+	bool FindCluster(const LightClusters& clusters, const glm::vec3& point, unsigned int& outCluster)
+	{
+		float depth = -point.z;
+		if (depth < NEAR_PLANE || depth >= FAR_PLANE)
+		{
+			return false;
+		}
+
+		float tanHalfFOV = std::tan(FOV * 0.5f);
+		float ndcX = point.x / (depth * tanHalfFOV * ASPECT_RATIO);
+		float ndcY = point.y / (depth * tanHalfFOV);
+		if (std::abs(ndcX) >= 1.0f || std::abs(ndcY) >= 1.0f)
+		{
+			return false;
+		}
+
+		glm::uvec3 grid = clusters.GetGridSize();
+		unsigned int x = std::min(static_cast<unsigned int>((ndcX * 0.5f + 0.5f) * grid.x), grid.x - 1);
+		unsigned int y = std::min(static_cast<unsigned int>((ndcY * 0.5f + 0.5f) * grid.y), grid.y - 1);
+		outCluster = clusters.GetClusterIndex(x, y, clusters.GetSlice(depth));
+		return true;
+	}
+
+	bool Run()
+	{
+		bool passed = true;
+
+		LightClusters clusters;
+		clusters.SetProjection(FOV, ASPECT_RATIO, NEAR_PLANE, FAR_PLANE);
+		glm::uvec3 grid = clusters.GetGridSize();
+
+		// Bounds: every cluster is a real box, the slices cover near to far, and neighboring slices meet
+		for (unsigned int cluster = 0; cluster < clusters.GetNumClusters(); ++cluster)
+		{
+			const BoundingBox& box = clusters.GetClusterBounds(cluster);
+			if (!Check(glm::all(glm::lessThan(box.min, box.max)), "cluster " + std::to_string(cluster) + " has positive size"))
+			{
+				passed = false;
+				break;
+			}
+		}
+		passed &= Check(std::abs(clusters.GetClusterBounds(clusters.GetClusterIndex(0, 0, 0)).max.z + NEAR_PLANE) < 1e-4f, "first slice starts at the near plane");
+		passed &= Check(std::abs(clusters.GetClusterBounds(clusters.GetClusterIndex(0, 0, grid.z - 1)).min.z + FAR_PLANE) < FAR_PLANE * 1e-4f, "last slice ends at the far plane");
+		for (unsigned int z = 0; z + 1 < grid.z; ++z)
+		{
+			float sliceFar = clusters.GetClusterBounds(clusters.GetClusterIndex(0, 0, z)).min.z;
+			float nextNear = clusters.GetClusterBounds(clusters.GetClusterIndex(0, 0, z + 1)).max.z;
+			passed &= Check(std::abs(sliceFar - nextNear) <= std::abs(sliceFar) * 1e-4f, "slice " + std::to_string(z) + " meets the next slice");
+		}
+
+		// Every point in the frustum is inside the cluster the shaders would look it up in
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		float tanHalfFOV = std::tan(FOV * 0.5f);
+		int outside = 0;
+		for (int i = 0; i < NUM_POINTS; ++i)
+		{
+			// Spread the depths exponentially like the slices so the near slices are tested too
+			float depth = NEAR_PLANE * std::pow(FAR_PLANE / NEAR_PLANE, unit(random) * 0.9999f);
+			float ndcX = unit(random) * 2.0f - 1.0f;
+			float ndcY = unit(random) * 2.0f - 1.0f;
+			glm::vec3 point(ndcX * tanHalfFOV * ASPECT_RATIO * depth, ndcY * tanHalfFOV * depth, -depth);
+
+			unsigned int cluster = 0;
+			if (FindCluster(clusters, point, cluster) && !Contains(point, clusters.GetClusterBounds(cluster)))
+			{
+				++outside;
+			}
+		}
+		passed &= Check(outside == 0, std::to_string(outside) + " points in the frustum are outside the cluster they look up");
+
+		// Random lights, some poking out of the frustum, some behind the camera or past the far plane
+		std::vector<ClusterLight> lights;
+		for (unsigned int i = 0; i < NUM_LIGHTS; ++i)
+		{
+			float depth = -5.0f + unit(random) * (FAR_PLANE + 10.0f);
+			float spread = (std::abs(depth) + 1.0f) * tanHalfFOV * 1.5f;
+			ClusterLight light = {};
+			light.position = glm::vec3((unit(random) * 2.0f - 1.0f) * spread * ASPECT_RATIO, (unit(random) * 2.0f - 1.0f) * spread, -depth);
+			light.radius = 0.5f + unit(random) * 30.0f;
+			light.index = i % 2 == 0 ? i : (i | SPOT_LIGHT_FLAG);
+			lights.emplace_back(light);
+		}
+
+		// Bin the slices in separate ranges like the cluster jobs do
+		unsigned int slicesPerJob = (grid.z + NUM_JOBS - 1) / NUM_JOBS;
+		for (unsigned int job = 0; job < NUM_JOBS; ++job)
+		{
+			clusters.BinLights(lights, job * slicesPerJob, (job + 1) * slicesPerJob);
+		}
+		clusters.Pack();
+
+		// Every point of a light's sphere that's in the frustum has to find the light in the cluster the shaders look it up in.
+		// The cluster bounds are boxes around each tile, which are looser than the tile itself, so binning can leave
+		// out a cluster whose box the sphere only touches outside the tile, but never one that a point of the sphere is in.
+		int missing = 0;
+		for (const ClusterLight& light : lights)
+		{
+			for (int i = 0; i < POINTS_PER_LIGHT; ++i)
+			{
+				glm::vec3 direction(unit(random) * 2.0f - 1.0f, unit(random) * 2.0f - 1.0f, unit(random) * 2.0f - 1.0f);
+				if (glm::dot(direction, direction) > 1.0f)
+				{
+					continue;
+				}
+				glm::vec3 point = light.position + direction * light.radius;
+
+				unsigned int cluster = 0;
+				if (FindCluster(clusters, point, cluster))
+				{
+					std::vector<unsigned int> binned = GetLights(clusters, cluster);
+					missing += std::binary_search(binned.begin(), binned.end(), light.index) ? 0 : 1;
+				}
+			}
+		}
+		passed &= Check(missing == 0, std::to_string(missing) + " points of a light's sphere are in clusters that don't have the light");
+
+		// Lights are only binned into clusters whose bounds their sphere overlaps
+		int extra = 0;
+		size_t numIndices = 0;
+		for (unsigned int cluster = 0; cluster < clusters.GetNumClusters(); ++cluster)
+		{
+			std::vector<unsigned int> binned = GetLights(clusters, cluster);
+			for (const ClusterLight& light : lights)
+			{
+				if (std::binary_search(binned.begin(), binned.end(), light.index) && !Overlaps(light, clusters.GetClusterBounds(cluster)))
+				{
+					++extra;
+				}
+			}
+			numIndices += binned.size();
+		}
+		passed &= Check(extra == 0, std::to_string(extra) + " lights were binned into clusters they don't overlap");
+		passed &= Check(numIndices == clusters.GetLightIndices().size(), "packed ranges cover the light index list");
+		passed &= Check(numIndices > 0, "some lights were binned");
+
+		// A light behind the camera isn't binned anywhere
+		LightClusters behind;
+		behind.SetProjection(FOV, ASPECT_RATIO, NEAR_PLANE, FAR_PLANE);
+		behind.BinLights({ ClusterLight{ glm::vec3(0.0f, 0.0f, 5.0f), 1.0f, 0 } }, 0, grid.z);
+		behind.Pack();
+		passed &= Check(behind.GetLightIndices().empty(), "light behind the camera isn't binned");
+
+		// Clusters stop taking lights once they're full
+		const unsigned int MAX_LIGHTS = 4;
+		LightClusters full(1, 1, 1, MAX_LIGHTS);
+		full.SetProjection(FOV, ASPECT_RATIO, NEAR_PLANE, FAR_PLANE);
+		std::vector<ClusterLight> crowd(MAX_LIGHTS * 2, ClusterLight{ glm::vec3(0.0f, 0.0f, -10.0f), 1.0f, 0 });
+		full.BinLights(crowd, 0, 1);
+		full.Pack();
+		passed &= Check(full.GetRanges()[0].count == MAX_LIGHTS, "a full cluster drops the extra lights");
+
+		std::cout << "Light clusters check: " << (passed ? "passed" : "failed") << " (" << numIndices << " light indices in " << clusters.GetNumClusters() << " clusters)\n";
+
+		return passed;
+	}
+}
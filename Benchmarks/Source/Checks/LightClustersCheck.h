@@ -0,0 +1,10 @@
+#pragma once
+
+namespace LightClustersCheck
+{
+	// Builds the cluster grid for a projection and bins random lights into it, checking that the cluster bounds
+	// tile the view frustum and that every light is in the cluster of every point its sphere covers, and only in clusters it overlaps.
+	// No OpenGL context is needed.
+	// @return - bool for if every check passed
+	bool Run();
+}
@@ -0,0 +1,48 @@
+#include <cstring>
+#include "CacheCheck.h"
+#include "LightClustersCheck.h"
+#include "RenderGraphCheck.h"
+#include "ShadowCascadesCheck.h"
+
+// Runs the headless checks named on the command line (rendergraph, cache, lightclusters, shadowcascades), or all of them if none are named.
+// These don't open a window or use OpenGL, so they build and run on every platform.
+// Returns 1 if a check failed.
+int main(int argc, char* args[])
+{
+	// Checks if a check was named on the command line
+	auto shouldRun = [argc, args](const char* name)
+	{
+		if (argc < 2)
+		{
+			return true;
+		}
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(args[i], name) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	bool passed = true;
+	if (shouldRun("rendergraph"))
+	{
+		passed &= RenderGraphCheck::Run();
+	}
+	if (shouldRun("cache"))
+	{
+		passed &= CacheCheck::Run();
+	}
+	if (shouldRun("lightclusters"))
+	{
+		passed &= LightClustersCheck::Run();
+	}
+	if (shouldRun("shadowcascades"))
+	{
+		passed &= ShadowCascadesCheck::Run();
+	}
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include "RenderGraphCheck.h"
+#include <iostream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Graphics/RenderGraph.h"
+
+namespace RenderGraphCheck
+{
+	// Prints a check that failed
+	// @param - bool for if the check passed
+	// @param - const std::string& for what was checked
+	// @return - bool for if the check passed
+	bool Check(bool passed, const std::string& description)
+	{
+		if (!passed)
+		{
+			std::cout << "Render graph check failed: " << description << "\n";
+		}
+		return passed;
+	}
+
+	// Builds the game's bloom chain (each level half the size of the one above it, downsampled then upsampled back)
+	// and checks that levels of different sizes alias onto each other
+	// @param - const std::function<void(const RenderGraphPassContext&)>& for the empty pass
+	// @return - bool for if every check passed
+	bool CheckBloomChain(const std::function<void(const RenderGraphPassContext&)>& execute)
+	{
+		bool passed = true;
+
+		const int BLOOM_MIPS = 6;
+		const int WIDTH = 1920;
+		const int HEIGHT = 1080;
+
+		RenderGraph graph;
+		RenderGraphResource scene = graph.ImportTarget("scene", { 0, 0, WIDTH, HEIGHT });
+		RenderGraphResource screen = graph.ImportTarget("screen", { 0, 0, WIDTH, HEIGHT });
+		graph.MarkOutput(screen);
+
+		std::vector<RenderGraphResource> bloomDown(BLOOM_MIPS);
+		std::vector<RenderGraphResource> bloomUp(BLOOM_MIPS);
+		float scale = 1.0f;
+		for (int i = 0; i < BLOOM_MIPS; ++i)
+		{
+			scale *= 0.5f;
+			bloomDown[i] = graph.CreateTexture("bloomDown" + std::to_string(i), { scale, RenderGraphFormat::RGB16F });
+			bloomUp[i] = i < BLOOM_MIPS - 1 ? graph.CreateTexture("bloomUp" + std::to_string(i), { scale, RenderGraphFormat::RGB16F }) : bloomDown[i];
+		}
+		RenderGraphResource bloomBlend = graph.CreateTexture("bloomBlend", { 1.0f, RenderGraphFormat::RGB16F });
+		RenderGraphResource overlay = graph.CreateTexture("overlay", { 1.0f, RenderGraphFormat::RGBA8 });
+
+		for (int i = 0; i < BLOOM_MIPS; ++i)
+		{
+			graph.AddPass("bloomDownsample" + std::to_string(i), { i == 0 ? scene : bloomDown[i - 1] }, bloomDown[i], execute);
+		}
+		for (int i = BLOOM_MIPS - 2; i >= 0; --i)
+		{
+			graph.AddPass("bloomUpsample" + std::to_string(i), { bloomUp[i + 1], bloomDown[i] }, bloomUp[i], execute);
+		}
+		graph.AddPass("bloomBlend", { scene, bloomUp[0] }, bloomBlend, execute);
+		graph.AddPass("overlay", { bloomBlend }, overlay, execute);
+		graph.AddPass("hdrGamma", { bloomBlend, overlay }, screen, execute);
+
+		passed &= Check(graph.Compile(), "bloom chain compiles");
+
+		// Every level is still read by its upsample, so the downsampled levels can't alias each other, but each upsampled
+		// level can take over a smaller level that's done, growing it
+		size_t numTransient = graph.GetNumResources() - 2;
+		size_t physicalMemory = graph.CalculatePhysicalMemory(WIDTH, HEIGHT);
+		size_t unaliasedMemory = graph.CalculateUnaliasedMemory(WIDTH, HEIGHT);
+		passed &= Check(graph.GetPhysicalTextures().size() < numTransient, "bloom levels of different sizes share physical textures");
+		passed &= Check(physicalMemory < unaliasedMemory, "aliasing the bloom chain saves memory");
+		for (int i = 0; i < BLOOM_MIPS - 1; ++i)
+		{
+			const RenderGraphResourceData& up = graph.GetResource(bloomUp[i]);
+			passed &= Check(graph.GetPhysicalTextures()[up.physicalIndex].scale >= up.desc.scale, "bloomUp" + std::to_string(i) + " fits in its physical texture");
+		}
+		passed &= Check(graph.GetResource(bloomUp[BLOOM_MIPS - 2]).physicalIndex != graph.GetResource(bloomDown[BLOOM_MIPS - 2]).physicalIndex, "a level isn't aliased onto a texture it reads");
+
+		// RGBA8 can't share with the 16 bit float textures even though some are free
+		int overlayPhysical = graph.GetResource(overlay).physicalIndex;
+		passed &= Check(graph.GetPhysicalTextures()[overlayPhysical].format == RenderGraphFormat::RGBA8, "textures only alias within their format class");
+
+		std::cout << "Render graph check: bloom chain uses " << graph.GetPhysicalTextures().size() << " textures for " << numTransient << " transient textures, "
+			<< physicalMemory / 1024 << " KB instead of " << unaliasedMemory / 1024 << " KB (" << 100 - physicalMemory * 100 / unaliasedMemory << "% saved) at " << WIDTH << "x" << HEIGHT << "\n";
+
+		return passed;
+	}
+
+	bool Run()
+	{
+		bool passed = true;
+
+		// Empty pass so the graph has something to execute
+		auto execute = [](const RenderGraphPassContext&) {};
+
+		// scene -> bright (half) -> blurH (half) -> blurV (half) -> composite -> backbuffer, plus a debug view nothing reads
+		RenderGraph graph;
+		RenderGraphResource scene = graph.ImportTarget("scene", { 0, 0, 1280, 720 });
+		RenderGraphResource backBuffer = graph.ImportTarget("backBuffer", { 0, 0, 1280, 720 });
+		RenderGraphResource bright = graph.CreateTexture("bright", { 0.5f, RenderGraphFormat::RGB16F });
+		RenderGraphResource blurH = graph.CreateTexture("blurH", { 0.5f, RenderGraphFormat::RGB16F });
+		RenderGraphResource blurV = graph.CreateTexture("blurV", { 0.5f, RenderGraphFormat::RGB16F });
+		RenderGraphResource debugView = graph.CreateTexture("debugView", { 1.0f, RenderGraphFormat::RGBA8 });
+		graph.MarkOutput(backBuffer);
+
+		int brightPass = graph.AddPass("bright", { scene }, bright, execute);
+		int blurHPass = graph.AddPass("blurH", { bright }, blurH, execute);
+		int blurVPass = graph.AddPass("blurV", { blurH }, blurV, execute);
+		int debugPass = graph.AddPass("debug", { scene }, debugView, execute);
+		int compositePass = graph.AddPass("composite", { scene, blurV }, backBuffer, execute);
+
+		passed &= Check(graph.Compile(), "graph compiles");
+		passed &= Check(graph.IsCompiled(), "graph is marked compiled");
+
+		// Only the pass whose output nothing reads is culled
+		passed &= Check(graph.GetPass(debugPass).isCulled, "debug pass is culled");
+		passed &= Check(!graph.GetPass(brightPass).isCulled && !graph.GetPass(blurHPass).isCulled && !graph.GetPass(blurVPass).isCulled && !graph.GetPass(compositePass).isCulled,
+			"passes that reach the back buffer are kept");
+		passed &= Check(graph.GetExecutionOrder() == std::vector<int>{ brightPass, blurHPass, blurVPass, compositePass }, "execution order skips the culled pass");
+
+		// bright is last read by blurH, so blurV reuses its texture. blurH is still being read when blurV is written, so it gets its own.
+		const RenderGraphResourceData& brightData = graph.GetResource(bright);
+		const RenderGraphResourceData& blurHData = graph.GetResource(blurH);
+		const RenderGraphResourceData& blurVData = graph.GetResource(blurV);
+		passed &= Check(graph.GetPhysicalTextures().size() == 2, "three transient textures fit in two physical textures");
+		passed &= Check(brightData.physicalIndex >= 0 && brightData.physicalIndex == blurVData.physicalIndex, "blurV is aliased onto bright");
+		passed &= Check(blurHData.physicalIndex >= 0 && blurHData.physicalIndex != brightData.physicalIndex, "blurH isn't aliased while bright is alive");
+		passed &= Check(graph.GetResource(debugView).physicalIndex == -1, "culled pass' texture isn't allocated");
+		passed &= Check(graph.GetResource(scene).physicalIndex == -1 && graph.GetResource(backBuffer).physicalIndex == -1, "imported targets aren't allocated");
+		passed &= Check(graph.CalculatePhysicalMemory(1280, 720) < graph.CalculateUnaliasedMemory(1280, 720), "aliasing saves memory");
+
+		// Reading a texture before it's written is an error
+		RenderGraph invalidGraph;
+		RenderGraphResource output = invalidGraph.ImportTarget("backBuffer", { 0, 0, 1280, 720 });
+		RenderGraphResource unwritten = invalidGraph.CreateTexture("unwritten", { 1.0f, RenderGraphFormat::RGBA8 });
+		invalidGraph.MarkOutput(output);
+		invalidGraph.AddPass("composite", { unwritten }, output, execute);
+		passed &= Check(!invalidGraph.Compile(), "graph that reads an unwritten texture doesn't compile");
+		passed &= Check(invalidGraph.HasCompileFailed(), "failed compile is remembered");
+		invalidGraph.Clear();
+		passed &= Check(!invalidGraph.HasCompileFailed(), "changing the graph forgets the failed compile");
+
+		passed &= CheckBloomChain(execute);
+
+		std::cout << "Render graph check: " << (passed ? "passed" : "failed") << "\n";
+
+		return passed;
+	}
+}
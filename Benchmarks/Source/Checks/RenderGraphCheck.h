@@ -0,0 +1,9 @@
+#pragma once
+
+namespace RenderGraphCheck
+{
+	// Builds a small post process graph, compiles it, and checks which passes are culled and which
+	// transient textures share a physical texture. No OpenGL context is needed.
+	// @return - bool for if every check passed
+	bool Run();
+}
@@ -0,0 +1,143 @@
+#include "ShadowCascadesCheck.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Graphics/ShadowCascades.h"
+
+namespace ShadowCascadesCheck
+{
+	// Camera and shadow map the cascades are fitted for
+	const float FOV = glm::radians(70.0f);
+	const float ASPECT_RATIO = 16.0f / 9.0f;
+	const float NEAR_PLANE = 0.1f;
+	const float SHADOW_DISTANCE = 150.0f;
+	const float CASTER_DISTANCE = 50.0f;
+	const unsigned int RESOLUTION = 2048;
+
+	// Number of random camera/light setups tested
+	const int NUM_SETUPS = 200;
+
+	// Prints a check that failed
+	// @param - bool for if the check passed
+	// @param - const std::string& for what was checked
+	// @return - bool for if the check passed
+	bool Check(bool passed, const std::string& description)
+	{
+		if (!passed)
+		{
+			std::cout << "Shadow cascades check failed: " << description << "\n";
+		}
+		return passed;
+	}
+
+	// Gets a random unit vector
+	// @param - std::mt19937& for the random number generator
+	// @return - glm::vec3 for the direction
+	glm::vec3 RandomDirection(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> range(-1.0f, 1.0f);
+		glm::vec3 direction(0.0f);
+		while (glm::dot(direction, direction) < 0.01f || glm::dot(direction, direction) > 1.0f)
+		{
+			direction = glm::vec3(range(random), range(random), range(random));
+		}
+		return glm::normalize(direction);
+	}
+
+	bool Run()
+	{
+		bool passed = true;
+
+		// Splits start at the near plane, end at the shadow distance, and always increase
+		for (int numCascades = 1; numCascades <= MAX_CASCADES; ++numCascades)
+		{
+			for (float lambda : { 0.0f, 0.5f, 0.75f, 1.0f })
+			{
+				std::vector<float> splits;
+				ShadowCascades::CalculateSplitDistances(numCascades, NEAR_PLANE, SHADOW_DISTANCE, lambda, splits);
+				std::string setup = std::to_string(numCascades) + " cascades, lambda " + std::to_string(lambda);
+
+				passed &= Check(splits.size() == static_cast<size_t>(numCascades) + 1, setup + ": one split per cascade plus the near plane");
+				passed &= Check(splits.front() == NEAR_PLANE, setup + ": splits start at the near plane");
+				passed &= Check(std::abs(splits.back() - SHADOW_DISTANCE) <= SHADOW_DISTANCE * 1e-5f, setup + ": splits end at the shadow distance");
+				for (size_t i = 1; i < splits.size(); ++i)
+				{
+					passed &= Check(splits[i] > splits[i - 1], setup + ": split " + std::to_string(i) + " is past the one before it");
+				}
+			}
+		}
+
+		// The logarithmic scheme gives the near cascades less of the view than the uniform one
+		std::vector<float> uniformSplits;
+		std::vector<float> logSplits;
+		ShadowCascades::CalculateSplitDistances(MAX_CASCADES, NEAR_PLANE, SHADOW_DISTANCE, 0.0f, uniformSplits);
+		ShadowCascades::CalculateSplitDistances(MAX_CASCADES, NEAR_PLANE, SHADOW_DISTANCE, 1.0f, logSplits);
+		passed &= Check(logSplits[1] < uniformSplits[1], "logarithmic splits put the first cascade closer than uniform splits");
+
+		// Every corner of each slice lands inside its cascade's light space volume. Snapping the projection to
+		// texels can move it by half a texel, so the corners get that much room.
+		std::mt19937 random(5678);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		float texel = 2.0f / static_cast<float>(RESOLUTION);
+		float worstOutside = 0.0f;
+		int numOutside = 0;
+		for (int setup = 0; setup < NUM_SETUPS; ++setup)
+		{
+			glm::vec3 eye(position(random), position(random) * 0.25f, position(random));
+			glm::vec3 forward = RandomDirection(random);
+			glm::vec3 up = std::abs(forward.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+			glm::mat4 cameraView = glm::lookAt(eye, eye + forward, up);
+			glm::vec3 lightDir = RandomDirection(random);
+
+			std::vector<float> splits;
+			ShadowCascades::CalculateSplitDistances(MAX_CASCADES, NEAR_PLANE, SHADOW_DISTANCE, 0.75f, splits);
+
+			for (int i = 0; i < MAX_CASCADES; ++i)
+			{
+				Cascade cascade = ShadowCascades::FitCascade(cameraView, FOV, ASPECT_RATIO, splits[i], splits[i + 1], lightDir, CASTER_DISTANCE, RESOLUTION);
+				passed &= Check(cascade.splitNear == splits[i] && cascade.splitFar == splits[i + 1], "cascade keeps its split distances");
+
+				glm::vec3 corners[8];
+				ShadowCascades::GetFrustumCorners(cameraView, FOV, ASPECT_RATIO, splits[i], splits[i + 1], corners);
+				for (const glm::vec3& corner : corners)
+				{
+					glm::vec4 clip = cascade.lightSpace * glm::vec4(corner, 1.0f);
+					glm::vec3 ndc = glm::vec3(clip) / clip.w;
+
+					float outsideXY = std::max(std::abs(ndc.x), std::abs(ndc.y)) - (1.0f + texel);
+					float outsideZ = std::abs(ndc.z) - 1.0f;
+					float outside = std::max(outsideXY, outsideZ);
+					if (outside > 0.0f)
+					{
+						++numOutside;
+						worstOutside = std::max(worstOutside, outside);
+					}
+				}
+
+				// A caster inside the slice is kept, one far off to the side is culled
+				glm::vec3 center(0.0f);
+				for (const glm::vec3& corner : corners)
+				{
+					center += corner;
+				}
+				center /= 8.0f;
+				passed &= Check(ShadowCascades::IsCasterInCascade(cascade, BoundingSphere{ center, 1.0f }), "caster in the middle of the slice is kept");
+
+				glm::vec3 side = glm::normalize(glm::cross(lightDir, std::abs(lightDir.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f)));
+				passed &= Check(!ShadowCascades::IsCasterInCascade(cascade, BoundingSphere{ center + side * (cascade.radius * 3.0f), 1.0f }), "caster beside the cascade is culled");
+
+				// Casters between the light and the slice still cast shadows into it, even past the light's near plane
+				passed &= Check(ShadowCascades::IsCasterInCascade(cascade, BoundingSphere{ center - glm::normalize(lightDir) * (cascade.depth * 2.0f), 1.0f }), "caster towards the light is kept");
+			}
+		}
+		passed &= Check(numOutside == 0, std::to_string(numOutside) + " frustum corners are outside their cascade (worst by " + std::to_string(worstOutside) + " in NDC)");
+
+		std::cout << "Shadow cascades check: " << (passed ? "passed" : "failed") << " (" << NUM_SETUPS << " camera/light setups)\n";
+
+		return passed;
+	}
+}
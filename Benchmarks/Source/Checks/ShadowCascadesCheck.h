@@ -0,0 +1,10 @@
+#pragma once
+
+namespace ShadowCascadesCheck
+{
+	// Splits a camera's view frustum into cascades and fits each cascade's light projection for a range of camera
+	// and light directions, checking that the splits increase from the near plane to the shadow distance and that every
+	// cascade's orthographic bounds enclose its slice of the frustum. No OpenGL context is needed.
+	// @return - bool for if every check passed
+	bool Run();
+}
@@ -0,0 +1,109 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Graphics/TextureCompressionBenchmark.h"
+#include "MemoryManager/AssetLoadBenchmark.h"
+#include "Particles/ParticleBenchmark.h"
+#include "ShaderReloadCheck.h"
+
+// Number of particles simulated by the particle benchmark
+const size_t NUM_BENCHMARK_PARTICLES = 1000000;
+// Number of frames simulated by the particle benchmark
+const int NUM_BENCHMARK_FRAMES = 60;
+
+// Models the game loads at startup
+const std::vector<std::string> MODEL_FILES =
+{
+	GAME_DIRECTORY "Assets/models/vampire/dancing_vampire.dae",
+	GAME_DIRECTORY "Assets/models/Sponza/sponza.obj",
+	GAME_DIRECTORY "Assets/models/SquidwardDance/Rumba Dancing.dae",
+	GAME_DIRECTORY "Assets/models/MissFortune/MissFortune.dae",
+	GAME_DIRECTORY "Assets/models/MissFortune2/MissFortune2.dae"
+};
+
+// Textures the game loads at startup
+const std::vector<std::pair<std::string, TextureType>> TEXTURE_FILES =
+{
+	{ GAME_DIRECTORY "Assets/matrix.jpg", TextureType::Emission },
+	{ GAME_DIRECTORY "Assets/container2.png", TextureType::Diffuse },
+	{ GAME_DIRECTORY "Assets/container2_specular.png", TextureType::Specular },
+	{ GAME_DIRECTORY "Assets/lightSphere.png", TextureType::Diffuse },
+	{ GAME_DIRECTORY "Assets/wood.png", TextureType::Diffuse },
+	{ GAME_DIRECTORY "Assets/brickwall.jpg", TextureType::Diffuse },
+	{ GAME_DIRECTORY "Assets/brickwall_normal.jpg", TextureType::Normal }
+};
+
+// Times simulating and writing out the instance data of a pool of particles
+void RunParticleBenchmark()
+{
+	ParticleBenchmarkResult result = ParticleBenchmark::Run(NUM_BENCHMARK_PARTICLES, NUM_BENCHMARK_FRAMES);
+	std::cout << "Particle benchmark: " << result.numParticles << " particles, simulate " << result.simulateMs << " ms, write " << result.writeMs << " ms\n";
+}
+
+// Times loading the game's startup assets from their source files on one thread against all of them
+void RunAssetLoadBenchmark()
+{
+	AssetLoadBenchmarkResult result = AssetLoadBenchmark::Run(MODEL_FILES, TEXTURE_FILES);
+	std::cout << "Asset load benchmark (derived data cache off): " << result.numModels << " models, " << result.numTextures << " textures, 1 thread " << result.serialMs << " ms, "
+		<< result.numThreads << " threads " << result.parallelMs << " ms\n";
+}
+
+// Measures block compression quality and encode speed on the game's startup textures
+void RunTextureCompressionBenchmark()
+{
+	std::vector<std::string> textureFiles;
+	for (const auto& textureFile : TEXTURE_FILES)
+	{
+		textureFiles.emplace_back(textureFile.first);
+	}
+	for (const TextureCompressionBenchmarkResult& result : TextureCompressionBenchmark::Run(textureFiles))
+	{
+		std::cout << "Texture compression benchmark: " << TextureCompressionBenchmark::GetName(result.compression) << " " << result.numPixels << " pixels, "
+			<< result.encodeMs << " ms (" << result.megapixelsPerSecond << " MPixels/s), PSNR " << result.psnr << " dB\n";
+	}
+}
+
+// Runs the benchmarks and checks named on the command line (particles, assetload, compression, shaderreload), or all of them if none are named.
+// Returns 1 if a check failed.
+int main(int argc, char* args[])
+{
+	// Checks if a benchmark was named on the command line
+	auto shouldRun = [argc, args](const char* name)
+	{
+		if (argc < 2)
+		{
+			return true;
+		}
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(args[i], name) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	if (shouldRun("particles"))
+	{
+		RunParticleBenchmark();
+	}
+	if (shouldRun("assetload"))
+	{
+		RunAssetLoadBenchmark();
+	}
+	if (shouldRun("compression"))
+	{
+		RunTextureCompressionBenchmark();
+	}
+
+	bool passed = true;
+	if (shouldRun("shaderreload"))
+	{
+		passed &= ShaderReloadCheck::Run();
+	}
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include "ShaderReloadCheck.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <glad/glad.h>
+#include <SDL2/SDL.h>
+#include "MemoryManager/AssetManager.h"
+
+namespace ShaderReloadCheck
+{
+	// Milliseconds to wait for the file watcher to see an edit (the polling fallback checks every half second)
+	const Uint32 RELOAD_TIMEOUT_MS = 3000;
+
+	const char* VERTEX_CODE =
+		"#version 450 core\n"
+		"layout(location = 0) in vec3 pos;\n"
+		"void main() { gl_Position = vec4(pos, 1.0); }\n";
+
+	const char* FRAGMENT_CODE =
+		"#version 450 core\n"
+		"uniform vec4 tint;\n"
+		"out vec4 fragColor;\n"
+		"void main() { fragColor = tint; }\n";
+
+	const char* EDITED_FRAGMENT_CODE =
+		"#version 450 core\n"
+		"uniform vec4 tint;\n"
+		"out vec4 fragColor;\n"
+		"void main() { fragColor = tint * 0.5; }\n";
+
+	// Writes a whole file
+	// @param - const std::string& for the file name
+	// @param - const char* for the contents
+	void WriteFile(const std::string& fileName, const char* contents)
+	{
+		std::ofstream file(fileName, std::ios::trunc);
+		file << contents;
+	}
+
+	// Prints a check that failed
+	// @param - bool for if the check passed
+	// @param - const std::string& for what was checked
+	// @return - bool for if the check passed
+	bool Check(bool passed, const std::string& description)
+	{
+		if (!passed)
+		{
+			std::cout << "Shader reload check failed: " << description << "\n";
+		}
+		return passed;
+	}
+
+	bool Run()
+	{
+		if (SDL_Init(SDL_INIT_VIDEO) != 0)
+		{
+			std::cout << "Shader reload check: skipped, no video (" << SDL_GetError() << ")\n";
+			return true;
+		}
+
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+		SDL_Window* window = SDL_CreateWindow("Shader reload check", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+		SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+		if (!context)
+		{
+			std::cout << "Shader reload check: skipped, no OpenGL 4.5 context (" << SDL_GetError() << ")\n";
+			if (window)
+			{
+				SDL_DestroyWindow(window);
+			}
+			SDL_Quit();
+			return true;
+		}
+		gladLoadGLLoader(SDL_GL_GetProcAddress);
+
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / "shader_reload_check";
+		std::filesystem::create_directories(directory);
+		std::string vertexFile = (directory / "check.vert").string();
+		std::string fragmentFile = (directory / "check.frag").string();
+		WriteFile(vertexFile, VERTEX_CODE);
+		WriteFile(fragmentFile, FRAGMENT_CODE);
+
+		bool passed = true;
+		{
+			AssetManager assetManager;
+
+			Shader* shader = assetManager.LoadShader("check", vertexFile.c_str(), fragmentFile.c_str());
+			shader->SetActive();
+			shader->SetVec4("tint", glm::vec4(0.25f, 0.5f, 0.75f, 1.0f));
+			unsigned int oldID = shader->GetID();
+
+			// The game frees its shader programs once every shader is linked
+			assetManager.ClearShaderPrograms();
+
+			WriteFile(fragmentFile, EDITED_FRAGMENT_CODE);
+
+			size_t numReloaded = 0;
+			Uint32 start = SDL_GetTicks();
+			while (numReloaded == 0 && SDL_GetTicks() - start < RELOAD_TIMEOUT_MS)
+			{
+				SDL_Delay(50);
+				numReloaded = assetManager.ReloadChangedFiles();
+			}
+
+			passed &= Check(numReloaded > 0, "editing the fragment shader reloads it");
+			passed &= Check(shader->GetID() != oldID, "the shader is relinked");
+
+			GLfloat tint[4] = {};
+			glGetUniformfv(shader->GetID(), glGetUniformLocation(shader->GetID(), "tint"), tint);
+			passed &= Check(tint[0] == 0.25f && tint[1] == 0.5f && tint[2] == 0.75f && tint[3] == 1.0f, "uniforms are copied to the relinked shader");
+			passed &= Check(assetManager.GetNumCachedAssets(AssetType::ShaderProgram) == 0, "cleared shader programs aren't kept after relinking");
+
+			// A typo keeps the last working shader
+			unsigned int workingID = shader->GetID();
+			WriteFile(fragmentFile, "#version 450 core\nvoid main() { typo }\n");
+			start = SDL_GetTicks();
+			while (SDL_GetTicks() - start < RELOAD_TIMEOUT_MS / 3)
+			{
+				SDL_Delay(50);
+				assetManager.ReloadChangedFiles();
+			}
+			passed &= Check(shader->GetID() == workingID, "a shader that doesn't compile keeps the last one");
+
+			assetManager.Shutdown();
+		}
+
+		std::filesystem::remove_all(directory);
+		SDL_GL_DeleteContext(context);
+		SDL_DestroyWindow(window);
+		SDL_Quit();
+
+		std::cout << "Shader reload check: " << (passed ? "passed" : "failed") << "\n";
+
+		return passed;
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace ShaderReloadCheck
+{
+	// Opens a hidden window, links a shader from temporary files, clears its shader programs like the game does,
+	// then edits the fragment shader and checks that the file watcher relinks the shader and keeps its uniforms.
+	// Skipped (and counted as passing) if there is no display to make an OpenGL context with.
+	// @return - bool for if every check passed
+	bool Run();
+}
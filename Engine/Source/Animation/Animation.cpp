@@ -1,5 +1,6 @@
 #include "Animation.h"
 #include <iostream>
+#include <utility>
 #include "../Util/AssimpGLMHelper.h"
 #include "Skeleton.h"
 
@@ -13,6 +14,15 @@ Animation::Animation(const aiAnimation* anim, Skeleton* skeleton, const std::str
 	ReadKeyFrames(anim, skeleton);
 }
 
+Animation::Animation(std::unordered_map<int, AnimationTrack>&& tracks, float duration, float ticksPerSecond, Skeleton* skeleton, const std::string& animName) :
+	mAnimationTracks(std::move(tracks)),
+	mName(animName),
+	mDuration(duration),
+	mTicksPerSecond(ticksPerSecond)
+{
+	skeleton->AddAnim(this);
+}
+
 Animation::~Animation()
 {
 	std::cout << "Deleted Animation: " << mName << "\n";
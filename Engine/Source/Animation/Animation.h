@@ -48,6 +48,13 @@ public:
 	// @param - const Skeleton* for the skeleton associated with this animation. This will add to skeleton's vector of animations
 	// @param - const std::string& for the animation name
 	Animation(const aiAnimation* anim, Skeleton* skeleton, const std::string& animName);
+	// Animation constructor: Takes tracks that were already read (used for cooked models) and saves this animation to skeleton's vector of animations
+	// @param - std::unordered_map<int, AnimationTrack>&& for the tracks by bone id
+	// @param - float for the duration in ticks
+	// @param - float for the ticks per second
+	// @param - Skeleton* for the skeleton associated with this animation
+	// @param - const std::string& for the animation name
+	Animation(std::unordered_map<int, AnimationTrack>&& tracks, float duration, float ticksPerSecond, Skeleton* skeleton, const std::string& animName);
 	~Animation();
 
 	// Gets a bone's animation track by bone id/index. Returns nullptr if not found
@@ -55,6 +62,10 @@ public:
 	// @return - const AnimationTrack* for the bone's animation track, nullptr if not found
 	const AnimationTrack* GetTrack(int boneID) const;
 
+	// Gets every bone's animation track by bone id
+	// @return - const std::unordered_map<int, AnimationTrack>& for the tracks
+	const std::unordered_map<int, AnimationTrack>& GetTracks() const { return mAnimationTracks; }
+
 	// Interpolates a bone's position from the current key frame to the next
 	// @param - float for the current time of the animation
 	// @param - const AnimationTrack& for the bone being interpolated
@@ -13,6 +13,17 @@ Skeleton::Skeleton(const aiScene* scene, const std::string& fileName) :
 	LoadOffset(scene);
 }
 
+Skeleton::Skeleton(const std::vector<Bone>& bones, const glm::mat4& rootInverseTransform, const std::string& fileName) :
+	mBones(bones),
+	mRootInverseTransform(rootInverseTransform),
+	mName(fileName)
+{
+	for (const Bone& bone : mBones)
+	{
+		mBoneNameToID[bone.name] = bone.id;
+	}
+}
+
 Skeleton::~Skeleton()
 {
 	std::cout << "Deleted Skeleton: " << mName << "\n";
@@ -28,6 +28,11 @@ public:
     // @param - const aiScene* for the model's scene
     // @param - const std::string& for the file name
 	Skeleton(const aiScene* scene, const std::string& fileName);
+    // Skeleton constructor: Rebuilds a skeleton from bones that are already in hierarchical order (used for cooked models)
+    // @param - const std::vector<Bone>& for the bones
+    // @param - const glm::mat4& for the inverse of the root transform
+    // @param - const std::string& for the file name
+    Skeleton(const std::vector<Bone>& bones, const glm::mat4& rootInverseTransform, const std::string& fileName);
 	// Skeleton destructor:
     // The vector of Animations* is used purely for copying animations to a duplicate model. Models with the same
     // file will share the same skeleton. All ownership of any Animation objects will be handled by the AssetManager. 
@@ -48,6 +53,14 @@ public:
     // @return - int for the bone's id
     int GetBoneID(const std::string& name) const;
 
+    // Gets the bones in hierarchical order
+    // @return - const std::vector<Bone>& for the bones
+    const std::vector<Bone>& GetBones() const { return mBones; }
+
+    // Gets the inverse of the root transform
+    // @return - const glm::mat4& for the inverse root transform
+    const glm::mat4& GetRootInverseTransform() const { return mRootInverseTransform; }
+
     // Adds an animation to the vector of animations
     void AddAnim(Animation* anim) { mAnimations.emplace_back(anim); }
 
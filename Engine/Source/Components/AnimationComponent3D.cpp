@@ -4,12 +4,14 @@
 #include "../Animation/Animation.h"
 #include "../Graphics/UniformBuffer.h"
 
-AnimationComponent3D::AnimationComponent3D(Entity* entity, Skeleton* skeleton, UniformBuffer* skeletonBuffer) :
+AnimationComponent3D::AnimationComponent3D(Entity* entity, Skeleton* skeleton, BufferRing* uniformRing) :
 	Component(entity),
 	mSkeletonConsts({}),
 	mSkeleton(skeleton),
 	mCurrentAnimation(nullptr),
-	mSkeletonBuffer(skeletonBuffer),
+	mUniformRing(uniformRing),
+	mSkeletonAllocation({}),
+	mSkeletonAllocationFrame(0),
 	mJob(this),
 	mCurrentTime(0.0f)
 {
@@ -53,7 +55,14 @@ void AnimationComponent3D::Update(float deltaTime, const EngineContext& engineCo
 
 void AnimationComponent3D::UpdateSkeletonBuffer()
 {
-	mSkeletonBuffer->UpdateBufferData(&mSkeletonConsts);
+	// Bones don't change between render passes, so only write them the first time they are used each frame
+	if (mSkeletonAllocation.size == 0 || mSkeletonAllocationFrame != mUniformRing->GetFrameCount())
+	{
+		mSkeletonAllocation = mUniformRing->Allocate(&mSkeletonConsts, sizeof(SkeletonConsts));
+		mSkeletonAllocationFrame = mUniformRing->GetFrameCount();
+	}
+
+	mUniformRing->Bind(mSkeletonAllocation, static_cast<unsigned int>(BufferBindingPoint::Skeleton));
 }
 
 void AnimationComponent3D::SetCurrentAnimation(Animation* anim)
@@ -3,13 +3,13 @@
 #include <string>
 #include <unordered_map>
 #include "../Animation/BoneData.h"
+#include "../Graphics/BufferRing.h"
 #include "../Multithreading/JobManager.h"
 #include "../EngineContext.h"
 
 class Animation;
 class Entity;
 class Skeleton;
-class UniformBuffer;
 class Model;
 
 
@@ -20,12 +20,13 @@ public:
 	// AnimationComponent constructor: 
 	// Checks to see if the skelton exists, and loads all the saved animations into the map of animations. Sets default animation at the end
 	// @param - Entity* for the component's owner
-	// @param - Model* for the 
-	AnimationComponent3D(Entity* entity, Skeleton* skeleton, UniformBuffer* skeletonBuffer);
+	// @param - Skeleton* for the model's skeleton
+	// @param - BufferRing* for the renderer's uniform ring that bone matrices are written into
+	AnimationComponent3D(Entity* entity, Skeleton* skeleton, BufferRing* uniformRing);
 
 	// AnimationComponent destructor:
-	// mSkeletonBuffer, mSkeleton, and mCurrentAnimation are all loaded through AssetManager, with mSkeletonBuffer being
-	// loaded through the Renderer3D. These are all cached/shared objects so do not free/call delete on these here.
+	// mUniformRing, mSkeleton, and mCurrentAnimation are all loaded through AssetManager, with mUniformRing being
+	// owned by the Renderer. These are all cached/shared objects so do not free/call delete on these here.
 	~AnimationComponent3D();
 
 	// Override update for animation component specific updates
@@ -34,7 +35,7 @@ public:
 	// @param - const EngineContext& for the engine context
 	void Update(float deltaTime, const EngineContext& engineContext) override;
 
-	// Updates the skeleton buffer with the final bone matrices array
+	// Writes the final bone matrices array into the uniform ring once per frame and binds it to the skeleton binding point
 	void UpdateSkeletonBuffer();
 
 	// Gets the skeleton's current animation
@@ -88,8 +89,14 @@ private:
 	// The current animation
 	Animation* mCurrentAnimation;
 
-	// Uniform buffer to send skelton data to
-	UniformBuffer* mSkeletonBuffer;
+	// Uniform ring to send skeleton data through
+	BufferRing* mUniformRing;
+
+	// Where this frame's bone matrices are in the uniform ring
+	BufferRingAllocation mSkeletonAllocation;
+
+	// Uniform ring frame that mSkeletonAllocation was written in
+	unsigned long long mSkeletonAllocationFrame;
 
 	// Job to update bone transformations on separate thread
 	UpdateBoneJob mJob;
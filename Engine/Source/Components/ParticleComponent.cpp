@@ -0,0 +1,38 @@
+#include "ParticleComponent.h"
+#include <iostream>
+#include "../Entity/Entity.h"
+#include "../Graphics/Renderer.h"
+
+ParticleComponent::ParticleComponent(Entity* owner, Renderer* renderer, size_t capacity, ParticleSimulation simulation, Shader* computeShader) :
+	Component(owner),
+	mOffset(0.0f),
+	mDirection(0.0f, 1.0f, 0.0f),
+	mRenderer(renderer),
+	mParticleSystem(new ParticleSystem(capacity, simulation, computeShader)),
+	mFollowsOwner(true)
+{
+	mRenderer->AddParticleSystem(mParticleSystem);
+}
+
+ParticleComponent::~ParticleComponent()
+{
+	std::cout << "Delete ParticleComponent\n";
+
+	mRenderer->RemoveParticleSystem(mParticleSystem);
+
+	delete mParticleSystem;
+}
+
+void ParticleComponent::Update(float deltaTime, const EngineContext&)
+{
+	if (mFollowsOwner)
+	{
+		ParticleEmitterSettings& settings = mParticleSystem->GetSettings();
+		const glm::quat& rotation = mOwner->GetQuatRotation();
+
+		settings.position = mOwner->GetPosition3D() + rotation * mOffset;
+		settings.direction = rotation * mDirection;
+	}
+
+	mParticleSystem->Update(deltaTime);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "Component.h"
+#include <glm/glm.hpp>
+#include "../Particles/ParticleSystem.h"
+
+class Renderer;
+class Shader;
+
+// ParticleComponent owns a particle system whose emitter follows the owner. The emitter's
+// offset and direction are in the owner's local space and are rotated with the owner.
+class ParticleComponent : public Component
+{
+public:
+	// ParticleComponent constructor:
+	// Creates the particle system and adds it to the renderer
+	// @param - Entity* for the owner
+	// @param - Renderer* for the renderer
+	// @param - size_t for the max number of particles
+	// @param - ParticleSimulation for where the particles are simulated (defaults to CPU)
+	// @param - Shader* for the compute shader used with ParticleSimulation::Compute (defaults to nullptr)
+	ParticleComponent(Entity* owner, Renderer* renderer, size_t capacity, ParticleSimulation simulation = ParticleSimulation::CPU, Shader* computeShader = nullptr);
+	~ParticleComponent();
+
+	// Moves the emitter to the owner and updates the particle system
+	// @param - float for delta time
+	// @param - const EngineContext& for the engine context
+	void Update(float deltaTime, const EngineContext& engineContext) override;
+
+	// Gets the particle system
+	// @return - ParticleSystem* for the particle system
+	ParticleSystem* GetParticleSystem() { return mParticleSystem; }
+
+	// Gets the emitter's settings
+	// @return - ParticleEmitterSettings& for the settings
+	ParticleEmitterSettings& GetSettings() { return mParticleSystem->GetSettings(); }
+
+	// Sets the emitter's offset from the owner in the owner's local space
+	// @param - const glm::vec3& for the offset
+	void SetOffset(const glm::vec3& offset) { mOffset = offset; }
+
+	// Sets the emitter's direction in the owner's local space
+	// @param - const glm::vec3& for the direction
+	void SetDirection(const glm::vec3& direction) { mDirection = glm::normalize(direction); }
+
+	// Sets if the emitter follows the owner. When false the emitter's settings are used as is.
+	// @param - bool for if the emitter follows the owner
+	void SetFollowsOwner(bool followsOwner) { mFollowsOwner = followsOwner; }
+
+private:
+	// Emitter's offset in the owner's local space
+	glm::vec3 mOffset;
+
+	// Emitter's direction in the owner's local space
+	glm::vec3 mDirection;
+
+	// Renderer that draws the particle system
+	Renderer* mRenderer;
+
+	// Particle system
+	ParticleSystem* mParticleSystem;
+
+	// Bool for if the emitter follows the owner
+	bool mFollowsOwner;
+};
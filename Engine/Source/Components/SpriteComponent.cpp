@@ -5,9 +5,11 @@
 
 SpriteComponent::SpriteComponent(Entity* owner, Renderer2D* renderer, int drawOrder) :
 	Component(owner),
+	mUVRect(0.0f, 0.0f, 1.0f, 1.0f),
 	mSize(),
 	mRenderer(renderer),
 	mCurrentSprite(nullptr),
+	mLayerIndex(0),
 	mDrawOrder(drawOrder),
 	mIsVisible(true)
 {
@@ -23,11 +25,26 @@ SpriteComponent::~SpriteComponent()
 
 void SpriteComponent::AddSprite(Texture* sprite)
 {
-	std::string spriteName = sprite->GetName();
+	AtlasRegion region = {};
+	region.texture = sprite;
+	region.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	region.size = glm::vec2(sprite->GetWidth(), sprite->GetHeight());
+
+	AddSprite(sprite->GetName(), &region);
+}
+
+void SpriteComponent::AddSprite(const std::string& spriteName, const AtlasRegion* region)
+{
+	if (!region)
+	{
+		std::cout << "Sprite name: " << spriteName << " has no region\n";
+		return;
+	}
+
 	auto iter = mSprites.find(spriteName);
 	if (iter == mSprites.end())
 	{
-		mSprites[spriteName] = sprite;
+		mSprites[spriteName] = *region;
 	}
 	else
 	{
@@ -35,12 +52,12 @@ void SpriteComponent::AddSprite(Texture* sprite)
 	}
 }
 
-Texture* SpriteComponent::GetSprite(const std::string& spriteName)
+const AtlasRegion* SpriteComponent::GetSprite(const std::string& spriteName) const
 {
 	auto iter = mSprites.find(spriteName);
 	if (iter != mSprites.end())
 	{
-		return iter->second;
+		return &iter->second;
 	}
 	return nullptr;
 }
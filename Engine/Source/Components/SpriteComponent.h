@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include "../Graphics/Texture.h"
+#include "../Graphics/TextureAtlas.h"
 
 class Renderer2D;
 
@@ -17,19 +18,28 @@ public:
 	SpriteComponent(Entity* owner, Renderer2D* renderer, int drawOrder = 100);
 	~SpriteComponent();
 
-	// Adds a sprite to the map of sprites
+	// Adds a whole texture to the map of sprites using the texture's file name
 	// @param - Texture* for the sprite
 	void AddSprite(Texture* sprite);
 
-	// Gets a sprite to the map by file name. Returns nullptr if not found
-	// @param - const std::string& for the sprite's file name
-	// @return - Texture* for the sprite
-	Texture* GetSprite(const std::string& spriteName);
+	// Adds an atlas region to the map of sprites
+	// @param - const std::string& for the sprite's name
+	// @param - const AtlasRegion* for the sprite's region in a texture atlas
+	void AddSprite(const std::string& spriteName, const AtlasRegion* region);
 
-	// Gets the current sprite being drawn
-	// @return - Texture* for the current sprite
+	// Gets a sprite's region from the map by name. Returns nullptr if not found
+	// @param - const std::string& for the sprite's name
+	// @return - const AtlasRegion* for the sprite
+	const AtlasRegion* GetSprite(const std::string& spriteName) const;
+
+	// Gets the texture of the current sprite being drawn
+	// @return - Texture* for the current sprite's texture
 	Texture* GetCurrentSprite() { return mCurrentSprite; }
 
+	// Gets the current sprite's uv sub-rect within its texture
+	// @return - const glm::vec4& for the uv offset (xy) and scale (zw)
+	const glm::vec4& GetUVRect() const { return mUVRect; }
+
 	// Gets the sprite's size
 	// @return - const glm::vec2& for the size
 	const glm::vec2& GetSize() { return mSize; }
@@ -51,17 +61,32 @@ public:
 	// @param - float for height
 	void SetSize(float w, float h) { mSize.x = w; mSize.y = h; }
 
-	// Sets the current sprite to draw
+	// Sets the current sprite to draw using a whole texture
 	// @param - Texture* for the new sprite
-	void SetSprite(Texture* sprite) { mCurrentSprite = sprite; SetSize(sprite->GetWidth(), sprite->GetHeight()); }
+	void SetSprite(Texture* sprite) { mCurrentSprite = sprite; mUVRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); SetSize(sprite->GetWidth(), sprite->GetHeight()); }
+
+	// Sets the current sprite to draw using a region of a texture atlas
+	// @param - const AtlasRegion* for the new sprite
+	void SetSprite(const AtlasRegion* region) { mCurrentSprite = region->texture; mUVRect = region->uvRect; SetSize(region->size); }
+
+	// Gets the sprite's index within its Renderer2D layer
+	// @return - size_t for the index
+	size_t GetLayerIndex() const { return mLayerIndex; }
+
+	// Sets the sprite's index within its Renderer2D layer (only Renderer2D should call this)
+	// @param - size_t for the index
+	void SetLayerIndex(size_t index) { mLayerIndex = index; }
 
 	// Sets the visiblity of a sprite
 	// @param - bool for if the sprite is visible or not
 	void SetIsVisible(bool visible) { mIsVisible = visible; }
 
 private:
-	// Map of sprites/textures used by the owner
-	std::unordered_map<std::string, Texture*> mSprites;
+	// Map of sprite regions used by the owner
+	std::unordered_map<std::string, AtlasRegion> mSprites;
+
+	// Current sprite's uv offset (xy) and scale (zw) within its texture
+	glm::vec4 mUVRect;
 
 	// Base size of the sprite (original texture dimensions)
 	glm::vec2 mSize;
@@ -72,6 +97,9 @@ private:
 	// Current sprite
 	Texture* mCurrentSprite;
 
+	// Index of the sprite within its Renderer2D layer, used for O(1) removal
+	size_t mLayerIndex;
+
 	// Draw order for the sprite. (lower number means further back)
 	int mDrawOrder;
 
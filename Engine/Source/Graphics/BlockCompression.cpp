@@ -0,0 +1,790 @@
+#include "BlockCompression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Interpolation weights (out of 64) of BC7's 4 bit indices
+static const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Number of power iterations used to find a block's principal axis
+static const int PRINCIPAL_AXIS_ITERATIONS = 8;
+
+// Writes bits into a block, least significant bit first
+// @param - unsigned char* for the block (must start zeroed)
+// @param - int& for the bit to write at, moved past the written bits
+// @param - unsigned int for the value
+// @param - int for the number of bits
+static void WriteBits(unsigned char* block, int& bit, unsigned int value, int numBits)
+{
+	for (int i = 0; i < numBits; ++i, ++bit)
+	{
+		if ((value >> i) & 1)
+		{
+			block[bit >> 3] |= static_cast<unsigned char>(1 << (bit & 7));
+		}
+	}
+}
+
+// Reads bits from a block, least significant bit first
+// @param - const unsigned char* for the block
+// @param - int& for the bit to read at, moved past the read bits
+// @param - int for the number of bits
+// @return - unsigned int for the value
+static unsigned int ReadBits(const unsigned char* block, int& bit, int numBits)
+{
+	unsigned int value = 0;
+	for (int i = 0; i < numBits; ++i, ++bit)
+	{
+		value |= ((block[bit >> 3] >> (bit & 7)) & 1u) << i;
+	}
+	return value;
+}
+
+// Finds the axis the pixels of a block spread along the most, using power iteration on their covariance
+// @param - const float (*)[4] for the block's pixels
+// @param - int for the number of channels to use
+// @param - float* for the mean of the pixels
+// @param - float* for the axis (all zero if every pixel is the same)
+static void FindPrincipalAxis(const float (*pixels)[4], int numChannels, float* mean, float* axis)
+{
+	for (int c = 0; c < numChannels; ++c)
+	{
+		mean[c] = 0.0f;
+		for (int i = 0; i < 16; ++i)
+		{
+			mean[c] += pixels[i][c];
+		}
+		mean[c] /= 16.0f;
+	}
+
+	float covariance[4][4] = {};
+	for (int i = 0; i < 16; ++i)
+	{
+		for (int a = 0; a < numChannels; ++a)
+		{
+			for (int b = 0; b < numChannels; ++b)
+			{
+				covariance[a][b] += (pixels[i][a] - mean[a]) * (pixels[i][b] - mean[b]);
+			}
+		}
+	}
+
+	// Start along the diagonal, which is close to the answer for most color blocks
+	for (int c = 0; c < numChannels; ++c)
+	{
+		axis[c] = 1.0f;
+	}
+
+	for (int iteration = 0; iteration < PRINCIPAL_AXIS_ITERATIONS; ++iteration)
+	{
+		float next[4] = {};
+		float length = 0.0f;
+		for (int a = 0; a < numChannels; ++a)
+		{
+			for (int b = 0; b < numChannels; ++b)
+			{
+				next[a] += covariance[a][b] * axis[b];
+			}
+			length = std::max(length, std::fabs(next[a]));
+		}
+
+		if (length < 1e-6f)
+		{
+			for (int c = 0; c < numChannels; ++c)
+			{
+				axis[c] = 0.0f;
+			}
+			return;
+		}
+
+		for (int c = 0; c < numChannels; ++c)
+		{
+			axis[c] = next[c] / length;
+		}
+	}
+}
+
+// Finds a block's endpoints at the ends of its principal axis
+// @param - const float (*)[4] for the block's pixels
+// @param - int for the number of channels to use
+// @param - float* for the first endpoint (highest along the axis)
+// @param - float* for the second endpoint (lowest along the axis)
+static void FindEndpoints(const float (*pixels)[4], int numChannels, float* e0, float* e1)
+{
+	float mean[4] = {};
+	float axis[4] = {};
+	FindPrincipalAxis(pixels, numChannels, mean, axis);
+
+	float minT = 0.0f;
+	float maxT = 0.0f;
+	float lengthSq = 0.0f;
+	for (int c = 0; c < numChannels; ++c)
+	{
+		lengthSq += axis[c] * axis[c];
+	}
+
+	if (lengthSq > 0.0f)
+	{
+		minT = maxT = 0.0f;
+		for (int i = 0; i < 16; ++i)
+		{
+			float t = 0.0f;
+			for (int c = 0; c < numChannels; ++c)
+			{
+				t += (pixels[i][c] - mean[c]) * axis[c];
+			}
+			t /= lengthSq;
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+	}
+
+	for (int c = 0; c < numChannels; ++c)
+	{
+		e0[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+		e1[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+	}
+}
+
+// Packs an 8 bit color into 565
+// @param - const float* for the color
+// @return - uint16_t for the packed color
+static uint16_t Pack565(const float* color)
+{
+	int r = static_cast<int>(std::lround(color[0] * 31.0f / 255.0f));
+	int g = static_cast<int>(std::lround(color[1] * 63.0f / 255.0f));
+	int b = static_cast<int>(std::lround(color[2] * 31.0f / 255.0f));
+	return static_cast<uint16_t>((std::clamp(r, 0, 31) << 11) | (std::clamp(g, 0, 63) << 5) | std::clamp(b, 0, 31));
+}
+
+// Unpacks a 565 color into 8 bits per channel
+// @param - uint16_t for the packed color
+// @param - int* for the color
+static void Unpack565(uint16_t packed, int* color)
+{
+	int r = (packed >> 11) & 31;
+	int g = (packed >> 5) & 63;
+	int b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+// Builds the 4 colors a BC1 block can use
+// @param - uint16_t for the first endpoint
+// @param - uint16_t for the second endpoint
+// @param - bool for if the block always uses 4 colors (BC3 color blocks do)
+// @param - int (*)[4] for the colors (alpha is 0 for the transparent color of 3 color blocks)
+static void GetColorPalette(uint16_t c0, uint16_t c1, bool isFourColor, int (*palette)[4])
+{
+	Unpack565(c0, palette[0]);
+	Unpack565(c1, palette[1]);
+	palette[0][3] = 255;
+	palette[1][3] = 255;
+
+	for (int c = 0; c < 3; ++c)
+	{
+		if (isFourColor || c0 > c1)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		else
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = (isFourColor || c0 > c1) ? 255 : 0;
+}
+
+// Picks the closest palette color for each pixel of a block
+// @param - const float (*)[4] for the block's pixels
+// @param - const int (*)[4] for the 4 colors
+// @param - int* for the index of each pixel
+// @return - float for the total squared error
+static float PickColorIndices(const float (*pixels)[4], const int (*palette)[4], int* indices)
+{
+	float totalError = 0.0f;
+	for (int i = 0; i < 16; ++i)
+	{
+		float bestError = 1e30f;
+		for (int p = 0; p < 4; ++p)
+		{
+			float dr = pixels[i][0] - palette[p][0];
+			float dg = pixels[i][1] - palette[p][1];
+			float db = pixels[i][2] - palette[p][2];
+			float error = dr * dr + dg * dg + db * db;
+			if (error < bestError)
+			{
+				bestError = error;
+				indices[i] = p;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+// Solves for the endpoints that best fit the pixels with their chosen indices (least squares)
+// @param - const float (*)[4] for the block's pixels
+// @param - const int* for the index of each pixel
+// @param - float* for the first endpoint
+// @param - float* for the second endpoint
+// @return - bool for if there was a solution (false when every pixel uses the same weight)
+static bool FitColorEndpoints(const float (*pixels)[4], const int* indices, float* e0, float* e1)
+{
+	// How far each index is from the first endpoint to the second
+	static const float INDEX_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float ax[3] = {};
+	float bx[3] = {};
+	for (int i = 0; i < 16; ++i)
+	{
+		float t = INDEX_WEIGHTS[indices[i]];
+		float s = 1.0f - t;
+		aa += s * s;
+		ab += s * t;
+		bb += t * t;
+		for (int c = 0; c < 3; ++c)
+		{
+			ax[c] += s * pixels[i][c];
+			bx[c] += t * pixels[i][c];
+		}
+	}
+
+	float determinant = aa * bb - ab * ab;
+	if (std::fabs(determinant) < 1e-6f)
+	{
+		return false;
+	}
+
+	for (int c = 0; c < 3; ++c)
+	{
+		e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+		e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+// Encodes a BC1 color block (always in 4 color mode so it's also valid inside BC3)
+// @param - const float (*)[4] for the block's pixels
+// @param - unsigned char* for the 8 byte block
+static void EncodeColorBlock(const float (*pixels)[4], unsigned char* block)
+{
+	float e0[4] = {};
+	float e1[4] = {};
+	FindEndpoints(pixels, 3, e0, e1);
+
+	uint16_t c0 = Pack565(e0);
+	uint16_t c1 = Pack565(e1);
+	int indices[16] = {};
+	int palette[4][4] = {};
+
+	// 4 color mode needs the first endpoint to be larger
+	if (c0 < c1)
+	{
+		std::swap(c0, c1);
+	}
+	GetColorPalette(c0, c1, true, palette);
+	float error = PickColorIndices(pixels, palette, indices);
+
+	// Refit the endpoints to the chosen indices once, and keep the result if it's better
+	float fit0[4] = {};
+	float fit1[4] = {};
+	if (c0 != c1 && FitColorEndpoints(pixels, indices, fit0, fit1))
+	{
+		uint16_t fitC0 = Pack565(fit0);
+		uint16_t fitC1 = Pack565(fit1);
+		if (fitC0 < fitC1)
+		{
+			std::swap(fitC0, fitC1);
+		}
+
+		int fitIndices[16] = {};
+		int fitPalette[4][4] = {};
+		GetColorPalette(fitC0, fitC1, true, fitPalette);
+		float fitError = PickColorIndices(pixels, fitPalette, fitIndices);
+		if (fitError < error)
+		{
+			c0 = fitC0;
+			c1 = fitC1;
+			std::memcpy(indices, fitIndices, sizeof(indices));
+		}
+	}
+
+	// Equal endpoints would be read as 3 color mode, where every pixel using index 0 is still right
+	uint32_t packedIndices = 0;
+	if (c0 != c1)
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			packedIndices |= static_cast<uint32_t>(indices[i]) << (2 * i);
+		}
+	}
+
+	block[0] = static_cast<unsigned char>(c0 & 0xFF);
+	block[1] = static_cast<unsigned char>(c0 >> 8);
+	block[2] = static_cast<unsigned char>(c1 & 0xFF);
+	block[3] = static_cast<unsigned char>(c1 >> 8);
+	for (int i = 0; i < 4; ++i)
+	{
+		block[4 + i] = static_cast<unsigned char>((packedIndices >> (8 * i)) & 0xFF);
+	}
+}
+
+// Decodes a BC1 color block
+// @param - const unsigned char* for the 8 byte block
+// @param - bool for if the block always uses 4 colors (BC3 color blocks do)
+// @param - unsigned char* for 16 RGBA8 pixels
+static void DecodeColorBlock(const unsigned char* block, bool isFourColor, unsigned char* rgba)
+{
+	uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+	uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+	uint32_t indices = static_cast<uint32_t>(block[4]) | (static_cast<uint32_t>(block[5]) << 8) | (static_cast<uint32_t>(block[6]) << 16) | (static_cast<uint32_t>(block[7]) << 24);
+
+	int palette[4][4] = {};
+	GetColorPalette(c0, c1, isFourColor, palette);
+
+	for (int i = 0; i < 16; ++i)
+	{
+		const int* color = palette[(indices >> (2 * i)) & 3];
+		for (int c = 0; c < 4; ++c)
+		{
+			rgba[i * 4 + c] = static_cast<unsigned char>(color[c]);
+		}
+	}
+}
+
+// Builds the 8 values a BC4 block can use
+// @param - int for the first endpoint
+// @param - int for the second endpoint
+// @param - int* for the values
+static void GetSingleChannelPalette(int a0, int a1, int* palette)
+{
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1)
+	{
+		for (int i = 2; i < 8; ++i)
+		{
+			palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+		}
+	}
+	else
+	{
+		for (int i = 2; i < 6; ++i)
+		{
+			palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+// Encodes a BC4 block for one channel of a block's pixels
+// @param - const float (*)[4] for the block's pixels
+// @param - int for the channel
+// @param - unsigned char* for the 8 byte block
+static void EncodeSingleChannelBlock(const float (*pixels)[4], int channel, unsigned char* block)
+{
+	int minValue = 255;
+	int maxValue = 0;
+	for (int i = 0; i < 16; ++i)
+	{
+		int value = static_cast<int>(std::lround(pixels[i][channel]));
+		minValue = std::min(minValue, value);
+		maxValue = std::max(maxValue, value);
+	}
+
+	// The first endpoint being larger picks the 8 value mode
+	int palette[8] = {};
+	GetSingleChannelPalette(maxValue, minValue, palette);
+
+	std::memset(block, 0, 8);
+	block[0] = static_cast<unsigned char>(maxValue);
+	block[1] = static_cast<unsigned char>(minValue);
+
+	int bit = 16;
+	for (int i = 0; i < 16; ++i)
+	{
+		int bestIndex = 0;
+		float bestError = 1e30f;
+		for (int p = 0; p < 8; ++p)
+		{
+			float error = std::fabs(pixels[i][channel] - palette[p]);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+		WriteBits(block, bit, static_cast<unsigned int>(bestIndex), 3);
+	}
+}
+
+// Decodes a BC4 block into one channel of 16 RGBA8 pixels
+// @param - const unsigned char* for the 8 byte block
+// @param - int for the channel
+// @param - unsigned char* for 16 RGBA8 pixels
+static void DecodeSingleChannelBlock(const unsigned char* block, int channel, unsigned char* rgba)
+{
+	int palette[8] = {};
+	GetSingleChannelPalette(block[0], block[1], palette);
+
+	int bit = 16;
+	for (int i = 0; i < 16; ++i)
+	{
+		rgba[i * 4 + channel] = static_cast<unsigned char>(palette[ReadBits(block, bit, 3)]);
+	}
+}
+
+// Quantizes an endpoint to BC7 mode 6's 7 bits per channel plus a shared bit, picking the shared bit with less error
+// @param - const float* for the RGBA endpoint
+// @param - int* for the 7 bit channels
+// @param - int& for the shared bit
+static void QuantizeMode6Endpoint(const float* endpoint, int* quantized, int& pBit)
+{
+	float bestError = 1e30f;
+	for (int p = 0; p < 2; ++p)
+	{
+		int candidate[4] = {};
+		float error = 0.0f;
+		for (int c = 0; c < 4; ++c)
+		{
+			candidate[c] = std::clamp(static_cast<int>(std::lround((endpoint[c] - p) / 2.0f)), 0, 127);
+			float diff = static_cast<float>((candidate[c] << 1) | p) - endpoint[c];
+			error += diff * diff;
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+			pBit = p;
+			std::memcpy(quantized, candidate, sizeof(candidate));
+		}
+	}
+}
+
+// Encodes a BC7 block with mode 6 (one subset, RGBA endpoints, 4 bit indices)
+// @param - const float (*)[4] for the block's pixels
+// @param - unsigned char* for the 16 byte block
+static void EncodeMode6Block(const float (*pixels)[4], unsigned char* block)
+{
+	float e0[4] = {};
+	float e1[4] = {};
+	FindEndpoints(pixels, 4, e0, e1);
+
+	int q0[4] = {};
+	int q1[4] = {};
+	int p0 = 0;
+	int p1 = 0;
+	QuantizeMode6Endpoint(e0, q0, p0);
+	QuantizeMode6Endpoint(e1, q1, p1);
+
+	int palette[16][4] = {};
+	for (int i = 0; i < 16; ++i)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			int d0 = (q0[c] << 1) | p0;
+			int d1 = (q1[c] << 1) | p1;
+			palette[i][c] = ((64 - BC7_WEIGHTS[i]) * d0 + BC7_WEIGHTS[i] * d1 + 32) >> 6;
+		}
+	}
+
+	int indices[16] = {};
+	for (int i = 0; i < 16; ++i)
+	{
+		float bestError = 1e30f;
+		for (int p = 0; p < 16; ++p)
+		{
+			float error = 0.0f;
+			for (int c = 0; c < 4; ++c)
+			{
+				float diff = pixels[i][c] - palette[p][c];
+				error += diff * diff;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				indices[i] = p;
+			}
+		}
+	}
+
+	// The first pixel's index is stored with its top bit implied to be 0, so flip the endpoints if it's set
+	if (indices[0] & 8)
+	{
+		std::swap(q0, q1);
+		std::swap(p0, p1);
+		for (int i = 0; i < 16; ++i)
+		{
+			indices[i] = 15 - indices[i];
+		}
+	}
+
+	std::memset(block, 0, 16);
+	int bit = 0;
+	WriteBits(block, bit, 1u << 6, 7);
+	for (int c = 0; c < 4; ++c)
+	{
+		WriteBits(block, bit, static_cast<unsigned int>(q0[c]), 7);
+		WriteBits(block, bit, static_cast<unsigned int>(q1[c]), 7);
+	}
+	WriteBits(block, bit, static_cast<unsigned int>(p0), 1);
+	WriteBits(block, bit, static_cast<unsigned int>(p1), 1);
+	WriteBits(block, bit, static_cast<unsigned int>(indices[0]), 3);
+	for (int i = 1; i < 16; ++i)
+	{
+		WriteBits(block, bit, static_cast<unsigned int>(indices[i]), 4);
+	}
+}
+
+// Decodes a BC7 block. Only mode 6 is supported since that's all the encoder writes, other modes decode to black.
+// @param - const unsigned char* for the 16 byte block
+// @param - unsigned char* for 16 RGBA8 pixels
+static void DecodeMode6Block(const unsigned char* block, unsigned char* rgba)
+{
+	int bit = 0;
+	if (ReadBits(block, bit, 7) != (1u << 6))
+	{
+		std::memset(rgba, 0, 64);
+		return;
+	}
+
+	int q[2][4] = {};
+	for (int c = 0; c < 4; ++c)
+	{
+		q[0][c] = static_cast<int>(ReadBits(block, bit, 7));
+		q[1][c] = static_cast<int>(ReadBits(block, bit, 7));
+	}
+	int p0 = static_cast<int>(ReadBits(block, bit, 1));
+	int p1 = static_cast<int>(ReadBits(block, bit, 1));
+
+	for (int i = 0; i < 16; ++i)
+	{
+		int index = static_cast<int>(ReadBits(block, bit, i == 0 ? 3 : 4));
+		for (int c = 0; c < 4; ++c)
+		{
+			int d0 = (q[0][c] << 1) | p0;
+			int d1 = (q[1][c] << 1) | p1;
+			rgba[i * 4 + c] = static_cast<unsigned char>(((64 - BC7_WEIGHTS[index]) * d0 + BC7_WEIGHTS[index] * d1 + 32) >> 6);
+		}
+	}
+}
+
+size_t BlockCompression::GetBlockSize(TextureCompression compression)
+{
+	switch (compression)
+	{
+	case TextureCompression::BC1:
+		return 8;
+	case TextureCompression::BC3:
+	case TextureCompression::BC5:
+	case TextureCompression::BC7:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+size_t BlockCompression::GetCompressedSize(TextureCompression compression, int width, int height)
+{
+	size_t blocksWide = static_cast<size_t>(width + 3) / 4;
+	size_t blocksHigh = static_cast<size_t>(height + 3) / 4;
+	return blocksWide * blocksHigh * BlockCompression::GetBlockSize(compression);
+}
+
+std::vector<TextureMip> BlockCompression::GetMipChain(TextureCompression compression, int width, int height)
+{
+	std::vector<TextureMip> mips;
+	size_t offset = 0;
+	while (true)
+	{
+		size_t size = compression == TextureCompression::None ? static_cast<size_t>(width) * height * 4 : BlockCompression::GetCompressedSize(compression, width, height);
+		mips.push_back({ offset, size, width, height });
+		offset += size;
+
+		if (width == 1 && height == 1)
+		{
+			break;
+		}
+		width = std::max(1, width / 2);
+		height = std::max(1, height / 2);
+	}
+	return mips;
+}
+
+void BlockCompression::EncodeBlock(TextureCompression compression, const unsigned char* rgba, unsigned char* block)
+{
+	float pixels[16][4] = {};
+	for (int i = 0; i < 16; ++i)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			pixels[i][c] = rgba[i * 4 + c];
+		}
+	}
+
+	switch (compression)
+	{
+	case TextureCompression::BC1:
+		EncodeColorBlock(pixels, block);
+		break;
+	case TextureCompression::BC3:
+		EncodeSingleChannelBlock(pixels, 3, block);
+		EncodeColorBlock(pixels, block + 8);
+		break;
+	case TextureCompression::BC5:
+		EncodeSingleChannelBlock(pixels, 0, block);
+		EncodeSingleChannelBlock(pixels, 1, block + 8);
+		break;
+	case TextureCompression::BC7:
+		EncodeMode6Block(pixels, block);
+		break;
+	default:
+		break;
+	}
+}
+
+void BlockCompression::DecodeBlock(TextureCompression compression, const unsigned char* block, unsigned char* rgba)
+{
+	switch (compression)
+	{
+	case TextureCompression::BC1:
+		DecodeColorBlock(block, false, rgba);
+		break;
+	case TextureCompression::BC3:
+		DecodeColorBlock(block + 8, true, rgba);
+		DecodeSingleChannelBlock(block, 3, rgba);
+		break;
+	case TextureCompression::BC5:
+		for (int i = 0; i < 16; ++i)
+		{
+			rgba[i * 4 + 2] = 0;
+			rgba[i * 4 + 3] = 255;
+		}
+		DecodeSingleChannelBlock(block, 0, rgba);
+		DecodeSingleChannelBlock(block + 8, 1, rgba);
+		break;
+	case TextureCompression::BC7:
+		DecodeMode6Block(block, rgba);
+		break;
+	default:
+		break;
+	}
+}
+
+void BlockCompression::Encode(TextureCompression compression, const unsigned char* rgba, int width, int height, unsigned char* blocks)
+{
+	size_t blockSize = BlockCompression::GetBlockSize(compression);
+	unsigned char blockPixels[64] = {};
+
+	for (int by = 0; by < height; by += 4)
+	{
+		for (int bx = 0; bx < width; bx += 4)
+		{
+			// Repeat the edge pixels for blocks that hang over the image
+			for (int y = 0; y < 4; ++y)
+			{
+				int sy = std::min(by + y, height - 1);
+				for (int x = 0; x < 4; ++x)
+				{
+					int sx = std::min(bx + x, width - 1);
+					std::memcpy(blockPixels + (y * 4 + x) * 4, rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+				}
+			}
+
+			BlockCompression::EncodeBlock(compression, blockPixels, blocks);
+			blocks += blockSize;
+		}
+	}
+}
+
+void BlockCompression::Decode(TextureCompression compression, const unsigned char* blocks, int width, int height, unsigned char* rgba)
+{
+	size_t blockSize = BlockCompression::GetBlockSize(compression);
+	unsigned char blockPixels[64] = {};
+
+	for (int by = 0; by < height; by += 4)
+	{
+		for (int bx = 0; bx < width; bx += 4)
+		{
+			BlockCompression::DecodeBlock(compression, blocks, blockPixels);
+			blocks += blockSize;
+
+			for (int y = 0; y < 4 && by + y < height; ++y)
+			{
+				for (int x = 0; x < 4 && bx + x < width; ++x)
+				{
+					std::memcpy(rgba + (static_cast<size_t>(by + y) * width + bx + x) * 4, blockPixels + (y * 4 + x) * 4, 4);
+				}
+			}
+		}
+	}
+}
+
+void BlockCompression::Downsample(const unsigned char* rgba, int width, int height, unsigned char* smaller)
+{
+	int smallerWidth = std::max(1, width / 2);
+	int smallerHeight = std::max(1, height / 2);
+
+	for (int y = 0; y < smallerHeight; ++y)
+	{
+		int y0 = std::min(y * 2, height - 1);
+		int y1 = std::min(y * 2 + 1, height - 1);
+		for (int x = 0; x < smallerWidth; ++x)
+		{
+			int x0 = std::min(x * 2, width - 1);
+			int x1 = std::min(x * 2 + 1, width - 1);
+			for (int c = 0; c < 4; ++c)
+			{
+				int sum = rgba[(static_cast<size_t>(y0) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y0) * width + x1) * 4 + c] +
+					rgba[(static_cast<size_t>(y1) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+				smaller[(static_cast<size_t>(y) * smallerWidth + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+std::vector<unsigned char> BlockCompression::ToRGBA(const unsigned char* pixels, int width, int height, int numChannels)
+{
+	size_t numPixels = static_cast<size_t>(width) * height;
+	std::vector<unsigned char> rgba(numPixels * 4);
+
+	for (size_t i = 0; i < numPixels; ++i)
+	{
+		const unsigned char* pixel = pixels + i * numChannels;
+		unsigned char* out = rgba.data() + i * 4;
+		switch (numChannels)
+		{
+		case 1:
+			out[0] = out[1] = out[2] = pixel[0];
+			out[3] = 255;
+			break;
+		case 2:
+			out[0] = pixel[0];
+			out[1] = pixel[1];
+			out[2] = 0;
+			out[3] = 255;
+			break;
+		case 3:
+			out[0] = pixel[0];
+			out[1] = pixel[1];
+			out[2] = pixel[2];
+			out[3] = 255;
+			break;
+		default:
+			std::memcpy(out, pixel, 4);
+			break;
+		}
+	}
+
+	return rgba;
+}
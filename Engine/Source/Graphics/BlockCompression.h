@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Enum class for how a texture's pixels are stored
+enum class TextureCompression
+{
+	None = 0,	// Uncompressed 8 bit channels
+	BC1 = 1,	// 8 bytes per 4x4 block: RGB with two 565 endpoints and 2 bit indices
+	BC3 = 2,	// 16 bytes per 4x4 block: BC1 color plus a BC4 alpha block
+	BC5 = 3,	// 16 bytes per 4x4 block: two BC4 blocks for red and green (used for normal maps)
+	BC7 = 4		// 16 bytes per 4x4 block: RGBA with high quality endpoints (encoded with mode 6)
+};
+
+// Struct for a mip level inside a block of compressed data
+struct TextureMip
+{
+	size_t offset;	// offset of the level's blocks in bytes
+	size_t size;	// size of the level's blocks in bytes
+	int width;		// width in pixels
+	int height;		// height in pixels
+};
+
+// BlockCompression encodes RGBA8 images into the BCn block formats GPUs sample directly, and decodes them
+// back for measuring quality. Images are split into 4x4 blocks, with edge pixels repeated to fill blocks
+// that hang over the image. Doesn't use OpenGL, so the cooker can run it on worker threads.
+namespace BlockCompression
+{
+	// Gets the number of bytes in a block
+	// @param - TextureCompression for the format
+	// @return - size_t for the number of bytes (0 for TextureCompression::None)
+	size_t GetBlockSize(TextureCompression compression);
+
+	// Gets the number of bytes an image takes when compressed
+	// @param - TextureCompression for the format
+	// @param - int for the width in pixels
+	// @param - int for the height in pixels
+	// @return - size_t for the number of bytes
+	size_t GetCompressedSize(TextureCompression compression, int width, int height);
+
+	// Gets the mip levels of an image from full size down to 1x1, laid out one after another
+	// @param - TextureCompression for the format
+	// @param - int for the width in pixels
+	// @param - int for the height in pixels
+	// @return - std::vector<TextureMip> for the levels
+	std::vector<TextureMip> GetMipChain(TextureCompression compression, int width, int height);
+
+	// Encodes one 4x4 block
+	// @param - TextureCompression for the format
+	// @param - const unsigned char* for 16 RGBA8 pixels in rows
+	// @param - unsigned char* for the block
+	void EncodeBlock(TextureCompression compression, const unsigned char* rgba, unsigned char* block);
+
+	// Decodes one 4x4 block
+	// @param - TextureCompression for the format
+	// @param - const unsigned char* for the block
+	// @param - unsigned char* for 16 RGBA8 pixels in rows
+	void DecodeBlock(TextureCompression compression, const unsigned char* block, unsigned char* rgba);
+
+	// Encodes an RGBA8 image
+	// @param - TextureCompression for the format
+	// @param - const unsigned char* for the pixels
+	// @param - int for the width in pixels
+	// @param - int for the height in pixels
+	// @param - unsigned char* for the blocks (GetCompressedSize() bytes)
+	void Encode(TextureCompression compression, const unsigned char* rgba, int width, int height, unsigned char* blocks);
+
+	// Decodes an image into RGBA8
+	// @param - TextureCompression for the format
+	// @param - const unsigned char* for the blocks
+	// @param - int for the width in pixels
+	// @param - int for the height in pixels
+	// @param - unsigned char* for the pixels (width * height * 4 bytes)
+	void Decode(TextureCompression compression, const unsigned char* blocks, int width, int height, unsigned char* rgba);
+
+	// Halves an RGBA8 image with a 2x2 box filter (a side that's already 1 pixel stays 1 pixel)
+	// @param - const unsigned char* for the pixels
+	// @param - int for the width in pixels
+	// @param - int for the height in pixels
+	// @param - unsigned char* for the smaller image's pixels
+	void Downsample(const unsigned char* rgba, int width, int height, unsigned char* smaller);
+
+	// Converts pixels with 1 to 4 channels into RGBA8 (1 channel is gray, 2 channels is red and green)
+	// @param - const unsigned char* for the pixels
+	// @param - int for the width in pixels
+	// @param - int for the height in pixels
+	// @param - int for the number of channels
+	// @return - std::vector<unsigned char> for the RGBA8 pixels
+	std::vector<unsigned char> ToRGBA(const unsigned char* pixels, int width, int height, int numChannels);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <algorithm>
+#include <glm/glm.hpp>
+
+// Axis aligned bounding box, typically stored in a mesh or model's local space
+struct BoundingBox
+{
+	glm::vec3 min; // smallest corner of the box
+	glm::vec3 max; // largest corner of the box
+};
+
+// Bounding sphere used for cheap visibility/culling tests
+struct BoundingSphere
+{
+	glm::vec3 center; // center of the sphere
+	float radius;	  // radius of the sphere
+};
+
+// Grows a bounding box so that it also contains another box
+// @param - BoundingBox& for the box to grow
+// @param - const BoundingBox& for the box to include
+inline void ExpandBoundingBox(BoundingBox& box, const BoundingBox& other)
+{
+	box.min = glm::min(box.min, other.min);
+	box.max = glm::max(box.max, other.max);
+}
+
+// Transforms a local space bounding box by a model matrix and returns a world space sphere that encloses it.
+// The radius is scaled by the largest axis scale of the matrix so the sphere stays conservative.
+// @param - const BoundingBox& for the local space box
+// @param - const glm::mat4& for the model matrix
+// @return - BoundingSphere for the world space sphere
+inline BoundingSphere GetWorldBoundingSphere(const BoundingBox& box, const glm::mat4& model)
+{
+	glm::vec3 localCenter = (box.min + box.max) * 0.5f;
+	float localRadius = glm::length(box.max - localCenter);
+
+	float scaleX = glm::length(glm::vec3(model[0]));
+	float scaleY = glm::length(glm::vec3(model[1]));
+	float scaleZ = glm::length(glm::vec3(model[2]));
+
+	BoundingSphere sphere = {};
+	sphere.center = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+	sphere.radius = localRadius * std::max(scaleX, std::max(scaleY, scaleZ));
+
+	return sphere;
+}
@@ -0,0 +1,206 @@
+#include "BufferRing.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <glad/glad.h>
+#include "../Util/Logger.h"
+
+BufferRing::BufferRing(size_t frameSize, int numFrames, BufferRingTarget target) :
+	mFences(),
+	mOverflowBuffers(),
+	mMappedData(nullptr),
+	mBufferID(0),
+	mTarget(target == BufferRingTarget::Uniform ? GL_UNIFORM_BUFFER : GL_SHADER_STORAGE_BUFFER),
+	mFrameSize(0),
+	mAlignment(256),
+	mOffset(0),
+	mFrameUsedSize(0),
+	mFrameCount(0),
+	mNumFrames(numFrames > 0 ? numFrames : 1),
+	mFrameIndex(0)
+{
+	int alignment = 0;
+	glGetIntegerv(target == BufferRingTarget::Uniform ? GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT : GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	if (alignment > 0)
+	{
+		mAlignment = static_cast<size_t>(alignment);
+	}
+
+	// Keep every region's start aligned
+	mFrameSize = (frameSize + mAlignment - 1) / mAlignment * mAlignment;
+
+	CreateBuffer();
+}
+
+BufferRing::~BufferRing()
+{
+	std::cout << "Delete buffer ring\n";
+
+	DeleteBuffer();
+
+	if (!mOverflowBuffers.empty())
+	{
+		glDeleteBuffers(static_cast<GLsizei>(mOverflowBuffers.size()), mOverflowBuffers.data());
+	}
+}
+
+void BufferRing::CreateBuffer()
+{
+	mFences.assign(mNumFrames, nullptr);
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	GLsizeiptr totalSize = static_cast<GLsizeiptr>(mFrameSize * mNumFrames);
+
+	glGenBuffers(1, &mBufferID);
+	glBindBuffer(mTarget, mBufferID);
+	// Immutable storage that stays mapped for the buffer's lifetime
+	glBufferStorage(mTarget, totalSize, NULL, flags);
+	mMappedData = static_cast<unsigned char*>(glMapBufferRange(mTarget, 0, totalSize, flags));
+	glBindBuffer(mTarget, 0);
+
+	if (!mMappedData)
+	{
+		LOG_ERROR("Failed to map buffer ring");
+	}
+}
+
+void BufferRing::DeleteBuffer()
+{
+	for (void* fence : mFences)
+	{
+		if (fence)
+		{
+			glDeleteSync(static_cast<GLsync>(fence));
+		}
+	}
+	mFences.clear();
+
+	glBindBuffer(mTarget, mBufferID);
+	glUnmapBuffer(mTarget);
+	glBindBuffer(mTarget, 0);
+
+	glDeleteBuffers(1, &mBufferID);
+	mBufferID = 0;
+	mMappedData = nullptr;
+}
+
+BufferRingAllocation BufferRing::Allocate(const void* data, size_t size)
+{
+	mFrameUsedSize += (size + mAlignment - 1) / mAlignment * mAlignment;
+
+	if (!mMappedData || mOffset + size > mFrameSize)
+	{
+		// Out of space this frame. Everything already in the region is still in use, so the data gets its own buffer.
+		return AllocateOverflow(data, size);
+	}
+
+	BufferRingAllocation allocation = {};
+	allocation.buffer = mBufferID;
+	allocation.offset = static_cast<size_t>(mFrameIndex) * mFrameSize + mOffset;
+	allocation.size = size;
+
+	std::memcpy(mMappedData + allocation.offset, data, size);
+
+	mOffset = (mOffset + size + mAlignment - 1) / mAlignment * mAlignment;
+
+	return allocation;
+}
+
+BufferRingAllocation BufferRing::AllocateOverflow(const void* data, size_t size)
+{
+	if (mOverflowBuffers.empty())
+	{
+		LOG_WARNING("Buffer ring is full, growing it at the end of the frame");
+	}
+
+	BufferRingAllocation allocation = {};
+	glCreateBuffers(1, &allocation.buffer);
+	glNamedBufferStorage(allocation.buffer, static_cast<GLsizeiptr>(size), data, 0);
+	allocation.offset = 0;
+	allocation.size = size;
+
+	mOverflowBuffers.emplace_back(allocation.buffer);
+
+	return allocation;
+}
+
+BufferRingAllocation BufferRing::AllocateAndBind(const void* data, size_t size, unsigned int bindingPoint)
+{
+	BufferRingAllocation allocation = Allocate(data, size);
+
+	Bind(allocation, bindingPoint);
+
+	return allocation;
+}
+
+void BufferRing::Bind(const BufferRingAllocation& allocation, unsigned int bindingPoint) const
+{
+	if (allocation.size > 0)
+	{
+		glBindBufferRange(mTarget, bindingPoint, allocation.buffer, allocation.offset, allocation.size);
+	}
+}
+
+void BufferRing::NextFrame()
+{
+	// Fence everything submitted so far that reads from this frame's region
+	if (mFences[mFrameIndex])
+	{
+		glDeleteSync(static_cast<GLsync>(mFences[mFrameIndex]));
+	}
+	mFences[mFrameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	// OpenGL keeps deleted buffers alive until the draws that read them are done
+	if (!mOverflowBuffers.empty())
+	{
+		glDeleteBuffers(static_cast<GLsizei>(mOverflowBuffers.size()), mOverflowBuffers.data());
+		mOverflowBuffers.clear();
+	}
+
+	// Grow the ring so a frame like this one fits next time. Every region has to be done first since the whole buffer is replaced.
+	if (mFrameUsedSize > mFrameSize)
+	{
+		for (int frame = 0; frame < mNumFrames; ++frame)
+		{
+			WaitForFrame(frame);
+		}
+		DeleteBuffer();
+
+		size_t newFrameSize = mFrameUsedSize + mFrameUsedSize / 2;
+		mFrameSize = (newFrameSize + mAlignment - 1) / mAlignment * mAlignment;
+		CreateBuffer();
+
+		LOG_DEBUG("Grew buffer ring to " + std::to_string(mFrameSize) + " bytes per frame");
+	}
+
+	mFrameIndex = (mFrameIndex + 1) % mNumFrames;
+	mOffset = 0;
+	mFrameUsedSize = 0;
+	++mFrameCount;
+
+	WaitForFrame(mFrameIndex);
+}
+
+void BufferRing::WaitForFrame(int frame)
+{
+	GLsync fence = static_cast<GLsync>(mFences[frame]);
+	if (!fence)
+	{
+		return;
+	}
+
+	// Flush on the first wait so the fence is guaranteed to signal
+	GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	while (true)
+	{
+		GLenum result = glClientWaitSync(fence, waitFlags, 1000000);
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+		{
+			break;
+		}
+		waitFlags = 0;
+	}
+
+	glDeleteSync(fence);
+	mFences[frame] = nullptr;
+}
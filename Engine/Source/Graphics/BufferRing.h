@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Enum class for the kind of buffer a BufferRing binds its allocations to
+enum class BufferRingTarget
+{
+	Uniform,	// binds ranges to uniform block binding points
+	Storage,	// binds ranges to shader storage block binding points
+};
+
+// Struct for a range of a BufferRing that was written this frame
+struct BufferRingAllocation
+{
+	unsigned int buffer;	// buffer the data was written to (the ring, or an overflow buffer)
+	size_t offset;			// offset from the start of the buffer
+	size_t size;			// size of the written data
+};
+
+// BufferRing is a persistently mapped buffer split into one region per frame in flight. Small
+// per draw data (material colors, bone palettes) is copied straight into the current frame's region
+// and bound by offset, instead of calling glBufferSubData on a shared buffer for every draw. Each
+// region is fenced when its frame ends, and is only written again once the GPU is done reading it.
+// Allocations that don't fit in the current frame's region get their own buffer for that frame, and the
+// ring grows to fit the largest frame at the next NextFrame(), so nothing handed out this frame is overwritten.
+class BufferRing
+{
+public:
+	// BufferRing constructor:
+	// Creates and persistently maps a buffer with a region for each frame in flight
+	// @param - size_t for the size of each frame's region
+	// @param - int for the number of frames in flight (3 for triple buffering)
+	// @param - BufferRingTarget for if allocations are bound as uniform or storage blocks
+	BufferRing(size_t frameSize, int numFrames = 3, BufferRingTarget target = BufferRingTarget::Uniform);
+	~BufferRing();
+
+	// Copies data into the current frame's region, aligned for binding by offset
+	// @param - const void* for the data
+	// @param - size_t for the size of the data in bytes
+	// @return - BufferRingAllocation for where the data was written
+	BufferRingAllocation Allocate(const void* data, size_t size);
+
+	// Copies data into the current frame's region and binds it to a binding point
+	// @param - const void* for the data
+	// @param - size_t for the size of the data in bytes
+	// @param - unsigned int for the binding point
+	// @return - BufferRingAllocation for where the data was written
+	BufferRingAllocation AllocateAndBind(const void* data, size_t size, unsigned int bindingPoint);
+
+	// Binds an allocation from this frame to a binding point
+	// @param - const BufferRingAllocation& for the allocation
+	// @param - unsigned int for the binding point
+	void Bind(const BufferRingAllocation& allocation, unsigned int bindingPoint) const;
+
+	// Fences the current frame's region, then moves to the next region and
+	// waits until the GPU has finished with it. If the frame overflowed, the ring is grown first.
+	// Call once at the end of every frame.
+	void NextFrame();
+
+	// Gets the number of frames this ring has gone through, used to tell if an allocation is still from this frame
+	// @return - unsigned long long for the frame count
+	unsigned long long GetFrameCount() const { return mFrameCount; }
+
+	// Gets the number of bytes written to the current frame's region
+	// @return - size_t for the bytes used
+	size_t GetUsedSize() const { return mOffset; }
+
+	// Gets the size of each frame's region
+	// @return - size_t for the number of bytes
+	size_t GetFrameSize() const { return mFrameSize; }
+
+private:
+	// Creates and persistently maps a buffer with a region of mFrameSize for each frame in flight
+	void CreateBuffer();
+
+	// Unmaps and deletes the buffer and its fences
+	void DeleteBuffer();
+
+	// Copies data into a new buffer of its own, for an allocation that doesn't fit in the current frame's region
+	// @param - const void* for the data
+	// @param - size_t for the size of the data in bytes
+	// @return - BufferRingAllocation for where the data was written
+	BufferRingAllocation AllocateOverflow(const void* data, size_t size);
+
+	// Waits until the GPU is done with a frame's region
+	// @param - int for the frame's index
+	void WaitForFrame(int frame);
+
+	// Fences for each frame's region (GLsync)
+	std::vector<void*> mFences;
+
+	// Buffers made this frame for allocations that didn't fit in the ring
+	std::vector<unsigned int> mOverflowBuffers;
+
+	// Start of the mapped buffer
+	unsigned char* mMappedData;
+
+	// ID reference for the buffer
+	unsigned int mBufferID;
+
+	// OpenGL buffer target (GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER)
+	unsigned int mTarget;
+
+	// Size of each frame's region
+	size_t mFrameSize;
+
+	// Alignment required for offsets when binding ranges
+	size_t mAlignment;
+
+	// Write offset within the current frame's region
+	size_t mOffset;
+
+	// Bytes this frame needed, including what overflowed
+	size_t mFrameUsedSize;
+
+	// Number of frames that have gone by
+	unsigned long long mFrameCount;
+
+	// Number of frames in flight
+	int mNumFrames;
+
+	// Index of the current frame's region
+	int mFrameIndex;
+};
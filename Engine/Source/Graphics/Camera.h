@@ -98,6 +98,10 @@ public:
 	// @return - float for the camera's fov
 	float GetFOV() const { return mFOV; }
 
+	// Gets the camera's aspect ratio
+	// @return - float for the aspect ratio
+	float GetAspectRatio() const { return mAspectRatio; }
+
 	// Gets the camera's near plane
 	// @return - float for the near plane
 	float GetNearPlane() const {return mNearPlane; }
@@ -0,0 +1,412 @@
+#include "CookedModel.h"
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../Animation/Animation.h"
+#include "../Animation/Skeleton.h"
+#include "../MemoryManager/DerivedDataCache.h"
+#include "../Util/Logger.h"
+
+// Appends cooked data to a buffer, keeping every section 4 byte aligned
+class CookedWriter
+{
+public:
+	// Appends raw bytes, then pads to 4 bytes
+	// @param - const void* for the bytes
+	// @param - size_t for the number of bytes
+	void WriteBytes(const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		mBuffer.insert(mBuffer.end(), bytes, bytes + size);
+		mBuffer.resize((mBuffer.size() + 3) & ~static_cast<size_t>(3), 0);
+	}
+
+	// Appends a plain value
+	// @param - const T& for the value
+	template <typename T>
+	void Write(const T& value)
+	{
+		WriteBytes(&value, sizeof(T));
+	}
+
+	// Appends a string as its length followed by its characters
+	// @param - const std::string& for the string
+	void WriteString(const std::string& str)
+	{
+		Write(static_cast<uint32_t>(str.size()));
+		WriteBytes(str.data(), str.size());
+	}
+
+	// Gets the written bytes
+	// @return - const std::vector<unsigned char>& for the buffer
+	const std::vector<unsigned char>& GetBuffer() const { return mBuffer; }
+
+private:
+	// Bytes written so far
+	std::vector<unsigned char> mBuffer;
+};
+
+// Reads cooked data in place, failing instead of reading past the end
+class CookedReader
+{
+public:
+	CookedReader(const unsigned char* data, size_t size) :
+		mData(data),
+		mSize(size),
+		mOffset(0)
+	{}
+
+	// Skips over raw bytes and the padding after them
+	// @param - size_t for the number of bytes
+	// @return - const unsigned char* for the first byte (nullptr if the data is too short)
+	const unsigned char* ReadBytes(size_t size)
+	{
+		size_t padded = (size + 3) & ~static_cast<size_t>(3);
+		if (padded < size || padded > mSize - mOffset)
+		{
+			return nullptr;
+		}
+
+		const unsigned char* bytes = mData + mOffset;
+		mOffset += padded;
+		return bytes;
+	}
+
+	// Reads a plain value
+	// @param - T& for the value
+	// @return - bool for if it was read
+	template <typename T>
+	bool Read(T& value)
+	{
+		const unsigned char* bytes = ReadBytes(sizeof(T));
+		if (!bytes)
+		{
+			return false;
+		}
+		std::memcpy(&value, bytes, sizeof(T));
+		return true;
+	}
+
+	// Reads a string written as its length followed by its characters
+	// @param - std::string& for the string
+	// @return - bool for if it was read
+	bool ReadString(std::string& str)
+	{
+		uint32_t length = 0;
+		if (!Read(length))
+		{
+			return false;
+		}
+		const unsigned char* bytes = ReadBytes(length);
+		if (!bytes)
+		{
+			return false;
+		}
+		str.assign(reinterpret_cast<const char*>(bytes), length);
+		return true;
+	}
+
+	// Reads an array of plain values into a vector
+	// @param - std::vector<T>& for the values
+	// @param - uint32_t for the number of values
+	// @return - bool for if they were read
+	template <typename T>
+	bool ReadArray(std::vector<T>& values, uint32_t count)
+	{
+		const unsigned char* bytes = ReadBytes(sizeof(T) * count);
+		if (!bytes)
+		{
+			return false;
+		}
+		values.resize(count);
+		std::memcpy(values.data(), bytes, sizeof(T) * count);
+		return true;
+	}
+
+private:
+	// Start of the data
+	const unsigned char* mData;
+
+	// Size of the data in bytes
+	size_t mSize;
+
+	// Offset of the next read
+	size_t mOffset;
+};
+
+// Gets the derived data cache key of the entry holding a model file's last cooked source hash
+// @param - const std::string& for the model's file name
+// @return - std::string for the key
+static std::string GetSourceHashKey(const std::string& fileName)
+{
+	return DerivedDataCache::MakeKey("modelsource", DerivedDataCache::HashBytes(fileName.data(), fileName.size()));
+}
+
+std::string CookedModel::GetCacheKey(uint64_t sourceHash)
+{
+	uint64_t hash = DerivedDataCache::CombineHash(sourceHash, COOKED_MODEL_VERSION);
+	hash = DerivedDataCache::CombineHash(hash, sizeof(Vertex));
+	hash = DerivedDataCache::CombineHash(hash, sizeof(VertexAnim));
+	hash = DerivedDataCache::CombineHash(hash, MODEL_IMPORT_FLAGS);
+	return DerivedDataCache::MakeKey("model", hash);
+}
+
+bool CookedModel::Save(const ModelLoader::ImportedModel* imported, uint64_t sourceHash)
+{
+	const Skeleton* skeleton = imported->skeleton;
+
+	CookedModelHeader header = {};
+	header.magic = COOKED_MODEL_MAGIC;
+	header.version = COOKED_MODEL_VERSION;
+	header.vertexSize = sizeof(Vertex);
+	header.vertexAnimSize = sizeof(VertexAnim);
+	header.sourceHash = sourceHash;
+	header.importFlags = MODEL_IMPORT_FLAGS;
+	header.hasAnimations = skeleton ? 1 : 0;
+	header.numMeshes = static_cast<uint32_t>(imported->meshes.size());
+	header.numMeshOrder = static_cast<uint32_t>(imported->meshOrder.size());
+	header.numMaterials = static_cast<uint32_t>(imported->materials.size());
+	header.numTextures = static_cast<uint32_t>(imported->textures.size());
+	header.numBones = skeleton ? static_cast<uint32_t>(skeleton->GetBones().size()) : 0;
+	header.numAnimations = static_cast<uint32_t>(imported->animations.size());
+
+	CookedWriter writer;
+	writer.Write(header);
+
+	for (const ModelLoader::ImportedTexture& texture : imported->textures)
+	{
+		writer.WriteString(texture.fileName);
+		writer.Write(static_cast<uint32_t>(texture.type));
+	}
+
+	for (const ModelLoader::ImportedMaterial& material : imported->materials)
+	{
+		writer.WriteString(material.name);
+		writer.Write(static_cast<uint32_t>(material.textures.size()));
+		writer.WriteBytes(material.textures.data(), sizeof(unsigned int) * material.textures.size());
+	}
+
+	size_t vertexSize = skeleton ? sizeof(VertexAnim) : sizeof(Vertex);
+	for (const ModelLoader::ImportedMesh& mesh : imported->meshes)
+	{
+		writer.WriteString(mesh.name);
+		writer.Write(static_cast<uint32_t>(mesh.materialIndex));
+		writer.Write(mesh.bounds.min);
+		writer.Write(mesh.bounds.max);
+		writer.Write(static_cast<uint32_t>(mesh.numVertices));
+		writer.Write(static_cast<uint32_t>(mesh.numIndices));
+		writer.WriteBytes(mesh.vertexData, vertexSize * mesh.numVertices);
+		writer.WriteBytes(mesh.indexData, sizeof(unsigned int) * mesh.numIndices);
+	}
+
+	writer.WriteBytes(imported->meshOrder.data(), sizeof(unsigned int) * imported->meshOrder.size());
+
+	if (skeleton)
+	{
+		writer.Write(skeleton->GetRootInverseTransform());
+		for (const Bone& bone : skeleton->GetBones())
+		{
+			writer.WriteString(bone.name);
+			writer.Write(bone.localTransform);
+			writer.Write(bone.offsetMatrix);
+			writer.Write(static_cast<int32_t>(bone.id));
+			writer.Write(static_cast<int32_t>(bone.parentID));
+			writer.Write(static_cast<uint32_t>(bone.influenceMesh ? 1 : 0));
+		}
+	}
+
+	for (const Animation* anim : imported->animations)
+	{
+		writer.WriteString(anim->GetName());
+		writer.Write(anim->GetDuration());
+		writer.Write(anim->GetTicksPerSecond());
+		writer.Write(static_cast<uint32_t>(anim->GetTracks().size()));
+		for (const auto& track : anim->GetTracks())
+		{
+			writer.Write(static_cast<int32_t>(track.first));
+			writer.Write(static_cast<uint32_t>(track.second.positions.size()));
+			writer.Write(static_cast<uint32_t>(track.second.rotations.size()));
+			writer.Write(static_cast<uint32_t>(track.second.scalings.size()));
+			writer.WriteBytes(track.second.positions.data(), sizeof(KeyPosition) * track.second.positions.size());
+			writer.WriteBytes(track.second.rotations.data(), sizeof(KeyRotation) * track.second.rotations.size());
+			writer.WriteBytes(track.second.scalings.data(), sizeof(KeyScale) * track.second.scalings.size());
+		}
+	}
+
+	std::string key = CookedModel::GetCacheKey(sourceHash);
+	const std::vector<unsigned char>& buffer = writer.GetBuffer();
+	if (!DerivedDataCache::Get()->Save(key, buffer.data(), buffer.size()))
+	{
+		return false;
+	}
+
+	// Only remembered once the cooked file is written, so it always points at a cooked file
+	DerivedDataCache::Get()->Save(GetSourceHashKey(imported->fileName), &sourceHash, sizeof(sourceHash));
+
+	LOG_DEBUG("Cooked model: " + imported->fileName + " to " + key + " (" + std::to_string(buffer.size()) + " bytes)");
+	return true;
+}
+
+ModelLoader::ImportedModel* CookedModel::Load(const std::string& fileName, uint64_t sourceHash)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::string key = CookedModel::GetCacheKey(sourceHash);
+	MappedFile file;
+	if (!DerivedDataCache::Get()->Load(key, file))
+	{
+		return nullptr;
+	}
+
+	CookedReader reader(file.GetData(), file.GetSize());
+
+	CookedModelHeader header = {};
+	bool isValid = reader.Read(header) && header.magic == COOKED_MODEL_MAGIC && header.version == COOKED_MODEL_VERSION &&
+		header.vertexSize == sizeof(Vertex) && header.vertexAnimSize == sizeof(VertexAnim) && header.sourceHash == sourceHash && header.importFlags == MODEL_IMPORT_FLAGS;
+	if (!isValid)
+	{
+		LOG_WARNING("Cooked model doesn't match its key, recooking: " + key);
+		file.Close();
+		DerivedDataCache::Get()->Remove(key);
+		return nullptr;
+	}
+
+	ModelLoader::ImportedModel* imported = new ModelLoader::ImportedModel();
+	imported->fileName = fileName;
+	imported->skeleton = nullptr;
+
+	imported->textures.resize(header.numTextures);
+	for (ModelLoader::ImportedTexture& texture : imported->textures)
+	{
+		uint32_t type = 0;
+		isValid = isValid && reader.ReadString(texture.fileName) && reader.Read(type);
+		texture.type = static_cast<TextureType>(type);
+	}
+
+	imported->materials.resize(header.numMaterials);
+	for (ModelLoader::ImportedMaterial& material : imported->materials)
+	{
+		uint32_t numTextures = 0;
+		isValid = isValid && reader.ReadString(material.name) && reader.Read(numTextures) && reader.ReadArray(material.textures, numTextures);
+		for (unsigned int textureIndex : material.textures)
+		{
+			isValid = isValid && textureIndex < header.numTextures;
+		}
+	}
+
+	// Meshes point straight into the mapped file
+	size_t vertexSize = header.hasAnimations ? sizeof(VertexAnim) : sizeof(Vertex);
+	imported->meshes.resize(header.numMeshes);
+	for (ModelLoader::ImportedMesh& mesh : imported->meshes)
+	{
+		uint32_t materialIndex = 0;
+		uint32_t numVertices = 0;
+		uint32_t numIndices = 0;
+		isValid = isValid && reader.ReadString(mesh.name) && reader.Read(materialIndex) && reader.Read(mesh.bounds.min) && reader.Read(mesh.bounds.max) &&
+			reader.Read(numVertices) && reader.Read(numIndices);
+		if (!isValid)
+		{
+			break;
+		}
+
+		mesh.materialIndex = materialIndex;
+		mesh.numVertices = numVertices;
+		mesh.numIndices = numIndices;
+		mesh.vertexData = reader.ReadBytes(vertexSize * numVertices);
+		mesh.indexData = reinterpret_cast<const unsigned int*>(reader.ReadBytes(sizeof(unsigned int) * numIndices));
+		isValid = mesh.vertexData && mesh.indexData;
+	}
+
+	isValid = isValid && reader.ReadArray(imported->meshOrder, header.numMeshOrder);
+	for (unsigned int meshIndex : imported->meshOrder)
+	{
+		isValid = isValid && meshIndex < header.numMeshes;
+	}
+
+	if (isValid && header.hasAnimations)
+	{
+		glm::mat4 rootInverseTransform(1.0f);
+		std::vector<Bone> bones(header.numBones);
+		isValid = reader.Read(rootInverseTransform);
+		for (Bone& bone : bones)
+		{
+			int32_t id = 0;
+			int32_t parentID = 0;
+			uint32_t influenceMesh = 0;
+			isValid = isValid && reader.ReadString(bone.name) && reader.Read(bone.localTransform) && reader.Read(bone.offsetMatrix) &&
+				reader.Read(id) && reader.Read(parentID) && reader.Read(influenceMesh);
+			bone.id = id;
+			bone.parentID = parentID;
+			bone.influenceMesh = influenceMesh != 0;
+		}
+
+		if (isValid)
+		{
+			imported->skeleton = new Skeleton(bones, rootInverseTransform, fileName);
+		}
+
+		for (uint32_t i = 0; isValid && i < header.numAnimations; ++i)
+		{
+			std::string animName;
+			float duration = 0.0f;
+			float ticksPerSecond = 0.0f;
+			uint32_t numTracks = 0;
+			isValid = reader.ReadString(animName) && reader.Read(duration) && reader.Read(ticksPerSecond) && reader.Read(numTracks);
+
+			std::unordered_map<int, AnimationTrack> tracks;
+			for (uint32_t t = 0; isValid && t < numTracks; ++t)
+			{
+				int32_t boneID = 0;
+				uint32_t numPositions = 0;
+				uint32_t numRotations = 0;
+				uint32_t numScalings = 0;
+				AnimationTrack track;
+				isValid = reader.Read(boneID) && reader.Read(numPositions) && reader.Read(numRotations) && reader.Read(numScalings) &&
+					reader.ReadArray(track.positions, numPositions) && reader.ReadArray(track.rotations, numRotations) && reader.ReadArray(track.scalings, numScalings);
+				tracks[boneID] = std::move(track);
+			}
+
+			if (isValid)
+			{
+				imported->animations.emplace_back(new Animation(std::move(tracks), duration, ticksPerSecond, imported->skeleton, animName));
+			}
+		}
+	}
+
+	if (!isValid)
+	{
+		LOG_WARNING("Cooked model is corrupt, recooking: " + key);
+		delete imported;
+		file.Close();
+		DerivedDataCache::Get()->Remove(key);
+		return nullptr;
+	}
+
+	imported->cookedFile = std::move(file);
+
+	auto end = std::chrono::high_resolution_clock::now();
+	LOG_DEBUG("Loaded cooked model: " + fileName + " in " + std::to_string(std::chrono::duration<double, std::milli>(end - start).count()) + " ms");
+
+	return imported;
+}
+
+bool CookedModel::FindSourceHash(const std::string& fileName, uint64_t& sourceHash)
+{
+	std::string key = GetSourceHashKey(fileName);
+	MappedFile file;
+	if (!DerivedDataCache::Get()->Load(key, file))
+	{
+		return false;
+	}
+
+	if (file.GetSize() != sizeof(sourceHash))
+	{
+		DerivedDataCache::Get()->Remove(key);
+		return false;
+	}
+
+	std::memcpy(&sourceHash, file.GetData(), sizeof(sourceHash));
+	return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "ModelLoader.h"
+
+// Bytes at the start of every cooked model file ("GECM")
+const uint32_t COOKED_MODEL_MAGIC = 0x4D434547;
+
+// Version of the cooked model format. Bump this whenever the layout changes so old files get recooked.
+const uint32_t COOKED_MODEL_VERSION = 2;
+
+// Header at the start of a cooked model file
+struct CookedModelHeader
+{
+	uint32_t magic;				// COOKED_MODEL_MAGIC
+	uint32_t version;			// COOKED_MODEL_VERSION
+	uint32_t vertexSize;		// sizeof(Vertex) when the file was cooked
+	uint32_t vertexAnimSize;	// sizeof(VertexAnim) when the file was cooked
+	uint64_t sourceHash;		// hash of the source model file's contents
+	uint32_t importFlags;		// Assimp flags the model was read with
+	uint32_t hasAnimations;		// 1 if the model has a skeleton and animations
+	uint32_t numMeshes;			// number of meshes
+	uint32_t numMeshOrder;		// number of meshes the nodes reference
+	uint32_t numMaterials;		// number of materials
+	uint32_t numTextures;		// number of textures
+	uint32_t numBones;			// number of bones in the skeleton
+	uint32_t numAnimations;		// number of animations
+};
+
+// CookedModel reads and writes the engine's binary model format. A cooked file holds everything
+// ModelLoader::ImportScene() produces: meshes, materials, texture file names, the skeleton, and animations.
+// Every section is 4 byte aligned, and each mesh's vertices and indices are stored exactly the way
+// the vertex and index buffers expect them, so a loaded mesh just points into the memory mapped file.
+// Cooked files are kept in the DerivedDataCache, keyed by the source file's contents and the import settings.
+//
+// Layout after the header:
+//	textures:	name, type
+//	materials:	name, number of textures, texture indices
+//	meshes:		name, material index, bounds, number of vertices, number of indices, vertices, indices
+//	mesh order:	mesh indices
+//	skeleton:	inverse root transform, then each bone's name, local transform, offset, id, parent id, and influence flag
+//	animations:	name, duration, ticks per second, number of tracks, then each track's bone id, key counts, and keys
+// Strings are a 32 bit length followed by the characters, padded to 4 bytes.
+namespace CookedModel
+{
+	// Gets the derived data cache key of a model's cooked file. The key covers the format version,
+	// the vertex layouts, and the Assimp flags, so changing any of them cooks the model again.
+	// @param - uint64_t for the hash of the model file's contents
+	// @return - std::string for the key
+	std::string GetCacheKey(uint64_t sourceHash);
+
+	// Writes a model's cooked file to the derived data cache, and remembers the source hash it was cooked
+	// from under the model's file name so FindSourceHash() can find it without the model file
+	// @param - const ModelLoader::ImportedModel* for a model imported with Assimp
+	// @param - uint64_t for the hash of the model file's contents
+	// @return - bool for if the file was written
+	bool Save(const ModelLoader::ImportedModel* imported, uint64_t sourceHash);
+
+	// Maps a model's cooked file from the derived data cache and reads it. Meshes point into the
+	// mapped file, which the imported model keeps open.
+	// @param - const std::string& for the model's file name
+	// @param - uint64_t for the hash of the model file's contents
+	// @return - ModelLoader::ImportedModel* for the imported data (nullptr if it isn't cached or is corrupt)
+	ModelLoader::ImportedModel* Load(const std::string& fileName, uint64_t sourceHash);
+
+	// Gets the hash of the source the model was last cooked from, used when the model file is missing
+	// @param - const std::string& for the model's file name
+	// @param - uint64_t& for the hash of the model file's contents when it was cooked
+	// @return - bool for if the model was cooked before
+	bool FindSourceHash(const std::string& fileName, uint64_t& sourceHash);
+}
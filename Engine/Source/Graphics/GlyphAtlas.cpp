@@ -0,0 +1,123 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <glad/glad.h>
+#include "Texture.h"
+
+GlyphAtlas::GlyphAtlas(int pageSize) :
+	mPages(),
+	mPageSize(pageSize)
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+	std::cout << "Deleted GlyphAtlas\n";
+
+	Clear();
+}
+
+bool GlyphAtlas::Allocate(int width, int height, GlyphRect& outRect)
+{
+	int paddedWidth = width + GLYPH_PADDING;
+	int paddedHeight = height + GLYPH_PADDING;
+
+	if (paddedWidth > mPageSize || paddedHeight > mPageSize)
+	{
+		return false;
+	}
+
+	if (mPages.empty())
+	{
+		AddPage();
+	}
+
+	GlyphPage* page = &mPages.back();
+
+	// Start a new shelf when the glyph doesn't fit on the rest of the current one
+	if (page->shelfX + paddedWidth > mPageSize)
+	{
+		page->shelfX = 0;
+		page->shelfY += page->shelfHeight;
+		page->shelfHeight = 0;
+	}
+
+	// Start a new page when the glyph doesn't fit below the last shelf
+	if (page->shelfY + paddedHeight > mPageSize)
+	{
+		AddPage();
+		page = &mPages.back();
+	}
+
+	outRect.page = static_cast<unsigned int>(mPages.size() - 1);
+	outRect.x = page->shelfX;
+	outRect.y = page->shelfY;
+
+	page->shelfX += paddedWidth;
+	page->shelfHeight = std::max(page->shelfHeight, paddedHeight);
+
+	return true;
+}
+
+void GlyphAtlas::CopyPixels(const GlyphRect& rect, int width, int height, int pitch, const unsigned char* pixels)
+{
+	GlyphPage& page = mPages[rect.page];
+
+	for (int row = 0; row < height; ++row)
+	{
+		std::memcpy(&page.pixels[static_cast<size_t>(rect.y + row) * mPageSize + rect.x], &pixels[static_cast<size_t>(row) * pitch], width);
+	}
+
+	page.dirtyMinY = std::min(page.dirtyMinY, rect.y);
+	page.dirtyMaxY = std::max(page.dirtyMaxY, rect.y + height);
+}
+
+void GlyphAtlas::Upload()
+{
+	// Glyph rows are tightly packed single bytes
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	for (GlyphPage& page : mPages)
+	{
+		if (!page.texture)
+		{
+			page.texture = new Texture(TextureType::Font);
+			page.texture->GenerateTexture(GL_TEXTURE_2D, mPageSize, mPageSize, GL_UNSIGNED_BYTE, page.pixels.data(),
+				false, false, 1, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+		}
+		else if (page.dirtyMinY < page.dirtyMaxY)
+		{
+			page.texture->BindTexture();
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, page.dirtyMinY, mPageSize, page.dirtyMaxY - page.dirtyMinY, GL_RED, GL_UNSIGNED_BYTE,
+				&page.pixels[static_cast<size_t>(page.dirtyMinY) * mPageSize]);
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+
+		page.dirtyMinY = mPageSize;
+		page.dirtyMaxY = 0;
+	}
+
+	// Restore back to 4 byte alignment
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void GlyphAtlas::Clear()
+{
+	for (GlyphPage& page : mPages)
+	{
+		delete page.texture;
+	}
+	mPages.clear();
+}
+
+void GlyphAtlas::AddPage()
+{
+	GlyphPage page = {};
+	page.pixels.resize(static_cast<size_t>(mPageSize) * mPageSize, 0);
+	page.texture = nullptr;
+	page.dirtyMinY = mPageSize;
+	page.dirtyMaxY = 0;
+
+	mPages.emplace_back(std::move(page));
+}
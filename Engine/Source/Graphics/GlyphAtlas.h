@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+class Texture;
+
+// Default width/height of a glyph atlas page
+const int GLYPH_ATLAS_PAGE_SIZE = 512;
+
+// Number of empty pixels kept between glyphs so filtering doesn't bleed into neighbors
+const int GLYPH_PADDING = 1;
+
+// Struct for where a glyph's bitmap lives in the atlas
+struct GlyphRect
+{
+	unsigned int page;	// page the glyph is on
+	int x;				// left pixel of the glyph on the page
+	int y;				// top pixel of the glyph on the page
+};
+
+// GlyphAtlas packs glyph bitmaps into single channel textures (pages) with a shelf packer.
+// Space is allocated and pixels are copied on the CPU, then Upload() sends only the rows of
+// each page that changed to the GPU. New pages are added whenever the current one is full.
+class GlyphAtlas
+{
+public:
+	// GlyphAtlas constructor
+	// @param - int for the width/height of each page
+	GlyphAtlas(int pageSize = GLYPH_ATLAS_PAGE_SIZE);
+	~GlyphAtlas();
+
+	// Finds space for a glyph bitmap, starting a new page if the current page is full
+	// @param - int for the glyph's width
+	// @param - int for the glyph's height
+	// @param - GlyphRect& for the glyph's location
+	// @return - bool for if the glyph fits on a page
+	bool Allocate(int width, int height, GlyphRect& outRect);
+
+	// Copies a glyph's bitmap into its allocated space and marks the page as changed
+	// @param - const GlyphRect& for the glyph's location
+	// @param - int for the bitmap's width
+	// @param - int for the bitmap's height
+	// @param - int for the number of bytes between rows of the bitmap
+	// @param - const unsigned char* for the bitmap's pixels
+	void CopyPixels(const GlyphRect& rect, int width, int height, int pitch, const unsigned char* pixels);
+
+	// Creates textures for new pages and uploads the changed rows of every page
+	void Upload();
+
+	// Deletes every page
+	void Clear();
+
+	// Gets a page's texture (valid after Upload())
+	// @param - unsigned int for the page
+	// @return - Texture* for the page's texture
+	Texture* GetPage(unsigned int page) const { return mPages[page].texture; }
+
+	// Gets the number of pages
+	// @return - size_t for the number of pages
+	size_t GetNumPages() const { return mPages.size(); }
+
+	// Gets the width/height of a page
+	// @return - int for the page size
+	int GetPageSize() const { return mPageSize; }
+
+private:
+	// Struct for a single page of the atlas
+	struct GlyphPage
+	{
+		std::vector<unsigned char> pixels;	// single channel pixels of the page
+		Texture* texture;					// texture of the page, nullptr until uploaded
+		int shelfX;							// next free pixel along the current shelf
+		int shelfY;							// top of the current shelf
+		int shelfHeight;					// height of the tallest glyph on the current shelf
+		int dirtyMinY;						// first row changed since the last upload
+		int dirtyMaxY;						// one past the last row changed since the last upload
+	};
+
+	// Adds an empty page
+	void AddPage();
+
+	// Pages of the atlas
+	std::vector<GlyphPage> mPages;
+
+	// Width/height of a page
+	int mPageSize;
+};
@@ -0,0 +1,153 @@
+#include "GpuProfiler.h"
+#include <glad/glad.h>
+#include "../Util/Logger.h"
+
+GpuProfiler* GpuProfiler::Get()
+{
+	static GpuProfiler s_GpuProfiler;
+
+	return &s_GpuProfiler;
+}
+
+GpuProfiler::GpuProfiler() :
+	mFrames(),
+	mCurrentFrame(0),
+	mIsSupported(false)
+{
+}
+
+GpuProfiler::~GpuProfiler()
+{
+}
+
+void GpuProfiler::Init()
+{
+	// Timestamp queries are core since 3.3. Some drivers expose them but report 0 bits of precision.
+	GLint bits = 0;
+	if (GLAD_GL_VERSION_3_3)
+	{
+		glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+	}
+	mIsSupported = bits > 0;
+
+	if (mIsSupported)
+	{
+		LOG_INFO("GPU timer queries enabled");
+	}
+	else
+	{
+		LOG_WARNING("GPU timer queries aren't supported, GPU zones won't be measured");
+	}
+}
+
+void GpuProfiler::Shutdown()
+{
+	for (Frame& frame : mFrames)
+	{
+		if (!frame.queries.empty())
+		{
+			glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+		}
+		frame.queries.clear();
+		frame.zones.clear();
+		frame.numQueries = 0;
+	}
+	mIsSupported = false;
+}
+
+int GpuProfiler::BeginZone(const std::string& name)
+{
+	if (!mIsSupported)
+	{
+		return -1;
+	}
+
+	Frame& frame = mFrames[mCurrentFrame];
+
+	Zone zone = {};
+	zone.timer = Profiler::Get()->GetTimer("GPU_" + name);
+	zone.beginQuery = WriteTimestamp();
+	zone.endQuery = -1;
+	frame.zones.emplace_back(zone);
+
+	return static_cast<int>(frame.zones.size() - 1);
+}
+
+void GpuProfiler::EndZone(int zone)
+{
+	if (!mIsSupported || zone < 0)
+	{
+		return;
+	}
+
+	mFrames[mCurrentFrame].zones[zone].endQuery = WriteTimestamp();
+}
+
+void GpuProfiler::NextFrame()
+{
+	if (!mIsSupported)
+	{
+		return;
+	}
+
+	mCurrentFrame = (mCurrentFrame + 1) % GPU_PROFILER_FRAMES;
+
+	// The oldest frame comes back around, so read it before its queries are written again
+	Frame& frame = mFrames[mCurrentFrame];
+	ReadFrame(frame);
+	frame.zones.clear();
+	frame.numQueries = 0;
+}
+
+int GpuProfiler::WriteTimestamp()
+{
+	Frame& frame = mFrames[mCurrentFrame];
+
+	if (frame.numQueries == static_cast<int>(frame.queries.size()))
+	{
+		// Grow the frame's queries in batches
+		size_t oldSize = frame.queries.size();
+		frame.queries.resize(oldSize + 32);
+		glGenQueries(32, frame.queries.data() + oldSize);
+	}
+
+	glQueryCounter(frame.queries[frame.numQueries], GL_TIMESTAMP);
+
+	return frame.numQueries++;
+}
+
+void GpuProfiler::ReadFrame(Frame& frame)
+{
+	if (frame.numQueries == 0)
+	{
+		return;
+	}
+
+	// Queries finish in order, so if the last one is ready they all are
+	GLint isAvailable = 0;
+	glGetQueryObjectiv(frame.queries[frame.numQueries - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+	if (!isAvailable)
+	{
+		return;
+	}
+
+	std::vector<GLuint64> timestamps(frame.numQueries);
+	for (int i = 0; i < frame.numQueries; ++i)
+	{
+		glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+	}
+
+	// Zones with the same name in a frame add up, so clear them before adding
+	for (const Zone& zone : frame.zones)
+	{
+		zone.timer->SetTimeMs(0.0);
+	}
+	for (const Zone& zone : frame.zones)
+	{
+		if (zone.endQuery >= 0)
+		{
+			double ms = static_cast<double>(timestamps[zone.endQuery] - timestamps[zone.beginQuery]) / 1000000.0;
+			zone.timer->SetTimeMs(zone.timer->GetTimeMs() + ms);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "../Util/Profiler.h"
+
+// Macro to time the GPU work submitted in a scope. The result is reported to the Profiler as GPU_<name>
+// a few frames later, next to the CPU timer with the same name.
+#define PROFILE_GPU_SCOPE(name) \
+GpuProfiler::ScopedZone name##_gpu_scope(std::string(#name))
+
+// Number of frames a zone's queries stay in flight before their results are read
+const int GPU_PROFILER_FRAMES = 3;
+
+// GpuProfiler measures how long the GPU takes to run the commands submitted between the start and end
+// of a zone. Each zone writes a timestamp query at its start and end, so zones can nest. Queries are
+// kept in a ring of GPU_PROFILER_FRAMES frames and only read once the ring comes back around, so
+// reading results never waits on the GPU. When the context doesn't support timer queries every zone
+// does nothing.
+class GpuProfiler
+{
+public:
+	// ScopedZone starts a GPU zone when created and ends it when it goes out of scope
+	class ScopedZone
+	{
+	public:
+		// ScopedZone constructor starts a zone
+		// @param - const std::string& for the zone's name
+		ScopedZone(const std::string& name) : mZone(GpuProfiler::Get()->BeginZone(name)) {}
+		~ScopedZone()
+		{
+			GpuProfiler::Get()->EndZone(mZone);
+		}
+	private:
+		// Zone index returned from BeginZone()
+		int mZone;
+	};
+
+	// Returns the instance of the GPU profiler
+	// @return - GpuProfiler* for the static instance
+	static GpuProfiler* Get();
+
+	// Checks if the context supports timer queries. Call once after OpenGL is loaded.
+	void Init();
+
+	// Deletes the queries. Call before the OpenGL context is destroyed.
+	void Shutdown();
+
+	// Writes a timestamp query for the start of a zone
+	// @param - const std::string& for the zone's name
+	// @return - int for the zone's index (-1 if timer queries aren't supported)
+	int BeginZone(const std::string& name);
+
+	// Writes a timestamp query for the end of a zone
+	// @param - int for the zone's index returned from BeginZone()
+	void EndZone(int zone);
+
+	// Moves to the next frame in the ring and reports the results of the frame
+	// that was submitted GPU_PROFILER_FRAMES frames ago. Call once at the end of every frame.
+	void NextFrame();
+
+	// Gets if the context supports timer queries
+	// @return - bool for if zones are measured
+	bool IsSupported() const { return mIsSupported; }
+
+private:
+	GpuProfiler();
+	~GpuProfiler();
+
+	// Struct for a zone written during a frame
+	struct Zone
+	{
+		Profiler::Timer* timer;	// timer the result is reported to
+		int beginQuery;			// index of the start timestamp in the frame's queries
+		int endQuery;			// index of the end timestamp in the frame's queries (-1 until the zone ends)
+	};
+
+	// Struct for the queries and zones of a frame in the ring
+	struct Frame
+	{
+		std::vector<unsigned int> queries;	// query objects, created as needed and reused every time the ring comes around
+		std::vector<Zone> zones;			// zones written this frame
+		int numQueries;						// number of queries written this frame
+	};
+
+	// Writes a timestamp into the current frame's next query
+	// @return - int for the query's index in the frame
+	int WriteTimestamp();
+
+	// Reads a frame's results and reports them to the Profiler. Skips the frame if the GPU isn't done with it.
+	// @param - Frame& for the frame
+	void ReadFrame(Frame& frame);
+
+	// Frames in the ring
+	Frame mFrames[GPU_PROFILER_FRAMES];
+
+	// Index of the frame being written
+	int mCurrentFrame;
+
+	// Bool for if the context supports timer queries
+	bool mIsSupported;
+};
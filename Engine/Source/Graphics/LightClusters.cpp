@@ -0,0 +1,190 @@
+#include "LightClusters.h"
+#include <algorithm>
+#include <cmath>
+
+// Tests if a sphere overlaps a box
+static bool SphereIntersectsBox(const glm::vec3& center, float radius, const BoundingBox& box)
+{
+	glm::vec3 closest = glm::clamp(center, box.min, box.max);
+	glm::vec3 offset = closest - center;
+
+	return glm::dot(offset, offset) <= radius * radius;
+}
+
+// Converts a range of view space values on one axis into a range of tiles on that axis.
+// Dividing by the depth is monotonic for a fixed sign, so the extremes come from the depth range's ends.
+static void GetTileRange(float minValue, float maxValue, float minDepth, float maxDepth, float halfExtent, unsigned int numTiles,
+	unsigned int& outBegin, unsigned int& outEnd)
+{
+	float ndcMin = std::min(minValue / minDepth, minValue / maxDepth) / halfExtent;
+	float ndcMax = std::max(maxValue / minDepth, maxValue / maxDepth) / halfExtent;
+
+	float tiles = static_cast<float>(numTiles);
+	float begin = std::floor((ndcMin * 0.5f + 0.5f) * tiles);
+	float end = std::floor((ndcMax * 0.5f + 0.5f) * tiles) + 1.0f;
+
+	outBegin = static_cast<unsigned int>(std::clamp(begin, 0.0f, tiles));
+	outEnd = static_cast<unsigned int>(std::clamp(end, 0.0f, tiles));
+}
+
+LightClusters::LightClusters(unsigned int gridX, unsigned int gridY, unsigned int gridZ, unsigned int maxLightsPerCluster) :
+	mClusterBounds(),
+	mClusterCounts(),
+	mClusterLights(),
+	mRanges(),
+	mLightIndices(),
+	mGridX(gridX),
+	mGridY(gridY),
+	mGridZ(gridZ),
+	mMaxLightsPerCluster(maxLightsPerCluster),
+	mFOV(0.0f),
+	mAspectRatio(0.0f),
+	mNearPlane(0.0f),
+	mFarPlane(0.0f),
+	mSliceScale(0.0f),
+	mSliceBias(0.0f)
+{
+	unsigned int numClusters = GetNumClusters();
+
+	mClusterBounds.resize(numClusters);
+	mClusterCounts.resize(numClusters, 0);
+	mClusterLights.resize(static_cast<size_t>(numClusters) * mMaxLightsPerCluster, 0);
+	mRanges.resize(numClusters);
+	mLightIndices.reserve(numClusters);
+}
+
+LightClusters::~LightClusters()
+{
+}
+
+void LightClusters::SetProjection(float fov, float aspectRatio, float nearPlane, float farPlane)
+{
+	if (fov == mFOV && aspectRatio == mAspectRatio && nearPlane == mNearPlane && farPlane == mFarPlane)
+	{
+		return;
+	}
+
+	mFOV = fov;
+	mAspectRatio = aspectRatio;
+	mNearPlane = nearPlane;
+	mFarPlane = farPlane;
+
+	// slice = log(depth / near) / log(far / near) * numSlices
+	float logRatio = std::log(mFarPlane / mNearPlane);
+	mSliceScale = static_cast<float>(mGridZ) / logRatio;
+	mSliceBias = -static_cast<float>(mGridZ) * std::log(mNearPlane) / logRatio;
+
+	float tanHalfFOV = std::tan(mFOV * 0.5f);
+	float halfWidth = tanHalfFOV * mAspectRatio;
+	float halfHeight = tanHalfFOV;
+
+	for (unsigned int z = 0; z < mGridZ; ++z)
+	{
+		float sliceNear = GetSliceDepth(z);
+		float sliceFar = GetSliceDepth(z + 1);
+
+		for (unsigned int y = 0; y < mGridY; ++y)
+		{
+			float bottom = (-1.0f + 2.0f * y / mGridY) * halfHeight;
+			float top = (-1.0f + 2.0f * (y + 1) / mGridY) * halfHeight;
+
+			for (unsigned int x = 0; x < mGridX; ++x)
+			{
+				float left = (-1.0f + 2.0f * x / mGridX) * halfWidth;
+				float right = (-1.0f + 2.0f * (x + 1) / mGridX) * halfWidth;
+
+				// Box around the tile's corners at both ends of the slice (the camera looks down -z)
+				BoundingBox& box = mClusterBounds[GetClusterIndex(x, y, z)];
+				box.min = glm::vec3(std::min(left * sliceNear, left * sliceFar), std::min(bottom * sliceNear, bottom * sliceFar), -sliceFar);
+				box.max = glm::vec3(std::max(right * sliceNear, right * sliceFar), std::max(top * sliceNear, top * sliceFar), -sliceNear);
+			}
+		}
+	}
+}
+
+void LightClusters::BinLights(const std::vector<ClusterLight>& lights, unsigned int sliceBegin, unsigned int sliceEnd)
+{
+	sliceEnd = std::min(sliceEnd, mGridZ);
+
+	for (unsigned int z = sliceBegin; z < sliceEnd; ++z)
+	{
+		std::fill_n(mClusterCounts.begin() + GetClusterIndex(0, 0, z), mGridX * mGridY, 0u);
+	}
+
+	float tanHalfFOV = std::tan(mFOV * 0.5f);
+
+	for (const ClusterLight& light : lights)
+	{
+		float depth = -light.position.z;
+
+		// Skip lights completely behind the camera or past the far plane
+		if (depth + light.radius <= mNearPlane || depth - light.radius >= mFarPlane)
+		{
+			continue;
+		}
+
+		unsigned int firstSlice = std::max(GetSlice(depth - light.radius), sliceBegin);
+		unsigned int lastSlice = std::min(GetSlice(depth + light.radius) + 1, sliceEnd);
+
+		for (unsigned int z = firstSlice; z < lastSlice; ++z)
+		{
+			// Narrow down the tiles with the light's box clipped to the slice
+			float minDepth = std::max(depth - light.radius, GetSliceDepth(z));
+			float maxDepth = std::min(depth + light.radius, GetSliceDepth(z + 1));
+
+			unsigned int xBegin = 0;
+			unsigned int xEnd = 0;
+			unsigned int yBegin = 0;
+			unsigned int yEnd = 0;
+			GetTileRange(light.position.x - light.radius, light.position.x + light.radius, minDepth, maxDepth, tanHalfFOV * mAspectRatio, mGridX, xBegin, xEnd);
+			GetTileRange(light.position.y - light.radius, light.position.y + light.radius, minDepth, maxDepth, tanHalfFOV, mGridY, yBegin, yEnd);
+
+			for (unsigned int y = yBegin; y < yEnd; ++y)
+			{
+				for (unsigned int x = xBegin; x < xEnd; ++x)
+				{
+					unsigned int cluster = GetClusterIndex(x, y, z);
+					unsigned int& count = mClusterCounts[cluster];
+
+					if (count < mMaxLightsPerCluster && SphereIntersectsBox(light.position, light.radius, mClusterBounds[cluster]))
+					{
+						mClusterLights[static_cast<size_t>(cluster) * mMaxLightsPerCluster + count] = light.index;
+						++count;
+					}
+				}
+			}
+		}
+	}
+}
+
+void LightClusters::Pack()
+{
+	mLightIndices.clear();
+
+	for (unsigned int cluster = 0; cluster < GetNumClusters(); ++cluster)
+	{
+		unsigned int count = mClusterCounts[cluster];
+		auto first = mClusterLights.begin() + static_cast<size_t>(cluster) * mMaxLightsPerCluster;
+
+		mRanges[cluster].offset = static_cast<unsigned int>(mLightIndices.size());
+		mRanges[cluster].count = count;
+		mLightIndices.insert(mLightIndices.end(), first, first + count);
+	}
+}
+
+unsigned int LightClusters::GetSlice(float depth) const
+{
+	if (depth <= mNearPlane)
+	{
+		return 0;
+	}
+
+	float slice = std::floor(std::log(depth) * mSliceScale + mSliceBias);
+
+	return static_cast<unsigned int>(std::clamp(slice, 0.0f, static_cast<float>(mGridZ - 1)));
+}
+
+float LightClusters::GetSliceDepth(unsigned int slice) const
+{
+	return mNearPlane * std::pow(mFarPlane / mNearPlane, static_cast<float>(slice) / mGridZ);
+}
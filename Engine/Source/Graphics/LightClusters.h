@@ -0,0 +1,142 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "BoundingVolumes.h"
+
+// Default number of clusters across the screen's width/height and along the view depth
+const unsigned int CLUSTER_GRID_X = 16;
+const unsigned int CLUSTER_GRID_Y = 9;
+const unsigned int CLUSTER_GRID_Z = 24;
+
+// Most lights a single cluster can reference, any extra lights are dropped
+const unsigned int MAX_LIGHTS_PER_CLUSTER = 256;
+
+// Set on a cluster's light index when it refers to a spot light instead of a point light.
+// This needs to match SPOT_LIGHT_FLAG in the shaders.
+const unsigned int SPOT_LIGHT_FLAG = 0x80000000u;
+
+// Struct for a light to bin into the clusters
+struct ClusterLight
+{
+	glm::vec3 position; // view space position of the light
+	float radius;		// distance the light reaches
+	unsigned int index; // index into the point lights, or into the spot lights with SPOT_LIGHT_FLAG set
+};
+
+// Struct for where a cluster's lights are within the packed light index list
+struct ClusterRange
+{
+	unsigned int offset; // first index in the list
+	unsigned int count;	 // number of lights in the cluster
+};
+
+// LightClusters splits the camera's view frustum into a grid of clusters: screen space tiles along x/y
+// and exponentially spaced slices along the view depth. Lights are binned into every cluster their
+// sphere overlaps so that a fragment only has to shade the lights of its own cluster. This class does
+// not touch OpenGL, so binning is safe to run on JobManager worker threads.
+class LightClusters
+{
+public:
+	// LightClusters constructor
+	// @param - unsigned int for the number of clusters across the screen's width
+	// @param - unsigned int for the number of clusters across the screen's height
+	// @param - unsigned int for the number of depth slices
+	// @param - unsigned int for the most lights a single cluster can hold
+	LightClusters(unsigned int gridX = CLUSTER_GRID_X, unsigned int gridY = CLUSTER_GRID_Y, unsigned int gridZ = CLUSTER_GRID_Z,
+		unsigned int maxLightsPerCluster = MAX_LIGHTS_PER_CLUSTER);
+	~LightClusters();
+
+	// Rebuilds the view space bounds of every cluster if the projection has changed
+	// @param - float for the camera's field of view in radians
+	// @param - float for the camera's aspect ratio
+	// @param - float for the camera's near plane
+	// @param - float for the camera's far plane
+	void SetProjection(float fov, float aspectRatio, float nearPlane, float farPlane);
+
+	// Clears and fills the clusters within a range of depth slices. Calls with ranges
+	// that do not overlap only write to their own clusters and can run at the same time.
+	// @param - const std::vector<ClusterLight>& for the lights in view space
+	// @param - unsigned int for the first slice
+	// @param - unsigned int for one past the last slice
+	void BinLights(const std::vector<ClusterLight>& lights, unsigned int sliceBegin, unsigned int sliceEnd);
+
+	// Packs every cluster's lights into one contiguous index list once binning is done
+	void Pack();
+
+	// Finds the depth slice a view space distance falls in
+	// @param - float for the distance in front of the camera
+	// @return - unsigned int for the slice
+	unsigned int GetSlice(float depth) const;
+
+	// Gets a cluster's index from its grid coordinates
+	// @return - unsigned int for the cluster's index
+	unsigned int GetClusterIndex(unsigned int x, unsigned int y, unsigned int z) const { return x + mGridX * (y + mGridY * z); }
+
+	// Gets a cluster's view space bounds
+	// @param - unsigned int for the cluster's index
+	// @return - const BoundingBox& for the bounds
+	const BoundingBox& GetClusterBounds(unsigned int cluster) const { return mClusterBounds[cluster]; }
+
+	// Gets each cluster's range within the packed light indices (valid after Pack())
+	// @return - const std::vector<ClusterRange>& for the ranges
+	const std::vector<ClusterRange>& GetRanges() const { return mRanges; }
+
+	// Gets the packed light indices of every cluster (valid after Pack())
+	// @return - const std::vector<unsigned int>& for the light indices
+	const std::vector<unsigned int>& GetLightIndices() const { return mLightIndices; }
+
+	// Gets the values that turn a view space distance into a slice: slice = log(depth) * x + y
+	// @return - glm::vec2 for the scale and bias
+	glm::vec2 GetSliceScaleBias() const { return glm::vec2(mSliceScale, mSliceBias); }
+
+	// Gets the grid's dimensions
+	// @return - glm::uvec3 for the number of clusters along x, y, and z
+	glm::uvec3 GetGridSize() const { return glm::uvec3(mGridX, mGridY, mGridZ); }
+
+	// Gets the total number of clusters
+	// @return - unsigned int for the number of clusters
+	unsigned int GetNumClusters() const { return mGridX * mGridY * mGridZ; }
+
+private:
+	// Calculates the view space distance where a slice starts
+	// @param - unsigned int for the slice
+	// @return - float for the distance
+	float GetSliceDepth(unsigned int slice) const;
+
+	// View space bounds of each cluster
+	std::vector<BoundingBox> mClusterBounds;
+
+	// Number of lights binned into each cluster
+	std::vector<unsigned int> mClusterCounts;
+
+	// Fixed size list of lights for each cluster, filled by BinLights()
+	std::vector<unsigned int> mClusterLights;
+
+	// Each cluster's range within mLightIndices
+	std::vector<ClusterRange> mRanges;
+
+	// Packed light indices of every cluster
+	std::vector<unsigned int> mLightIndices;
+
+	// Number of clusters across the screen's width
+	unsigned int mGridX;
+
+	// Number of clusters across the screen's height
+	unsigned int mGridY;
+
+	// Number of depth slices
+	unsigned int mGridZ;
+
+	// Most lights a single cluster can hold
+	unsigned int mMaxLightsPerCluster;
+
+	// Projection the cluster bounds were built for
+	float mFOV;
+	float mAspectRatio;
+	float mNearPlane;
+	float mFarPlane;
+
+	// Scale and bias to find a depth's slice
+	float mSliceScale;
+	float mSliceBias;
+};
@@ -1,9 +1,16 @@
 #pragma once
+#include <vector>
 #include <glm/glm.hpp>
 
-const int MAX_LIGHTS = 10;
+// Maximum number of point lights and spot lights each. These live in shader storage buffers
+// and are culled into clusters, so this only bounds memory and not per fragment cost.
+const int MAX_LIGHTS = 4096;
 const int MAX_DIR_LIGHT = 1;
 
+// Light intensity under which a point/spot light's contribution is cut off.
+// Used to find each light's radius for clustered culling.
+const float LIGHT_CUTOFF = 0.01f;
+
 // Struct that defines lighting data
 // such as color, ambient, diffuse, and
 // specular intensities
@@ -27,8 +34,8 @@ struct PointLight
     float constant;
     float linear;
     float quadratic;
-    float padding;
-    float padding2;
+    int shadowSlot = -1;    // slot in the point shadow atlas, -1 if it has no shadow this frame
+    float radius;           // distance where the light's contribution reaches LIGHT_CUTOFF
 };
 
 // Struct for directional light contains info about a light's direction
@@ -51,16 +58,16 @@ struct SpotLight
     float constant;
     float linear;
     float quadratic;
-    float padding;
+    float radius;           // distance where the light's contribution reaches LIGHT_CUTOFF
 };
 
 // Struct that contains different arrays for 
 // directional lights, point lights, and spotlights.
-// Each array is capped to a certain number that is allowed
-// to be rendered into the scene.
+// Spot/point lights are sized to MAX_LIGHTS once by Lights
+// so that pointers to them stay valid.
 struct LightArrays
 {
-    SpotLight spotLights[MAX_LIGHTS];
-    PointLight pointLights[MAX_LIGHTS];
+    std::vector<SpotLight> spotLights;
+    std::vector<PointLight> pointLights;
     DirectionalLight directionalLight[MAX_DIR_LIGHT];
 };
@@ -1,13 +1,48 @@
 #include "Lights.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include "Camera.h"
 #include "Renderer.h"
+#include "ShaderStorageBuffer.h"
 #include "UniformBuffer.h"
 
+// Finds the distance where a light's 1 / (distance * distance) falloff drops under LIGHT_CUTOFF
+static float CalculateLightRadius(const LightData& data)
+{
+	float brightest = std::max(std::max(data.color.r, data.color.g), data.color.b);
+	float intensity = brightest * (data.ambientIntensity + data.diffuseIntensity + data.specularIntensity);
+
+	return std::sqrt(std::max(intensity, 0.0f) / LIGHT_CUTOFF);
+}
+
 Lights::Lights() :
 	mLightArrays({}),
-	mLightBuffer(nullptr)
+	mClusters(),
+	mClusterLights(),
+	mClusterJobs(),
+	mClusterJobsDone(nullptr),
+	mClusterConsts({}),
+	mLightBuffer(nullptr),
+	mClusterBuffer(nullptr),
+	mPointLightBuffer(nullptr),
+	mSpotLightBuffer(nullptr),
+	mClusterRangeBuffer(nullptr),
+	mClusterIndexBuffer(nullptr),
+	mNumPointLights(0),
+	mNumSpotLights(0)
 {
-
+	mLightArrays.pointLights.resize(MAX_LIGHTS);
+	mLightArrays.spotLights.resize(MAX_LIGHTS);
+	mClusterLights.reserve(MAX_LIGHTS * 2);
+
+	// Split the depth slices evenly between the jobs
+	unsigned int numSlices = mClusters.GetGridSize().z;
+	mClusterJobs.reserve(NUM_CLUSTER_JOBS);
+	for (unsigned int i = 0; i < NUM_CLUSTER_JOBS; ++i)
+	{
+		mClusterJobs.emplace_back(this, numSlices * i / NUM_CLUSTER_JOBS, numSlices * (i + 1) / NUM_CLUSTER_JOBS);
+	}
 }
 
 Lights::~Lights()
@@ -21,13 +56,73 @@ void Lights::CreateBuffer(Renderer* renderer)
 {
 	if (mLightBuffer == nullptr)
 	{
-		mLightBuffer = renderer->CreateUniformBuffer(sizeof(LightArrays), BufferBindingPoint::Lights, "LightBuffer");
+		mLightBuffer = renderer->CreateUniformBuffer(sizeof(DirectionalLight) * MAX_DIR_LIGHT, BufferBindingPoint::Lights, "LightBuffer");
+		mClusterBuffer = renderer->CreateUniformBuffer(sizeof(ClusterConsts), BufferBindingPoint::Cluster, "ClusterBuffer");
+
+		mPointLightBuffer = renderer->CreateShaderStorageBuffer(sizeof(PointLight) * MAX_LIGHTS, StorageBindingPoint::PointLights, "PointLightBuffer");
+		mSpotLightBuffer = renderer->CreateShaderStorageBuffer(sizeof(SpotLight) * MAX_LIGHTS, StorageBindingPoint::SpotLights, "SpotLightBuffer");
+		mClusterRangeBuffer = renderer->CreateShaderStorageBuffer(sizeof(ClusterRange) * mClusters.GetNumClusters(), StorageBindingPoint::ClusterRanges, "ClusterRangeBuffer");
+		mClusterIndexBuffer = renderer->CreateShaderStorageBuffer(sizeof(unsigned int) * mClusters.GetNumClusters() * MAX_LIGHTS_PER_CLUSTER,
+			StorageBindingPoint::ClusterLightIndices, "ClusterLightIndexBuffer");
 	}
 }
 
-void Lights::SetBuffer()
+void Lights::SetBuffer(Renderer* renderer, JobManager* jobManager)
 {
-	mLightBuffer->UpdateBufferData(&mLightArrays);
+	const Camera* camera = renderer->GetCamera();
+	const glm::mat4& view = camera->GetViewMatrix();
+
+	mClusters.SetProjection(glm::radians(camera->GetFOV()), camera->GetAspectRatio(), camera->GetNearPlane(), camera->GetFarPlane());
+
+	// Update the range of every enabled light and gather them in view space
+	mClusterLights.clear();
+	for (int i = 0; i < mNumPointLights; ++i)
+	{
+		PointLight& light = mLightArrays.pointLights[i];
+		if (light.data.isEnabled)
+		{
+			light.radius = CalculateLightRadius(light.data);
+			glm::vec3 viewPos = glm::vec3(view * glm::vec4(light.position, 1.0f));
+			mClusterLights.emplace_back(ClusterLight{ viewPos, light.radius, static_cast<unsigned int>(i) });
+		}
+	}
+	for (int i = 0; i < mNumSpotLights; ++i)
+	{
+		SpotLight& light = mLightArrays.spotLights[i];
+		if (light.data.isEnabled)
+		{
+			light.radius = CalculateLightRadius(light.data);
+			glm::vec3 viewPos = glm::vec3(view * glm::vec4(light.position, 1.0f));
+			mClusterLights.emplace_back(ClusterLight{ viewPos, light.radius, static_cast<unsigned int>(i) | SPOT_LIGHT_FLAG });
+		}
+	}
+
+	// Bin the lights into each range of depth slices on a separate thread, waiting only on these jobs and not everything else the job manager is running
+	std::latch clusterJobsDone(static_cast<std::ptrdiff_t>(mClusterJobs.size()));
+	mClusterJobsDone = &clusterJobsDone;
+	for (ClusterJob& job : mClusterJobs)
+	{
+		jobManager->AddJob(&job);
+	}
+	clusterJobsDone.wait();
+	mClusterJobsDone = nullptr;
+
+	mClusters.Pack();
+
+	glm::vec2 sliceScaleBias = mClusters.GetSliceScaleBias();
+	mClusterConsts.view = view;
+	mClusterConsts.gridSize = glm::uvec4(mClusters.GetGridSize(), 0);
+	mClusterConsts.sliceParams = glm::vec4(sliceScaleBias.x, sliceScaleBias.y, 0.0f, 0.0f);
+	mClusterConsts.screenSize = glm::vec4(static_cast<float>(renderer->GetWidth()), static_cast<float>(renderer->GetHeight()), 0.0f, 0.0f);
+
+	const std::vector<unsigned int>& lightIndices = mClusters.GetLightIndices();
+
+	mLightBuffer->UpdateBufferData(mLightArrays.directionalLight);
+	mClusterBuffer->UpdateBufferData(&mClusterConsts);
+	mPointLightBuffer->UpdateBufferData(mLightArrays.pointLights.data(), sizeof(PointLight) * mNumPointLights);
+	mSpotLightBuffer->UpdateBufferData(mLightArrays.spotLights.data(), sizeof(SpotLight) * mNumSpotLights);
+	mClusterRangeBuffer->UpdateBufferData(mClusters.GetRanges().data(), sizeof(ClusterRange) * mClusters.GetRanges().size());
+	mClusterIndexBuffer->UpdateBufferData(lightIndices.data(), sizeof(unsigned int) * lightIndices.size());
 }
 
 SpotLight* Lights::AllocateSpotLight(const glm::vec4& color, const glm::vec3& pos, const glm::vec3& dir, float cutoff, float outerCutoff, float constant, float linear, float quadratic)
@@ -48,6 +143,8 @@ SpotLight* Lights::AllocateSpotLight(const glm::vec4& color, const glm::vec3& po
 			spotlight->constant = constant;
 			spotlight->linear = linear;
 			spotlight->quadratic = quadratic;
+			spotlight->radius = CalculateLightRadius(spotlight->data);
+			mNumSpotLights = std::max(mNumSpotLights, i + 1);
 			return spotlight;
 		}
 	}
@@ -70,6 +167,9 @@ PointLight* Lights::AllocatePointLight(const glm::vec4& color, const glm::vec3&
 			pointLight->constant = constant;
 			pointLight->linear = linear;
 			pointLight->quadratic = quadratic;
+			pointLight->shadowSlot = -1;
+			pointLight->radius = CalculateLightRadius(pointLight->data);
+			mNumPointLights = std::max(mNumPointLights, i + 1);
 			return pointLight;
 		}
 	}
@@ -97,15 +197,28 @@ DirectionalLight* Lights::AllocateDirectionalLight(const glm::vec4& color, const
 
 void Lights::DeAllocateLights()
 {
-	for (unsigned int i = 0; i < MAX_LIGHTS; ++i)
+	for (PointLight& light : mLightArrays.pointLights)
 	{
-		mLightArrays.pointLights[i].data.isEnabled = false;
+		light.data.isEnabled = false;
+	}
 
-		mLightArrays.spotLights[i].data.isEnabled = false;
+	for (SpotLight& light : mLightArrays.spotLights)
+	{
+		light.data.isEnabled = false;
 	}
 
+	mNumPointLights = 0;
+	mNumSpotLights = 0;
+
 	for (unsigned int i = 0; i < MAX_DIR_LIGHT; ++i)
 	{
 		mLightArrays.directionalLight[i].data.isEnabled = false;
 	}
 }
+
+void Lights::ClusterJob::DoJob()
+{
+	mLights->mClusters.BinLights(mLights->mClusterLights, mSliceBegin, mSliceEnd);
+
+	mLights->mClusterJobsDone->count_down();
+}
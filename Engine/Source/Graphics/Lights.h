@@ -1,25 +1,46 @@
 #pragma once
+#include <latch>
+#include <vector>
+#include "../Multithreading/JobManager.h"
+#include "LightClusters.h"
 #include "LightConstants.h"
 
 class Renderer;
+class ShaderStorageBuffer;
 class UniformBuffer;
 
+// Number of jobs the depth slices are split between when binning lights into clusters
+const int NUM_CLUSTER_JOBS = 4;
+
+// Struct for the cluster grid's data to be sent to the shaders
+struct ClusterConsts
+{
+	glm::mat4 view;			// camera's view matrix used to find a fragment's depth
+	glm::uvec4 gridSize;	// xyz = number of clusters along each axis
+	glm::vec4 sliceParams;	// x = slice scale, y = slice bias
+	glm::vec4 screenSize;	// xy = screen's width and height in pixels
+};
+
 // Lights class manages all the lighting within a scene.
 // Allocators for specific light casters can be used to
-// add lights to a scene. This lighting data is stored
-// and sent into a uniform buffer that the shaders can use.
+// add lights to a scene. Point and spot lights are sent to the shaders
+// through storage buffers and binned into view space clusters every frame
+// so that each fragment only shades the lights near it.
 class Lights
 {
 public:
 	Lights();
 	~Lights();
 
-	// Creates a UniformBuffer for lights object to send lighting data to a buffer
-	// @param - Renderer3D* to create/add a buffer to its map of UniformBuffers
+	// Creates the uniform buffers and storage buffers used to send lighting data to the shaders
+	// @param - Renderer* to create/add the buffers to its maps of buffers
 	void CreateBuffer(Renderer* renderer);
 
-	// Updates the lighting buffer with the current state of the light arrays
-	void SetBuffer();
+	// Bins the point and spot lights into the camera's clusters on JobManager threads,
+	// then updates the lighting buffers with the current state of the lights and clusters
+	// @param - Renderer* for the renderer's camera and screen size
+	// @param - JobManager* for the engine's job manager
+	void SetBuffer(Renderer* renderer, JobManager* jobManager);
 
 	// Gets the light arrays
 	// @return - LightArrays& for the light arrays
@@ -29,6 +50,18 @@ public:
 	// @return - UniformBuffer* for the lighting buffer
 	UniformBuffer* GetLightBuffer() { return mLightBuffer; }
 
+	// Gets the light clusters
+	// @return - const LightClusters& for the clusters
+	const LightClusters& GetClusters() const { return mClusters; }
+
+	// Gets the number of point light slots in use (highest allocated slot + 1)
+	// @return - int for the number of point lights
+	int GetNumPointLights() const { return mNumPointLights; }
+
+	// Gets the number of spot light slots in use (highest allocated slot + 1)
+	// @return - int for the number of spot lights
+	int GetNumSpotLights() const { return mNumSpotLights; }
+
 	// Allocator for spot lights
 	// @param - const glm::vec4& for the light's color
 	// @param - const glm::vec3& for the light's position
@@ -60,9 +93,62 @@ public:
 	void DeAllocateLights();
 
 private:
+	// Job to bin the lights into a range of the clusters' depth slices on a separate thread
+	class ClusterJob : public JobManager::Job
+	{
+	public:
+		ClusterJob(Lights* lights, unsigned int sliceBegin, unsigned int sliceEnd) :
+			mLights(lights),
+			mSliceBegin(sliceBegin),
+			mSliceEnd(sliceEnd)
+		{
+		}
+		void DoJob() override;
+	private:
+		Lights* mLights;
+		unsigned int mSliceBegin;
+		unsigned int mSliceEnd;
+	};
+
 	// Array of different lights
 	LightArrays mLightArrays;
 
-	// Buffer to send lighting data to shaders
+	// View space clusters the lights get binned into
+	LightClusters mClusters;
+
+	// Enabled point/spot lights in view space, rebuilt every frame for binning
+	std::vector<ClusterLight> mClusterLights;
+
+	// Jobs used to bin the lights
+	std::vector<ClusterJob> mClusterJobs;
+
+	// Counts down as this frame's cluster jobs finish (only set while SetBuffer() waits on them)
+	std::latch* mClusterJobsDone;
+
+	// Cluster grid constants
+	ClusterConsts mClusterConsts;
+
+	// Buffer to send the directional lights to shaders
 	UniformBuffer* mLightBuffer;
-};
\ No newline at end of file
+
+	// Buffer to send the cluster grid's data to shaders
+	UniformBuffer* mClusterBuffer;
+
+	// Buffer to send point lights to shaders
+	ShaderStorageBuffer* mPointLightBuffer;
+
+	// Buffer to send spot lights to shaders
+	ShaderStorageBuffer* mSpotLightBuffer;
+
+	// Buffer to send each cluster's range of light indices to shaders
+	ShaderStorageBuffer* mClusterRangeBuffer;
+
+	// Buffer to send the packed light indices of every cluster to shaders
+	ShaderStorageBuffer* mClusterIndexBuffer;
+
+	// Number of point light slots in use
+	int mNumPointLights;
+
+	// Number of spot light slots in use
+	int mNumSpotLights;
+};
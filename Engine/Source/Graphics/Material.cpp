@@ -1,16 +1,16 @@
 #include "Material.h"
 #include <iostream>
-#include <string>
 #include <unordered_map>
 #include "Shader.h"
+#include "ShaderUniforms.h"
 #include "Texture.h"
 
-static std::unordered_map<TextureType, std::string> s_TextureSamplerNames = 
+static const std::unordered_map<TextureType, UniformHandle> s_TextureSamplers = 
 {
-    {TextureType::Diffuse, "textureSamplers.diffuse"},
-    {TextureType::Specular, "textureSamplers.specular"},
-    {TextureType::Emission, "textureSamplers.emission"},
-    {TextureType::Normal, "textureSamplers.normal"},
+    {TextureType::Diffuse, ShaderUniforms::DiffuseSampler},
+    {TextureType::Specular, ShaderUniforms::SpecularSampler},
+    {TextureType::Emission, ShaderUniforms::EmissionSampler},
+    {TextureType::Normal, ShaderUniforms::NormalSampler},
 };
 
 Material::Material() : 
@@ -36,18 +36,14 @@ void Material::SetActive()
 {
 	mShader->SetActive();
 
-    std::string samplerName;
-
     for (size_t i = 0; i < mTextures.size(); ++i)
     {
-        // Check if texture type with sampler name exists
-        auto iter = s_TextureSamplerNames.find(mTextures[i]->GetType());
-        if (iter != s_TextureSamplerNames.end())
+        // Check if texture type has a sampler
+        auto iter = s_TextureSamplers.find(mTextures[i]->GetType());
+        if (iter != s_TextureSamplers.end())
         {
-            samplerName = iter->second;
-
             // Set the proper texture sampler uniform in the shader
-            mShader->SetInt((samplerName), mTextures[i]->GetTextureUnit());
+            mShader->SetInt(iter->second, mTextures[i]->GetTextureUnit());
             
             mTextures[i]->BindTexture();
         }
@@ -74,3 +70,21 @@ void Material::AddTexture(Texture* t)
         break;
 	}
 }
+
+void Material::ClearTextures()
+{
+    mTextures.clear();
+
+    SetHasDiffuseTexture(false);
+    SetHasSpecularTexture(false);
+    SetHasEmissionTexture(false);
+    SetHasNormalTexture(false);
+}
+
+void Material::RequestTextureScreenSize(float pixels)
+{
+    for (Texture* texture : mTextures)
+    {
+        texture->RequestScreenSize(pixels);
+    }
+}
@@ -44,6 +44,13 @@ public:
 	// @param - Texture* for the new texture
 	void AddTexture(Texture* t);
 
+	// Removes all the material's textures and clears its texture statuses
+	void ClearTextures();
+
+	// Asks the material's textures to be sharp enough for a mesh covering a number of pixels on screen
+	// @param - float for how many pixels across the mesh covers
+	void RequestTextureScreenSize(float pixels);
+
 	// Gets the material's colors
 	// @returns - const MaterialColors& for the material's colors
 	const MaterialColors& GetMats() const { return mMats; }
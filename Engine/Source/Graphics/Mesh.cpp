@@ -6,7 +6,8 @@
 
 Mesh::Mesh(VertexBuffer* vb, Material* material) :
 	mVertexBuffer(vb),
-	mMaterial(material)
+	mMaterial(material),
+	mBounds({ glm::vec3(0.0f), glm::vec3(0.0f) })
 {
 }
 
@@ -17,6 +18,18 @@ Mesh::~Mesh()
 	delete mVertexBuffer;
 }
 
+Mesh* Mesh::Copy() const
+{
+	Mesh* mesh = new Mesh(mVertexBuffer->Copy(), mMaterial);
+	mesh->SetBounds(mBounds);
+	return mesh;
+}
+
+size_t Mesh::GetMemorySize() const
+{
+	return mVertexBuffer ? mVertexBuffer->GetSize() : 0;
+}
+
 void Mesh::Draw(const glm::mat4& modelMatrix)
 {
 	mMaterial->SetActive();
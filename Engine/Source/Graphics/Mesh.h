@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include "BoundingVolumes.h"
 
 class VertexBuffer;
 class Material;
@@ -27,6 +28,14 @@ public:
 
 	VertexBuffer* GetVertexBuffer() { return mVertexBuffer; }
 
+	// Creates a new mesh with a copy of this mesh's vertex buffer, the same material, and the same bounds
+	// @return - Mesh* for the copy
+	Mesh* Copy() const;
+
+	// Gets the number of bytes of video memory the mesh's vertex and index buffers use
+	// @return - size_t for the number of bytes
+	size_t GetMemorySize() const;
+
 	// Gets the mesh's material
 	// @return - Material* for the mesh's material
 	Material* GetMaterial() { return mMaterial; }
@@ -35,10 +44,21 @@ public:
 	// @param - Material* for the new material
 	void SetMaterial(Material* material) { mMaterial = material; }
 
+	// Gets the mesh's local space bounding box
+	// @return - const BoundingBox& for the bounds
+	const BoundingBox& GetBounds() const { return mBounds; }
+
+	// Sets the mesh's local space bounding box
+	// @param - const BoundingBox& for the new bounds
+	void SetBounds(const BoundingBox& bounds) { mBounds = bounds; }
+
 private:
 	// The mesh's vertex buffer
 	VertexBuffer* mVertexBuffer;
 
 	// The mesh's material
 	Material* mMaterial;
+
+	// The mesh's bounding box in local space
+	BoundingBox mBounds;
 };
@@ -1,5 +1,7 @@
 #include "Model.h"
+#include <algorithm>
 #include <iostream>
+#include <utility>
 #include "../Graphics/Mesh.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../MemoryManager/AssetManager.h"
@@ -7,6 +9,8 @@
 Model::Model() :
 	mDirectory(),
 	mSkeleton(nullptr),
+	mInstancedMeshes(),
+	mBounds({ glm::vec3(0.0f), glm::vec3(0.0f) }),
 	mHasAnimations(false)
 {
 }
@@ -17,15 +21,49 @@ Model::~Model()
 
 	mMeshes.clear();
 
+	for (Mesh* mesh : mInstancedMeshes)
+	{
+		delete mesh;
+	}
+	mInstancedMeshes.clear();
+
 	mMaterialMap.clear();
 
 	delete mSkeleton;
 }
 
+void Model::AddMesh(Mesh* m)
+{
+	if (mMeshes.empty())
+	{
+		mBounds = m->GetBounds();
+	}
+	else
+	{
+		ExpandBoundingBox(mBounds, m->GetBounds());
+	}
+
+	mMeshes.emplace_back(m);
+}
+
+void Model::SwapMeshes(Model& other)
+{
+	std::swap(mMeshes, other.mMeshes);
+	std::swap(mMaterialMap, other.mMaterialMap);
+	std::swap(mInstancedMeshes, other.mInstancedMeshes);
+	std::swap(mBounds, other.mBounds);
+}
+
 void Model::MakeInstance(unsigned int numInstances)
 {
-	for (auto m : mMeshes)
+	for (Mesh*& m : mMeshes)
 	{
+		if (std::find(mInstancedMeshes.begin(), mInstancedMeshes.end(), m) == mInstancedMeshes.end())
+		{
+			m = m->Copy();
+			mInstancedMeshes.emplace_back(m);
+		}
+
 		m->GetVertexBuffer()->MakeInstance(numInstances);
 	}
 }
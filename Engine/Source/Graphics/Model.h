@@ -3,6 +3,8 @@
 #include <string>
 #include <unordered_map>
 #include <glm/glm.hpp>
+#include "BoundingVolumes.h"
+#include "../MemoryManager/AssetId.h"
 
 class Material;
 class Mesh;
@@ -17,28 +19,33 @@ public:
 	
 	// Model destructor:
 	// Meshs and Materials are owned/deleted by AssetManager.
-	// Don't call delete on any meshes and materials here.
+	// Don't call delete on any meshes and materials here (except the model's instanced copies).
 	~Model();
 
 	// Makes this an instanced model so that multiple instances of the same
 	// vertices can be rendered with one draw function call. This generates 
 	// a new buffer and loops through all the meshes to enable its array attributes
-	// and points them to the data needed per instance.
+	// and points them to the data needed per instance. Cached meshes can be shared
+	// with other models, so each one is swapped for a copy the model owns first.
 	// @param - unsigned int for the number of instances to draw
 	void MakeInstance(unsigned int numInstances);
 
-	// Adds a mesh to the model's vector of meshes
+	// Adds a mesh to the model's vector of meshes and grows the model's bounds to fit it
 	// @param - Mesh* for the new mesh
-	void AddMesh(Mesh* m) { mMeshes.emplace_back(m); }
+	void AddMesh(Mesh* m);
 
 	// Gets the model's vector of meshes (can change data)
 	// @return - std::vector<Mesh*>& for the vector of meshes
 	std::vector<Mesh*>& GetMeshes() { return mMeshes; }
 
 	// Gets a material by name through the entity's material map
-	// @param - const std::string& for the name of the material
-	// @return - Material* for the desired material
-	Material* GetMaterial(const std::string& name) { return mMaterialMap[name]; }
+	// @param - AssetId for the name of the material
+	// @return - Material* for the desired material (nullptr if the model doesn't have it)
+	Material* GetMaterial(AssetId name)
+	{
+		auto iter = mMaterialMap.find(name);
+		return iter != mMaterialMap.end() ? iter->second : nullptr;
+	}
 
 	// Return the number of meshes this model has
 	// @return - size_t for num of meshes
@@ -69,19 +76,27 @@ public:
 	// @param - Skeleton* for the skeleton
 	void SetSkeleton(Skeleton* skeleton) { mSkeleton = skeleton; }
 
-	void SaveMaterial(const std::string& name, Material* material) { mMaterialMap[name] = material; }
+	void SaveMaterial(AssetId name, Material* material) { mMaterialMap[name] = material; }
+
+	// Swaps meshes (with their instanced copies), materials, and bounds with another model, so a model can be rebuilt in place
+	// @param - Model& for the other model
+	void SwapMeshes(Model& other);
 
 	void SetHasAnimations(bool anim) { mHasAnimations = anim; }
 
 	Skeleton* GetSkeleton() { return mSkeleton; }
 
+	// Gets the model's local space bounding box (union of all its meshes' bounds)
+	// @return - const BoundingBox& for the bounds
+	const BoundingBox& GetBounds() const { return mBounds; }
+
 private:
 	// Model's vector of meshes
 	std::vector<Mesh*> mMeshes;
 
 	// Map of the model's materials. Each mesh of this model
 	// is indexed to one of these materials.
-	std::unordered_map<std::string, Material*> mMaterialMap;
+	std::unordered_map<AssetId, Material*> mMaterialMap;
 
 	// The model's file directory/name
 	std::string mDirectory;
@@ -89,6 +104,12 @@ private:
 	// Model's skeleton for animation
 	Skeleton* mSkeleton;
 
+	// Copies of cached meshes the model made for instancing, deleted with the model
+	std::vector<Mesh*> mInstancedMeshes;
+
+	// Model's local space bounding box
+	BoundingBox mBounds;
+
 	// Bool for if this model has animations
 	bool mHasAnimations;
 };
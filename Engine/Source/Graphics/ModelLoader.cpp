@@ -1,84 +1,171 @@
 #include "ModelLoader.h"
+#include <cstdio>
 #include <iostream>
+#include <latch>
 #include <queue>
 #include <vector>
 #include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
 #include "../Animation/Animation.h"
 #include "../Animation/Skeleton.h"
 #include "../MemoryManager/AssetManager.h"
+#include "../MemoryManager/DerivedDataCache.h"
+#include "../Multithreading/JobManager.h"
 #include "../Util/Logger.h"
+#include "CookedModel.h"
 #include "Material.h"
 #include "Mesh.h"
 #include "Model.h"
 #include "VertexBuffer.h"
 
+// Texture types a material can have, in the order their textures are added to the material
+static const aiTextureType MATERIAL_TEXTURE_TYPES[] = { aiTextureType_DIFFUSE, aiTextureType_SPECULAR, aiTextureType_EMISSIVE, aiTextureType_NORMALS };
+
+// Job that decodes one of an imported model's textures in place, then counts down the latch its caller waits on
+class TextureDecodeJob : public JobManager::Job
+{
+public:
+	TextureDecodeJob(ModelLoader::ImportedTexture* texture, std::latch* done) :
+		JobManager::Job(true),
+		mTexture(texture),
+		mDone(done)
+	{}
+
+	void DoJob() override
+	{
+		mTexture->data = Texture::Decode(mTexture->fileName, mTexture->type);
+		mDone->count_down();
+	}
+
+private:
+	ModelLoader::ImportedTexture* mTexture;
+	std::latch* mDone;
+};
 
 Model* ModelLoader::Load(const std::string& fileName, AssetManager* am)
+{
+	ImportedModel* imported = ModelLoader::Import(fileName);
+
+	if (!imported)
+	{
+		return nullptr;
+	}
+
+	ModelLoader::DecodeTextures(imported, am);
+
+	return ModelLoader::Finish(imported, am);
+}
+
+ModelLoader::ImportedModel::~ImportedModel()
+{
+	for (Animation* anim : animations)
+	{
+		delete anim;
+	}
+	delete skeleton;
+}
+
+ModelLoader::ImportedModel* ModelLoader::Import(const std::string& fileName)
 {
 	LOG_DEBUG("Loading model: " + fileName);
 	std::cout << "Loading model: " << fileName << "\n";
 
-	Assimp::Importer import;
-	const aiScene* scene = import.ReadFile(fileName, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace);
+	// The cooked file is keyed by the model file's contents, so editing the model cooks it again
+	uint64_t sourceHash = 0;
+	if (!DerivedDataCache::HashFile(fileName, sourceHash))
+	{
+		// Without the model file, use whatever it was last cooked from
+		ImportedModel* imported = nullptr;
+		if (CookedModel::FindSourceHash(fileName, sourceHash))
+		{
+			imported = CookedModel::Load(fileName, sourceHash);
+		}
+
+		if (imported)
+		{
+			LOG_WARNING("Couldn't read model file, using its last cooked file: " + fileName);
+		}
+		else
+		{
+			LOG_ERROR("Couldn't read model file: " + fileName);
+		}
+		return imported;
+	}
+
+	ImportedModel* imported = CookedModel::Load(fileName, sourceHash);
+	if (imported)
+	{
+		return imported;
+	}
+
+	imported = ModelLoader::ImportScene(fileName);
+	if (imported)
+	{
+		// Cook the model so the next import can skip Assimp
+		CookedModel::Save(imported, sourceHash);
+	}
+
+	return imported;
+}
+
+ModelLoader::ImportedModel* ModelLoader::ImportScene(const std::string& fileName)
+{
+	Assimp::Importer importer;
+	const aiScene* scene = importer.ReadFile(fileName, MODEL_IMPORT_FLAGS);
 
 	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
 	{
-		LOG_ERROR("ASSIMP parsing the object's file:: " + std::string(import.GetErrorString()));
-		std::cout << "ERROR ASSIMP parsing the object's file:: " << import.GetErrorString() << "\n";
+		LOG_ERROR("ASSIMP parsing the object's file:: " + std::string(importer.GetErrorString()));
+		std::cout << "ERROR ASSIMP parsing the object's file:: " << importer.GetErrorString() << "\n";
 		return nullptr;
 	}
 
-	Model* model = new Model();
-	model->SetName(fileName);
-
-	Skeleton* skeleton = nullptr;
+	ImportedModel* imported = new ImportedModel();
+	imported->fileName = fileName;
+	imported->skeleton = nullptr;
 
 	bool hasAnimations = scene->HasAnimations();
 
 	if (hasAnimations)
 	{
-		model->SetHasAnimations(true);
-		skeleton = new Skeleton(scene, fileName);
-		model->SetSkeleton(skeleton);
+		imported->skeleton = new Skeleton(scene, fileName);
 
 		// Load animations
-		for (int i = 0; i < scene->mNumAnimations; ++i)
+		for (unsigned int i = 0; i < scene->mNumAnimations; ++i)
 		{
 			std::string animName = fileName + "/" + scene->mAnimations[i]->mName.C_Str();
-
-			// Check to see if animation was already loaded
-			Animation* anim = am->LoadAnimation(animName);
-
-			if (!anim)
-			{
-				// Create a new animation
-				anim = new Animation(scene->mAnimations[i], skeleton, animName);
-
-				// Save the animation into AssetManager
-				am->SaveAnimation(animName, anim);
-			}
+			imported->animations.emplace_back(new Animation(scene->mAnimations[i], imported->skeleton, animName));
 		}
 	}
 
-	ModelLoader::ProcessNodes(scene->mRootNode, scene, model, skeleton, am, hasAnimations);
+	// Go through the nodes breadth first, converting each mesh the first time a node references it
+	// and reading its material the first time a mesh uses it
+	imported->meshes.resize(scene->mNumMeshes);
+	imported->materials.resize(scene->mNumMaterials);
+	std::vector<bool> isImported(scene->mNumMeshes, false);
+	std::vector<bool> isMaterialImported(scene->mNumMaterials, false);
+	std::unordered_map<std::string, unsigned int> textureIndices;
 
-	return model;
-}
-
-void ModelLoader::ProcessNodes(aiNode* node, const aiScene* scene, Model* targetModel, Skeleton* skeleton, AssetManager* am, bool hasAnims)
-{
 	std::queue<aiNode*> nodeQ;
-	nodeQ.push(node);
-	aiNode* currNode = nullptr;
+	nodeQ.push(scene->mRootNode);
 	while (!nodeQ.empty())
 	{
-		currNode = nodeQ.front();
+		aiNode* currNode = nodeQ.front();
 		for (unsigned int i = 0; i < currNode->mNumMeshes; ++i)
 		{
-			aiMesh* mesh = scene->mMeshes[currNode->mMeshes[i]];
-			Mesh* newMesh = ModelLoader::ProcessMesh(mesh, scene, targetModel, skeleton, am, hasAnims);
-			targetModel->AddMesh(newMesh);
+			unsigned int meshIndex = currNode->mMeshes[i];
+			if (!isImported[meshIndex])
+			{
+				imported->meshes[meshIndex] = ModelLoader::ImportMesh(scene->mMeshes[meshIndex], imported->skeleton, hasAnimations);
+				isImported[meshIndex] = true;
+
+				unsigned int materialIndex = imported->meshes[meshIndex].materialIndex;
+				if (materialIndex < scene->mNumMaterials && !isMaterialImported[materialIndex])
+				{
+					imported->materials[materialIndex] = ModelLoader::ImportMaterial(imported, scene->mMaterials[materialIndex], textureIndices);
+					isMaterialImported[materialIndex] = true;
+				}
+			}
+			imported->meshOrder.emplace_back(meshIndex);
 		}
 		nodeQ.pop();
 		for (unsigned int i = 0; i < currNode->mNumChildren; ++i)
@@ -89,109 +176,312 @@ void ModelLoader::ProcessNodes(aiNode* node, const aiScene* scene, Model* target
 			}
 		}
 	}
+
+	// Point each mesh at its converted vertices now that the meshes won't move anymore
+	for (ImportedMesh& mesh : imported->meshes)
+	{
+		if (hasAnimations)
+		{
+			mesh.vertexData = mesh.animVertices.data();
+			mesh.numVertices = mesh.animVertices.size();
+		}
+		else
+		{
+			mesh.vertexData = mesh.vertices.data();
+			mesh.numVertices = mesh.vertices.size();
+		}
+		mesh.indexData = mesh.indices.data();
+		mesh.numIndices = mesh.indices.size();
+	}
+
+	return imported;
+}
+
+bool ModelLoader::Cook(const std::string& fileName)
+{
+	uint64_t sourceHash = 0;
+	if (!DerivedDataCache::HashFile(fileName, sourceHash))
+	{
+		return false;
+	}
+
+	ImportedModel* imported = ModelLoader::ImportScene(fileName);
+	if (!imported)
+	{
+		return false;
+	}
+
+	bool isCooked = CookedModel::Save(imported, sourceHash);
+	delete imported;
+	return isCooked;
 }
 
-Mesh* ModelLoader::ProcessMesh(aiMesh* mesh, const aiScene* scene, Model* targetModel, Skeleton* skeleton, AssetManager* am, bool hasAnims)
+void ModelLoader::DecodeTextures(ImportedModel* imported, AssetManager* am)
 {
-	std::string meshName = mesh->mName.C_Str();
+	// Skip the textures another model already loaded
+	std::vector<ImportedTexture*> textures;
+	for (ImportedTexture& texture : imported->textures)
+	{
+		if (!am->LoadTexture(texture.fileName))
+		{
+			textures.emplace_back(&texture);
+		}
+	}
+
+	if (textures.empty())
+	{
+		return;
+	}
+
+	// Decode the rest in parallel on the async loader's workers, each job writes only its own texture.
+	// Only these jobs are waited on, not the other loads the workers are running.
+	JobManager* jobManager = am->GetLoadJobManager();
+	std::latch done(static_cast<std::ptrdiff_t>(textures.size()));
+	for (ImportedTexture* texture : textures)
+	{
+		jobManager->AddJob(new TextureDecodeJob(texture, &done));
+	}
+	done.wait();
+}
 
-	LOG_DEBUG("Loading mesh: " + meshName);
-	std::cout << "Loading mesh: " << meshName << "\n";
+Model* ModelLoader::Finish(ImportedModel* imported, AssetManager* am, bool updateMaterials)
+{
+	Model* model = new Model();
+	model->SetName(imported->fileName);
 
-	// Check to see if mesh has already been loaded (only for models that might have the exact same mesh with same name)
-	Mesh* newMesh = am->LoadMesh(meshName);
+	bool hasAnimations = imported->skeleton != nullptr;
 
-	// Create a new mesh
-	if (!newMesh)
+	if (hasAnimations)
 	{
-		std::vector<unsigned int> indices;
-		indices.reserve(static_cast<size_t>(mesh->mNumFaces * 3));
+		model->SetHasAnimations(true);
+		model->SetSkeleton(imported->skeleton);
 
-		// Loop through the mesh's faces to get indices
-		for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
+		for (Animation* anim : imported->animations)
 		{
-			aiFace face = mesh->mFaces[i];
-			// Retrieve index info of the face
-			for (unsigned int j = 0; j < face.mNumIndices; ++j)
+			// Check to see if animation was already loaded
+			if (!am->LoadAnimation(anim->GetName()))
+			{
+				// Save the animation into AssetManager
+				am->SaveAnimation(anim->GetName(), anim);
+			}
+			else
 			{
-				indices.emplace_back(face.mIndices[j]);
+				delete anim;
 			}
 		}
 
-		bool hasTextures = mesh->HasTextureCoords(0);
+		// The model and AssetManager own these now
+		imported->skeleton = nullptr;
+		imported->animations.clear();
+	}
+
+	// Upload the decoded textures so the materials find them in the cache. Textures that
+	// weren't decoded are loaded by the materials instead.
+	for (ImportedTexture& texture : imported->textures)
+	{
+		if (texture.data.pixels && !am->LoadTexture(texture.fileName))
+		{
+			am->SaveTexture(texture.fileName, am->CreateTexture(texture.fileName, texture.type, std::move(texture.data)));
+		}
+	}
+
+	// Each cached material only gets its textures again once, even if several meshes use it
+	std::vector<bool> isMaterialUpdated(imported->materials.size(), !updateMaterials);
+
+	size_t vertexSize = hasAnimations ? sizeof(VertexAnim) : sizeof(Vertex);
+	VertexLayout vertexLayout = hasAnimations ? VertexLayout::VertexAnim : VertexLayout::Vertex;
 
-		VertexBuffer* vb = nullptr;
+	for (unsigned int meshIndex : imported->meshOrder)
+	{
+		ImportedMesh& importedMesh = imported->meshes[meshIndex];
 
-		if (!hasAnims)
+		LOG_DEBUG("Loading mesh: " + importedMesh.name);
+		std::cout << "Loading mesh: " << importedMesh.name << "\n";
+
+		// Check to see if mesh has already been loaded (the nodes can reference the same mesh more than once)
+		std::string meshKey = ModelLoader::GetMeshKey(imported->fileName, meshIndex);
+		Mesh* newMesh = am->LoadMesh(meshKey);
+
+		if (!newMesh)
 		{
-			std::vector<Vertex> vertices;
-			vertices.reserve(static_cast<size_t>(mesh->mNumVertices));
+			// Load material
+			bool updateTextures = importedMesh.materialIndex < isMaterialUpdated.size() && !isMaterialUpdated[importedMesh.materialIndex];
+			Material* mat = ModelLoader::LoadMaterial(imported, importedMesh, model, am, hasAnimations, updateTextures);
+			if (updateTextures)
+			{
+				isMaterialUpdated[importedMesh.materialIndex] = true;
+			}
+
+			size_t vertexBytes = vertexSize * importedMesh.numVertices;
+			size_t indexBytes = sizeof(unsigned int) * importedMesh.numIndices;
 
-			// Loop through vertices and add to our vector of vertices
-			for (unsigned int i = 0; i < mesh->mNumVertices; ++i)
+			// Another mesh in the file might be exactly the same. The key is only a hash, so the buffers are
+			// compared too, and a different mesh with the same hash just isn't shared.
+			std::string contentKey;
+			if (am->GetDeduplicateMeshes())
 			{
-				vertices.emplace_back(GetVertexData(mesh, hasTextures, i));
+				contentKey = ModelLoader::GetMeshContentKey(importedMesh, vertexSize, mat);
+				newMesh = am->LoadMesh(contentKey);
+
+				if (newMesh && (newMesh->GetMaterial() != mat || !newMesh->GetVertexBuffer()->HasData(importedMesh.vertexData, importedMesh.indexData, vertexBytes, indexBytes)))
+				{
+					LOG_WARNING("Mesh content key collision, not sharing mesh: " + importedMesh.name);
+					newMesh = nullptr;
+					contentKey.clear();
+				}
+			}
+
+			// Create a new mesh
+			if (!newMesh)
+			{
+				// Vertices go straight from the imported data (or the mapped cooked file) into the buffers
+				VertexBuffer* vb = new VertexBuffer(importedMesh.vertexData, importedMesh.indexData, vertexBytes, indexBytes,
+					importedMesh.numVertices, importedMesh.numIndices, vertexLayout);
+
+				newMesh = new Mesh(vb, mat);
+				newMesh->SetBounds(importedMesh.bounds);
+
+				if (!contentKey.empty())
+				{
+					am->SaveMesh(contentKey, newMesh);
+				}
 			}
 
-			vb = new VertexBuffer(vertices.data(), indices.data(), sizeof(Vertex) * vertices.size(), sizeof(unsigned int) * indices.size(),
-				vertices.size(), indices.size(), VertexLayout::Vertex);
+			// A shared mesh is cached under each key it's loaded by
+			am->SaveMesh(meshKey, newMesh);
 		}
-		else
+
+		model->AddMesh(newMesh);
+	}
+
+	delete imported;
+
+	return model;
+}
+
+std::string ModelLoader::GetMeshKey(const std::string& fileName, unsigned int meshIndex)
+{
+	return fileName + "#mesh" + std::to_string(meshIndex);
+}
+
+std::string ModelLoader::GetMaterialKey(const std::string& fileName, const std::string& materialName)
+{
+	return fileName + "#" + materialName;
+}
+
+std::string ModelLoader::GetMeshContentKey(const ImportedMesh& mesh, size_t vertexSize, const Material* material)
+{
+	uint64_t hash = DerivedDataCache::HashBytes(mesh.vertexData, vertexSize * mesh.numVertices);
+	hash = DerivedDataCache::HashBytes(mesh.indexData, sizeof(unsigned int) * mesh.numIndices, hash);
+	hash = DerivedDataCache::CombineHash(hash, vertexSize);
+	hash = DerivedDataCache::CombineHash(hash, reinterpret_cast<uintptr_t>(material));
+
+	char key[32] = {};
+	std::snprintf(key, sizeof(key), "mesh:%016llx", static_cast<unsigned long long>(hash));
+	return key;
+}
+
+size_t ModelLoader::GetUploadSize(const ImportedModel* imported)
+{
+	size_t vertexSize = imported->skeleton ? sizeof(VertexAnim) : sizeof(Vertex);
+	size_t bytes = 0;
+	for (const ImportedMesh& mesh : imported->meshes)
+	{
+		bytes += vertexSize * mesh.numVertices + sizeof(unsigned int) * mesh.numIndices;
+	}
+	return bytes;
+}
+
+ModelLoader::ImportedMesh ModelLoader::ImportMesh(const aiMesh* mesh, Skeleton* skeleton, bool hasAnims)
+{
+	ImportedMesh importedMesh = {};
+	importedMesh.name = mesh->mName.C_Str();
+	importedMesh.materialIndex = mesh->mMaterialIndex;
+	importedMesh.bounds = { glm::vec3(0.0f), glm::vec3(0.0f) };
+
+	importedMesh.indices.reserve(static_cast<size_t>(mesh->mNumFaces * 3));
+
+	// Loop through the mesh's faces to get indices
+	for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
+	{
+		const aiFace& face = mesh->mFaces[i];
+		// Retrieve index info of the face
+		for (unsigned int j = 0; j < face.mNumIndices; ++j)
 		{
-			std::vector<VertexAnim> vertices;
-			vertices.reserve(static_cast<size_t>(mesh->mNumVertices));
+			importedMesh.indices.emplace_back(face.mIndices[j]);
+		}
+	}
 
-			// Loop through vertices and add to our vector of vertices
-			for (unsigned int i = 0; i < mesh->mNumVertices; ++i)
-			{
-				Vertex v = GetVertexData(mesh, hasTextures, i);
+	bool hasTextures = mesh->HasTextureCoords(0);
 
-				VertexAnim vertex = { v.pos, v.normal, v.uv, v.tangent, v.bitangent };
+	if (!hasAnims)
+	{
+		importedMesh.vertices.reserve(static_cast<size_t>(mesh->mNumVertices));
 
-				vertices.emplace_back(vertex);
-			}
+		// Loop through vertices and add to our vector of vertices
+		for (unsigned int i = 0; i < mesh->mNumVertices; ++i)
+		{
+			importedMesh.vertices.emplace_back(GetVertexData(mesh, hasTextures, i));
+		}
+	}
+	else
+	{
+		std::vector<VertexAnim>& vertices = importedMesh.animVertices;
+		vertices.reserve(static_cast<size_t>(mesh->mNumVertices));
 
-			// Add bone id and weights to vertex
-			for (int i = 0; i < mesh->mNumBones; ++i)
-			{
-				// Get bone id from skeleton
-				int boneID = skeleton->GetBoneID(mesh->mBones[i]->mName.C_Str());
+		// Loop through vertices and add to our vector of vertices
+		for (unsigned int i = 0; i < mesh->mNumVertices; ++i)
+		{
+			Vertex v = GetVertexData(mesh, hasTextures, i);
 
-				aiVertexWeight* boneWeightsArray = mesh->mBones[i]->mWeights;
+			VertexAnim vertex = { v.pos, v.normal, v.uv, v.tangent, v.bitangent };
 
-				int numWeights = mesh->mBones[i]->mNumWeights;
+			vertices.emplace_back(vertex);
+		}
 
-				for (int weightIndex = 0; weightIndex < numWeights; ++weightIndex)
-				{
-					int vertexID = boneWeightsArray[weightIndex].mVertexId;
-					float weight = boneWeightsArray[weightIndex].mWeight;
+		// Add bone id and weights to vertex
+		for (unsigned int i = 0; i < mesh->mNumBones; ++i)
+		{
+			// Get bone id from skeleton
+			int boneID = skeleton->GetBoneID(mesh->mBones[i]->mName.C_Str());
+
+			aiVertexWeight* boneWeightsArray = mesh->mBones[i]->mWeights;
+
+			int numWeights = mesh->mBones[i]->mNumWeights;
 
-					VertexAnim& v = vertices[vertexID];
-					for (int j = 0; j < MAX_BONE_INFLUENCE; ++j)
+			for (int weightIndex = 0; weightIndex < numWeights; ++weightIndex)
+			{
+				int vertexID = boneWeightsArray[weightIndex].mVertexId;
+				float weight = boneWeightsArray[weightIndex].mWeight;
+
+				VertexAnim& v = vertices[vertexID];
+				for (int j = 0; j < MAX_BONE_INFLUENCE; ++j)
+				{
+					if (v.boneIDs[j] < 0)
 					{
-						if (v.boneIDs[j] < 0)
-						{
-							v.boneIDs[j] = boneID;
-							v.weights[j] = weight;
-							break;
-						}
+						v.boneIDs[j] = boneID;
+						v.weights[j] = weight;
+						break;
 					}
 				}
 			}
-
-			vb = new VertexBuffer(vertices.data(), indices.data(), sizeof(VertexAnim) * vertices.size(), sizeof(unsigned int) * indices.size(),
-				vertices.size(), indices.size(), VertexLayout::VertexAnim);
 		}
+	}
 
-		// Load material
-		Material* mat = ModelLoader::LoadMaterial(scene, mesh, targetModel, am, hasAnims);
-
-		newMesh = new Mesh(vb, mat);
-
-		am->SaveMesh(meshName, newMesh);
+	// Save the mesh's local space bounds for culling
+	if (mesh->mNumVertices > 0)
+	{
+		BoundingBox bounds = { glm::vec3(mesh->mVertices[0].x, mesh->mVertices[0].y, mesh->mVertices[0].z), glm::vec3(mesh->mVertices[0].x, mesh->mVertices[0].y, mesh->mVertices[0].z) };
+		for (unsigned int i = 1; i < mesh->mNumVertices; ++i)
+		{
+			glm::vec3 pos(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+			bounds.min = glm::min(bounds.min, pos);
+			bounds.max = glm::max(bounds.max, pos);
+		}
+		importedMesh.bounds = bounds;
 	}
 
-	return newMesh;
+	return importedMesh;
 }
 
 const Vertex ModelLoader::GetVertexData(const aiMesh* mesh, bool hasTextures, unsigned int index)
@@ -222,83 +512,105 @@ const Vertex ModelLoader::GetVertexData(const aiMesh* mesh, bool hasTextures, un
 	return vertex;
 }
 
-Material* ModelLoader::LoadMaterial(const aiScene* scene, aiMesh* mesh, Model* targetModel, AssetManager* am, bool hasAnims)
+Material* ModelLoader::LoadMaterial(const ImportedModel* imported, const ImportedMesh& mesh, Model* targetModel, AssetManager* am, bool hasAnims, bool updateTextures)
 {
-	if (mesh->mMaterialIndex >= 0)
+	if (mesh.materialIndex < imported->materials.size())
 	{
-		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-		std::string name = material->GetName().C_Str();
+		const ImportedMaterial& material = imported->materials[mesh.materialIndex];
 
 		// Check to see if it's in the asset manager map
-		Material* mat = am->LoadMaterial(name);
+		std::string materialKey = ModelLoader::GetMaterialKey(imported->fileName, material.name);
+		Material* mat = am->LoadMaterial(materialKey);
 
 		// Create a new material if it's not in the asset manager
 		if (!mat)
 		{
-			LOG_DEBUG("Loading material: " + name + " " + std::to_string(mesh->mMaterialIndex));
-			std::cout << "Loading material: " << name << " " << mesh->mMaterialIndex << "\n";
+			LOG_DEBUG("Loading material: " + material.name + " " + std::to_string(mesh.materialIndex));
+			std::cout << "Loading material: " << material.name << " " << mesh.materialIndex << "\n";
 
 			mat = new Material();
-			mat->SetShader(am->LoadShader("phong"));
+			mat->SetShader(am->LoadShader("phong"_id));
 			if (hasAnims)
 			{
-				mat->SetShader(am->LoadShader("skinned"));
+				mat->SetShader(am->LoadShader("skinned"_id));
+			}
+
+			// Diffuse, specular, emissive, then normal textures
+			for (unsigned int textureIndex : material.textures)
+			{
+				const ImportedTexture& texture = imported->textures[textureIndex];
+				mat->AddTexture(am->LoadTexture(texture.fileName, texture.type));
 			}
 
-			targetModel->SaveMaterial(name, mat);
-			// Diffuse textures
-			ModelLoader::LoadMaterialTextures(material, aiTextureType_DIFFUSE, mat, targetModel, am);
-			// Specular textures
-			ModelLoader::LoadMaterialTextures(material, aiTextureType_SPECULAR, mat, targetModel, am);
-			// Emissive textures
-			ModelLoader::LoadMaterialTextures(material, aiTextureType_EMISSIVE, mat, targetModel, am);
-			// Normal textures
-			ModelLoader::LoadMaterialTextures(material, aiTextureType_NORMALS, mat, targetModel, am);
-
-			am->SaveMaterial(name, mat);
+			am->SaveMaterial(materialKey, mat);
+		}
+		else if (updateTextures)
+		{
+			// Keep the same material so the game's changes to it stay, only its textures come from the file again
+			mat->ClearTextures();
+			for (unsigned int textureIndex : material.textures)
+			{
+				const ImportedTexture& texture = imported->textures[textureIndex];
+				mat->AddTexture(am->LoadTexture(texture.fileName, texture.type));
+			}
+			am->UpdateMaterial(materialKey);
 		}
 
+		targetModel->SaveMaterial(material.name, mat);
+
 		return mat;
 	}
 
 	return nullptr;
 }
 
-void ModelLoader::LoadMaterialTextures(aiMaterial* mat, aiTextureType aiTextureType, Material* material, Model* targetModel, AssetManager* am)
+ModelLoader::ImportedMaterial ModelLoader::ImportMaterial(ImportedModel* imported, const aiMaterial* material, std::unordered_map<std::string, unsigned int>& textureIndices)
 {
-	const std::string& directory = targetModel->GetName();
+	ImportedMaterial importedMaterial = {};
+	importedMaterial.name = material->GetName().C_Str();
 
-	aiString str;
-	std::string path = directory.substr(0, directory.find_last_of('/') + 1);
-
-	for (unsigned int i = 0; i < mat->GetTextureCount(aiTextureType); ++i)
+	for (aiTextureType aiType : MATERIAL_TEXTURE_TYPES)
 	{
-		if (AI_SUCCESS == mat->GetTexture(aiTextureType, i, &str))
+		aiString str;
+		for (unsigned int i = 0; i < material->GetTextureCount(aiType); ++i)
 		{
-			path = path + (str.C_Str());
-
-			// Set the texture's type
-			TextureType type = TextureType::None;
-			switch (aiTextureType)
+			if (AI_SUCCESS == material->GetTexture(aiType, i, &str))
 			{
-			case aiTextureType_DIFFUSE:
-				type = TextureType::Diffuse;
-				break;
-			case aiTextureType_SPECULAR:
-				type = TextureType::Specular;
-				break;
-			case aiTextureType_EMISSIVE:
-				type = TextureType::Emission;
-				break;
-			case aiTextureType_NORMALS:
-				type = TextureType::Normal;
-				break;
+				// Each file is only added to the model's textures once
+				std::string textureFileName = ModelLoader::GetTextureFileName(imported->fileName, str);
+				auto iter = textureIndices.find(textureFileName);
+				if (iter == textureIndices.end())
+				{
+					iter = textureIndices.emplace(textureFileName, static_cast<unsigned int>(imported->textures.size())).first;
+					imported->textures.emplace_back(ImportedTexture{ textureFileName, ModelLoader::GetTextureType(aiType), TextureData() });
+				}
+				importedMaterial.textures.emplace_back(iter->second);
 			}
-			// Load the texture
-			Texture* t = am->LoadTexture(path, type);
-
-			// Add the texture to the material
-			material->AddTexture(t);
 		}
 	}
-}
\ No newline at end of file
+
+	return importedMaterial;
+}
+
+std::string ModelLoader::GetTextureFileName(const std::string& modelFileName, const aiString& texturePath)
+{
+	return modelFileName.substr(0, modelFileName.find_last_of('/') + 1) + texturePath.C_Str();
+}
+
+TextureType ModelLoader::GetTextureType(aiTextureType aiTextureType)
+{
+	// Set the texture's type
+	switch (aiTextureType)
+	{
+	case aiTextureType_DIFFUSE:
+		return TextureType::Diffuse;
+	case aiTextureType_SPECULAR:
+		return TextureType::Specular;
+	case aiTextureType_EMISSIVE:
+		return TextureType::Emission;
+	case aiTextureType_NORMALS:
+		return TextureType::Normal;
+	default:
+		return TextureType::None;
+	}
+}
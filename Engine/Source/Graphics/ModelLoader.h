@@ -1,39 +1,145 @@
 #pragma once
 #include <string>
+#include <unordered_map>
+#include <vector>
+#include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include "../Util/MappedFile.h"
+#include "BoundingVolumes.h"
+#include "Texture.h"
 #include "VertexLayouts.h"
 
+class Animation;
 class AssetManager;
 class Material;
 class Mesh;
 class Model;
 class Skeleton;
 
+// Flags every model is read with by Assimp (part of a cooked model's cache key)
+const unsigned int MODEL_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace;
+
 namespace ModelLoader
 {
-	// Loads a 3D model by file name using Assimp, and loads all meshes, textures/materials, and animations
+	// Struct for a mesh's vertex data, either converted from Assimp or pointing into a cooked model file
+	struct ImportedMesh
+	{
+		std::string name;						// mesh name from the file (not unique, so meshes are cached with GetMeshKey())
+		std::vector<Vertex> vertices;			// converted vertices if the model has no animations
+		std::vector<VertexAnim> animVertices;	// converted vertices with bone weights if the model has animations
+		std::vector<unsigned int> indices;		// converted triangle indices
+		const void* vertexData;					// vertices laid out the way the vertex buffer expects them
+		const unsigned int* indexData;			// triangle indices
+		size_t numVertices;						// number of vertices
+		size_t numIndices;						// number of indices
+		BoundingBox bounds;						// local space bounds
+		unsigned int materialIndex;				// index of the mesh's material in the model's materials
+	};
+
+	// Struct for a texture one of the model's materials uses
+	struct ImportedTexture
+	{
+		std::string fileName;	// texture file name used to cache the texture
+		TextureType type;		// type the material uses the texture as
+		TextureData data;		// decoded image (empty until it's decoded)
+	};
+
+	// Struct for a material the model's meshes use
+	struct ImportedMaterial
+	{
+		std::string name;					// material name used to cache the material
+		std::vector<unsigned int> textures;	// index of each texture in the model's textures, in the order they're added to the material
+	};
+
+	// Struct for everything read from a model file that doesn't need OpenGL. Importing
+	// can run on a worker thread, then Finish() creates the buffers on the render thread.
+	struct ImportedModel
+	{
+		// Deletes the skeleton and animations if Finish() didn't take them
+		~ImportedModel();
+
+		std::string fileName;						// model file name
+		Skeleton* skeleton;							// skeleton if the model has animations
+		std::vector<Animation*> animations;			// animations read from the file
+		std::vector<ImportedMesh> meshes;			// meshes, indexed the same as the file's meshes
+		std::vector<unsigned int> meshOrder;		// mesh index of every mesh the nodes reference, in the order they're added to the model
+		std::vector<ImportedMaterial> materials;	// materials, indexed the same as the file's materials (only the ones meshes use are filled in)
+		std::vector<ImportedTexture> textures;		// textures of the materials the meshes use, each file once
+		MappedFile cookedFile;						// cooked model file the meshes point into (not open if the model was read with Assimp)
+	};
+
+	// Loads a 3D model by file name, and loads all meshes, textures/materials, and animations
 	// @param - const std::string& for the file name of the model
 	// @param - AssetManager* for the engine's asset manager to cache meshes, textures, and animations
 	Model* Load(const std::string& fileName, AssetManager* am);
 
-	// Recursively goes through the scene's nodes and loads any meshes
-	// @param - aiNode* for the current scene node that's being processed
-	// @param - const aiScene* for the model's assimp scene
-	// @param - Model* for the target model to save all vertex and skelteon data
-	// @param - Skeleton* if there is a skeleton for this model
+	// Imports a model from its cooked file in the derived data cache, found by hashing the whole model file on every import.
+	// Otherwise reads the model with Assimp and cooks it so the next import can skip Assimp. If the model file is missing,
+	// the file it was last cooked from is used instead. Doesn't make any OpenGL calls or touch the AssetManager, so it's
+	// safe to run on a worker thread.
+	// @param - const std::string& for the file name of the model
+	// @return - ImportedModel* for the imported data (nullptr if the file couldn't be read and was never cooked)
+	ImportedModel* Import(const std::string& fileName);
+
+	// Reads a model file with Assimp, converts its meshes, builds its skeleton and animations, and gathers
+	// the textures of the materials the meshes use without decoding them
+	// @param - const std::string& for the file name of the model
+	// @return - ImportedModel* for the imported data (nullptr if the file couldn't be read)
+	ImportedModel* ImportScene(const std::string& fileName);
+
+	// Reads a model file with Assimp and writes its cooked file, even if one is already cached
+	// @param - const std::string& for the file name of the model
+	// @return - bool for if the cooked file was written
+	bool Cook(const std::string& fileName);
+
+	// Decodes the imported textures that aren't cached yet on the AssetManager's load worker threads, and skips the ones that are.
+	// Must run on the render thread since it reads the texture cache.
+	// @param - ImportedModel* for the imported data
 	// @param - AssetManager* for the engine's asset manager
-	// @param - bool for if the model has animations
-	void ProcessNodes(aiNode* node, const aiScene* scene, Model* targetModel, Skeleton* skeleton, AssetManager* am, bool hasAnims);
+	void DecodeTextures(ImportedModel* imported, AssetManager* am);
 
-	// Takes an assimp mesh and store it in our own Mesh object.
-	// It then appends that mesh to the entity's vector of meshes.
-	// @param - aiMesh* for the current mesh being processed
-	// @param - const aiScene* for the model's assimp scene
-	// @param - Model* for the target model to save all vertex and skelteon data
-	// @param - Skeleton* if there is a skeleton for this model
+	// Creates the model's textures, vertex buffers, and materials from imported data and caches them.
+	// Must run on the render thread. Deletes the imported data.
+	// @param - ImportedModel* for the imported data
 	// @param - AssetManager* for the engine's asset manager
+	// @param - bool for if cached materials get the imported textures again (used when the model is reloaded)
+	// @return - Model* for the new model
+	Model* Finish(ImportedModel* imported, AssetManager* am, bool updateMaterials = false);
+
+	// Gets the key a model's mesh is cached by. Mesh names often repeat across files ("Cube") or are empty,
+	// so the key is the model's file name and the mesh's index in the file.
+	// @param - const std::string& for the model's file name
+	// @param - unsigned int for the mesh's index in the file
+	// @return - std::string for the key
+	std::string GetMeshKey(const std::string& fileName, unsigned int meshIndex);
+
+	// Gets the key a model's material is cached by. Material names repeat across files too, and models
+	// change their materials, so each model file gets its own materials.
+	// @param - const std::string& for the model's file name
+	// @param - const std::string& for the material's name in the file
+	// @return - std::string for the key
+	std::string GetMaterialKey(const std::string& fileName, const std::string& materialName);
+
+	// Gets the key for a mesh's contents, so meshes repeated in a model file share one vertex buffer.
+	// Hashes the vertices, indices, and material, since meshes with different materials can't be shared
+	// (so meshes from different files, which never share materials, aren't shared either).
+	// @param - const ImportedMesh& for the mesh
+	// @param - size_t for the size of a vertex in bytes
+	// @param - const Material* for the mesh's material
+	// @return - std::string for the key
+	std::string GetMeshContentKey(const ImportedMesh& mesh, size_t vertexSize, const Material* material);
+
+	// Gets how many bytes Finish() will upload for a model's vertex buffers
+	// @param - const ImportedModel* for the imported data
+	// @return - size_t for the number of bytes
+	size_t GetUploadSize(const ImportedModel* imported);
+
+	// Converts an Assimp mesh's vertices, bone weights, and indices
+	// @param - const aiMesh* for the mesh being converted
+	// @param - Skeleton* if there is a skeleton for this model
 	// @param - bool for if the model has animations
-	Mesh* ProcessMesh(aiMesh* mesh, const aiScene* scene, Model* targetModel, Skeleton* skeleton, AssetManager* am, bool hasAnims);
+	// @return - ImportedMesh for the converted mesh
+	ImportedMesh ImportMesh(const aiMesh* mesh, Skeleton* skeleton, bool hasAnims);
 
 	// Extracts vertex data and returns a vertex containing pos, normal, and texture coordinates
 	// @param - const aiMesh* for the mesh being processed
@@ -41,19 +147,31 @@ namespace ModelLoader
 	// @param - index of the mesh
 	const Vertex GetVertexData(const aiMesh* mesh, bool hasTextures, unsigned int index);
 
-	// Loads a mesh's materials
-	// @param - const aiScene* for the model's assimp scene
-	// @param - const aiMesh* for the mesh being processed
-	// @param - Model* for the target model to save all vertex and skelteon data
+	// Gets a mesh's material from the cache, or creates it and loads its textures
+	// @param - const ImportedModel* for the imported data
+	// @param - const ImportedMesh& for the mesh
+	// @param - Model* for the target model to save the material to
 	// @param - AssetManager* for the engine's asset manager
 	// @param - bool for if the model has animations
-	Material* LoadMaterial(const aiScene* scene, aiMesh* mesh, Model* targetModel, AssetManager* am, bool hasAnims);
+	// @param - bool for if a cached material's textures are replaced with the imported ones
+	// @return - Material* for the material
+	Material* LoadMaterial(const ImportedModel* imported, const ImportedMesh& mesh, Model* targetModel, AssetManager* am, bool hasAnims, bool updateTextures);
 
-	// Loads the textures of the material
-	// @param - aiMaterial*
-	// @param - aiTextureType
-	// @param - Material* for the material
-	// @param - Model* for the target model to save all vertex and skelteon data
-	// @param - AssetManager* for the engine's asset manager
-	void LoadMaterialTextures(aiMaterial* mat, aiTextureType aiTextureType, Material* material, Model* targetModel, AssetManager* am);
+	// Reads a material's name and texture file names, adding textures the model doesn't have yet
+	// @param - ImportedModel* for the imported data
+	// @param - const aiMaterial* for the material
+	// @param - std::unordered_map<std::string, unsigned int>& for the index of each texture file already added
+	// @return - ImportedMaterial for the material
+	ImportedMaterial ImportMaterial(ImportedModel* imported, const aiMaterial* material, std::unordered_map<std::string, unsigned int>& textureIndices);
+
+	// Gets the file name of a material's texture. Texture paths are relative to the model's directory.
+	// @param - const std::string& for the model's file name
+	// @param - const aiString& for the texture path stored in the material
+	// @return - std::string for the texture's file name
+	std::string GetTextureFileName(const std::string& modelFileName, const aiString& texturePath);
+
+	// Gets the engine's texture type for an Assimp texture type
+	// @param - aiTextureType for the Assimp texture type
+	// @return - TextureType for the texture type
+	TextureType GetTextureType(aiTextureType aiTextureType);
 }
@@ -0,0 +1,130 @@
+#include "PointShadowAtlas.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Direction and up vector for each cube face (matches the OpenGL cube map face order)
+static const glm::vec3 s_FaceDirections[NUM_CUBE_FACES] =
+{
+	glm::vec3(1.0f, 0.0f, 0.0f),
+	glm::vec3(-1.0f, 0.0f, 0.0f),
+	glm::vec3(0.0f, 1.0f, 0.0f),
+	glm::vec3(0.0f, -1.0f, 0.0f),
+	glm::vec3(0.0f, 0.0f, 1.0f),
+	glm::vec3(0.0f, 0.0f, -1.0f)
+};
+
+static const glm::vec3 s_FaceUps[NUM_CUBE_FACES] =
+{
+	glm::vec3(0.0f, -1.0f, 0.0f),
+	glm::vec3(0.0f, -1.0f, 0.0f),
+	glm::vec3(0.0f, 0.0f, 1.0f),
+	glm::vec3(0.0f, 0.0f, -1.0f),
+	glm::vec3(0.0f, -1.0f, 0.0f),
+	glm::vec3(0.0f, -1.0f, 0.0f)
+};
+
+// Rounds down to a power of two
+static unsigned int FloorPowerOfTwo(unsigned int value)
+{
+	unsigned int result = 1;
+	while (result * 2 <= value)
+	{
+		result *= 2;
+	}
+	return value == 0 ? 0 : result;
+}
+
+unsigned int PointShadowAtlas::CalculateAtlasSize(size_t budgetBytes, size_t bytesPerTexel)
+{
+	unsigned int size = 1;
+	while (static_cast<size_t>(size) * 2 * size * 2 * bytesPerTexel <= budgetBytes)
+	{
+		size *= 2;
+	}
+	return size;
+}
+
+PointShadowAtlasLayout PointShadowAtlas::CalculateLayout(unsigned int atlasSize, int numLights, unsigned int maxTileSize, unsigned int minTileSize)
+{
+	PointShadowAtlasLayout layout = {};
+	layout.atlasSize = atlasSize;
+	layout.numLights = std::clamp(numLights, 0, MAX_POINT_SHADOWS);
+
+	while (layout.numLights > 0)
+	{
+		unsigned int numTiles = static_cast<unsigned int>(layout.numLights * NUM_CUBE_FACES);
+		unsigned int tilesPerRow = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(numTiles))));
+
+		layout.tileSize = std::min(FloorPowerOfTwo(atlasSize / tilesPerRow), maxTileSize);
+		layout.tilesPerRow = layout.tileSize > 0 ? atlasSize / layout.tileSize : 0;
+
+		if (layout.tileSize >= minTileSize)
+		{
+			return layout;
+		}
+
+		// Tiles would be too small, drop the least important light
+		--layout.numLights;
+	}
+
+	layout.tileSize = 0;
+	layout.tilesPerRow = 0;
+	return layout;
+}
+
+glm::vec4 PointShadowAtlas::GetTileRect(const PointShadowAtlasLayout& layout, int tileIndex)
+{
+	float scale = static_cast<float>(layout.tileSize) / static_cast<float>(layout.atlasSize);
+	unsigned int x = static_cast<unsigned int>(tileIndex) % layout.tilesPerRow;
+	unsigned int y = static_cast<unsigned int>(tileIndex) / layout.tilesPerRow;
+
+	return glm::vec4(x * scale, y * scale, scale, scale);
+}
+
+glm::mat4 PointShadowAtlas::GetFaceViewProjection(const glm::vec3& lightPos, int face, float nearPlane, float farPlane)
+{
+	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, farPlane);
+
+	return projection * glm::lookAt(lightPos, lightPos + s_FaceDirections[face], s_FaceUps[face]);
+}
+
+unsigned int PointShadowAtlas::GetVisibleFaces(const glm::vec3& lightPos, float farPlane, const BoundingSphere& bounds)
+{
+	glm::vec3 center = bounds.center - lightPos;
+	float distance = glm::length(center);
+
+	// Out of the light's range
+	if (distance - bounds.radius > farPlane)
+	{
+		return 0;
+	}
+
+	// Light is inside the caster, every face can see it
+	if (distance <= bounds.radius)
+	{
+		return (1u << NUM_CUBE_FACES) - 1;
+	}
+
+	// Each face's frustum is bounded by four planes at 45 degrees between its axis and the other two axes.
+	// The sphere overlaps a face if it is not fully behind any of those planes.
+	float offset = bounds.radius * std::sqrt(2.0f);
+	unsigned int mask = 0;
+
+	for (int face = 0; face < NUM_CUBE_FACES; ++face)
+	{
+		int axis = face / 2;
+		float sign = (face % 2 == 0) ? 1.0f : -1.0f;
+		float along = sign * center[axis];
+		float sideA = center[(axis + 1) % 3];
+		float sideB = center[(axis + 2) % 3];
+
+		if (along - sideA >= -offset && along + sideA >= -offset &&
+			along - sideB >= -offset && along + sideB >= -offset)
+		{
+			mask |= (1u << face);
+		}
+	}
+
+	return mask;
+}
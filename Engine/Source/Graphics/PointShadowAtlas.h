@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "BoundingVolumes.h"
+
+// Maximum number of point lights that can have shadows at the same time.
+// This needs to match MAX_POINT_SHADOWS in the shaders.
+const int MAX_POINT_SHADOWS = 4;
+
+// Number of faces of a point light's cube (+X, -X, +Y, -Y, +Z, -Z)
+const int NUM_CUBE_FACES = 6;
+
+// Struct for how a shadow atlas is split into tiles
+struct PointShadowAtlasLayout
+{
+	unsigned int atlasSize;	  // width/height of the atlas texture
+	unsigned int tileSize;	  // width/height of a single cube face's tile
+	unsigned int tilesPerRow; // number of tiles in a row of the atlas
+	int numLights;			  // number of lights that fit into the atlas
+};
+
+// PointShadowAtlas contains the CPU side math used by point light shadows. All six cube faces
+// of every shadowed light are packed as tiles into one 2D depth atlas. None of these functions
+// touch OpenGL, so they are safe to call from JobManager worker threads.
+namespace PointShadowAtlas
+{
+	// Calculates the largest square atlas (power of two) that fits into a memory budget
+	// @param - size_t for the budget in bytes
+	// @param - size_t for the bytes per texel of the depth format
+	// @return - unsigned int for the atlas' width/height
+	unsigned int CalculateAtlasSize(size_t budgetBytes, size_t bytesPerTexel);
+
+	// Splits an atlas into tiles for a number of lights. Fewer lights get bigger tiles. If the tiles
+	// would be smaller than minTileSize, lights are dropped until they fit.
+	// @param - unsigned int for the atlas' width/height
+	// @param - int for the number of lights that want shadows
+	// @param - unsigned int for the largest tile size
+	// @param - unsigned int for the smallest tile size
+	// @return - PointShadowAtlasLayout for the layout
+	PointShadowAtlasLayout CalculateLayout(unsigned int atlasSize, int numLights, unsigned int maxTileSize, unsigned int minTileSize);
+
+	// Gets a tile's offset and scale in the atlas' uv space
+	// @param - const PointShadowAtlasLayout& for the layout
+	// @param - int for the tile index (light slot * 6 + face)
+	// @return - glm::vec4 where xy = offset, zw = scale
+	glm::vec4 GetTileRect(const PointShadowAtlasLayout& layout, int tileIndex);
+
+	// Calculates the view * projection matrix for a cube face of a point light
+	// @param - const glm::vec3& for the light's position
+	// @param - int for the face (+X, -X, +Y, -Y, +Z, -Z)
+	// @param - float for the near plane
+	// @param - float for the far plane
+	// @return - glm::mat4 for the face's view * projection matrix
+	glm::mat4 GetFaceViewProjection(const glm::vec3& lightPos, int face, float nearPlane, float farPlane);
+
+	// Finds which of a point light's cube faces a caster's bounding sphere overlaps
+	// @param - const glm::vec3& for the light's position
+	// @param - float for the light's far plane
+	// @param - const BoundingSphere& for the caster's world space bounds
+	// @return - unsigned int bit mask where bit N is set if face N sees the caster
+	unsigned int GetVisibleFaces(const glm::vec3& lightPos, float farPlane, const BoundingSphere& bounds);
+}
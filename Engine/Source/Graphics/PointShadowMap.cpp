@@ -1,42 +1,52 @@
 #include "PointShadowMap.h"
+#include <algorithm>
 #include <iostream>
 #include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
+#include "../Entity/Entity.h"
+#include "Model.h"
+#include "Renderer.h"
+#include "Shader.h"
 #include "Texture.h"
 #include "UniformBuffer.h"
 
-const unsigned int SHADOW_WIDTH = 8560;
-const unsigned int SHADOW_HEIGHT = 8560;
-float nearPlane = 1.0f;
-float farPlane = 100.0f;
-
-PointShadowMap::PointShadowMap() :
+PointShadowMap::PointShadowMap(Renderer* renderer, size_t budgetBytes) :
 	mPointShadowConsts({}),
-	mPointShadowBuffer(new UniformBuffer(sizeof(PointShadowMapConsts), BufferBindingPoint::PointShadow, "PointShadowBuffer")),
+	mLayout({}),
+	mCasterEntities(),
+	mCasterBounds(),
+	mSlotCasters(MAX_POINT_SHADOWS),
+	mCullJobs(),
+	mCullJobsDone(nullptr),
+	mShader(nullptr),
+	mPointShadowBuffer(renderer->CreateUniformBuffer(sizeof(PointShadowMapConsts), BufferBindingPoint::PointShadow, "PointShadowBuffer")),
 	mPointShadowMapFrameBuffer(0),
 	mPointShadowMap(0),
-	mTextureUnit(static_cast<int>(TextureType::PointShadow))
+	mAtlasSize(PointShadowAtlas::CalculateAtlasSize(budgetBytes, sizeof(float))),
+	mMaxTileSize(1024),
+	mMinTileSize(128),
+	mTextureUnit(static_cast<int>(TextureType::PointShadow)),
+	mNearPlane(0.1f),
+	mFarPlane(100.0f)
 {
-	glGenTextures(1, &mPointShadowMap);
-
-	glBindTexture(GL_TEXTURE_CUBE_MAP, mPointShadowMap);
-
-	// Assign each side of cubemap a 2D depth-valued texture image
-	for (unsigned int i = 0; i < 6; ++i)
+	mCullJobs.reserve(MAX_POINT_SHADOWS);
+	for (int i = 0; i < MAX_POINT_SHADOWS; ++i)
 	{
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-
+		mCullJobs.emplace_back(this, i);
 	}
-	// Set texture parameters
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
+	// Create a 2D texture for the atlas' depth
+	glGenTextures(1, &mPointShadowMap);
+	glBindTexture(GL_TEXTURE_2D, mPointShadowMap);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, mAtlasSize, mAtlasSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// Create a framebuffer object and attach the atlas as its depth buffer
+	glGenFramebuffers(1, &mPointShadowMapFrameBuffer);
 	glBindFramebuffer(GL_FRAMEBUFFER, mPointShadowMapFrameBuffer);
-	glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mPointShadowMap, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mPointShadowMap, 0);
 	glDrawBuffer(GL_NONE);
 	glReadBuffer(GL_NONE);
 
@@ -52,38 +62,151 @@ PointShadowMap::~PointShadowMap()
 	glDeleteTextures(1, &mPointShadowMap);
 }
 
-void PointShadowMap::SetActive(float near, float far, const glm::vec3 pos)
+void PointShadowMap::Update(const glm::vec3& viewPos, LightArrays& lights, const std::vector<Entity*>& entities, JobManager* jobManager)
 {
-	float aspect = static_cast<float>(SHADOW_WIDTH / SHADOW_HEIGHT);
+	// Find the point lights that want shadows, closest to the camera first, and clear every light's old slot
+	std::vector<int> candidates;
+	for (int i = 0; i < static_cast<int>(lights.pointLights.size()); ++i)
+	{
+		PointLight& light = lights.pointLights[i];
+		light.shadowSlot = -1;
+		if (light.data.isEnabled && light.data.usesShadow)
+		{
+			candidates.emplace_back(i);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [&lights, &viewPos](int a, int b) {
+		glm::vec3 toA = lights.pointLights[a].position - viewPos;
+		glm::vec3 toB = lights.pointLights[b].position - viewPos;
+		return glm::dot(toA, toA) < glm::dot(toB, toB);
+	});
+
+	mLayout = PointShadowAtlas::CalculateLayout(mAtlasSize, static_cast<int>(candidates.size()), mMaxTileSize, mMinTileSize);
+
+	for (int slot = 0; slot < mLayout.numLights; ++slot)
+	{
+		int lightIndex = candidates[slot];
+		const glm::vec3& lightPos = lights.pointLights[lightIndex].position;
+
+		lights.pointLights[lightIndex].shadowSlot = slot;
+		mPointShadowConsts.lightPositions[slot] = glm::vec4(lightPos, mFarPlane);
+
+		for (int face = 0; face < NUM_CUBE_FACES; ++face)
+		{
+			int tile = slot * NUM_CUBE_FACES + face;
+			mPointShadowConsts.faceViewProjections[tile] = PointShadowAtlas::GetFaceViewProjection(lightPos, face, mNearPlane, mFarPlane);
+			mPointShadowConsts.faceTiles[tile] = PointShadowAtlas::GetTileRect(mLayout, tile);
+		}
+	}
 
-	float nearPlane = near;
-	float farPlane = far;
+	// Gather the world space bounds of every entity with a model on this thread since GetModelMatrix() can update the entity
+	mCasterEntities.clear();
+	mCasterBounds.clear();
+	for (Entity* e : entities)
+	{
+		Model* model = e->GetModel();
+		if (model)
+		{
+			mCasterEntities.emplace_back(e);
+			mCasterBounds.emplace_back(GetWorldBoundingSphere(model->GetBounds(), e->GetModelMatrix()));
+		}
+	}
 
-	glm::mat4 shadowProj = glm::perspective(glm::radians(90.0f), aspect, near, far);
+	// Cull each light's casters on a separate thread, waiting only on these jobs and not everything else the job manager is running
+	std::latch cullJobsDone(mLayout.numLights);
+	mCullJobsDone = &cullJobsDone;
+	for (int slot = 0; slot < mLayout.numLights; ++slot)
+	{
+		jobManager->AddJob(&mCullJobs[slot]);
+	}
+	cullJobsDone.wait();
+	mCullJobsDone = nullptr;
 
-	mPointShadowConsts.shadowTransforms[0] = shadowProj * glm::lookAt(pos, pos + glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
-	mPointShadowConsts.shadowTransforms[1] = shadowProj * glm::lookAt(pos, pos + glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
-	mPointShadowConsts.shadowTransforms[2] = shadowProj * glm::lookAt(pos, pos + glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-	mPointShadowConsts.shadowTransforms[3] = shadowProj * glm::lookAt(pos, pos + glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
-	mPointShadowConsts.shadowTransforms[4] = shadowProj * glm::lookAt(pos, pos + glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
-	mPointShadowConsts.shadowTransforms[5] = shadowProj * glm::lookAt(pos, pos + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+	mPointShadowBuffer->UpdateBufferData(&mPointShadowConsts);
+}
 
-	// First pass will render to shadow map
-	glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+void PointShadowMap::SetActive() const
+{
+	glViewport(0, 0, mAtlasSize, mAtlasSize);
 
 	// Bind to frame buffer
 	glBindFramebuffer(GL_FRAMEBUFFER, mPointShadowMapFrameBuffer);
 	// Clear depth buffer
 	glClear(GL_DEPTH_BUFFER_BIT);
 
-	mPointShadowBuffer->UpdateBufferData(&mPointShadowConsts);
+	// Clip distances keep each instance inside its face's tile
+	for (int i = 0; i < 4; ++i)
+	{
+		glEnable(GL_CLIP_DISTANCE0 + i);
+	}
+}
+
+void PointShadowMap::DrawCasters(Renderer* renderer)
+{
+	mShader->SetActive();
+
+	for (int slot = 0; slot < mLayout.numLights; ++slot)
+	{
+		mShader->SetInt(ShaderUniforms::ShadowSlot, slot);
+
+		for (const PointShadowCaster& caster : mSlotCasters[slot])
+		{
+			mShader->SetIntArray(ShaderUniforms::Faces, caster.numFaces, caster.faces);
+			renderer->RenderEntity3D(caster.entity, mShader, caster.numFaces);
+		}
+	}
 }
 
 void PointShadowMap::End(int width, int height) const
 {
+	for (int i = 0; i < 4; ++i)
+	{
+		glDisable(GL_CLIP_DISTANCE0 + i);
+	}
+
 	// Bind back to default frame buffer
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	// Set viewport back to screen's width and height
 	glViewport(0, 0, width, height);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
+
+void PointShadowMap::BindShadowMapToShader(Shader* s, const std::string& uniformName) const
+{
+	s->SetActive();
+	s->SetInt(uniformName, mTextureUnit);
+	glActiveTexture(GL_TEXTURE0 + mTextureUnit);
+	glBindTexture(GL_TEXTURE_2D, mPointShadowMap);
+}
+
+void PointShadowMap::CullJob::DoJob()
+{
+	PointShadowMap* sm = mShadowMap;
+	const glm::vec4& light = sm->mPointShadowConsts.lightPositions[mSlot];
+
+	std::vector<PointShadowCaster>& casters = sm->mSlotCasters[mSlot];
+	casters.clear();
+
+	for (size_t i = 0; i < sm->mCasterBounds.size(); ++i)
+	{
+		unsigned int mask = PointShadowAtlas::GetVisibleFaces(glm::vec3(light), light.w, sm->mCasterBounds[i]);
+		if (mask == 0)
+		{
+			continue;
+		}
+
+		PointShadowCaster caster = {};
+		caster.entity = sm->mCasterEntities[i];
+		for (int face = 0; face < NUM_CUBE_FACES; ++face)
+		{
+			if (mask & (1u << face))
+			{
+				caster.faces[caster.numFaces] = face;
+				++caster.numFaces;
+			}
+		}
+		casters.emplace_back(caster);
+	}
+
+	sm->mCullJobsDone->count_down();
+}
@@ -1,34 +1,163 @@
 #pragma once
+#include <latch>
+#include <string>
+#include <vector>
 #include <glm/glm.hpp>
+#include "../Multithreading/JobManager.h"
+#include "LightConstants.h"
+#include "PointShadowAtlas.h"
 
+class Entity;
+class Renderer;
+class Shader;
+class UniformBuffer;
+
+// Struct for point shadow data to be sent to the shaders
 struct PointShadowMapConsts
 {
-	glm::mat4 shadowTransforms[6];
+	glm::mat4 faceViewProjections[MAX_POINT_SHADOWS * NUM_CUBE_FACES]; // view * projection for each face of each shadowed light
+	glm::vec4 faceTiles[MAX_POINT_SHADOWS * NUM_CUBE_FACES];		   // xy = tile offset, zw = tile scale in the atlas' uv space
+	glm::vec4 lightPositions[MAX_POINT_SHADOWS];					   // xyz = light position, w = far plane
 };
 
-class UniformBuffer;
+// Struct for an entity that casts a shadow into some faces of a point light
+struct PointShadowCaster
+{
+	Entity* entity;				// entity to draw
+	int faces[NUM_CUBE_FACES];	// faces that can see the entity
+	int numFaces;				// number of faces (instances to draw)
+};
 
+// PointShadowMap is used to create shadows for point lights without a geometry shader.
+// The six cube faces of every shadowed point light are packed as tiles into a single 2D depth atlas
+// whose size comes from a fixed memory budget. Casters are culled per cube face on JobManager threads,
+// then each caster is drawn once per light with one instance per face it is visible in. The vertex
+// shader moves each instance into its face's tile and clips it to the tile.
 class PointShadowMap
 {
 public:
-	PointShadowMap();
+	// PointShadowMap constructor:
+	// Creates a frame buffer and the largest depth atlas that fits in the memory budget
+	// @param - Renderer* for the renderer
+	// @param - size_t for the atlas' memory budget in bytes
+	PointShadowMap(Renderer* renderer, size_t budgetBytes);
 	~PointShadowMap();
 
-	void SetActive(float near, float far, const glm::vec3 pos);
+	// Picks the point lights that get shadows this frame (closest enabled lights with usesShadow set),
+	// lays out their tiles in the atlas, and culls the casters for each light's faces on JobManager threads.
+	// This blocks until the jobs are done and sends the shadow data to mPointShadowBuffer. Each point light's
+	// shadowSlot is set to its slot in the atlas (-1 for none), so this needs to run before Lights::SetBuffer().
+	// @param - const glm::vec3& for the camera's position
+	// @param - LightArrays& for the scene's lights
+	// @param - const std::vector<Entity*>& for the entities that can cast shadows
+	// @param - JobManager* for the engine's job manager
+	void Update(const glm::vec3& viewPos, LightArrays& lights, const std::vector<Entity*>& entities, JobManager* jobManager);
+
+	// Sets the viewport to fit the atlas and binds the framebuffer to draw to it, then clears the depth
+	void SetActive() const;
+
+	// Draws every culled caster into the atlas with this shadow map's shader
+	// @param - Renderer* for the renderer
+	void DrawCasters(Renderer* renderer);
 
+	// Binds back to the default frame buffer, resets the viewport back to the original size, and clears the color/depth buffers
+	// @param - int for the width of the viewport
+	// @param - int for the height of the viewport
 	void End(int width, int height) const;
 
+	// Activates the texture unit to match the point shadow map and binds the atlas as the texture within a shader
+	// @param - Shader* to activate
+	// @param - const std::string& for the uniform name
+	void BindShadowMapToShader(Shader* s, const std::string& uniformName) const;
+
+	// Gets the number of point lights that have shadows this frame
+	// @return - int for the number of lights
+	int GetNumShadowedLights() const { return mLayout.numLights; }
+
+	// Gets the atlas' current layout
+	// @return - const PointShadowAtlasLayout& for the layout
+	const PointShadowAtlasLayout& GetLayout() const { return mLayout; }
+
+	// Gets the frame buffer's shader
+	// @return - Shader* for the frame buffer's shader
+	Shader* GetShader() { return mShader; }
+
+	// Sets the frame buffer's shader
+	// @param - Shader* for the new shader
+	void SetShader(Shader* s) { mShader = s; }
+
+	// Sets the far plane (range) of the point lights' shadows
+	// @param - float for the far plane
+	void SetFarPlane(float far) { mFarPlane = far; }
+
+	// Sets the largest tile a single cube face can get
+	// @param - unsigned int for the tile's width/height
+	void SetMaxTileSize(unsigned int size) { mMaxTileSize = size; }
+
 private:
+	// Job to cull the casters of a single light on a separate thread
+	class CullJob : public JobManager::Job
+	{
+	public:
+		CullJob(PointShadowMap* shadowMap, int slot) :
+			mShadowMap(shadowMap),
+			mSlot(slot)
+		{
+		}
+		void DoJob() override;
+	private:
+		PointShadowMap* mShadowMap;
+		int mSlot;
+	};
+
+	// Point shadow constants
 	PointShadowMapConsts mPointShadowConsts;
 
+	// Current layout of the atlas
+	PointShadowAtlasLayout mLayout;
+
+	// Entities that can cast shadows this frame
+	std::vector<Entity*> mCasterEntities;
+
+	// World space bounds of mCasterEntities
+	std::vector<BoundingSphere> mCasterBounds;
+
+	// Culled casters for each shadowed light
+	std::vector<std::vector<PointShadowCaster>> mSlotCasters;
+
+	// Jobs used to cull each shadowed light's casters
+	std::vector<CullJob> mCullJobs;
+
+	// Counts down as this frame's cull jobs finish (only set while Update() waits on them)
+	std::latch* mCullJobsDone;
+
+	// The shader used to draw into the atlas
+	Shader* mShader;
+
+	// Uniform buffer to send point shadow data to shaders
 	UniformBuffer* mPointShadowBuffer;
 
 	// Frame buffer for point shadow map
 	unsigned int mPointShadowMapFrameBuffer;
 
-	// Cube map used for point shadows
+	// Depth atlas used for point shadows
 	unsigned int mPointShadowMap;
 
+	// Width/height of the atlas
+	unsigned int mAtlasSize;
+
+	// Largest tile size for a cube face
+	unsigned int mMaxTileSize;
+
+	// Smallest tile size before lights are dropped
+	unsigned int mMinTileSize;
+
 	// PointShadow texture unit
 	int mTextureUnit;
+
+	// Near plane of each cube face
+	float mNearPlane;
+
+	// Far plane (range) of each cube face
+	float mFarPlane;
 };
@@ -0,0 +1,324 @@
+#include "RenderGraph.h"
+#include <algorithm>
+#include "../Util/Logger.h"
+
+// Bytes per pixel of a format. RGB16F is counted as 8 bytes since drivers pad it to RGBA16F.
+static size_t GetBytesPerPixel(RenderGraphFormat format)
+{
+	switch (format)
+	{
+	case RenderGraphFormat::RGB16F:
+	case RenderGraphFormat::RGBA16F:
+		return 8;
+	case RenderGraphFormat::RGBA8:
+		return 4;
+	}
+	return 4;
+}
+
+RenderGraph::RenderGraph() :
+	mPasses(),
+	mResources(),
+	mExecutionOrder(),
+	mPhysicalTextures(),
+	mIsCompiled(false),
+	mHasCompileFailed(false)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+}
+
+RenderGraphResource RenderGraph::CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+{
+	RenderGraphResourceData resource = {};
+	resource.name = name;
+	resource.desc = desc;
+	resource.producer = -1;
+	resource.firstUse = -1;
+	resource.lastUse = -1;
+	resource.physicalIndex = -1;
+	resource.isImported = false;
+	resource.isOutput = false;
+	mResources.emplace_back(resource);
+
+	mIsCompiled = false;
+	mHasCompileFailed = false;
+
+	return static_cast<RenderGraphResource>(mResources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::ImportTarget(const std::string& name, const RenderGraphTarget& target)
+{
+	RenderGraphResource resource = CreateTexture(name, RenderGraphTextureDesc{ 1.0f, RenderGraphFormat::RGB16F });
+	mResources[resource].imported = target;
+	mResources[resource].isImported = true;
+
+	return resource;
+}
+
+void RenderGraph::SetImportedTarget(RenderGraphResource resource, const RenderGraphTarget& target)
+{
+	if (resource >= 0 && resource < static_cast<int>(mResources.size()) && mResources[resource].isImported)
+	{
+		mResources[resource].imported = target;
+	}
+}
+
+void RenderGraph::MarkOutput(RenderGraphResource resource)
+{
+	if (resource >= 0 && resource < static_cast<int>(mResources.size()))
+	{
+		mResources[resource].isOutput = true;
+		mIsCompiled = false;
+		mHasCompileFailed = false;
+	}
+}
+
+int RenderGraph::AddPass(const std::string& name, const std::vector<RenderGraphResource>& inputs, RenderGraphResource output, std::function<void(const RenderGraphPassContext&)> execute)
+{
+	RenderGraphPass pass = {};
+	pass.name = name;
+	pass.inputs = inputs;
+	pass.execute = execute;
+	pass.output = output;
+	pass.isCulled = false;
+	mPasses.emplace_back(pass);
+
+	mIsCompiled = false;
+	mHasCompileFailed = false;
+
+	return static_cast<int>(mPasses.size() - 1);
+}
+
+bool RenderGraph::Compile()
+{
+	mIsCompiled = false;
+	mHasCompileFailed = true;
+	mExecutionOrder.clear();
+	mPhysicalTextures.clear();
+
+	int numResources = static_cast<int>(mResources.size());
+
+	for (RenderGraphResourceData& resource : mResources)
+	{
+		resource.producer = -1;
+		resource.firstUse = -1;
+		resource.lastUse = -1;
+		resource.physicalIndex = -1;
+	}
+
+	// Find each texture's writer and make sure every read texture has been written or imported
+	for (int p = 0; p < static_cast<int>(mPasses.size()); ++p)
+	{
+		const RenderGraphPass& pass = mPasses[p];
+
+		for (RenderGraphResource input : pass.inputs)
+		{
+			if (input < 0 || input >= numResources)
+			{
+				LOG_ERROR("Render graph pass " + pass.name + " reads an invalid texture");
+				return false;
+			}
+			if (input == pass.output)
+			{
+				LOG_ERROR("Render graph pass " + pass.name + " reads the texture it writes: " + mResources[input].name);
+				return false;
+			}
+			if (!mResources[input].isImported && mResources[input].producer < 0)
+			{
+				LOG_ERROR("Render graph pass " + pass.name + " reads " + mResources[input].name + " before it is written");
+				return false;
+			}
+		}
+
+		if (pass.output < 0 || pass.output >= numResources)
+		{
+			LOG_ERROR("Render graph pass " + pass.name + " writes an invalid texture");
+			return false;
+		}
+		if (mResources[pass.output].producer >= 0)
+		{
+			LOG_ERROR("Render graph texture " + mResources[pass.output].name + " is written by more than one pass");
+			return false;
+		}
+		mResources[pass.output].producer = p;
+	}
+
+	// Walk backwards from the outputs and keep only the passes that contribute to them
+	std::vector<bool> isNeeded(mResources.size(), false);
+	for (int r = 0; r < numResources; ++r)
+	{
+		isNeeded[r] = mResources[r].isOutput;
+	}
+	for (int p = static_cast<int>(mPasses.size()) - 1; p >= 0; --p)
+	{
+		RenderGraphPass& pass = mPasses[p];
+		pass.isCulled = !isNeeded[pass.output];
+
+		if (!pass.isCulled)
+		{
+			for (RenderGraphResource input : pass.inputs)
+			{
+				isNeeded[input] = true;
+			}
+		}
+	}
+
+	for (int p = 0; p < static_cast<int>(mPasses.size()); ++p)
+	{
+		if (!mPasses[p].isCulled)
+		{
+			mExecutionOrder.emplace_back(p);
+		}
+	}
+
+	// Find the first and last position in the execution order that uses each texture
+	int numPositions = static_cast<int>(mExecutionOrder.size());
+	for (int pos = 0; pos < numPositions; ++pos)
+	{
+		const RenderGraphPass& pass = mPasses[mExecutionOrder[pos]];
+
+		RenderGraphResourceData& output = mResources[pass.output];
+		output.firstUse = pos;
+		output.lastUse = output.isOutput ? numPositions : pos;
+
+		for (RenderGraphResource input : pass.inputs)
+		{
+			RenderGraphResourceData& resource = mResources[input];
+			if (resource.firstUse < 0)
+			{
+				resource.firstUse = pos;
+			}
+			resource.lastUse = std::max(resource.lastUse, pos);
+		}
+	}
+
+	// Alias transient textures: a pass' output takes a free physical texture of the same format class, and the
+	// textures it read are freed once it is their last use. The smallest free texture that's already big enough is
+	// used, otherwise the largest free texture grows to fit, since growing it costs less than a new texture.
+	std::vector<bool> isFree;
+	for (int pos = 0; pos < numPositions; ++pos)
+	{
+		const RenderGraphPass& pass = mPasses[mExecutionOrder[pos]];
+
+		RenderGraphResourceData& output = mResources[pass.output];
+		if (!output.isImported)
+		{
+			int fits = -1;
+			int largest = -1;
+			for (int i = 0; i < static_cast<int>(mPhysicalTextures.size()); ++i)
+			{
+				const RenderGraphTextureDesc& physical = mPhysicalTextures[i];
+				if (!isFree[i] || GetFormatClass(physical.format) != GetFormatClass(output.desc.format))
+				{
+					continue;
+				}
+
+				if (physical.scale >= output.desc.scale && (fits < 0 || physical.scale < mPhysicalTextures[fits].scale))
+				{
+					fits = i;
+				}
+				if (largest < 0 || physical.scale > mPhysicalTextures[largest].scale)
+				{
+					largest = i;
+				}
+			}
+
+			output.physicalIndex = fits >= 0 ? fits : largest;
+			if (output.physicalIndex >= 0)
+			{
+				RenderGraphTextureDesc& physical = mPhysicalTextures[output.physicalIndex];
+				physical.scale = std::max(physical.scale, output.desc.scale);
+
+				// Keep the alpha channel if any of the textures aliased onto it needs one
+				if (output.desc.format == RenderGraphFormat::RGBA16F)
+				{
+					physical.format = output.desc.format;
+				}
+				isFree[output.physicalIndex] = false;
+			}
+			else
+			{
+				output.physicalIndex = static_cast<int>(mPhysicalTextures.size());
+				mPhysicalTextures.emplace_back(output.desc);
+				isFree.emplace_back(false);
+			}
+		}
+
+		for (RenderGraphResource input : pass.inputs)
+		{
+			const RenderGraphResourceData& resource = mResources[input];
+			if (!resource.isImported && resource.lastUse == pos)
+			{
+				isFree[resource.physicalIndex] = true;
+			}
+		}
+	}
+
+	mIsCompiled = true;
+	mHasCompileFailed = false;
+
+	return true;
+}
+
+void RenderGraph::Clear()
+{
+	mPasses.clear();
+	mResources.clear();
+	mExecutionOrder.clear();
+	mPhysicalTextures.clear();
+	mIsCompiled = false;
+	mHasCompileFailed = false;
+}
+
+void RenderGraph::CalculateSize(const RenderGraphTextureDesc& desc, int screenWidth, int screenHeight, int& outWidth, int& outHeight)
+{
+	outWidth = std::max(1, static_cast<int>(static_cast<float>(screenWidth) * desc.scale));
+	outHeight = std::max(1, static_cast<int>(static_cast<float>(screenHeight) * desc.scale));
+}
+
+int RenderGraph::GetFormatClass(RenderGraphFormat format)
+{
+	// RGB16F is padded to RGBA16F by drivers, so they store the same texels
+	switch (format)
+	{
+	case RenderGraphFormat::RGB16F:
+	case RenderGraphFormat::RGBA16F:
+		return 0;
+	case RenderGraphFormat::RGBA8:
+		return 1;
+	}
+	return 1;
+}
+
+size_t RenderGraph::CalculatePhysicalMemory(int screenWidth, int screenHeight) const
+{
+	size_t bytes = 0;
+	for (const RenderGraphTextureDesc& desc : mPhysicalTextures)
+	{
+		int width = 0;
+		int height = 0;
+		CalculateSize(desc, screenWidth, screenHeight, width, height);
+		bytes += static_cast<size_t>(width) * height * GetBytesPerPixel(desc.format);
+	}
+	return bytes;
+}
+
+size_t RenderGraph::CalculateUnaliasedMemory(int screenWidth, int screenHeight) const
+{
+	size_t bytes = 0;
+	for (int p : mExecutionOrder)
+	{
+		const RenderGraphResourceData& output = mResources[mPasses[p].output];
+		if (!output.isImported)
+		{
+			int width = 0;
+			int height = 0;
+			CalculateSize(output.desc, screenWidth, screenHeight, width, height);
+			bytes += static_cast<size_t>(width) * height * GetBytesPerPixel(output.desc.format);
+		}
+	}
+	return bytes;
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Handle to a texture declared in a RenderGraph
+using RenderGraphResource = int;
+
+// Handle for a resource that doesn't exist
+const RenderGraphResource INVALID_RENDER_GRAPH_RESOURCE = -1;
+
+// Enum class for the formats a transient render graph texture can have
+enum class RenderGraphFormat
+{
+	RGB16F,		// HDR color
+	RGBA16F,	// HDR color with alpha
+	RGBA8		// LDR color with alpha
+};
+
+// Struct describing a transient texture. Its size is relative to the screen so it can follow window resizes.
+struct RenderGraphTextureDesc
+{
+	float scale;				// width/height relative to the screen
+	RenderGraphFormat format;	// texture format
+};
+
+// Struct for a target a pass can read from or draw to
+struct RenderGraphTarget
+{
+	unsigned int frameBuffer;	// frame buffer to draw to (0 for the default frame buffer)
+	unsigned int texture;		// color texture to sample from (0 if it can't be sampled)
+	int width;					// width in pixels
+	int height;					// height in pixels
+};
+
+// Struct given to a pass when it executes
+struct RenderGraphPassContext
+{
+	std::vector<unsigned int> inputs;		// texture of each input, in the order the pass declared them
+	std::vector<glm::vec2> inputUvScales;	// part of each input's texture its image covers (less than 1 when it's aliased onto a larger texture)
+	RenderGraphTarget output;				// target the pass draws to (already bound, cleared, and set as the viewport).
+											// Its width/height are the output's own size, which can be smaller than the texture.
+};
+
+// Struct for a pass declared in a RenderGraph
+struct RenderGraphPass
+{
+	std::string name;										// name used for debugging
+	std::vector<RenderGraphResource> inputs;				// textures the pass samples from
+	std::function<void(const RenderGraphPassContext&)> execute;	// draws the pass
+	RenderGraphResource output;								// texture the pass draws to
+	bool isCulled;											// if nothing uses the pass' output
+};
+
+// Struct for a texture declared in a RenderGraph
+struct RenderGraphResourceData
+{
+	std::string name;				// name used for debugging
+	RenderGraphTextureDesc desc;	// size/format of a transient texture
+	RenderGraphTarget imported;		// target of an imported texture
+	int producer;					// pass that writes the texture (-1 for none)
+	int firstUse;					// first position in the execution order that uses the texture
+	int lastUse;					// last position in the execution order that uses the texture
+	int physicalIndex;				// physical texture a transient texture is aliased to (-1 for none)
+	bool isImported;				// if the texture is owned outside the graph
+	bool isOutput;					// if the texture is needed after the graph executes
+};
+
+// RenderGraph schedules a chain of full screen passes. Each pass declares the textures it reads and the
+// one it writes, and Compile() works out everything else: passes whose output never reaches a graph output
+// are culled, and transient textures whose lifetimes don't overlap share one physical texture. Textures of the same
+// format class can share even if their sizes differ: a smaller texture draws to the corner of a larger one, and
+// a physical texture grows when a larger texture takes it over. Adding a pass only adds memory when its output
+// has to be alive at the same time as every existing texture.
+// The graph doesn't make any OpenGL calls so it can be compiled and inspected without a GPU. A
+// RenderTargetPool creates the physical textures and executes the compiled passes.
+class RenderGraph
+{
+public:
+	RenderGraph();
+	~RenderGraph();
+
+	// Declares a transient texture owned by the graph
+	// @param - const std::string& for the name
+	// @param - const RenderGraphTextureDesc& for the size/format
+	// @return - RenderGraphResource for the texture
+	RenderGraphResource CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+	// Declares a target owned outside the graph, such as the scene's frame buffer or the default frame buffer
+	// @param - const std::string& for the name
+	// @param - const RenderGraphTarget& for the target (can be updated later with SetImportedTarget())
+	// @return - RenderGraphResource for the target
+	RenderGraphResource ImportTarget(const std::string& name, const RenderGraphTarget& target);
+
+	// Updates an imported target, for example after the window is resized
+	// @param - RenderGraphResource for the imported target
+	// @param - const RenderGraphTarget& for the new target
+	void SetImportedTarget(RenderGraphResource resource, const RenderGraphTarget& target);
+
+	// Marks a texture as needed after the graph executes so its passes aren't culled
+	// @param - RenderGraphResource for the texture
+	void MarkOutput(RenderGraphResource resource);
+
+	// Adds a pass. Passes execute in the order they are added.
+	// @param - const std::string& for the name
+	// @param - const std::vector<RenderGraphResource>& for the textures the pass reads
+	// @param - RenderGraphResource for the texture the pass writes
+	// @param - std::function<void(const RenderGraphPassContext&)> for the function that draws the pass
+	// @return - int for the pass' index
+	int AddPass(const std::string& name, const std::vector<RenderGraphResource>& inputs, RenderGraphResource output, std::function<void(const RenderGraphPassContext&)> execute);
+
+	// Culls unused passes, finds each texture's lifetime, and aliases transient textures onto physical textures
+	// @return - bool for if the graph is valid (every read texture is written or imported first, each texture has one writer)
+	bool Compile();
+
+	// Gets if Compile() failed and nothing has changed since, so compiling again would fail the same way
+	// @return - bool for if the graph is invalid
+	bool HasCompileFailed() const { return mHasCompileFailed; }
+
+	// Removes every pass and texture
+	void Clear();
+
+	// Gets the passes that survived culling in execution order
+	// @return - const std::vector<int>& for the pass indices
+	const std::vector<int>& GetExecutionOrder() const { return mExecutionOrder; }
+
+	// Gets a pass
+	// @param - int for the pass' index
+	// @return - const RenderGraphPass& for the pass
+	const RenderGraphPass& GetPass(int index) const { return mPasses[index]; }
+
+	// Gets a texture
+	// @param - RenderGraphResource for the texture
+	// @return - const RenderGraphResourceData& for the texture's data
+	const RenderGraphResourceData& GetResource(RenderGraphResource resource) const { return mResources[resource]; }
+
+	// Gets the physical textures that transient textures are aliased onto
+	// @return - const std::vector<RenderGraphTextureDesc>& for the physical textures
+	const std::vector<RenderGraphTextureDesc>& GetPhysicalTextures() const { return mPhysicalTextures; }
+
+	// Gets the number of declared passes
+	// @return - size_t for the number of passes
+	size_t GetNumPasses() const { return mPasses.size(); }
+
+	// Gets the number of declared textures
+	// @return - size_t for the number of textures
+	size_t GetNumResources() const { return mResources.size(); }
+
+	// Gets if the graph has been compiled since it last changed
+	// @return - bool for if the graph is compiled
+	bool IsCompiled() const { return mIsCompiled; }
+
+	// Calculates the size of a texture in pixels for a screen size
+	// @param - const RenderGraphTextureDesc& for the texture
+	// @param - int for the screen's width
+	// @param - int for the screen's height
+	// @param - int& for the texture's width
+	// @param - int& for the texture's height
+	static void CalculateSize(const RenderGraphTextureDesc& desc, int screenWidth, int screenHeight, int& outWidth, int& outHeight);
+
+	// Gets a format's class. Textures can only share a physical texture with textures of the same class.
+	// @param - RenderGraphFormat for the format
+	// @return - int for the format class
+	static int GetFormatClass(RenderGraphFormat format);
+
+	// Calculates the memory the physical textures use for a screen size
+	// @param - int for the screen's width
+	// @param - int for the screen's height
+	// @return - size_t for the number of bytes
+	size_t CalculatePhysicalMemory(int screenWidth, int screenHeight) const;
+
+	// Calculates the memory the transient textures would use if none of them were aliased
+	// @param - int for the screen's width
+	// @param - int for the screen's height
+	// @return - size_t for the number of bytes
+	size_t CalculateUnaliasedMemory(int screenWidth, int screenHeight) const;
+
+private:
+	// Declared passes
+	std::vector<RenderGraphPass> mPasses;
+
+	// Declared textures
+	std::vector<RenderGraphResourceData> mResources;
+
+	// Passes that survived culling in execution order
+	std::vector<int> mExecutionOrder;
+
+	// Physical textures that transient textures are aliased onto
+	std::vector<RenderGraphTextureDesc> mPhysicalTextures;
+
+	// Bool for if the graph is compiled
+	bool mIsCompiled;
+
+	// Bool for if the last Compile() failed
+	bool mHasCompileFailed;
+};
@@ -0,0 +1,162 @@
+#include "RenderTargetPool.h"
+#include <iostream>
+#include <glad/glad.h>
+#include "GpuProfiler.h"
+#include "../Util/Logger.h"
+#include "../Util/Profiler.h"
+
+RenderTargetPool::RenderTargetPool() :
+	mTargets(),
+	mDescs(),
+	mScreenWidth(0),
+	mScreenHeight(0)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+	std::cout << "Deleted RenderTargetPool\n";
+
+	Release();
+}
+
+void RenderTargetPool::Execute(RenderGraph& graph, int screenWidth, int screenHeight)
+{
+	// A graph that failed to compile is reported once, then skipped until it changes instead of failing every frame
+	if (!graph.IsCompiled())
+	{
+		if (graph.HasCompileFailed())
+		{
+			return;
+		}
+		if (!graph.Compile())
+		{
+			LOG_ERROR("Render graph failed to compile, none of its " + std::to_string(graph.GetNumPasses()) + " passes will run until it changes");
+			return;
+		}
+	}
+
+	// Recreate the targets if the physical textures or the screen size changed
+	const std::vector<RenderGraphTextureDesc>& descs = graph.GetPhysicalTextures();
+	bool isDirty = screenWidth != mScreenWidth || screenHeight != mScreenHeight || descs.size() != mDescs.size();
+	for (size_t i = 0; !isDirty && i < descs.size(); ++i)
+	{
+		isDirty = descs[i].scale != mDescs[i].scale || descs[i].format != mDescs[i].format;
+	}
+	if (isDirty)
+	{
+		Allocate(graph, screenWidth, screenHeight);
+	}
+
+	RenderGraphPassContext context = {};
+	for (int p : graph.GetExecutionOrder())
+	{
+		const RenderGraphPass& pass = graph.GetPass(p);
+
+		// Time each pass on the CPU and GPU under its own name
+		Profiler::ScopedTimer timer(Profiler::Get()->GetTimer(pass.name));
+		GpuProfiler::ScopedZone gpuZone(pass.name);
+
+		context.inputs.clear();
+		context.inputUvScales.clear();
+		for (RenderGraphResource input : pass.inputs)
+		{
+			const RenderGraphResourceData& resource = graph.GetResource(input);
+			RenderGraphTarget target = GetTarget(resource, screenWidth, screenHeight);
+			context.inputs.emplace_back(target.texture);
+
+			// Textures aliased onto a larger one only cover its corner
+			glm::vec2 uvScale(1.0f);
+			if (!resource.isImported)
+			{
+				const RenderGraphTarget& physical = mTargets[resource.physicalIndex];
+				uvScale = glm::vec2(static_cast<float>(target.width) / physical.width, static_cast<float>(target.height) / physical.height);
+			}
+			context.inputUvScales.emplace_back(uvScale);
+		}
+
+		context.output = GetTarget(graph.GetResource(pass.output), screenWidth, screenHeight);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, context.output.frameBuffer);
+		glViewport(0, 0, context.output.width, context.output.height);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		pass.execute(context);
+	}
+}
+
+RenderGraphTarget RenderTargetPool::GetTarget(const RenderGraphResourceData& resource, int screenWidth, int screenHeight) const
+{
+	if (resource.isImported)
+	{
+		return resource.imported;
+	}
+
+	RenderGraphTarget target = mTargets[resource.physicalIndex];
+	RenderGraph::CalculateSize(resource.desc, screenWidth, screenHeight, target.width, target.height);
+	return target;
+}
+
+void RenderTargetPool::Release()
+{
+	for (RenderGraphTarget& target : mTargets)
+	{
+		glDeleteFramebuffers(1, &target.frameBuffer);
+		glDeleteTextures(1, &target.texture);
+	}
+	mTargets.clear();
+	mDescs.clear();
+}
+
+void RenderTargetPool::Allocate(const RenderGraph& graph, int screenWidth, int screenHeight)
+{
+	Release();
+
+	mDescs = graph.GetPhysicalTextures();
+	mScreenWidth = screenWidth;
+	mScreenHeight = screenHeight;
+
+	for (const RenderGraphTextureDesc& desc : mDescs)
+	{
+		RenderGraphTarget target = {};
+		RenderGraph::CalculateSize(desc, screenWidth, screenHeight, target.width, target.height);
+
+		GLenum internalFormat = GL_RGBA8;
+		GLenum format = GL_RGBA;
+		if (desc.format == RenderGraphFormat::RGB16F)
+		{
+			internalFormat = GL_RGB16F;
+			format = GL_RGB;
+		}
+		else if (desc.format == RenderGraphFormat::RGBA16F)
+		{
+			internalFormat = GL_RGBA16F;
+		}
+
+		// Create texture to use as a color attachment
+		glGenTextures(1, &target.texture);
+		glBindTexture(GL_TEXTURE_2D, target.texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, target.width, target.height, 0, format, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// Post process passes only draw screen quads, so no depth attachment is needed
+		glGenFramebuffers(1, &target.frameBuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, target.frameBuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			LOG_ERROR("Render target is not complete");
+		}
+
+		mTargets.emplace_back(target);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	LOG_DEBUG("Allocated " + std::to_string(mTargets.size()) + " render targets for " + std::to_string(graph.GetNumResources()) + " render graph textures");
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include "RenderGraph.h"
+
+// RenderTargetPool owns the OpenGL textures and frame buffers behind a RenderGraph's physical
+// textures and executes the graph's passes. Targets are only recreated when the graph's
+// physical textures or the screen size change.
+class RenderTargetPool
+{
+public:
+	RenderTargetPool();
+	~RenderTargetPool();
+
+	// Compiles the graph if needed, makes sure a target exists for every physical texture,
+	// then binds, clears, and sets the viewport of each pass' output before running the pass.
+	// A graph that fails to compile logs an error once and runs no passes until it changes.
+	// Each pass is timed on the CPU and the GPU with profiler timers named after the pass.
+	// @param - RenderGraph& for the graph
+	// @param - int for the screen's width
+	// @param - int for the screen's height
+	void Execute(RenderGraph& graph, int screenWidth, int screenHeight);
+
+	// Deletes every target
+	void Release();
+
+	// Gets the number of targets that are allocated
+	// @return - size_t for the number of targets
+	size_t GetNumTargets() const { return mTargets.size(); }
+
+private:
+	// Creates a target for each of the graph's physical textures
+	// @param - const RenderGraph& for the compiled graph
+	// @param - int for the screen's width
+	// @param - int for the screen's height
+	void Allocate(const RenderGraph& graph, int screenWidth, int screenHeight);
+
+	// Gets the target a texture is drawn to, sized to the texture instead of the physical texture it's aliased onto
+	// @param - const RenderGraphResourceData& for the texture
+	// @param - int for the screen's width
+	// @param - int for the screen's height
+	// @return - RenderGraphTarget for the target
+	RenderGraphTarget GetTarget(const RenderGraphResourceData& resource, int screenWidth, int screenHeight) const;
+
+	// Allocated targets, indexed by physical texture
+	std::vector<RenderGraphTarget> mTargets;
+
+	// Physical textures the targets were created for
+	std::vector<RenderGraphTextureDesc> mDescs;
+
+	// Screen width the targets were created for
+	int mScreenWidth;
+
+	// Screen height the targets were created for
+	int mScreenHeight;
+};
@@ -1,25 +1,35 @@
 #include "Renderer.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <glad/glad.h>
 #include "../Animation/BoneData.h"
 #include "../Components/AnimationComponent3D.h"
 #include "../Entity/Entity.h"
+#include "../Particles/ParticleSystem.h"
 #include "../Util/Logger.h"
 #include "Camera.h"
 #include "FrameBuffer.h"
 #include "FrameBufferMultiSampled.h"
+#include "GpuProfiler.h"
 #include "Material.h"
 #include "Mesh.h"
 #include "Model.h"
+#include "PointShadowMap.h"
+#include "RenderTargetPool.h"
 #include "Shader.h"
 #include "ShadowMap.h"
+#include "Texture.h"
 #include "VertexBuffer.h"
 
 Renderer::Renderer(RendererMode mode) :
+	mParticleSystems(),
 	mCamera(nullptr),
+	mParticleShader(nullptr),
 	mRenderer2D(nullptr),
 	mVertexBuffer(nullptr),
-	mMaterialBuffer(nullptr),
+	mUniformRing(nullptr),
+	mRenderTargetPool(nullptr),
 	mWindow(nullptr),
 	mContext(nullptr),
 	mWindowTitle(),
@@ -67,6 +77,8 @@ bool Renderer::Init(int width, int height, int subsamples, int vsync, bool fulls
 
 	LoadGLAD();
 
+	GpuProfiler::Get()->Init();
+
 	LoadSdlSettings(mouseCaptured);
 
 	SetOpenGLCapabilities();
@@ -89,11 +101,11 @@ bool Renderer::Init(int width, int height, int subsamples, int vsync, bool fulls
 
 	if (mMode == RendererMode::MODE_3D)
 	{
-		// Create a material buffer in 3D mode and save the pointer
-		mMaterialBuffer = CreateUniformBuffer(sizeof(MaterialColors), BufferBindingPoint::Material, "MaterialBuffer");
-	
-		// Create a skeleton buffer in 3D mode
-		CreateUniformBuffer(sizeof(SkeletonConsts), BufferBindingPoint::Skeleton, "SkeletonBuffer");
+		// Create a triple buffered ring in 3D mode for material and skeleton data
+		mUniformRing = new BufferRing(UNIFORM_RING_FRAME_SIZE, 3, BufferRingTarget::Uniform);
+
+		// Create the pool of transient targets used by render graphs
+		mRenderTargetPool = new RenderTargetPool();
 
 		// Create a camera for 3D
 		mCamera = new Camera(this);
@@ -113,6 +125,20 @@ void Renderer::Shutdown()
 	}
 	mUniformBuffers.clear();
 
+	for (auto& sb : mShaderStorageBuffers)
+	{
+		delete sb.second;
+	}
+	mShaderStorageBuffers.clear();
+
+	delete mUniformRing;
+	mUniformRing = nullptr;
+
+	delete mRenderTargetPool;
+	mRenderTargetPool = nullptr;
+
+	GpuProfiler::Get()->Shutdown();
+
 	for (auto fb : mFrameBuffers)
 	{
 		delete fb;
@@ -125,6 +151,12 @@ void Renderer::Shutdown()
 	}
 	mShadowMaps.clear();
 
+	for (auto psm : mPointShadowMaps)
+	{
+		delete psm;
+	}
+	mPointShadowMaps.clear();
+
 	delete mCamera;
 
 	delete mRenderer2D;
@@ -169,10 +201,11 @@ void Renderer::RenderEntity3D(Entity* entity)
 		{
 			Material* material = mesh->GetMaterial();
 
+			material->RequestTextureScreenSize(GetScreenSize(mesh->GetBounds(), modelMatrix));
 			material->SetActive();
 
-			// update material unifrom buffer
-			mMaterialBuffer->UpdateBufferData(&material->GetMats());
+			// Write the material's colors into the uniform ring and bind them
+			mUniformRing->AllocateAndBind(&material->GetMats(), sizeof(MaterialColors), static_cast<unsigned int>(BufferBindingPoint::Material));
 
 			// Upload model matrix if the shader program changed
 			unsigned int currentShaderID = material->GetShader()->GetID();
@@ -180,7 +213,7 @@ void Renderer::RenderEntity3D(Entity* entity)
 			// Check if shader id changed. If so, update model matrix
 			if (currentShaderID != lastBoundShaderID)
 			{
-				material->GetShader()->SetMat4("model", modelMatrix);
+				material->GetShader()->SetMat4(ShaderUniforms::Model, modelMatrix);
 				lastBoundShaderID = currentShaderID;
 			}
 
@@ -204,15 +237,15 @@ void Renderer::RenderEntity3D(Entity* entity, Shader* shader)
 		const std::vector<Mesh*>& meshes = model->GetMeshes();
 
 		shader->SetActive();
-		shader->SetBool("isSkinned", model->HasAnimations());
-		shader->SetMat4("model", entity->GetModelMatrix());
+		shader->SetBool(ShaderUniforms::IsSkinned, model->HasAnimations());
+		shader->SetMat4(ShaderUniforms::Model, entity->GetModelMatrix());
 
 		for (Mesh* mesh : meshes)
 		{
 			Material* material = mesh->GetMaterial();
 
-			// update material unifrom buffer
-			mMaterialBuffer->UpdateBufferData(&material->GetMats());
+			// Write the material's colors into the uniform ring and bind them
+			mUniformRing->AllocateAndBind(&material->GetMats(), sizeof(MaterialColors), static_cast<unsigned int>(BufferBindingPoint::Material));
 
 			VertexBuffer* vb = mesh->GetVertexBuffer();
 			vb->Draw();
@@ -220,9 +253,80 @@ void Renderer::RenderEntity3D(Entity* entity, Shader* shader)
 	}
 }
 
+void Renderer::RenderEntity3D(Entity* entity, Shader* shader, unsigned int numInstances)
+{
+	Model* model = entity->GetModel();
+
+	if (model && numInstances > 0)
+	{
+		if (model->HasAnimations())
+		{
+			entity->GetComponent<AnimationComponent3D>()->UpdateSkeletonBuffer();
+		}
+
+		shader->SetActive();
+		shader->SetBool(ShaderUniforms::IsSkinned, model->HasAnimations());
+		shader->SetMat4(ShaderUniforms::Model, entity->GetModelMatrix());
+
+		for (Mesh* mesh : model->GetMeshes())
+		{
+			mesh->GetVertexBuffer()->DrawInstanced(numInstances);
+		}
+	}
+}
+
 void Renderer::Draw2D()
 {
 	mRenderer2D->DrawSprites();
+
+	DrawParticles();
+}
+
+void Renderer::DrawParticles()
+{
+	if (!mParticleShader || mParticleSystems.empty())
+	{
+		return;
+	}
+
+	if (mMode == RendererMode::MODE_2D)
+	{
+		mRenderer2D->DrawParticles(mParticleSystems, mParticleShader);
+		return;
+	}
+
+	// Billboard the quads with the camera's axes, taken from the rows of the view matrix
+	const glm::mat4& view = mCamera->GetViewMatrix();
+	mParticleShader->SetActive();
+	mParticleShader->SetMat4(ShaderUniforms::ViewProjection, mCamera->GetProjectionMatrix() * view);
+	mParticleShader->SetVec3(ShaderUniforms::CameraRight, glm::vec3(view[0][0], view[1][0], view[2][0]));
+	mParticleShader->SetVec3(ShaderUniforms::CameraUp, glm::vec3(view[0][1], view[1][1], view[2][1]));
+
+	// Particles are depth tested against the scene but don't occlude each other
+	glDepthMask(GL_FALSE);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+	for (ParticleSystem* ps : mParticleSystems)
+	{
+		ps->Draw();
+	}
+
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDepthMask(GL_TRUE);
+}
+
+void Renderer::AddParticleSystem(ParticleSystem* particleSystem)
+{
+	mParticleSystems.emplace_back(particleSystem);
+}
+
+void Renderer::RemoveParticleSystem(ParticleSystem* particleSystem)
+{
+	auto iter = std::find(mParticleSystems.begin(), mParticleSystems.end(), particleSystem);
+	if (iter != mParticleSystems.end())
+	{
+		mParticleSystems.erase(iter);
+	}
 }
 
 void Renderer::SetDefaultFrameBuffer() const
@@ -240,6 +344,13 @@ void Renderer::SetDefaultFrameBuffer() const
 void Renderer::EndFrame()
 {
 	SDL_GL_SwapWindow(mWindow);
+
+	GpuProfiler::Get()->NextFrame();
+
+	if (mUniformRing)
+	{
+		mUniformRing->NextFrame();
+	}
 }
 
 UniformBuffer* Renderer::CreateUniformBuffer(size_t bufferSize, BufferBindingPoint bindingPoint, const char* bufferName)
@@ -263,6 +374,15 @@ UniformBuffer* Renderer::GetUniformBuffer(const std::string& bufferName)
 	return nullptr;
 }
 
+ShaderStorageBuffer* Renderer::CreateShaderStorageBuffer(size_t bufferSize, StorageBindingPoint bindingPoint, const char* bufferName)
+{
+	ShaderStorageBuffer* buffer = new ShaderStorageBuffer(bufferSize, bindingPoint, bufferName);
+
+	mShaderStorageBuffers[bufferName] = buffer;
+
+	return buffer;
+}
+
 FrameBuffer* Renderer::CreateFrameBuffer(int width, int height, Shader* shader)
 {
 	FrameBuffer* framebuffer = new FrameBuffer(width, height, this, shader);
@@ -281,9 +401,9 @@ FrameBufferMultiSampled* Renderer::CreateMultiSampledFrameBuffer(int width, int
 	return framebuffer;
 }
 
-size_t  Renderer::CreateShadowMap(Shader* shader)
+size_t  Renderer::CreateShadowMap(Shader* shader, int numCascades, unsigned int resolution)
 {
-	ShadowMap* shadowMap = new ShadowMap(this);
+	ShadowMap* shadowMap = new ShadowMap(this, numCascades, resolution);
 	shadowMap->SetShader(shader);
 
 	mShadowMaps.emplace_back(shadowMap);
@@ -291,6 +411,16 @@ size_t  Renderer::CreateShadowMap(Shader* shader)
 	return (mShadowMaps.size() - 1);
 }
 
+size_t Renderer::CreatePointShadowMap(Shader* shader, size_t budgetBytes)
+{
+	PointShadowMap* pointShadowMap = new PointShadowMap(this, budgetBytes);
+	pointShadowMap->SetShader(shader);
+
+	mPointShadowMaps.emplace_back(pointShadowMap);
+
+	return (mPointShadowMaps.size() - 1);
+}
+
 void Renderer::CreateBlend(Shader* shader, unsigned int texture1, unsigned int texture2, int textureUnit)
 {
 	shader->SetActive();
@@ -307,6 +437,29 @@ void Renderer::CreateBlend(Shader* shader, unsigned int texture1, unsigned int t
 	glBindTexture(GL_TEXTURE_2D, texture2);
 }
 
+void Renderer::DrawScreenQuad(Shader* shader, unsigned int texture)
+{
+	// Disable depth test so screen quad isn't discarded
+	glDisable(GL_DEPTH_TEST);
+
+	int textureUnit = static_cast<int>(TextureType::FrameBuffer);
+
+	shader->SetActive();
+	shader->SetInt("screenTexture", textureUnit);
+	glActiveTexture(GL_TEXTURE0 + textureUnit);
+	glBindTexture(GL_TEXTURE_2D, texture);
+
+	mVertexBuffer->Draw();
+
+	// Enable depth test again
+	glEnable(GL_DEPTH_TEST);
+}
+
+void Renderer::ExecuteRenderGraph(RenderGraph& graph)
+{
+	mRenderTargetPool->Execute(graph, mWindowWidth, mWindowHeight);
+}
+
 void Renderer::Resize(int width, int height)
 {
 	mWindowWidth = width;
@@ -365,6 +518,33 @@ bool Renderer::InitSDL() const
 	return true;
 }
 
+float Renderer::GetScreenSize(const BoundingBox& bounds, const glm::mat4& model) const
+{
+	if (!mCamera)
+	{
+		return 0.0f;
+	}
+
+	BoundingSphere sphere = GetWorldBoundingSphere(bounds, model);
+	glm::vec3 toCenter = sphere.center - mCamera->GetPosition();
+	float distance = glm::length(toCenter);
+
+	// Up close the mesh can fill the screen
+	if (distance <= sphere.radius)
+	{
+		return static_cast<float>(mWindowHeight);
+	}
+
+	if (glm::dot(toCenter, mCamera->GetForward()) < -sphere.radius)
+	{
+		return 0.0f;
+	}
+
+	// Projected diameter: the screen is 2 * tan(fov / 2) * distance tall at that distance
+	float halfHeight = distance * std::tan(glm::radians(mCamera->GetFOV()) * 0.5f);
+	return sphere.radius / halfHeight * static_cast<float>(mWindowHeight);
+}
+
 void Renderer::LoadOpenGL() const
 {
 	SDL_GL_LoadLibrary(NULL);
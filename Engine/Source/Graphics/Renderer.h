@@ -3,9 +3,16 @@
 #include <unordered_map>
 #include <vector>
 #include <SDL2/SDL.h>
+#include "BoundingVolumes.h"
+#include "BufferRing.h"
 #include "Renderer2D.h"
+#include "ShaderStorageBuffer.h"
+#include "ShadowCascades.h"
 #include "UniformBuffer.h"
 
+// Size of each frame's region in the uniform ring
+const size_t UNIFORM_RING_FRAME_SIZE = 4 * 1024 * 1024;
+
 enum class RendererMode 
 {
 	MODE_2D, // Represents 2D rendering mode
@@ -16,7 +23,12 @@ class Camera;
 class Entity;
 class FrameBuffer;
 class FrameBufferMultiSampled;
+class ParticleSystem;
+class PointShadowMap;
+class RenderGraph;
+class RenderTargetPool;
 class Shader;
+class ShaderStorageBuffer;
 class ShadowMap;
 class UniformBuffer;
 class VertexBuffer;
@@ -54,13 +66,36 @@ public:
 	// @param - Shader* for the shader
 	void RenderEntity3D(Entity* entity, Shader* shader);
 
-	// Draws any 2D sprites, UI, and text with the Renderer2D
+	// Renders several instances of a 3D entity in one draw call per mesh using a specific shader.
+	// The shader uses gl_InstanceID to tell the instances apart.
+	// @param - Entity3D* for the entity
+	// @param - Shader* for the shader
+	// @param - unsigned int for the number of instances
+	void RenderEntity3D(Entity* entity, Shader* shader, unsigned int numInstances);
+
+	// Draws any 2D sprites and particles, UI, and text with the Renderer2D
 	void Draw2D();
 
+	// Draws every particle system as instanced camera facing quads with additive blending.
+	// In 3D this doesn't write depth so it should be called after the opaque geometry.
+	void DrawParticles();
+
+	// Adds a particle system to be drawn by DrawParticles()
+	// @param - ParticleSystem* for the particle system
+	void AddParticleSystem(ParticleSystem* particleSystem);
+
+	// Removes a particle system
+	// @param - ParticleSystem* for the particle system to remove
+	void RemoveParticleSystem(ParticleSystem* particleSystem);
+
+	// Sets the shader used to draw particles
+	// @param - Shader* for the new shader
+	void SetParticleShader(Shader* shader) { mParticleShader = shader; }
+
 	// Sets back to the default frame buffer, clears its color/depth buffers and resets the viewport
 	void SetDefaultFrameBuffer() const;
 
-	// Swap the buffers and present to the screen
+	// Swap the buffers and present to the screen, then moves the uniform ring to the next frame's region
 	void EndFrame();
 
 	// Creates a uniform buffer and saves it into the renderer's map of uniform buffers
@@ -75,6 +110,17 @@ public:
 	// @return - UniformBuffer* for the desired uniform buffer
 	UniformBuffer* GetUniformBuffer(const std::string& bufferName);
 
+	// Gets the ring used to sub-allocate per draw uniform data (material colors, bone matrices)
+	// @return - BufferRing* for the uniform ring
+	BufferRing* GetUniformRing() { return mUniformRing; }
+
+	// Creates a shader storage buffer and saves it into the renderer's map of storage buffers
+	// @param - size_t for the buffer's size, or the amount of memory to allocate to the buffer
+	// @param - StorageBindingPoint for the buffer's binding point
+	// @param - const char* for the buffer's name
+	// @return - ShaderStorageBuffer* for the newly created buffer object
+	ShaderStorageBuffer* CreateShaderStorageBuffer(size_t bufferSize, StorageBindingPoint bindingPoint, const char* bufferName);
+
 	// Creates a frame buffer for the renderer to use
 	// @param - int for the screen/window's width
 	// @param - int for the screen/window's height
@@ -88,10 +134,12 @@ public:
 	// @param - Shader* for the framebuffer's shader
 	FrameBufferMultiSampled* CreateMultiSampledFrameBuffer(int width, int height, int subsamples, Shader* shader);
 
-	// Creates a shadow map and returns it
+	// Creates a cascaded shadow map and returns it
 	// @param - Shader* for the shader used to draw the shadow map
+	// @param - int for the number of cascades
+	// @param - unsigned int for the width/height of each cascade's depth map
 	// @return - size_t for the index to the shadow map
-	size_t CreateShadowMap(Shader* shader);
+	size_t CreateShadowMap(Shader* shader, int numCascades = MAX_CASCADES, unsigned int resolution = 2048);
 
 	ShadowMap* GetShadowMap(size_t index)
 	{
@@ -103,6 +151,22 @@ public:
 		return shadowMap;
 	}
 
+	// Creates a point shadow map that packs the cube faces of several point lights into one depth atlas
+	// @param - Shader* for the shader used to draw the shadow map
+	// @param - size_t for the atlas' memory budget in bytes
+	// @return - size_t for the index to the point shadow map
+	size_t CreatePointShadowMap(Shader* shader, size_t budgetBytes);
+
+	PointShadowMap* GetPointShadowMap(size_t index)
+	{
+		PointShadowMap* pointShadowMap = nullptr;
+		if (index < mPointShadowMaps.size())
+		{
+			pointShadowMap = mPointShadowMaps[index];
+		}
+		return pointShadowMap;
+	}
+
 	// Sets up a shader so that two textures can be additively blended together
 	// @param - Shader* to set active
 	// @param - unsigned int for a reference to the first texture
@@ -110,6 +174,16 @@ public:
 	// @param - int for the texture unit to activate
 	void CreateBlend(Shader* shader, unsigned int texture1, unsigned int texture2, int textureUnit);
 
+	// Draws a screen quad sampling a texture with a shader into the bound frame buffer
+	// @param - Shader* for the shader
+	// @param - unsigned int for the texture bound to the shader's screenTexture sampler
+	void DrawScreenQuad(Shader* shader, unsigned int texture);
+
+	// Executes a render graph's passes, aliasing its transient textures onto the renderer's render target pool.
+	// Only available in 3D mode.
+	// @param - RenderGraph& for the graph (compiled here if it changed)
+	void ExecuteRenderGraph(RenderGraph& graph);
+
 	// Gets the camera
 	// @retur - Camera* for the 3D camera
 	Camera* GetCamera() { return mCamera; }
@@ -183,6 +257,12 @@ private:
 	// Load default OpenGL library, and sets any OpenGL attributes
 	void LoadOpenGL() const;
 
+	// Estimates how many pixels across a mesh covers on screen, used to pick the mip levels its textures stream in
+	// @param - const BoundingBox& for the mesh's local bounds
+	// @param - const glm::mat4& for the model matrix
+	// @return - float for the number of pixels (0 if it's behind the camera)
+	float GetScreenSize(const BoundingBox& bounds, const glm::mat4& model) const;
+
 	// Creates a window based on if the user wants fullscreen or windowed
 	// @return - true if the window was successfully created
 	bool CreateWindow();
@@ -207,23 +287,38 @@ private:
 	// Map of uniform buffers
 	std::unordered_map<std::string, UniformBuffer*> mUniformBuffers;
 
+	// Map of shader storage buffers
+	std::unordered_map<std::string, ShaderStorageBuffer*> mShaderStorageBuffers;
+
 	// Vector of frame buffers used by the renderer
 	std::vector<FrameBuffer*> mFrameBuffers;
 
 	// Vector of shadow maps used by the renderer
 	std::vector<ShadowMap*> mShadowMaps;
 
+	// Vector of point shadow maps used by the renderer
+	std::vector<PointShadowMap*> mPointShadowMaps;
+
+	// Particle systems drawn by DrawParticles()
+	std::vector<ParticleSystem*> mParticleSystems;
+
 	// Camera for different camera modes and view/projection matrix for 3D
 	Camera* mCamera;
 
+	// Shader used to draw particles
+	Shader* mParticleShader;
+
 	// Renderer2D for sprites, text, and UI
 	Renderer2D* mRenderer2D;
 
 	// Vertex buffer to represent the quad vertices that this frame buffer can draw to
 	VertexBuffer* mVertexBuffer;
 
-	// Uniform buffer to send material data to gpu
-	UniformBuffer* mMaterialBuffer;
+	// Persistently mapped ring that per draw uniform data is written into and bound by offset
+	BufferRing* mUniformRing;
+
+	// Textures and frame buffers that render graphs alias their transient textures onto
+	RenderTargetPool* mRenderTargetPool;
 
 	// SDL window used for the game
 	SDL_Window* mWindow;
@@ -5,7 +5,10 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "../Components/SpriteComponent.h"
 #include "../Entity/Entity.h"
+#include "../Particles/ParticleSystem.h"
 #include "Shader.h"
+#include "ShaderUniforms.h"
+#include "SpriteBatch.h"
 #include "Texture.h"
 #include "VertexBuffer.h"
 
@@ -14,10 +17,13 @@ Renderer2D::Renderer2D(float width, float height) :
 	mSpriteShader(nullptr),
 	mUIBoxShader(nullptr),
 	mTextRenderer(nullptr),
-	mVertexBuffer(nullptr)
+	mVertexBuffer(nullptr),
+	mSpriteBatch(nullptr)
 {
 	mTextRenderer = new Text(this);
 
+	mSpriteBatch = new SpriteBatch();
+
 	// Vertex attributes for screen quad that fills the entire screen in Normalized Device Coordinates
 	VertexScreenQuad quadVertices[] =
 	{
@@ -38,6 +44,8 @@ Renderer2D::~Renderer2D()
 
 	delete mTextRenderer;
 
+	delete mSpriteBatch;
+
 	delete mVertexBuffer;
 }
 
@@ -45,44 +53,86 @@ void Renderer2D::DrawSprites()
 {
 	if (mSpriteShader)
 	{
-		mSpriteShader->SetActive();
+		mSpriteBatch->Begin(mSpriteShader, mProjection);
 
-		for (auto sprite : mSprites)
+		for (const SpriteLayer& layer : mSpriteLayers)
 		{
-			if (sprite->IsVisible())
+			// Group the layer's sprites by texture. Sprites with the same draw order
+			// have no order between them, so each texture can be drawn together.
+			size_t numGroups = 0;
+			size_t lastGroup = 0;
+			for (SpriteComponent* sprite : layer.sprites)
 			{
-				Entity* e = sprite->GetEntity();
-
 				Texture* tex = sprite->GetCurrentSprite();
 
-				glm::vec2 size = sprite->GetSize();
-
-				// Calculate model matrix
-				glm::mat4 model = e->GetModelMatrix();
-
-				// Apply sprite size to scale
-				model = glm::scale(model, glm::vec3(size, 1.0f));
+				if (!sprite->IsVisible() || !tex)
+				{
+					continue;
+				}
 
-				// Send model and projection matrix to shader
-				mSpriteShader->SetMat4("model", model);
+				if (numGroups == 0 || mSpriteGroups[lastGroup].texture != tex)
+				{
+					lastGroup = 0;
+					while (lastGroup < numGroups && mSpriteGroups[lastGroup].texture != tex)
+					{
+						++lastGroup;
+					}
+
+					if (lastGroup == numGroups)
+					{
+						if (numGroups == mSpriteGroups.size())
+						{
+							mSpriteGroups.emplace_back();
+						}
+						mSpriteGroups[numGroups].texture = tex;
+						mSpriteGroups[numGroups].sprites.clear();
+						++numGroups;
+					}
+				}
 
-				mSpriteShader->SetMat4("projection", mProjection);
+				mSpriteGroups[lastGroup].sprites.emplace_back(sprite);
+			}
 
-				if (tex)
+			for (size_t g = 0; g < numGroups; ++g)
+			{
+				for (SpriteComponent* sprite : mSpriteGroups[g].sprites)
 				{
-					mSpriteShader->SetInt("sprite", tex->GetTextureUnit());
-
-					// Bind the texture
-					tex->BindTexture();
+					mSpriteBatch->Draw(mSpriteGroups[g].texture, sprite->GetEntity()->GetModelMatrix(), sprite->GetSize(), sprite->GetUVRect());
 				}
-
-				// Draw
-				mVertexBuffer->Draw();
 			}
 		}
+
+		mSpriteBatch->End();
 	}
 }
 
+void Renderer2D::DrawParticles(const std::vector<ParticleSystem*>& particleSystems, Shader* shader)
+{
+	shader->SetActive();
+	shader->SetMat4(ShaderUniforms::ViewProjection, mProjection);
+	shader->SetVec3(ShaderUniforms::CameraRight, glm::vec3(1.0f, 0.0f, 0.0f));
+	shader->SetVec3(ShaderUniforms::CameraUp, glm::vec3(0.0f, 1.0f, 0.0f));
+
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+	for (ParticleSystem* ps : particleSystems)
+	{
+		ps->Draw();
+	}
+
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+unsigned int Renderer2D::GetNumSpriteDrawCalls() const
+{
+	return mSpriteBatch->GetNumDrawCalls();
+}
+
+unsigned int Renderer2D::GetNumSpritesDrawn() const
+{
+	return mSpriteBatch->GetNumSprites();
+}
+
 void Renderer2D::DrawRect(float x, float y, float width, float height, const glm::vec4& color)
 {
 	if (mUIBoxShader)
@@ -92,9 +142,9 @@ void Renderer2D::DrawRect(float x, float y, float width, float height, const glm
 		model = glm::scale(model, glm::vec3(width, height, 1.0f));
 
 		mUIBoxShader->SetActive();
-		mUIBoxShader->SetMat4("model", model);
-		mUIBoxShader->SetMat4("projection", mProjection);
-		mUIBoxShader->SetVec4("color", color);
+		mUIBoxShader->SetMat4(ShaderUniforms::Model, model);
+		mUIBoxShader->SetMat4(ShaderUniforms::Projection, mProjection);
+		mUIBoxShader->SetVec4(ShaderUniforms::Color, color);
 		
 		mVertexBuffer->Draw();
 	}
@@ -115,20 +165,41 @@ void Renderer2D::DrawText(const std::string& text, float x, float y, float size,
 
 void Renderer2D::AddSprite(SpriteComponent* sprite)
 {
-	mSprites.emplace_back(sprite);
-	
-	// Sort the vector by draw order (smalll to largest so lower sprites get drawn first and will be further back)
-	std::sort(mSprites.begin(), mSprites.end(), [](SpriteComponent* a, SpriteComponent* b) {
-		return a->GetDrawOrder() < b->GetDrawOrder();
+	// Find the sprite's layer (small to largest so lower layers get drawn first and will be further back)
+	int drawOrder = sprite->GetDrawOrder();
+	auto iter = std::lower_bound(mSpriteLayers.begin(), mSpriteLayers.end(), drawOrder, [](const SpriteLayer& layer, int order) {
+		return layer.drawOrder < order;
 	});
+
+	if (iter == mSpriteLayers.end() || iter->drawOrder != drawOrder)
+	{
+		iter = mSpriteLayers.insert(iter, SpriteLayer{ drawOrder, {} });
+	}
+
+	sprite->SetLayerIndex(iter->sprites.size());
+	iter->sprites.emplace_back(sprite);
 }
 
 void Renderer2D::RemoveSprite(SpriteComponent* sprite)
 {
-	auto iter = std::find(mSprites.begin(), mSprites.end(), sprite);
-	if (iter != mSprites.end())
+	int drawOrder = sprite->GetDrawOrder();
+	auto iter = std::lower_bound(mSpriteLayers.begin(), mSpriteLayers.end(), drawOrder, [](const SpriteLayer& layer, int order) {
+		return layer.drawOrder < order;
+	});
+
+	if (iter == mSpriteLayers.end() || iter->drawOrder != drawOrder)
+	{
+		return;
+	}
+
+	std::vector<SpriteComponent*>& sprites = iter->sprites;
+	size_t index = sprite->GetLayerIndex();
+	if (index < sprites.size() && sprites[index] == sprite)
 	{
-		mSprites.erase(iter);
+		// Move the last sprite into the removed sprite's spot
+		sprites[index] = sprites.back();
+		sprites[index]->SetLayerIndex(index);
+		sprites.pop_back();
 	}
 }
 
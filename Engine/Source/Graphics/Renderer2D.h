@@ -4,11 +4,29 @@
 #include <glm/glm.hpp>
 #include "Text.h"
 
+class ParticleSystem;
 class Renderer;
 class Shader;
+class SpriteBatch;
 class SpriteComponent;
+class Texture;
 class VertexBuffer;
 
+// Layer of sprites that share a draw order. Sprites within a layer have no order
+// between them, so they can be stored unsorted and removed by swapping with the last sprite.
+struct SpriteLayer
+{
+	int drawOrder;
+	std::vector<SpriteComponent*> sprites;
+};
+
+// Group of sprites within the same draw order that share a texture
+struct SpriteGroup
+{
+	Texture* texture;
+	std::vector<SpriteComponent*> sprites;
+};
+
 class Renderer2D
 {
 public:
@@ -18,9 +36,15 @@ public:
 	Renderer2D(float width, float height);
 	~Renderer2D();
 
-	// Loops through sprite component vector and draws each sprite
+	// Loops through the sprite layers in draw order and draws the sprites in batches.
+	// Sprites with the same draw order are grouped by texture so each texture is one draw call.
 	void DrawSprites();
 
+	// Draws particle systems on top of the sprites with additive blending using the 2D projection
+	// @param - const std::vector<ParticleSystem*>& for the particle systems
+	// @param - Shader* for the particle shader
+	void DrawParticles(const std::vector<ParticleSystem*>& particleSystems, Shader* shader);
+
 	// Draws rectangle to screen
 	// @param - float for x position
 	// @param - float for y position
@@ -46,13 +70,23 @@ public:
 	// @param - const glm::vec3& for the color of the font (optional, defaults to white)
 	void DrawText(const std::string& text, float x, float y, float size, const glm::vec3& color);
 
-	// Adds a sprite to the sprite renderer, sorting it by draw order (lower means further back)
+	// Adds a sprite to the layer matching its draw order (lower means further back).
+	// Only adding a new draw order inserts a layer, otherwise this is O(1).
 	// @param - SpriteComponent* for the new sprite
 	void AddSprite(SpriteComponent* sprite);
 
-	// Removes a sprite from the sprite renderer
+	// Removes a sprite from its layer in O(1) using the sprite's stored index
+	// @param - SpriteComponent* for the sprite to remove
 	void RemoveSprite(SpriteComponent* sprite);
 
+	// Gets the number of draw calls used for sprites last frame
+	// @return - unsigned int for the number of draw calls
+	unsigned int GetNumSpriteDrawCalls() const;
+
+	// Gets the number of sprites drawn last frame
+	// @return - unsigned int for the number of sprites
+	unsigned int GetNumSpritesDrawn() const;
+
 	// Gets the text renderer
 	// @return - Text* for the text renderer
 	Text* GetTextRenderer() { return mTextRenderer; }
@@ -79,8 +113,11 @@ public:
 	void SetUIBoxShader(Shader* shader) { mUIBoxShader = shader; }
 
 private:
-	// Array of sprites
-	std::vector<SpriteComponent*> mSprites;
+	// Layers of sprites sorted by draw order
+	std::vector<SpriteLayer> mSpriteLayers;
+
+	// Texture groups reused every frame while batching
+	std::vector<SpriteGroup> mSpriteGroups;
 
 	// Projection matrix used for 2D rendering
 	glm::mat4 mProjection;
@@ -96,4 +133,7 @@ private:
 
 	// Vertex buffer to represent the quad vertices that this frame buffer can draw to
 	VertexBuffer* mVertexBuffer;
+
+	// Batches sprites into as few draw calls as possible
+	SpriteBatch* mSpriteBatch;
 };
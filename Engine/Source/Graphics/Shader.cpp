@@ -1,5 +1,6 @@
 ﻿#include "Shader.h"
 #include <iostream>
+#include <unordered_map>
 #include "../MemoryManager/AssetManager.h"
 #include "../Util/Logger.h"
 #include "Renderer.h"
@@ -8,8 +9,16 @@
 
 Shader::Shader(AssetManager* am, const std::string& name, const char* vertexFile, const char* fragmentFile, const char* geometryFile) :
     mName(name),
-	mShaderID(0)
+	mShaderID(0),
+    mProgramFiles()
 {
+    mProgramFiles.emplace_back(vertexFile);
+    mProgramFiles.emplace_back(fragmentFile);
+    if (geometryFile != nullptr)
+    {
+        mProgramFiles.emplace_back(geometryFile);
+    }
+
     // Create a shader program and save the ID reference into mShaderID
     mShaderID = glCreateProgram();
 
@@ -28,6 +37,63 @@ Shader::Shader(AssetManager* am, const std::string& name, const char* vertexFile
         glAttachShader(mShaderID, geometryProgram->GetShaderID());
     }
 
+    LinkProgram();
+}
+
+Shader::Shader(AssetManager* am, const std::string& name, const char* computeFile) :
+    mName(name),
+    mShaderID(0),
+    mProgramFiles({ computeFile })
+{
+    // Create a shader program and save the ID reference into mShaderID
+    mShaderID = glCreateProgram();
+
+    // Load and attach compute shader
+    ShaderProgram* computeProgram = am->LoadShaderProgram(computeFile);
+    glAttachShader(mShaderID, computeProgram->GetShaderID());
+
+    LinkProgram();
+}
+
+Shader::~Shader()
+{
+    std::cout << "Deleted shader: " << mName << " "  << mShaderID << "\n";
+
+    LOG_DEBUG("Deleted shader: " + mName + " " + std::to_string(mShaderID));
+
+    glDeleteProgram(mShaderID);
+    mShaderID = 0;
+}
+
+bool Shader::Relink(AssetManager* am)
+{
+    unsigned int oldShaderID = mShaderID;
+
+    mShaderID = glCreateProgram();
+    for (const std::string& programFile : mProgramFiles)
+    {
+        glAttachShader(mShaderID, am->LoadShaderProgram(programFile)->GetShaderID());
+    }
+
+    // The uniform table is only rebuilt if the link works, so the old program is still usable if it doesn't
+    if (!LinkProgram())
+    {
+        glDeleteProgram(mShaderID);
+        mShaderID = oldShaderID;
+        return false;
+    }
+
+    CopyUniforms(oldShaderID);
+    glDeleteProgram(oldShaderID);
+
+    LOG_DEBUG("Relinked shader: " + mName + " " + std::to_string(mShaderID));
+    std::cout << "Relinked shader: " << mName << " " << mShaderID << "\n";
+
+    return true;
+}
+
+bool Shader::LinkProgram()
+{
     // Link shader program
     glLinkProgram(mShaderID);
 
@@ -41,21 +107,135 @@ Shader::Shader(AssetManager* am, const std::string& name, const char* vertexFile
         std::cout << "Shader program creation failed\n" << infoLog << "\n";
 
         LOG_ERROR("Shader program creation failed\nOpenGL " + std::string(infoLog));
+        return false;
     }
-    else
-    {
-        LinkShadersToUniformBlocks();
-    }
+
+    LinkShadersToUniformBlocks();
+
+    ReflectUniforms();
+
+    return true;
 }
 
-Shader::~Shader()
+void Shader::CopyUniforms(unsigned int fromProgram) const
 {
-    std::cout << "Deleted shader: " << mName << " "  << mShaderID << "\n";
+    // Types of this program's uniforms, so a uniform whose type changed isn't set with the old type
+    std::unordered_map<std::string, GLenum> types;
+    GLint numUniforms = 0;
+    GLint maxNameLen = 0;
+    glGetProgramiv(mShaderID, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(mShaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLen);
 
-    LOG_DEBUG("Deleted shader: " + mName + " " + std::to_string(mShaderID));
+    std::vector<char> name(static_cast<size_t>(std::max(maxNameLen, 1)));
+    for (int i = 0; i < numUniforms; ++i)
+    {
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(mShaderID, i, maxNameLen, NULL, &size, &type, name.data());
+        types[name.data()] = type;
+    }
 
-    glDeleteProgram(mShaderID);
-    mShaderID = 0;
+    glGetProgramiv(fromProgram, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(fromProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLen);
+    name.resize(static_cast<size_t>(std::max(maxNameLen, 1)));
+
+    for (int i = 0; i < numUniforms; ++i)
+    {
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(fromProgram, i, maxNameLen, NULL, &size, &type, name.data());
+
+        auto newType = types.find(name.data());
+        if (newType == types.end() || newType->second != type)
+        {
+            continue;
+        }
+
+        // Copy one element at a time, since a changed array might be shorter now
+        std::string nameString = name.data();
+        size_t bracket = nameString.rfind("[0]");
+        std::string baseName = bracket != std::string::npos && bracket + 3 == nameString.size() ? nameString.substr(0, bracket) : nameString;
+
+        for (int element = 0; element < size; ++element)
+        {
+            std::string elementName = size > 1 ? baseName + "[" + std::to_string(element) + "]" : nameString;
+            int fromLocation = glGetUniformLocation(fromProgram, elementName.c_str());
+            int toLocation = glGetUniformLocation(mShaderID, elementName.c_str());
+            if (fromLocation == -1 || toLocation == -1)
+            {
+                continue;
+            }
+
+            GLfloat floats[16] = {};
+            GLint ints[4] = {};
+            GLuint uints[1] = {};
+            switch (type)
+            {
+            case GL_FLOAT:
+                glGetUniformfv(fromProgram, fromLocation, floats);
+                glProgramUniform1fv(mShaderID, toLocation, 1, floats);
+                break;
+            case GL_FLOAT_VEC2:
+                glGetUniformfv(fromProgram, fromLocation, floats);
+                glProgramUniform2fv(mShaderID, toLocation, 1, floats);
+                break;
+            case GL_FLOAT_VEC3:
+                glGetUniformfv(fromProgram, fromLocation, floats);
+                glProgramUniform3fv(mShaderID, toLocation, 1, floats);
+                break;
+            case GL_FLOAT_VEC4:
+                glGetUniformfv(fromProgram, fromLocation, floats);
+                glProgramUniform4fv(mShaderID, toLocation, 1, floats);
+                break;
+            case GL_FLOAT_MAT3:
+                glGetUniformfv(fromProgram, fromLocation, floats);
+                glProgramUniformMatrix3fv(mShaderID, toLocation, 1, GL_FALSE, floats);
+                break;
+            case GL_FLOAT_MAT4:
+                glGetUniformfv(fromProgram, fromLocation, floats);
+                glProgramUniformMatrix4fv(mShaderID, toLocation, 1, GL_FALSE, floats);
+                break;
+            case GL_INT_VEC2:
+                glGetUniformiv(fromProgram, fromLocation, ints);
+                glProgramUniform2iv(mShaderID, toLocation, 1, ints);
+                break;
+            case GL_INT_VEC3:
+                glGetUniformiv(fromProgram, fromLocation, ints);
+                glProgramUniform3iv(mShaderID, toLocation, 1, ints);
+                break;
+            case GL_INT_VEC4:
+                glGetUniformiv(fromProgram, fromLocation, ints);
+                glProgramUniform4iv(mShaderID, toLocation, 1, ints);
+                break;
+            case GL_UNSIGNED_INT:
+                glGetUniformuiv(fromProgram, fromLocation, uints);
+                glProgramUniform1uiv(mShaderID, toLocation, 1, uints);
+                break;
+            case GL_INT:
+            case GL_BOOL:
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_2D_ARRAY_SHADOW:
+            case GL_SAMPLER_CUBE_SHADOW:
+            case GL_SAMPLER_CUBE_MAP_ARRAY:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_SAMPLER_BUFFER:
+            case GL_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+                // Ints, bools, and samplers are all set with one int
+                glGetUniformiv(fromProgram, fromLocation, ints);
+                glProgramUniform1iv(mShaderID, toLocation, 1, ints);
+                break;
+            default:
+                // Types the engine doesn't set (unsigned and bool vectors, other matrices) keep the new program's defaults
+                break;
+            }
+        }
+    }
 }
 
 void Shader::LinkShadersToUniformBlocks() const
@@ -90,6 +270,65 @@ void Shader::LinkShadersToUniformBlocks() const
     }
 }
 
+void Shader::ReflectUniforms()
+{
+    mUniforms.clear();
+
+    GLint numUniforms = 0;
+    GLint maxNameLen = 0;
+    glGetProgramiv(mShaderID, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(mShaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLen);
+
+    std::vector<char> name(static_cast<size_t>(std::max(maxNameLen, 1)));
+
+    for (int i = 0; i < numUniforms; ++i)
+    {
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(mShaderID, i, maxNameLen, NULL, &size, &type, name.data());
+        std::string nameString = name.data();
+
+        // Uniforms inside of uniform blocks don't have a location
+        int location = glGetUniformLocation(mShaderID, nameString.c_str());
+        if (location == -1)
+        {
+            continue;
+        }
+
+        // Arrays are reported as "name[0]", so store the base name and every element like glGetUniformLocation accepts
+        size_t bracket = nameString.rfind("[0]");
+        if (bracket != std::string::npos && bracket + 3 == nameString.size())
+        {
+            std::string baseName = nameString.substr(0, bracket);
+            mUniforms.emplace_back(ShaderUniform{ HashUniformName(baseName), location });
+
+            for (int element = 0; element < size; ++element)
+            {
+                std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                int elementLocation = glGetUniformLocation(mShaderID, elementName.c_str());
+                mUniforms.emplace_back(ShaderUniform{ HashUniformName(elementName), elementLocation });
+            }
+        }
+        else
+        {
+            mUniforms.emplace_back(ShaderUniform{ HashUniformName(nameString), location });
+        }
+    }
+
+    std::sort(mUniforms.begin(), mUniforms.end(), [](const ShaderUniform& a, const ShaderUniform& b) {
+        return a.hash < b.hash;
+    });
+
+    // Two names with the same hash would silently set the wrong uniform
+    for (size_t i = 1; i < mUniforms.size(); ++i)
+    {
+        if (mUniforms[i].hash == mUniforms[i - 1].hash)
+        {
+            LOG_WARNING("Uniform name hash collision in shader: " + mName);
+        }
+    }
+}
+
 int Shader::GetBindingPointFromName(const std::string& blockName) const
 {
     if (blockName == ShaderUniforms::CameraBuffer)
@@ -116,6 +355,14 @@ int Shader::GetBindingPointFromName(const std::string& blockName) const
     {
         return static_cast<int>(BufferBindingPoint::PointShadow);
     }
+    if (blockName == ShaderUniforms::CascadeBuffer)
+    {
+        return static_cast<int>(BufferBindingPoint::Cascade);
+    }
+    if (blockName == ShaderUniforms::ClusterBuffer)
+    {
+        return static_cast<int>(BufferBindingPoint::Cluster);
+    }
 
     return -1;
 }
@@ -1,10 +1,20 @@
 #pragma once
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include "ShaderUniforms.h"
 
 class AssetManager;
 
+// Struct for an active uniform's location, stored by its name's hash
+struct ShaderUniform
+{
+    uint32_t hash;  // hash of the uniform's name
+    int location;   // the uniform's location in the program
+};
+
 // Shader class contains a OpenGL program that attaches a vertex,
 // fragment, geometry, shaders etc to a program. This shader class manages
 // when a particular shader program is being set as active, as well as
@@ -25,6 +35,13 @@ public:
 	// @param - const char* for the fragment shader name/file path
     // @param - const char* for the geometry shader name/file path if it exists (defaults to nullptr)
 	Shader(AssetManager* am, const std::string& name, const char* vertexFile, const char* fragmentFile, const char* geometryFile = nullptr);
+
+    // Shader constructor for a compute only program:
+    // loads the compute shader through the AssetManager, attaches it to a program, and links it
+    // @param - AssetManager* for the engine's asset manager
+    // @param - const std::string& for the name of the shader (used to acces through AssetManager)
+    // @param - const char* for the compute shader name/file path
+    Shader(AssetManager* am, const std::string& name, const char* computeFile);
 	~Shader();
 
     // Finds all the uniform buffers used by this shader and calls glUniformBlockBinding on each one with this shader
@@ -36,6 +53,21 @@ public:
     // @return - int for the binding point
     int GetBindingPointFromName(const std::string& blockName) const;
 
+    // Gets a uniform's location from the table built at link time. No driver call is made.
+    // @param - UniformHandle for the uniform
+    // @return - int for the location, -1 if the shader does not have the uniform
+    int GetUniformLocation(UniformHandle handle) const
+    {
+        auto iter = std::lower_bound(mUniforms.begin(), mUniforms.end(), handle.hash,
+            [](const ShaderUniform& uniform, uint32_t hash) { return uniform.hash < hash; });
+
+        if (iter != mUniforms.end() && iter->hash == handle.hash)
+        {
+            return iter->location;
+        }
+        return -1;
+    }
+
 	// Sets this shader program as the active one with glUseProgram
 	// Every shader/rendering call will use this program object and its shaders
 	void SetActive() const { glUseProgram(mShaderID); }
@@ -44,12 +76,30 @@ public:
     // @return - unsigned int for the shader's id
 	unsigned int GetID() const { return mShaderID; }
 
+    // Links the shader's programs again after one of them was reloaded. The new program replaces the old only if it links,
+    // and the old program's uniform values are copied over so uniforms that are only set once keep their values.
+    // @param - AssetManager* for the engine's asset manager
+    // @return - bool for if the new program linked
+    bool Relink(AssetManager* am);
+
+    // Gets the file names of the shader programs this shader links
+    // @return - const std::vector<std::string>& for the file names
+    const std::vector<std::string>& GetProgramFiles() const { return mProgramFiles; }
+
     // Sets bool uniform in a shader
     // @param - const std::string& for the uniform name
     // @param - bool for the new boolean value
     void SetBool(const std::string& name, bool value) const
     {
-        glUniform1i(glGetUniformLocation(mShaderID, name.c_str()), static_cast<int>(value));
+        SetBool(UniformHandle(name), value);
+    }
+
+    // Sets bool uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - bool for the new boolean value
+    void SetBool(UniformHandle handle, bool value) const
+    {
+        glUniform1i(GetUniformLocation(handle), static_cast<int>(value));
     }
 
     // Sets an int uniform in a shader
@@ -57,7 +107,33 @@ public:
     // @param - int for the new int value
     void SetInt(const std::string& name, int value) const
     {
-        glUniform1i(glGetUniformLocation(mShaderID, name.c_str()), value);
+        SetInt(UniformHandle(name), value);
+    }
+
+    // Sets an int uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - int for the new int value
+    void SetInt(UniformHandle handle, int value) const
+    {
+        glUniform1i(GetUniformLocation(handle), value);
+    }
+
+    // Sets an int array uniform in a shader
+    // @param - const std::string& for the uniform name
+    // @param - int for the number of values
+    // @param - const int* for the new values
+    void SetIntArray(const std::string& name, int count, const int* values) const
+    {
+        SetIntArray(UniformHandle(name), count, values);
+    }
+
+    // Sets an int array uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - int for the number of values
+    // @param - const int* for the new values
+    void SetIntArray(UniformHandle handle, int count, const int* values) const
+    {
+        glUniform1iv(GetUniformLocation(handle), count, values);
     }
 
     // Sets a float uniform in a shader
@@ -65,7 +141,15 @@ public:
     // @param - float for the new float value
     void SetFloat(const std::string& name, float value) const
     {
-        glUniform1f(glGetUniformLocation(mShaderID, name.c_str()), value);
+        SetFloat(UniformHandle(name), value);
+    }
+
+    // Sets a float uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - float for the new float value
+    void SetFloat(UniformHandle handle, float value) const
+    {
+        glUniform1f(GetUniformLocation(handle), value);
     }
 
     // Sets a vector2 uniform in a shader
@@ -73,7 +157,15 @@ public:
     // @param - const glm::vec2& for the new vector2
     void SetVec2(const std::string& name, const glm::vec2& value) const
     {
-        glUniform2fv(glGetUniformLocation(mShaderID, name.c_str()), 1, &value[0]);
+        SetVec2(UniformHandle(name), value);
+    }
+
+    // Sets a vector2 uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - const glm::vec2& for the new vector2
+    void SetVec2(UniformHandle handle, const glm::vec2& value) const
+    {
+        glUniform2fv(GetUniformLocation(handle), 1, &value[0]);
     }
 
     // Sets a vector3 uniform in a shader
@@ -81,7 +173,15 @@ public:
     // @param - const glm::vec3& for the new vector3
     void SetVec3(const std::string& name, const glm::vec3& value) const
     {
-        glUniform3fv(glGetUniformLocation(mShaderID, name.c_str()), 1, &value[0]);
+        SetVec3(UniformHandle(name), value);
+    }
+
+    // Sets a vector3 uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - const glm::vec3& for the new vector3
+    void SetVec3(UniformHandle handle, const glm::vec3& value) const
+    {
+        glUniform3fv(GetUniformLocation(handle), 1, &value[0]);
     }
 
     // Sets a vector4 uniform in a shader
@@ -89,7 +189,15 @@ public:
     // @param - const glm::vec4& for the new vector4
     void SetVec4(const std::string& name, const glm::vec4& value) const
     {
-        glUniform4fv(glGetUniformLocation(mShaderID, name.c_str()), 1, &value[0]);
+        SetVec4(UniformHandle(name), value);
+    }
+
+    // Sets a vector4 uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - const glm::vec4& for the new vector4
+    void SetVec4(UniformHandle handle, const glm::vec4& value) const
+    {
+        glUniform4fv(GetUniformLocation(handle), 1, &value[0]);
     }
 
     // Sets a matrix2 uniform in a shader
@@ -97,7 +205,15 @@ public:
     // @param - const glm::mat2& for the new matrix2
     void SetMat2(const std::string& name, const glm::mat2& mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(mShaderID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        SetMat2(UniformHandle(name), mat);
+    }
+
+    // Sets a matrix2 uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - const glm::mat2& for the new matrix2
+    void SetMat2(UniformHandle handle, const glm::mat2& mat) const
+    {
+        glUniformMatrix2fv(GetUniformLocation(handle), 1, GL_FALSE, &mat[0][0]);
     }
 
     // Sets a matrix3 uniform in a shader
@@ -105,7 +221,15 @@ public:
     // @param - const glm::mat3& for the new matrix3
     void SetMat3(const std::string& name, const glm::mat3& mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(mShaderID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        SetMat3(UniformHandle(name), mat);
+    }
+
+    // Sets a matrix3 uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - const glm::mat3& for the new matrix3
+    void SetMat3(UniformHandle handle, const glm::mat3& mat) const
+    {
+        glUniformMatrix3fv(GetUniformLocation(handle), 1, GL_FALSE, &mat[0][0]);
     }
 
     // Sets a matrix4 uniform in a shader
@@ -113,12 +237,38 @@ public:
     // @param - const glm::mat4& for the new matrix4
     void SetMat4(const std::string& name, const glm::mat4& mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(mShaderID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        SetMat4(UniformHandle(name), mat);
+    }
+
+    // Sets a matrix4 uniform in a shader
+    // @param - UniformHandle for the uniform
+    // @param - const glm::mat4& for the new matrix4
+    void SetMat4(UniformHandle handle, const glm::mat4& mat) const
+    {
+        glUniformMatrix4fv(GetUniformLocation(handle), 1, GL_FALSE, &mat[0][0]);
     }
 
 private:
+    // Links the attached shaders and checks for errors, then reflects the program's uniform blocks and uniforms
+    // @return - bool for if the program linked
+    bool LinkProgram();
+
+    // Copies the values of every uniform another program shares with this one by name and type.
+    // Uniforms of types it doesn't know how to copy are skipped.
+    // @param - unsigned int for the other program's id
+    void CopyUniforms(unsigned int fromProgram) const;
+
+    // Reads every active uniform's location once after linking and stores them sorted by name hash
+    void ReflectUniforms();
+
+    // Table of active uniform locations sorted by hash
+    std::vector<ShaderUniform> mUniforms;
+
     std::string mName;
 
 	// The shader program object's reference ID
 	unsigned int mShaderID;
+
+    // File names of the shader programs attached to the program
+    std::vector<std::string> mProgramFiles;
 };
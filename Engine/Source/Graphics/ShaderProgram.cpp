@@ -21,6 +21,34 @@ ShaderProgram::~ShaderProgram()
 	glDeleteShader(mShaderID);
 }
 
+bool ShaderProgram::Reload()
+{
+    std::string code = ReadShaderFile(mPath.c_str());
+    if (code.empty())
+    {
+        return false;
+    }
+
+    unsigned int shader = CompileShader(code.c_str(), mType);
+
+    int success = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        glDeleteShader(shader);
+        return false;
+    }
+
+    glDeleteShader(mShaderID);
+    mShaderID = shader;
+    mCode = std::move(code);
+
+    LOG_DEBUG("Reloaded shader program: \"" + mPath + "\" " + std::to_string(mShaderID));
+    std::cout << "Reloaded shader program: \"" << mPath << "\" " << mShaderID << "\n";
+
+    return true;
+}
+
 GLenum ShaderProgram::LoadType(const std::string& shaderFile)
 {
     std::string extension = shaderFile.substr(shaderFile.find_last_of('.'));
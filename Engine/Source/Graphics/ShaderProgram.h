@@ -32,6 +32,15 @@ public:
 	// @param - GLenum for the shader type
 	unsigned int CompileShader(const char* shaderCode, GLenum type) const;
 
+	// Reads and compiles the shader file again. The new code replaces the old only if it compiles,
+	// so a typo while editing keeps the last working shader.
+	// @return - bool for if the new code compiled
+	bool Reload();
+
+	// Gets the shader's file path
+	// @return - const std::string& for the file path
+	const std::string& GetPath() const { return mPath; }
+
 	// Getter for the shader program's id
 	// @return - unsigned int for the shader's id
 	unsigned int GetShaderID() const { return mShaderID; }
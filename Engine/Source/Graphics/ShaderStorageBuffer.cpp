@@ -0,0 +1,41 @@
+#include "ShaderStorageBuffer.h"
+#include <algorithm>
+#include <iostream>
+#include <glad/glad.h>
+
+ShaderStorageBuffer::ShaderStorageBuffer(size_t bufferSize, StorageBindingPoint bindingPoint, const char* bufferName) :
+	mBufferID(0),
+	mBufferSize(bufferSize),
+	mBindingPoint(static_cast<unsigned int>(bindingPoint)),
+	mBufferName(bufferName)
+{
+	glGenBuffers(1, &mBufferID);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, mBufferSize, NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	// Link the buffer to its binding point
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, mBindingPoint, mBufferID);
+}
+
+ShaderStorageBuffer::~ShaderStorageBuffer()
+{
+	std::cout << "Delete shader storage buffer: " << mBufferName << std::endl;
+	glDeleteBuffers(1, &mBufferID);
+}
+
+void ShaderStorageBuffer::UpdateBufferData(const void* data, size_t size) const
+{
+	size = std::min(size, mBufferSize);
+
+	// Bind buffer to update data
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBufferID);
+	if (size > 0)
+	{
+		// Update only the part of the buffer that is used
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+	}
+	// Unbind
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	// Binding to shader binding point
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, mBindingPoint, mBufferID);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+
+// Enum class for the different shader storage buffer binding points
+enum class StorageBindingPoint
+{
+	PointLights = 0,
+	SpotLights = 1,
+	ClusterRanges = 2,
+	ClusterLightIndices = 3,
+	Particles = 4,
+};
+
+// ShaderStorageBuffer class helps abstract an OpenGL shader storage buffer object. Use this
+// class for data that is too large for a uniform buffer or whose size changes every frame.
+class ShaderStorageBuffer
+{
+public:
+	// ShaderStorageBuffer constructor generates the OpenGL shader storage buffer object
+	// @param - size_t for the buffer's size, or the amount of memory to allocate to the buffer
+	// @param - StorageBindingPoint for the buffer's binding point
+	// @param - const char* for the buffer's name
+	ShaderStorageBuffer(size_t bufferSize, StorageBindingPoint bindingPoint, const char* bufferName);
+	~ShaderStorageBuffer();
+
+	// Updates the start of the buffer's data. Only the given size is uploaded.
+	// @param - const void* for the new data
+	// @param - size_t for the size of the new data in bytes (clamped to the buffer's size)
+	void UpdateBufferData(const void* data, size_t size) const;
+
+	unsigned int GetBindingPoint() const { return mBindingPoint; }
+
+	size_t GetBufferSize() const { return mBufferSize; }
+
+private:
+	// ID reference for the storage buffer
+	unsigned int mBufferID;
+
+	// Size of the buffer
+	size_t mBufferSize;
+
+	// The storage buffer's binding point
+	unsigned int mBindingPoint;
+
+	// The buffer's block name in the shader
+	const char* mBufferName;
+};
@@ -1,6 +1,29 @@
 #pragma once
+#include <cstdint>
 #include <string_view>
 
+// Hashes a uniform name with 32 bit FNV-1a. This is constexpr so names known at compile time cost nothing at runtime.
+// @param - std::string_view for the uniform's name
+// @return - uint32_t for the hash
+constexpr uint32_t HashUniformName(std::string_view name)
+{
+	uint32_t hash = 2166136261u;
+	for (char c : name)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Pre-hashed handle used to look up a uniform's location in a Shader's uniform table
+struct UniformHandle
+{
+	constexpr explicit UniformHandle(std::string_view name) : hash(HashUniformName(name)) {}
+
+	uint32_t hash;
+};
+
 namespace ShaderUniforms
 {
 	const std::string_view CameraBuffer = "CameraBuffer";
@@ -9,4 +32,25 @@ namespace ShaderUniforms
 	const std::string_view SkeletonBuffer = "SkeletonBuffer";
 	const std::string_view ShadowBuffer = "ShadowBuffer";
 	const std::string_view PointShadowBuffer = "PointShadowBuffer";
+	const std::string_view CascadeBuffer = "CascadeBuffer";
+	const std::string_view ClusterBuffer = "ClusterBuffer";
+
+	// Handles for uniforms that are set every draw
+	constexpr UniformHandle Model{ "model" };
+	constexpr UniformHandle Projection{ "projection" };
+	constexpr UniformHandle IsSkinned{ "isSkinned" };
+	constexpr UniformHandle Sprite{ "sprite" };
+	constexpr UniformHandle Color{ "color" };
+	constexpr UniformHandle Text{ "text" };
+	constexpr UniformHandle TextColor{ "textColor" };
+	constexpr UniformHandle TextOffset{ "textOffset" };
+	constexpr UniformHandle ShadowSlot{ "shadowSlot" };
+	constexpr UniformHandle Faces{ "faces" };
+	constexpr UniformHandle ViewProjection{ "viewProjection" };
+	constexpr UniformHandle CameraRight{ "cameraRight" };
+	constexpr UniformHandle CameraUp{ "cameraUp" };
+	constexpr UniformHandle DiffuseSampler{ "textureSamplers.diffuse" };
+	constexpr UniformHandle SpecularSampler{ "textureSamplers.specular" };
+	constexpr UniformHandle EmissionSampler{ "textureSamplers.emission" };
+	constexpr UniformHandle NormalSampler{ "textureSamplers.normal" };
 }
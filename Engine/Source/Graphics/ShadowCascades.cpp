@@ -0,0 +1,114 @@
+#include "ShadowCascades.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+void ShadowCascades::CalculateSplitDistances(int numCascades, float nearPlane, float farPlane, float lambda, std::vector<float>& outSplits)
+{
+	outSplits.resize(static_cast<size_t>(numCascades) + 1);
+
+	outSplits[0] = nearPlane;
+
+	for (int i = 1; i <= numCascades; ++i)
+	{
+		float p = static_cast<float>(i) / static_cast<float>(numCascades);
+		float logSplit = nearPlane * std::pow(farPlane / nearPlane, p);
+		float uniformSplit = nearPlane + (farPlane - nearPlane) * p;
+		outSplits[i] = lambda * logSplit + (1.0f - lambda) * uniformSplit;
+	}
+}
+
+void ShadowCascades::GetFrustumCorners(const glm::mat4& cameraView, float fov, float aspect, float sliceNear, float sliceFar, glm::vec3* outCorners)
+{
+	glm::mat4 inverseViewProj = glm::inverse(glm::perspective(fov, aspect, sliceNear, sliceFar) * cameraView);
+
+	int index = 0;
+	for (int x = 0; x < 2; ++x)
+	{
+		for (int y = 0; y < 2; ++y)
+		{
+			for (int z = 0; z < 2; ++z)
+			{
+				// Transform the NDC cube's corner back into world space
+				glm::vec4 corner = inverseViewProj * glm::vec4(2.0f * x - 1.0f, 2.0f * y - 1.0f, 2.0f * z - 1.0f, 1.0f);
+				outCorners[index] = glm::vec3(corner) / corner.w;
+				++index;
+			}
+		}
+	}
+}
+
+Cascade ShadowCascades::FitCascade(const glm::mat4& cameraView, float fov, float aspect, float sliceNear, float sliceFar,
+	const glm::vec3& lightDir, float casterDistance, unsigned int resolution)
+{
+	glm::vec3 corners[8];
+	GetFrustumCorners(cameraView, fov, aspect, sliceNear, sliceFar, corners);
+
+	glm::vec3 center(0.0f);
+	for (const glm::vec3& corner : corners)
+	{
+		center += corner;
+	}
+	center /= 8.0f;
+
+	// Use a bounding sphere so the projection's size is the same no matter which way the camera faces
+	float radius = 0.0f;
+	for (const glm::vec3& corner : corners)
+	{
+		radius = std::max(radius, glm::length(corner - center));
+	}
+	radius = std::ceil(radius * 16.0f) / 16.0f;
+
+	glm::vec3 dir = glm::normalize(lightDir);
+	glm::vec3 up = std::abs(dir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+	Cascade cascade = {};
+	cascade.splitNear = sliceNear;
+	cascade.splitFar = sliceFar;
+	cascade.radius = radius;
+	// Pull the light back so casters outside of the slice (but between it and the light) are still captured
+	cascade.depth = 2.0f * radius + casterDistance;
+
+	cascade.lightView = glm::lookAt(center - dir * (radius + casterDistance), center, up);
+	cascade.lightProjection = glm::ortho(-radius, radius, -radius, radius, 0.0f, cascade.depth);
+
+	// Snap the projection to whole texels so the shadow edges don't shimmer when the camera moves
+	glm::mat4 shadowMatrix = cascade.lightProjection * cascade.lightView;
+	float halfResolution = static_cast<float>(resolution) * 0.5f;
+	glm::vec4 origin = shadowMatrix * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	origin *= halfResolution;
+	glm::vec4 offset = (glm::round(origin) - origin) / halfResolution;
+	cascade.lightProjection[3][0] += offset.x;
+	cascade.lightProjection[3][1] += offset.y;
+
+	cascade.lightSpace = cascade.lightProjection * cascade.lightView;
+
+	return cascade;
+}
+
+bool ShadowCascades::IsCasterInCascade(const Cascade& cascade, const BoundingSphere& bounds)
+{
+	// Orthographic projection keeps spheres as spheres, so test in clip space with the radius scaled per axis
+	glm::vec4 clip = cascade.lightSpace * glm::vec4(bounds.center, 1.0f);
+	float radiusXY = bounds.radius / cascade.radius;
+	float radiusZ = 2.0f * bounds.radius / cascade.depth;
+
+	// Only reject casters past the far plane. Casters between the light and the near plane still
+	// cast shadows since the depth pass clamps their depth onto the near plane.
+	return std::abs(clip.x) <= 1.0f + radiusXY &&
+		std::abs(clip.y) <= 1.0f + radiusXY &&
+		clip.z - radiusZ <= 1.0f;
+}
+
+void ShadowCascades::CullCasters(const Cascade& cascade, const std::vector<BoundingSphere>& casters, std::vector<unsigned int>& outVisible)
+{
+	outVisible.clear();
+
+	for (size_t i = 0; i < casters.size(); ++i)
+	{
+		if (IsCasterInCascade(cascade, casters[i]))
+		{
+			outVisible.emplace_back(static_cast<unsigned int>(i));
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "BoundingVolumes.h"
+
+// Maximum number of cascades a directional shadow map can split the camera's view frustum into.
+// This needs to match MAX_CASCADES in the shaders.
+const int MAX_CASCADES = 4;
+
+// Struct for a single shadow cascade: the light's view/projection that
+// encloses one slice of the camera's view frustum
+struct Cascade
+{
+	glm::mat4 lightView;	   // light's view matrix for this cascade
+	glm::mat4 lightProjection; // light's orthographic projection (snapped to texel increments)
+	glm::mat4 lightSpace;	   // lightProjection * lightView
+	float splitNear;		   // view space distance where this cascade starts
+	float splitFar;			   // view space distance where this cascade ends
+	float radius;			   // half size of the cascade's orthographic projection
+	float depth;			   // distance between the cascade's near and far plane
+};
+
+// ShadowCascades contains the CPU side math used by cascaded shadow maps. None of these
+// functions touch OpenGL, so they are safe to call from JobManager worker threads.
+namespace ShadowCascades
+{
+	// Calculates the view space split distances for each cascade. Blends a logarithmic and a uniform split scheme.
+	// @param - int for the number of cascades
+	// @param - float for the camera's near plane
+	// @param - float for the farthest distance that receives shadows
+	// @param - float for the blend between uniform (0.0) and logarithmic (1.0) splits
+	// @param - std::vector<float>& that will be filled with numCascades + 1 distances (first is the near plane)
+	void CalculateSplitDistances(int numCascades, float nearPlane, float farPlane, float lambda, std::vector<float>& outSplits);
+
+	// Calculates the 8 world space corners of a slice of the camera's view frustum
+	// @param - const glm::mat4& for the camera's view matrix
+	// @param - float for the camera's field of view in radians
+	// @param - float for the camera's aspect ratio
+	// @param - float for the slice's near distance
+	// @param - float for the slice's far distance
+	// @param - glm::vec3* for an array of 8 corners that will be filled
+	void GetFrustumCorners(const glm::mat4& cameraView, float fov, float aspect, float sliceNear, float sliceFar, glm::vec3* outCorners);
+
+	// Fits a stable orthographic light projection around a slice of the camera's view frustum.
+	// The projection is sized by the slice's bounding sphere so it does not change with camera rotation,
+	// and its origin is snapped to whole shadow map texels so it does not shimmer as the camera moves.
+	// @param - const glm::mat4& for the camera's view matrix
+	// @param - float for the camera's field of view in radians
+	// @param - float for the camera's aspect ratio
+	// @param - float for the slice's near distance
+	// @param - float for the slice's far distance
+	// @param - const glm::vec3& for the light's direction
+	// @param - float for how far behind the slice (towards the light) casters are still captured
+	// @param - unsigned int for the shadow map's resolution
+	// @return - Cascade for the fitted cascade
+	Cascade FitCascade(const glm::mat4& cameraView, float fov, float aspect, float sliceNear, float sliceFar,
+		const glm::vec3& lightDir, float casterDistance, unsigned int resolution);
+
+	// Checks if a shadow caster's bounding sphere overlaps a cascade's light volume (ignoring the near plane)
+	// @param - const Cascade& for the cascade
+	// @param - const BoundingSphere& for the caster's world space bounds
+	// @return - bool for if the caster needs to be drawn into this cascade
+	bool IsCasterInCascade(const Cascade& cascade, const BoundingSphere& bounds);
+
+	// Culls a list of casters against a cascade
+	// @param - const Cascade& for the cascade
+	// @param - const std::vector<BoundingSphere>& for the casters' world space bounds
+	// @param - std::vector<unsigned int>& that will be filled with the indices of the visible casters
+	void CullCasters(const Cascade& cascade, const std::vector<BoundingSphere>& casters, std::vector<unsigned int>& outVisible);
+}
@@ -1,44 +1,70 @@
 #include "ShadowMap.h"
+#include <algorithm>
 #include <iostream>
 #include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
+#include "../Entity/Entity.h"
+#include "Camera.h"
+#include "Model.h"
 #include "Renderer.h"
 #include "Shader.h"
 #include "Texture.h"
 #include "UniformBuffer.h"
 #include "VertexBuffer.h"
 
-const unsigned int SHADOW_WIDTH = 8560;
-const unsigned int SHADOW_HEIGHT = 8560;
-float shadowNearPlane = 1.0f;
-float shadowFarPlane = 1000.0f;
-
-ShadowMap::ShadowMap(Renderer* renderer) :
+ShadowMap::ShadowMap(Renderer* renderer, int numCascades, unsigned int resolution) :
+	mCascades(),
+	mSplits(),
+	mCasterEntities(),
+	mCasterBounds(),
+	mCascadeCasters(),
+	mCascadeCasterIndices(),
+	mCascadeJobs(),
+	mCascadeJobsDone(nullptr),
+	mCameraView(1.0f),
+	mLightDir(0.0f, -1.0f, 0.0f),
 	mShadowConsts({}),
+	mCascadeConsts({}),
 	mShader(nullptr),
 	mVertexBuffer(renderer->GetVertexBuffer()),
-	mShadowBuffer(renderer->CreateUniformBuffer(sizeof(glm::mat4), BufferBindingPoint::Shadow, "ShadowBuffer")),
+	mShadowBuffer(renderer->CreateUniformBuffer(sizeof(ShadowMapConsts), BufferBindingPoint::Shadow, "ShadowBuffer")),
+	mCascadeBuffer(renderer->CreateUniformBuffer(sizeof(CascadeConsts), BufferBindingPoint::Cascade, "CascadeBuffer")),
 	mShadowMapFrameBuffer(0),
 	mShadowMap(0),
-	mTextureUnit(static_cast<int>(TextureType::Shadow))
+	mResolution(resolution),
+	mTextureUnit(static_cast<int>(TextureType::Shadow)),
+	mNumCascades(std::clamp(numCascades, 1, MAX_CASCADES)),
+	mCameraFOV(0.0f),
+	mCameraAspectRatio(1.0f),
+	mShadowDistance(150.0f),
+	mSplitLambda(0.75f),
+	mCasterDistance(50.0f)
 {
+	mCascades.resize(mNumCascades);
+	mCascadeCasters.resize(mNumCascades);
+	mCascadeCasterIndices.resize(mNumCascades);
+	mCascadeJobs.reserve(mNumCascades);
+	for (int i = 0; i < mNumCascades; ++i)
+	{
+		mCascadeJobs.emplace_back(this, i);
+	}
+
 	// Create a framebuffer object
 	glGenFramebuffers(1, &mShadowMapFrameBuffer);
 	glBindFramebuffer(GL_FRAMEBUFFER, mShadowMapFrameBuffer);
 
-	// Create a 2D texture for framebuffer's depth buffer
+	// Create a 2D texture array for the framebuffer's depth buffer, with a layer for each cascade
 	glGenTextures(1, &mShadowMap);
-	glBindTexture(GL_TEXTURE_2D, mShadowMap);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, mShadowMap);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, mResolution, mResolution, mNumCascades, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 	float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
 
-	// Attach the depth texture as framebuffer's depth buffer
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mShadowMap, 0);
+	// Attach the first layer as the framebuffer's depth buffer (SetActive() swaps layers)
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mShadowMap, 0, 0);
 	// Set read and draw buffer to none since this does not need a color buffer
 	glDrawBuffer(GL_NONE);
 	glReadBuffer(GL_NONE);
@@ -55,46 +81,83 @@ ShadowMap::~ShadowMap()
 	glDeleteTextures(1, &mShadowMap);
 }
 
-void ShadowMap::SetActive(float size, float near, float far, const glm::vec3& pos, const glm::vec3& target)
+void ShadowMap::Update(const Camera* camera, const glm::vec3& lightDir, const std::vector<Entity*>& entities, JobManager* jobManager)
 {
-	shadowNearPlane = near;
-	shadowFarPlane = far;
+	mCameraView = camera->GetViewMatrix();
+	mCameraFOV = glm::radians(camera->GetFOV());
+	mCameraAspectRatio = camera->GetAspectRatio();
+	mLightDir = lightDir;
+
+	ShadowCascades::CalculateSplitDistances(mNumCascades, camera->GetNearPlane(), std::min(mShadowDistance, camera->GetFarPlane()), mSplitLambda, mSplits);
+
+	// Gather the world space bounds of every entity with a model on this thread since GetModelMatrix() can update the entity
+	mCasterEntities.clear();
+	mCasterBounds.clear();
+	for (Entity* e : entities)
+	{
+		Model* model = e->GetModel();
+		if (model)
+		{
+			mCasterEntities.emplace_back(e);
+			mCasterBounds.emplace_back(GetWorldBoundingSphere(model->GetBounds(), e->GetModelMatrix()));
+		}
+	}
+
+	// Fit and cull each cascade on a separate thread, waiting only on these jobs and not everything else the job manager is running
+	std::latch cascadeJobsDone(static_cast<std::ptrdiff_t>(mCascadeJobs.size()));
+	mCascadeJobsDone = &cascadeJobsDone;
+	for (CascadeJob& job : mCascadeJobs)
+	{
+		jobManager->AddJob(&job);
+	}
+	cascadeJobsDone.wait();
+	mCascadeJobsDone = nullptr;
+
+	for (int i = 0; i < mNumCascades; ++i)
+	{
+		mCascadeConsts.cascadeLightSpace[i] = mCascades[i].lightSpace;
+		mCascadeConsts.cascadeSplits[i] = glm::vec4(mCascades[i].splitFar, mCascades[i].depth, 0.0f, 0.0f);
+	}
+	mCascadeConsts.cameraView = mCameraView;
+	mCascadeConsts.numCascades = mNumCascades;
+
+	mCascadeBuffer->UpdateBufferData(&mCascadeConsts);
+}
 
-	// First pass will render to shadow map
-	glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+void ShadowMap::SetActive(int cascadeIndex)
+{
+	// Render to the cascade's layer of the shadow map
+	glViewport(0, 0, mResolution, mResolution);
 
-	// Bind to frame buffer
+	// Bind to frame buffer and attach the cascade's layer
 	glBindFramebuffer(GL_FRAMEBUFFER, mShadowMapFrameBuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mShadowMap, 0, cascadeIndex);
 	// Clear depth buffer
 	glClear(GL_DEPTH_BUFFER_BIT);
+	// Clamp casters in front of the near plane onto it instead of clipping them
+	glEnable(GL_DEPTH_CLAMP);
 
-	// Create an othographic projection for a directional shadow from the light's perspective
-	glm::mat4 lightProjection = glm::ortho(-size, size, -size, size, near, far);
-	// Create a look at
-	glm::mat4 lightView = glm::lookAt(pos, target, glm::vec3(0.0f, 1.0f, 0.0f));
-
-	// Multiply the new view and projection to create the light space transform matrix
-	mShadowConsts.lightSpace = lightProjection * lightView;
+	mShadowConsts.lightSpace = mCascades[cascadeIndex].lightSpace;
 
-	// Update the light shadow buffer's data with the new light space matrix
+	// Update the light shadow buffer's data with the cascade's light space matrix
 	mShadowBuffer->UpdateBufferData(&mShadowConsts);
 }
 
-void ShadowMap::DrawDebug(Shader* s)
+void ShadowMap::DrawDebug(Shader* s, int cascadeIndex)
 {
 	glViewport(0, 0, 400, 300);
 	s->SetActive();
-	s->SetFloat("nearPlane", shadowNearPlane);
-	s->SetFloat("farPlane", shadowFarPlane);
+	s->SetInt("layer", cascadeIndex);
 	s->SetInt("depthMap", mTextureUnit);
 	glActiveTexture(GL_TEXTURE0 + mTextureUnit);
-	glBindTexture(GL_TEXTURE_2D, mShadowMap);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, mShadowMap);
 
 	mVertexBuffer->Draw();
 }
 
 void ShadowMap::End(int width, int height) const
 {
+	glDisable(GL_DEPTH_CLAMP);
 	// Bind back to default frame buffer
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	// Set viewport back to screen's width and height
@@ -107,5 +170,25 @@ void ShadowMap::BindShadowMapToShader(Shader* s, const std::string& uniformName)
 	s->SetActive();
 	s->SetInt(uniformName, mTextureUnit);
 	glActiveTexture(GL_TEXTURE0 + mTextureUnit);
-	glBindTexture(GL_TEXTURE_2D, mShadowMap);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, mShadowMap);
+}
+
+void ShadowMap::CascadeJob::DoJob()
+{
+	ShadowMap* sm = mShadowMap;
+	int i = mCascadeIndex;
+
+	sm->mCascades[i] = ShadowCascades::FitCascade(sm->mCameraView, sm->mCameraFOV, sm->mCameraAspectRatio,
+		sm->mSplits[i], sm->mSplits[i + 1], sm->mLightDir, sm->mCasterDistance, sm->mResolution);
+
+	ShadowCascades::CullCasters(sm->mCascades[i], sm->mCasterBounds, sm->mCascadeCasterIndices[i]);
+
+	std::vector<Entity*>& casters = sm->mCascadeCasters[i];
+	casters.clear();
+	for (unsigned int index : sm->mCascadeCasterIndices[i])
+	{
+		casters.emplace_back(sm->mCasterEntities[index]);
+	}
+
+	sm->mCascadeJobsDone->count_down();
 }
@@ -1,38 +1,69 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <latch>
 #include <string>
+#include <vector>
+#include "../Multithreading/JobManager.h"
+#include "ShadowCascades.h"
 
 // Struct for shadow map data to be sent to the shaders
 struct ShadowMapConsts
 {
-	glm::mat4 lightSpace; // matrix for transforming world-space vectors into space that's visible from the light's point of view (light-space)
+	glm::mat4 lightSpace; // matrix for transforming world-space vectors into space that's visible from the light's point of view (light-space) for the cascade being rendered
 };
 
+// Struct for cascade data to be sent to the lighting shaders
+struct CascadeConsts
+{
+	glm::mat4 cascadeLightSpace[MAX_CASCADES]; // light space matrix for each cascade
+	glm::vec4 cascadeSplits[MAX_CASCADES];	   // x = view space distance where the cascade ends, y = cascade's depth range
+	glm::mat4 cameraView;					   // camera's view matrix used to pick a cascade per fragment
+	int numCascades;						   // number of active cascades
+	float padding[3];						   // padding for alignment
+};
+
+class Camera;
+class Entity;
 class Renderer;
 class Shader;
 class UniformBuffer;
 class VertexBuffer;
 
-// ShadowMap is used to create shadows that are cast from a directional light.
-// This creates a depth map using a framebuffer's depth buffer. To render
-// a shadow, render a first pass in Game::Render() after setting ShadowMap::SetActive(). This
-// will render to the depth/shadow map, which will be used to calculate whether the fragments 
-// are in shadow in a second normal render pass.
+// ShadowMap is used to create cascaded shadows that are cast from a directional light.
+// The camera's view frustum is split into several slices (cascades) and each one gets its own
+// layer in a depth texture array. Each frame call ShadowMap::Update() to fit the cascades and cull
+// the shadow casters (done on JobManager threads), then for each cascade call ShadowMap::SetActive()
+// and draw ShadowMap::GetCasters(). The depth layers are used in a second normal render pass to
+// calculate whether the fragments are in shadow.
 class ShadowMap
 {
 public:
 	// ShadowMap constructor:
-	// Creates a frame buffer 
-	ShadowMap(Renderer* renderer);
+	// Creates a frame buffer and a depth texture array with a layer for each cascade
+	// @param - Renderer* for the renderer
+	// @param - int for the number of cascades (clamped to MAX_CASCADES)
+	// @param - unsigned int for the width/height of each cascade's depth map
+	ShadowMap(Renderer* renderer, int numCascades, unsigned int resolution);
 	~ShadowMap();
 
-	// Sets the viewport to fit the depth map's size and binds the framebuffer to
-	// to draw to this shadow map's frame buffer. It will clear the framebuffer's depth buffer
-	// and calculates the light space matrix. It then sends the light space matrix to the mShadowBuffer
-	void SetActive(float size, float near, float far, const glm::vec3& pos, const glm::vec3& target);
-
-	// Renders the shadow/depth map for debug purposes
-	void DrawDebug(Shader* s);
+	// Fits each cascade around its slice of the camera's view frustum and culls the entities that
+	// cast shadows into it. Each cascade is fitted and culled on a JobManager worker thread, and this
+	// blocks until they are all done. The cascade data is then sent to mCascadeBuffer.
+	// @param - const Camera* for the camera viewing the scene
+	// @param - const glm::vec3& for the directional light's direction
+	// @param - const std::vector<Entity*>& for the entities that can cast shadows
+	// @param - JobManager* for the engine's job manager
+	void Update(const Camera* camera, const glm::vec3& lightDir, const std::vector<Entity*>& entities, JobManager* jobManager);
+
+	// Sets the viewport to fit the depth map's size and binds the framebuffer to draw into a cascade's
+	// layer of the shadow map. It will clear that layer's depth and send the cascade's light space matrix to mShadowBuffer
+	// @param - int for the cascade to render to
+	void SetActive(int cascadeIndex);
+
+	// Renders a cascade of the shadow/depth map for debug purposes
+	// @param - Shader* for the debug shader
+	// @param - int for the cascade to show
+	void DrawDebug(Shader* s, int cascadeIndex);
 
 	// Binds back to the default frame buffer, resets the viewport back to the original size, and clears the color/depth buffers
 	// @param - int for the width of the viewport
@@ -44,6 +75,20 @@ public:
 	// @param - const std::string& for the uniform name
 	void BindShadowMapToShader(Shader* s, const std::string& uniformName) const;
 
+	// Gets the entities that cast shadows into a cascade (valid after Update())
+	// @param - int for the cascade
+	// @return - const std::vector<Entity*>& for the culled casters
+	const std::vector<Entity*>& GetCasters(int cascadeIndex) const { return mCascadeCasters[cascadeIndex]; }
+
+	// Gets a cascade's fitted light matrices (valid after Update())
+	// @param - int for the cascade
+	// @return - const Cascade& for the cascade
+	const Cascade& GetCascade(int cascadeIndex) const { return mCascades[cascadeIndex]; }
+
+	// Gets the number of cascades
+	// @return - int for the number of cascades
+	int GetNumCascades() const { return mNumCascades; }
+
 	// Gets the frame buffer's shader
 	// @return - Shader* for the frame buffer's shader
 	Shader* GetShader() { return mShader; }
@@ -52,25 +97,109 @@ public:
 	// @param - Shader* for the new shader
 	void SetShader(Shader* s) { mShader = s; }
 
+	// Sets how far from the camera shadows are drawn
+	// @param - float for the distance
+	void SetShadowDistance(float distance) { mShadowDistance = distance; }
+
+	// Sets the blend between uniform (0.0) and logarithmic (1.0) cascade splits
+	// @param - float for the blend
+	void SetSplitLambda(float lambda) { mSplitLambda = lambda; }
+
+	// Sets how far towards the light casters outside of a cascade's slice are still captured
+	// @param - float for the distance
+	void SetCasterDistance(float distance) { mCasterDistance = distance; }
+
 private:
+	// Job to fit a single cascade and cull its casters on a separate thread
+	class CascadeJob : public JobManager::Job
+	{
+	public:
+		CascadeJob(ShadowMap* shadowMap, int cascadeIndex) :
+			mShadowMap(shadowMap),
+			mCascadeIndex(cascadeIndex)
+		{
+		}
+		void DoJob() override;
+	private:
+		ShadowMap* mShadowMap;
+		int mCascadeIndex;
+	};
+
+	// Cascades fitted this frame
+	std::vector<Cascade> mCascades;
+
+	// View space split distances (mNumCascades + 1 entries)
+	std::vector<float> mSplits;
+
+	// Entities that can cast shadows this frame
+	std::vector<Entity*> mCasterEntities;
+
+	// World space bounds of mCasterEntities
+	std::vector<BoundingSphere> mCasterBounds;
+
+	// Culled casters for each cascade
+	std::vector<std::vector<Entity*>> mCascadeCasters;
+
+	// Culled caster indices for each cascade
+	std::vector<std::vector<unsigned int>> mCascadeCasterIndices;
+
+	// Jobs used to fit each cascade
+	std::vector<CascadeJob> mCascadeJobs;
+
+	// Counts down as this frame's cascade jobs finish (only set while Update() waits on them)
+	std::latch* mCascadeJobsDone;
+
+	// Camera's view matrix for this frame
+	glm::mat4 mCameraView;
+
+	// Light's direction for this frame
+	glm::vec3 mLightDir;
+
 	// Shadow constants
 	ShadowMapConsts mShadowConsts;
 
+	// Cascade constants
+	CascadeConsts mCascadeConsts;
+
 	// The shader used to help draw the frame buffer's quad
 	Shader* mShader;
 
 	// Vertex buffer to represent the quad vertices that this frame buffer can draw to
 	VertexBuffer* mVertexBuffer;
 
-	// Uniform buffer to send shadow data to shaders
+	// Uniform buffer to send the light space matrix of the cascade being rendered
 	UniformBuffer* mShadowBuffer;
 
+	// Uniform buffer to send all cascades to the lighting shaders
+	UniformBuffer* mCascadeBuffer;
+
 	// Frame buffer for the shadow map
 	unsigned int mShadowMapFrameBuffer;
 
-	// Texture used for the depth map
+	// Texture array used for the depth maps (one layer per cascade)
 	unsigned int mShadowMap;
 
+	// Width/height of each cascade's depth map
+	unsigned int mResolution;
+
 	// Shadow texture unit
 	int mTextureUnit;
+
+	// Number of cascades
+	int mNumCascades;
+
+	// Camera's field of view (radians) for this frame
+	float mCameraFOV;
+
+	// Camera's aspect ratio for this frame
+	float mCameraAspectRatio;
+
+	// Distance from the camera that shadows are drawn
+	float mShadowDistance;
+
+	// Blend between uniform and logarithmic splits
+	float mSplitLambda;
+
+	// Distance towards the light that casters are still captured
+	float mCasterDistance;
 };
@@ -0,0 +1,145 @@
+#include "SpriteBatch.h"
+#include <cstddef>
+#include <iostream>
+#include <glad/glad.h>
+#include "Shader.h"
+#include "Texture.h"
+
+SpriteBatch::SpriteBatch(unsigned int maxSprites) :
+	mVertices(),
+	mRanges(),
+	mShader(nullptr),
+	mVAO(0),
+	mVBO(0),
+	mIBO(0),
+	mMaxSprites(maxSprites),
+	mNumDrawCalls(0),
+	mNumSprites(0)
+{
+	mVertices.reserve(static_cast<size_t>(mMaxSprites) * 4);
+
+	// Every quad uses the same index pattern, so the index buffer never changes
+	std::vector<unsigned int> indices(static_cast<size_t>(mMaxSprites) * 6);
+	for (unsigned int i = 0; i < mMaxSprites; ++i)
+	{
+		unsigned int vertex = i * 4;
+		unsigned int* quad = &indices[static_cast<size_t>(i) * 6];
+		quad[0] = vertex + 3;
+		quad[1] = vertex + 1;
+		quad[2] = vertex + 0;
+		quad[3] = vertex + 3;
+		quad[4] = vertex + 2;
+		quad[5] = vertex + 1;
+	}
+
+	glGenVertexArrays(1, &mVAO);
+	glGenBuffers(1, &mVBO);
+	glGenBuffers(1, &mIBO);
+
+	glBindVertexArray(mVAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteVertex) * mMaxSprites * 4, NULL, GL_STREAM_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+	// Position
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, position));
+	// UV
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, uv));
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+	std::cout << "Deleted SpriteBatch\n";
+
+	glDeleteVertexArrays(1, &mVAO);
+	glDeleteBuffers(1, &mVBO);
+	glDeleteBuffers(1, &mIBO);
+}
+
+void SpriteBatch::Begin(Shader* shader, const glm::mat4& projection)
+{
+	mShader = shader;
+	mNumDrawCalls = 0;
+	mNumSprites = 0;
+	mVertices.clear();
+	mRanges.clear();
+
+	mShader->SetActive();
+	mShader->SetMat4(ShaderUniforms::Projection, projection);
+}
+
+void SpriteBatch::Draw(Texture* texture, const glm::mat4& model, const glm::vec2& size, const glm::vec4& uvRect)
+{
+	if (mVertices.size() >= static_cast<size_t>(mMaxSprites) * 4)
+	{
+		Flush();
+	}
+
+	unsigned int sprite = static_cast<unsigned int>(mVertices.size() / 4);
+
+	// Start a new run when the texture changes
+	if (mRanges.empty() || mRanges.back().texture != texture)
+	{
+		mRanges.emplace_back(SpriteBatchRange{ texture, sprite, 0 });
+	}
+	++mRanges.back().numSprites;
+
+	// The quad is centered on the entity, so only the 2D part of the model matrix is needed
+	glm::vec2 center = glm::vec2(model[3]);
+	glm::vec2 halfX = glm::vec2(model[0]) * (size.x * 0.5f);
+	glm::vec2 halfY = glm::vec2(model[1]) * (size.y * 0.5f);
+
+	glm::vec2 uvMin = glm::vec2(uvRect.x, uvRect.y);
+	glm::vec2 uvMax = uvMin + glm::vec2(uvRect.z, uvRect.w);
+
+	mVertices.emplace_back(SpriteVertex{ center - halfX - halfY, glm::vec2(uvMin.x, uvMin.y) });
+	mVertices.emplace_back(SpriteVertex{ center + halfX - halfY, glm::vec2(uvMax.x, uvMin.y) });
+	mVertices.emplace_back(SpriteVertex{ center + halfX + halfY, glm::vec2(uvMax.x, uvMax.y) });
+	mVertices.emplace_back(SpriteVertex{ center - halfX + halfY, glm::vec2(uvMin.x, uvMax.y) });
+}
+
+void SpriteBatch::End()
+{
+	Flush();
+}
+
+void SpriteBatch::Flush()
+{
+	if (mVertices.empty())
+	{
+		return;
+	}
+
+	glBindVertexArray(mVAO);
+
+	// Orphan the old buffer so the driver doesn't wait on draws still using it
+	glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteVertex) * mMaxSprites * 4, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(SpriteVertex) * mVertices.size(), mVertices.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	for (const SpriteBatchRange& range : mRanges)
+	{
+		mShader->SetInt(ShaderUniforms::Sprite, range.texture->GetTextureUnit());
+		range.texture->BindTexture();
+
+		glDrawElements(GL_TRIANGLES, range.numSprites * 6, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * 6 * range.firstSprite));
+
+		++mNumDrawCalls;
+		mNumSprites += range.numSprites;
+	}
+
+	glBindVertexArray(0);
+
+	mVertices.clear();
+	mRanges.clear();
+}
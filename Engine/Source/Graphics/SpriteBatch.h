@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+class Shader;
+class Texture;
+
+// Default number of sprites that fit into the streaming vertex buffer before it is flushed
+const unsigned int MAX_SPRITES_PER_BATCH = 16384;
+
+// Struct for a single sprite vertex that is already transformed into screen space
+struct SpriteVertex
+{
+	glm::vec2 position; // screen space position
+	glm::vec2 uv;		// texture coordinate
+};
+
+// Struct for a run of sprites in the vertex buffer that share a texture
+struct SpriteBatchRange
+{
+	Texture* texture;		  // texture used by every sprite in the run
+	unsigned int firstSprite; // first sprite in the vertex buffer
+	unsigned int numSprites;  // number of sprites in the run
+};
+
+// SpriteBatch builds transformed quads on the CPU and streams them into a single
+// vertex buffer. Consecutive sprites with the same texture are drawn together, so
+// a frame of sprites only needs one draw call per texture change instead of one per sprite.
+class SpriteBatch
+{
+public:
+	// SpriteBatch constructor:
+	// Creates the vertex array, a streaming vertex buffer, and a static index buffer for the quads
+	// @param - unsigned int for the most sprites that are buffered before flushing
+	SpriteBatch(unsigned int maxSprites = MAX_SPRITES_PER_BATCH);
+	~SpriteBatch();
+
+	// Starts a new batch of sprites and resets the draw stats
+	// @param - Shader* for the sprite shader
+	// @param - const glm::mat4& for the projection matrix
+	void Begin(Shader* shader, const glm::mat4& projection);
+
+	// Adds a sprite's quad to the batch. Flushes first if the vertex buffer is full.
+	// @param - Texture* for the sprite's texture
+	// @param - const glm::mat4& for the sprite's model matrix
+	// @param - const glm::vec2& for the sprite's size
+	// @param - const glm::vec4& for the sprite's uv offset (xy) and scale (zw) within the texture
+	void Draw(Texture* texture, const glm::mat4& model, const glm::vec2& size, const glm::vec4& uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+
+	// Flushes any sprites left in the batch
+	void End();
+
+	// Gets the number of draw calls used since Begin()
+	// @return - unsigned int for the number of draw calls
+	unsigned int GetNumDrawCalls() const { return mNumDrawCalls; }
+
+	// Gets the number of sprites drawn since Begin()
+	// @return - unsigned int for the number of sprites
+	unsigned int GetNumSprites() const { return mNumSprites; }
+
+private:
+	// Uploads the buffered quads and issues a draw call for each texture run
+	void Flush();
+
+	// Quads waiting to be drawn (4 vertices each)
+	std::vector<SpriteVertex> mVertices;
+
+	// Texture runs within mVertices
+	std::vector<SpriteBatchRange> mRanges;
+
+	// Shader used for this batch
+	Shader* mShader;
+
+	// Vertex array object
+	unsigned int mVAO;
+
+	// Streaming vertex buffer
+	unsigned int mVBO;
+
+	// Static index buffer with 6 indices per quad
+	unsigned int mIBO;
+
+	// Most sprites the vertex buffer can hold
+	unsigned int mMaxSprites;
+
+	// Draw calls since Begin()
+	unsigned int mNumDrawCalls;
+
+	// Sprites drawn since Begin()
+	unsigned int mNumSprites;
+};
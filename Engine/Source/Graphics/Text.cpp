@@ -1,34 +1,39 @@
 #include "Text.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <freetype/freetype.h>
 #include <ft2build.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include "../Util/Utf8.h"
 #include "Renderer2D.h"
 #include "Shader.h"
 #include "Texture.h"
 
 Text::Text(Renderer2D* renderer) :
+	mCharacterBlocks(),
+	mGlyphAtlas(),
+	mTextMeshCache(),
+	mVertices(),
+	mPageVertices(),
+	mRanges(),
+	mKey(),
+	mRequestedCodepoints(),
+	mJobCodepoints(),
+	mJobGlyphs(),
+	mGlyphJob(this),
 	mRenderer(renderer),
 	mShader(nullptr),
-	mVAO(0),
-	mVBO(0),
-	mMaxBearingY(0)
+	mJobManager(nullptr),
+	mFreeType(nullptr),
+	mFace(nullptr),
+	mNumLoadedGlyphs(0),
+	mMaxBearingY(0),
+	mIsJobRunning(false),
+	mIsJobDone(false),
+	mJobMutex(),
+	mJobDoneCondition()
 {
-	glGenVertexArrays(1, &mVAO);
-	glGenBuffers(1, &mVBO);
-
-	glBindVertexArray(mVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, mVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-	// Position
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-	// UV
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
 }
 
 Text::~Text()
@@ -38,124 +43,310 @@ Text::~Text()
 	ClearCharacters();
 }
 
-void Text::LoadFont(const std::string& fontFileName, unsigned int fontSize)
+void Text::LoadFont(const std::string& fontFileName, unsigned int fontSize, JobManager* jobManager)
 {
 	ClearCharacters();
 
 	// Initialize and load FreeType library
-	FT_Library freeType;
-
-	if (FT_Init_FreeType(&freeType))
+	if (FT_Init_FreeType(&mFreeType))
 	{
 		std::cout << "ERROR::FREETYPE: Could not init FreeType Library\n";
+		mFreeType = nullptr;
 		return;
 	}
 
 	// Load the FreeType font face
-	FT_Face face;
-	if (FT_New_Face(freeType, fontFileName.c_str(), 0, &face))
+	if (FT_New_Face(mFreeType, fontFileName.c_str(), 0, &mFace))
 	{
 		std::cout << "ERROR::FREETYPE: Failed to load font\n";
+		FT_Done_FreeType(mFreeType);
+		mFreeType = nullptr;
+		mFace = nullptr;
 		return;
 	}
 
 	// Set font size
-	FT_Set_Pixel_Sizes(face, 0, fontSize);
+	FT_Set_Pixel_Sizes(mFace, 0, fontSize);
+
+	// Align text to the font's ascender since glyphs are loaded as they are used
+	mMaxBearingY = static_cast<int>(mFace->size->metrics.ascender >> 6);
 
-	// Disable byte alignment
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	mJobManager = jobManager;
+	mKey.font = fontFileName + ":" + std::to_string(fontSize);
+	mCharacterBlocks.resize(UTF8_MAX_CODEPOINT / CHARACTER_BLOCK_SIZE + 1);
+}
 
-	for (unsigned char c = 0; c < 128; ++c)
+void Text::RenderText(const std::string& text, float x, float y, float scale, const glm::vec3& color)
+{
+	if (mShader && mFace)
 	{
-		// Load character glyph
-		if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+		// Pack any glyphs that finished since the last call
+		UpdateGlyphs();
+
+		mKey.text = text;
+		mKey.scale = scale;
+
+		const TextMesh* mesh = mTextMeshCache.Get(mKey);
+		if (!mesh)
+		{
+			LayoutText(text, scale);
+
+			if (!mRequestedCodepoints.empty())
+			{
+				UpdateGlyphs();
+
+				// Without a job manager the glyphs are ready right away, so lay the string out again with them
+				if (!mJobManager)
+				{
+					LayoutText(text, scale);
+				}
+			}
+
+			mesh = mTextMeshCache.Insert(mKey, mVertices, mRanges);
+		}
+
+		if (mesh->ranges.empty())
 		{
-			std::cout << "ERROR::FREETYPE: Failed to load Glyph: " << c << "\n";
-			continue;
+			return;
 		}
 
-		Texture* texture = new Texture(TextureType::Font);
-		texture->BindTexture();
-		texture->GenerateTexture(GL_TEXTURE_2D, face->glyph->bitmap.width, face->glyph->bitmap.rows, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer, 
-			false, false, 1, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+		mShader->SetActive();
+		mShader->SetMat4(ShaderUniforms::Projection, mRenderer->GetProjection());
+		mShader->SetVec3(ShaderUniforms::TextColor, color);
+		mShader->SetVec2(ShaderUniforms::TextOffset, glm::vec2(x, y));
+		mShader->SetInt(ShaderUniforms::Text, static_cast<int>(TextureType::Font));
+
+		glBindVertexArray(mesh->vao);
 
-		int bearingY = face->glyph->bitmap_top;
-		if (bearingY > mMaxBearingY)
+		// One draw per atlas page
+		for (const TextMeshRange& range : mesh->ranges)
 		{
-			mMaxBearingY = bearingY;
+			mGlyphAtlas.GetPage(range.page)->BindTexture();
+			glDrawArrays(GL_TRIANGLES, range.first, range.count);
 		}
-		Character character = {
-			glm::ivec2(static_cast<int>(face->glyph->bitmap.width), static_cast<int>(face->glyph->bitmap.rows)),
-			glm::ivec2(static_cast<int>(face->glyph->bitmap_left), static_cast<int>(face->glyph->bitmap_top)),
-			texture,
-			static_cast<unsigned int>(face->glyph->advance.x)
-		};
-
-		mCharacterMap[c] = character;
+
+		glBindVertexArray(0);
 	}
+}
 
-	// De-allocate FreeType memory
-	FT_Done_Face(face);
-	FT_Done_FreeType(freeType);
+Character& Text::GetCharacter(uint32_t codepoint)
+{
+	if (codepoint > UTF8_MAX_CODEPOINT)
+	{
+		codepoint = UTF8_REPLACEMENT_CHARACTER;
+	}
 
-	// Restore back to 4 byte alignment
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	std::vector<Character>& block = mCharacterBlocks[codepoint / CHARACTER_BLOCK_SIZE];
+	if (block.empty())
+	{
+		Character unloaded = {};
+		unloaded.state = GlyphState::Unloaded;
+		block.resize(CHARACTER_BLOCK_SIZE, unloaded);
+	}
+
+	return block[codepoint % CHARACTER_BLOCK_SIZE];
 }
 
-void Text::RenderText(const std::string& text, float x, float y, float scale, const glm::vec3& color)
+void Text::RasterizeGlyphs()
 {
-	if (mShader)
+	mJobGlyphs.clear();
+
+	for (uint32_t codepoint : mJobCodepoints)
 	{
-		mShader->SetActive();
+		RasterizedGlyph glyph = {};
+		glyph.codepoint = codepoint;
+
+		// Failed glyphs are still returned (empty) so they aren't requested again
+		if (FT_Load_Char(mFace, codepoint, FT_LOAD_RENDER) == 0)
+		{
+			const FT_Bitmap& bitmap = mFace->glyph->bitmap;
+			glyph.size = glm::ivec2(static_cast<int>(bitmap.width), static_cast<int>(bitmap.rows));
+			glyph.bearing = glm::ivec2(mFace->glyph->bitmap_left, mFace->glyph->bitmap_top);
+			glyph.advanceOffset = static_cast<unsigned int>(mFace->glyph->advance.x);
+
+			// Copy the rows tightly packed since FreeType's pitch can include padding
+			glyph.pixels.resize(static_cast<size_t>(glyph.size.x) * glyph.size.y);
+			for (int row = 0; row < glyph.size.y; ++row)
+			{
+				std::memcpy(&glyph.pixels[static_cast<size_t>(row) * glyph.size.x], bitmap.buffer + static_cast<size_t>(row) * std::abs(bitmap.pitch), glyph.size.x);
+			}
+		}
+		else
+		{
+			std::cout << "ERROR::FREETYPE: Failed to load Glyph: " << codepoint << "\n";
+		}
+
+		mJobGlyphs.emplace_back(std::move(glyph));
+	}
+}
+
+void Text::UpdateGlyphs()
+{
+	if (mIsJobRunning && mIsJobDone.load(std::memory_order_acquire))
+	{
+		mIsJobRunning = false;
+
+		float pageScale = 1.0f / static_cast<float>(mGlyphAtlas.GetPageSize());
+
+		for (const RasterizedGlyph& glyph : mJobGlyphs)
+		{
+			Character& c = GetCharacter(glyph.codepoint);
+			c.size = glyph.size;
+			c.bearing = glyph.bearing;
+			c.advanceOffset = glyph.advanceOffset;
+			c.state = GlyphState::Loaded;
+
+			// Empty glyphs like spaces only need their advance
+			if (glyph.size.x > 0 && glyph.size.y > 0)
+			{
+				GlyphRect rect = {};
+				if (!mGlyphAtlas.Allocate(glyph.size.x, glyph.size.y, rect))
+				{
+					std::cout << "ERROR::FREETYPE: Glyph does not fit in the atlas: " << glyph.codepoint << "\n";
+					c.size = glm::ivec2(0);
+					continue;
+				}
+				mGlyphAtlas.CopyPixels(rect, glyph.size.x, glyph.size.y, glyph.size.x, glyph.pixels.data());
 
-		mShader->SetMat4("projection", mRenderer->GetProjection());
+				c.uvRect = glm::vec4(rect.x * pageScale, rect.y * pageScale, glyph.size.x * pageScale, glyph.size.y * pageScale);
+				c.page = rect.page;
+			}
+		}
+
+		mNumLoadedGlyphs += mJobGlyphs.size();
+		mJobGlyphs.clear();
+
+		// Only the changed rows of the atlas are sent to the GPU
+		mGlyphAtlas.Upload();
+		mPageVertices.resize(mGlyphAtlas.GetNumPages());
 
-		for (auto& character : text)
+		// Strings laid out while these glyphs were pending are missing them
+		mTextMeshCache.Clear();
+	}
+
+	if (!mIsJobRunning && !mRequestedCodepoints.empty())
+	{
+		mJobCodepoints.swap(mRequestedCodepoints);
+		mRequestedCodepoints.clear();
+
+		mIsJobRunning = true;
+		mIsJobDone.store(false, std::memory_order_relaxed);
+
+		if (mJobManager)
 		{
-			Character c = mCharacterMap[character];
+			mJobManager->AddJob(&mGlyphJob);
+		}
+		else
+		{
+			mGlyphJob.DoJob();
+			UpdateGlyphs();
+		}
+	}
+}
+
+void Text::LayoutText(const std::string& text, float scale)
+{
+	for (std::vector<TextVertex>& vertices : mPageVertices)
+	{
+		vertices.clear();
+	}
 
-			Texture* texture = c.texture;
+	float x = 0.0f;
+	float y = 0.0f;
+
+	// Lay out the whole string, keeping each page's quads together
+	size_t index = 0;
+	while (index < text.size())
+	{
+		uint32_t codepoint = Utf8::DecodeNext(text, index);
+		Character& c = GetCharacter(codepoint);
+
+		// Request glyphs that haven't been rasterized, they'll be drawn once they are ready
+		if (c.state == GlyphState::Unloaded)
+		{
+			c.state = GlyphState::Pending;
+			mRequestedCodepoints.emplace_back(codepoint);
+		}
 
+		if (c.state == GlyphState::Loaded && c.size.x > 0 && c.size.y > 0)
+		{
 			float xpos = x + c.bearing.x * scale;
 			float ypos = y + (mMaxBearingY - c.bearing.y) * scale;
 
 			float w = c.size.x * scale;
 			float h = c.size.y * scale;
-			// update VBO for each character
-			float vertices[6][4] = {
-				{ xpos,     ypos + h,   0.0f, 1.0f },
-				{ xpos,     ypos,       0.0f, 0.0f },
-				{ xpos + w, ypos,       1.0f, 0.0f },
-
-				{ xpos,     ypos + h,   0.0f, 1.0f },
-				{ xpos + w, ypos,       1.0f, 0.0f },
-				{ xpos + w, ypos + h,   1.0f, 1.0f }
-			};
-
-			mShader->SetVec3("textColor", color);
-			mShader->SetInt("text", texture->GetTextureUnit());
-			
-			texture->BindTexture();
-
-			glBindVertexArray(mVAO);
-
-			// update content of VBO memory
-			glBindBuffer(GL_ARRAY_BUFFER, mVBO);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			// render quad
-			glDrawArrays(GL_TRIANGLES, 0, 6);
-			// now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-			x += (c.advanceOffset >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
+
+			glm::vec2 uvMin = glm::vec2(c.uvRect.x, c.uvRect.y);
+			glm::vec2 uvMax = uvMin + glm::vec2(c.uvRect.z, c.uvRect.w);
+
+			std::vector<TextVertex>& vertices = mPageVertices[c.page];
+			vertices.emplace_back(TextVertex{ glm::vec2(xpos, ypos + h), glm::vec2(uvMin.x, uvMax.y) });
+			vertices.emplace_back(TextVertex{ glm::vec2(xpos, ypos), glm::vec2(uvMin.x, uvMin.y) });
+			vertices.emplace_back(TextVertex{ glm::vec2(xpos + w, ypos), glm::vec2(uvMax.x, uvMin.y) });
+
+			vertices.emplace_back(TextVertex{ glm::vec2(xpos, ypos + h), glm::vec2(uvMin.x, uvMax.y) });
+			vertices.emplace_back(TextVertex{ glm::vec2(xpos + w, ypos), glm::vec2(uvMax.x, uvMin.y) });
+			vertices.emplace_back(TextVertex{ glm::vec2(xpos + w, ypos + h), glm::vec2(uvMax.x, uvMax.y) });
+		}
+
+		// now advance cursors for next glyph (note that advance is number of 1/64 pixels)
+		x += (c.advanceOffset >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
+	}
+
+	mVertices.clear();
+	mRanges.clear();
+	for (unsigned int page = 0; page < mPageVertices.size(); ++page)
+	{
+		const std::vector<TextVertex>& vertices = mPageVertices[page];
+		if (!vertices.empty())
+		{
+			mRanges.emplace_back(TextMeshRange{ page, static_cast<int>(mVertices.size()), static_cast<int>(vertices.size()) });
+			mVertices.insert(mVertices.end(), vertices.begin(), vertices.end());
 		}
 	}
 }
 
 void Text::ClearCharacters()
 {
-	for (auto& c : mCharacterMap)
+	// The glyph job uses the font face, so let it finish first. Only the glyph job is waited on,
+	// not everything else running on the job manager.
+	if (mIsJobRunning)
 	{
-		delete c.second.texture;
+		std::unique_lock<std::mutex> lock(mJobMutex);
+		mJobDoneCondition.wait(lock, [this]() { return mIsJobDone.load(std::memory_order_acquire); });
 	}
-	mCharacterMap.clear();
+	mIsJobRunning = false;
+
+	// Cached meshes point into the old atlas
+	mTextMeshCache.Clear();
+	mCharacterBlocks.clear();
+	mPageVertices.clear();
+	mRequestedCodepoints.clear();
+	mJobCodepoints.clear();
+	mJobGlyphs.clear();
+	mGlyphAtlas.Clear();
+	mNumLoadedGlyphs = 0;
+	mMaxBearingY = 0;
+
+	// De-allocate FreeType memory
+	if (mFace)
+	{
+		FT_Done_Face(mFace);
+		mFace = nullptr;
+	}
+	if (mFreeType)
+	{
+		FT_Done_FreeType(mFreeType);
+		mFreeType = nullptr;
+	}
+}
+
+void Text::GlyphJob::DoJob()
+{
+	mText->RasterizeGlyphs();
+
+	// Notify under the lock so a waiting ClearCharacters() can't return (and the Text be deleted) before this is done with it
+	std::lock_guard<std::mutex> lock(mText->mJobMutex);
+	mText->mIsJobDone.store(true, std::memory_order_release);
+	mText->mJobDoneCondition.notify_all();
 }
@@ -1,51 +1,167 @@
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
+#include "../Multithreading/JobManager.h"
+#include "GlyphAtlas.h"
+#include "TextMeshCache.h"
 
+struct FT_FaceRec_;
+struct FT_LibraryRec_;
 class Renderer2D;
 class Shader;
-class Texture;
+
+// Number of codepoints in each lazily allocated block of characters
+const uint32_t CHARACTER_BLOCK_SIZE = 256;
+
+// Enum class for where a glyph is in the loading process
+enum class GlyphState
+{
+	Unloaded,	// never requested
+	Pending,	// waiting to be rasterized on a worker thread
+	Loaded		// rasterized and packed into the glyph atlas
+};
 
 // Struct for character glyph used for text rendering
 struct Character
 {
-	glm::ivec2 size;				// Size (width and height in pixels) of the glyph texture
+	glm::ivec2 size;				// Size (width and height in pixels) of the glyph
 	glm::ivec2 bearing;				// Offset from baseline to left/top of glyph
-	Texture* texture;				// Texture* for the character
+	glm::vec4 uvRect;				// xy = uv offset, zw = uv scale of the glyph within its atlas page
+	unsigned int page;				// Atlas page that holds the glyph
 	unsigned int advanceOffset;		// Offset to advance to next glyph
+	GlyphState state;				// Whether the glyph has been rasterized yet
 };
 
-// Text class for rendering text displayed by the loaded font
+// Struct for a single text vertex
+struct TextVertex
+{
+	glm::vec2 position;	// screen space position
+	glm::vec2 uv;		// texture coordinate within the glyph's atlas page
+};
+
+// Struct for a glyph's bitmap rasterized by FreeType on a worker thread
+struct RasterizedGlyph
+{
+	std::vector<unsigned char> pixels;	// tightly packed single channel pixels
+	glm::ivec2 size;					// width and height of the bitmap
+	glm::ivec2 bearing;					// offset from baseline to left/top of glyph
+	uint32_t codepoint;					// codepoint of the glyph
+	unsigned int advanceOffset;			// offset to advance to next glyph
+};
+
+// Text class for rendering UTF-8 text displayed by the loaded font.
+// Glyphs are rasterized lazily the first time a codepoint is drawn: requests are
+// batched into a job that runs FreeType on a JobManager worker thread, and the
+// results are packed into a growable glyph atlas on the main thread. Characters
+// live in blocks of CHARACTER_BLOCK_SIZE codepoints that are only allocated once
+// one of their codepoints is used. A whole string is laid out into one vertex
+// buffer and drawn with one draw call per atlas page. Laid out strings are kept
+// in a TextMeshCache so text that doesn't change is only laid out once, and moving
+// it only changes an offset uniform.
 class Text
 {
 public:
 	Text(Renderer2D* renderer);
 	~Text();
 
-	// Loads/sets text font and font size by pixel height
+	// Loads/sets text font and font size by pixel height. No glyphs are rasterized until they are drawn.
 	// @param - const std::string& for the font file name
 	// @param - unsigned int for font pixel height (width auto adjusts based on height)
-	void LoadFont(const std::string& fontFileName, unsigned int fontSize);
+	// @param - JobManager* for the job manager used to rasterize glyphs (optional, glyphs are rasterized immediately if nullptr)
+	void LoadFont(const std::string& fontFileName, unsigned int fontSize, JobManager* jobManager = nullptr);
 
-	// Renders a string of text using pre-compiled font textures
-	// @param - const std::string& for the text
+	// Renders a UTF-8 string of text using the glyph atlas. The string's mesh is looked up
+	// in the text mesh cache by (text, font, scale) and only laid out on a miss. Glyphs that
+	// haven't been rasterized yet are requested and show up once their job finishes.
+	// @param - const std::string& for the UTF-8 text
 	// @param - float for x position
 	// @param - float for y position
 	// @param - float for the scale
 	// @param - const glm::vec3& for the color of the font (optional, defaults to white)
 	void RenderText(const std::string& text, float x, float y, float scale, const glm::vec3& color = glm::vec3(1.0f));
 
-	// Loops through character map and frees each texture and clears the map
+	// Clears every character, the glyph atlas, and the loaded font
 	void ClearCharacters();
 
 	// Sets the shader used for text rendering
 	// @param - Shader* for the new shader
 	void SetShader(Shader* shader) { mShader = shader; }
 
+	// Gets the cache of laid out strings
+	// @return - TextMeshCache& for the cache
+	TextMeshCache& GetTextMeshCache() { return mTextMeshCache; }
+
+	// Gets the number of glyphs that have been rasterized into the atlas
+	// @return - size_t for the number of glyphs
+	size_t GetNumLoadedGlyphs() const { return mNumLoadedGlyphs; }
+
 private:
-	// Map of char to Character glyph
-	std::unordered_map<char, Character> mCharacterMap;
+	// Job to rasterize a batch of requested glyphs with FreeType on a separate thread
+	class GlyphJob : public JobManager::Job
+	{
+	public:
+		GlyphJob(Text* text) :
+			mText(text)
+		{
+		}
+		void DoJob() override;
+	private:
+		Text* mText;
+	};
+
+	// Gets a codepoint's character, allocating its block if needed
+	// @param - uint32_t for the codepoint
+	// @return - Character& for the character
+	Character& GetCharacter(uint32_t codepoint);
+
+	// Rasterizes every codepoint in mJobCodepoints into mJobGlyphs. Only called by one thread at a time.
+	void RasterizeGlyphs();
+
+	// Packs finished glyphs into the atlas and starts a job for any new requests
+	void UpdateGlyphs();
+
+	// Lays out a string at the origin into mVertices, sorted by atlas page
+	// @param - const std::string& for the UTF-8 text
+	// @param - float for the scale
+	void LayoutText(const std::string& text, float scale);
+
+	// Blocks of characters indexed by codepoint / CHARACTER_BLOCK_SIZE (empty until used)
+	std::vector<std::vector<Character>> mCharacterBlocks;
+
+	// Atlas that holds every glyph's bitmap
+	GlyphAtlas mGlyphAtlas;
+
+	// Cache of laid out strings
+	TextMeshCache mTextMeshCache;
+
+	// Vertices of the string being laid out, sorted by atlas page
+	std::vector<TextVertex> mVertices;
+
+	// Vertices of the string being laid out for each atlas page
+	std::vector<std::vector<TextVertex>> mPageVertices;
+
+	// Ranges of mVertices for each atlas page
+	std::vector<TextMeshRange> mRanges;
+
+	// Key used to look up strings in the text mesh cache
+	TextMeshKey mKey;
+
+	// Codepoints requested since the last job started
+	std::vector<uint32_t> mRequestedCodepoints;
+
+	// Codepoints the current job is rasterizing
+	std::vector<uint32_t> mJobCodepoints;
+
+	// Glyphs the current job has rasterized
+	std::vector<RasterizedGlyph> mJobGlyphs;
+
+	// Job used to rasterize glyphs
+	GlyphJob mGlyphJob;
 
 	// 2D renderer pointer
 	Renderer2D* mRenderer;
@@ -53,9 +169,28 @@ private:
 	// Shader used for rendering text
 	Shader* mShader;
 
-	unsigned int mVAO;
-	unsigned int mVBO;
+	// Job manager used to rasterize glyphs
+	JobManager* mJobManager;
+
+	// FreeType library
+	FT_LibraryRec_* mFreeType;
+
+	// FreeType font face, only used by one thread at a time
+	FT_FaceRec_* mFace;
 
-	// Max bearing Y to align text
+	// Number of glyphs rasterized into the atlas
+	size_t mNumLoadedGlyphs;
+
+	// Max bearing Y (font ascender) to align text
 	int mMaxBearingY;
+
+	// Bool for if mGlyphJob has been added to the job manager and hasn't been collected yet
+	bool mIsJobRunning;
+
+	// Set by the job once mJobGlyphs is ready
+	std::atomic<bool> mIsJobDone;
+
+	// Mutex and condition the glyph job signals mIsJobDone with, so ClearCharacters() waits on just that job
+	std::mutex mJobMutex;
+	std::condition_variable mJobDoneCondition;
 };
@@ -0,0 +1,116 @@
+#include "TextMeshCache.h"
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <glad/glad.h>
+#include "Text.h"
+
+TextMeshCache::TextMeshCache(size_t capacity) :
+	mMeshes(),
+	mMeshMap(),
+	mStats({}),
+	mCapacity(capacity)
+{
+}
+
+TextMeshCache::~TextMeshCache()
+{
+	std::cout << "Deleted TextMeshCache\n";
+
+	Clear();
+}
+
+const TextMesh* TextMeshCache::Get(const TextMeshKey& key)
+{
+	auto iter = mMeshMap.find(key);
+
+	if (iter == mMeshMap.end())
+	{
+		++mStats.misses;
+		return nullptr;
+	}
+
+	++mStats.hits;
+
+	// Move to the front as the most recently used
+	mMeshes.splice(mMeshes.begin(), mMeshes, iter->second);
+
+	return &iter->second->mesh;
+}
+
+const TextMesh* TextMeshCache::Insert(const TextMeshKey& key, const std::vector<TextVertex>& vertices, const std::vector<TextMeshRange>& ranges)
+{
+	auto iter = mMeshMap.find(key);
+	if (iter != mMeshMap.end())
+	{
+		mMeshes.splice(mMeshes.begin(), mMeshes, iter->second);
+	}
+	else if (mMeshes.size() >= mCapacity && !mMeshes.empty())
+	{
+		// Reuse the least recently used mesh's buffers for the new string
+		++mStats.evictions;
+		mMeshMap.erase(mMeshes.back().key);
+		mMeshes.splice(mMeshes.begin(), mMeshes, std::prev(mMeshes.end()));
+		mMeshes.front().key = key;
+		mMeshMap[key] = mMeshes.begin();
+	}
+	else
+	{
+		mMeshes.emplace_front(TextMeshEntry{ key, TextMesh{} });
+		CreateBuffers(mMeshes.front().mesh);
+		mMeshMap[key] = mMeshes.begin();
+	}
+
+	TextMesh& mesh = mMeshes.front().mesh;
+	mesh.ranges = ranges;
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+	if (vertices.size() > mesh.capacity)
+	{
+		mesh.capacity = vertices.size();
+		glBufferData(GL_ARRAY_BUFFER, sizeof(TextVertex) * mesh.capacity, vertices.data(), GL_STATIC_DRAW);
+	}
+	else if (!vertices.empty())
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(TextVertex) * vertices.size(), vertices.data());
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	return &mesh;
+}
+
+void TextMeshCache::Clear()
+{
+	for (TextMeshEntry& entry : mMeshes)
+	{
+		DeleteBuffers(entry.mesh);
+	}
+	mMeshes.clear();
+	mMeshMap.clear();
+}
+
+void TextMeshCache::CreateBuffers(TextMesh& mesh)
+{
+	mesh.capacity = 0;
+
+	glGenVertexArrays(1, &mesh.vao);
+	glGenBuffers(1, &mesh.vbo);
+
+	glBindVertexArray(mesh.vao);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+	// Position
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, position));
+	// UV
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, uv));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+void TextMeshCache::DeleteBuffers(TextMesh& mesh)
+{
+	glDeleteVertexArrays(1, &mesh.vao);
+	glDeleteBuffers(1, &mesh.vbo);
+}
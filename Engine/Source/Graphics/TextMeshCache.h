@@ -0,0 +1,123 @@
+#pragma once
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct TextVertex;
+
+// Default number of laid out strings kept on the GPU
+const size_t TEXT_MESH_CACHE_CAPACITY = 256;
+
+// Struct for the key of a laid out string
+struct TextMeshKey
+{
+	std::string text;	// string that was laid out
+	std::string font;	// font (file name and pixel size) the string was laid out with
+	float scale;		// scale the string was laid out with
+
+	bool operator==(const TextMeshKey& other) const { return scale == other.scale && text == other.text && font == other.font; }
+};
+
+// Hash for TextMeshKey so it can be used in an unordered_map
+struct TextMeshKeyHash
+{
+	size_t operator()(const TextMeshKey& key) const
+	{
+		size_t hash = std::hash<std::string>()(key.text);
+		hash ^= std::hash<std::string>()(key.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		hash ^= std::hash<float>()(key.scale) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		return hash;
+	}
+};
+
+// Struct for a run of a text mesh's vertices that use the same glyph atlas page
+struct TextMeshRange
+{
+	unsigned int page;	// glyph atlas page
+	int first;			// first vertex
+	int count;			// number of vertices
+};
+
+// Struct for a string that is laid out at the origin and stored on the GPU
+struct TextMesh
+{
+	std::vector<TextMeshRange> ranges;	// vertices to draw for each atlas page
+	unsigned int vao;					// vertex array object
+	unsigned int vbo;					// vertex buffer with the string's quads
+	size_t capacity;					// number of vertices the vertex buffer can hold
+};
+
+// Struct for the text mesh cache's stats
+struct TextMeshCacheStats
+{
+	unsigned int hits;		// lookups that found a mesh
+	unsigned int misses;	// lookups that had to lay the string out
+	unsigned int evictions;	// meshes evicted to make room for new ones
+};
+
+// TextMeshCache keeps the vertex buffers of recently drawn strings so that text that
+// doesn't change is only laid out once. When the cache is full the least recently used
+// mesh is evicted and its GL buffers are reused for the new string.
+class TextMeshCache
+{
+public:
+	// TextMeshCache constructor
+	// @param - size_t for the most meshes kept at once
+	TextMeshCache(size_t capacity = TEXT_MESH_CACHE_CAPACITY);
+	~TextMeshCache();
+
+	// Finds a mesh and marks it as the most recently used
+	// @param - const TextMeshKey& for the mesh's key
+	// @return - const TextMesh* for the mesh, nullptr if it isn't cached
+	const TextMesh* Get(const TextMeshKey& key);
+
+	// Stores a newly laid out string, evicting the least recently used mesh if the cache is full
+	// @param - const TextMeshKey& for the mesh's key
+	// @param - const std::vector<TextVertex>& for the string's vertices, sorted by atlas page
+	// @param - const std::vector<TextMeshRange>& for each atlas page's vertices
+	// @return - const TextMesh* for the stored mesh
+	const TextMesh* Insert(const TextMeshKey& key, const std::vector<TextVertex>& vertices, const std::vector<TextMeshRange>& ranges);
+
+	// Deletes every mesh
+	void Clear();
+
+	// Gets the cache's stats
+	// @return - const TextMeshCacheStats& for the stats
+	const TextMeshCacheStats& GetStats() const { return mStats; }
+
+	// Resets the cache's stats
+	void ResetStats() { mStats = {}; }
+
+	// Gets the number of cached meshes
+	// @return - size_t for the number of meshes
+	size_t GetSize() const { return mMeshes.size(); }
+
+private:
+	// Struct for a cached mesh and its key
+	struct TextMeshEntry
+	{
+		TextMeshKey key;
+		TextMesh mesh;
+	};
+
+	// Creates the vertex array and buffer for a mesh
+	// @param - TextMesh& for the mesh
+	void CreateBuffers(TextMesh& mesh);
+
+	// Deletes a mesh's vertex array and buffer
+	// @param - TextMesh& for the mesh
+	void DeleteBuffers(TextMesh& mesh);
+
+	// Meshes with the most recently used at the front
+	std::list<TextMeshEntry> mMeshes;
+
+	// Map of keys to their place in mMeshes
+	std::unordered_map<TextMeshKey, std::list<TextMeshEntry>::iterator, TextMeshKeyHash> mMeshMap;
+
+	// Cache stats
+	TextMeshCacheStats mStats;
+
+	// Most meshes kept at once
+	size_t mCapacity;
+};
@@ -1,7 +1,234 @@
 #include "Texture.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <utility>
+#include <vector>
+#include "../MemoryManager/DerivedDataCache.h"
 #include "../Util/Logger.h"
 #include "stb_image.h"
+#include "TextureStreamer.h"
+
+// Bytes at the start of every decoded image in the derived data cache ("GETX")
+static const uint32_t DECODED_TEXTURE_MAGIC = 0x58544547;
+
+// Version of the decoded image format in the derived data cache. Bump this whenever decoding changes.
+static const uint32_t DECODED_TEXTURE_VERSION = 2;
+
+// S3TC formats are an extension OpenGL never made core (but every desktop driver supports), so glad doesn't define them
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+// Header in front of a decoded image's pixels in the derived data cache. Like a DDS file, the pixels
+// are either plain 8 bit channels or every mip level's blocks from largest to smallest.
+struct DecodedTextureHeader
+{
+	uint32_t magic;			// DECODED_TEXTURE_MAGIC
+	uint32_t version;		// DECODED_TEXTURE_VERSION
+	uint32_t width;			// width in pixels
+	uint32_t height;		// height in pixels
+	uint32_t numChannels;	// number of color channels in the source image
+	uint32_t compression;	// TextureCompression of the pixels
+	uint32_t numMips;		// number of mip levels stored
+};
+
+// Maps a decoded image from the derived data cache
+// @param - const std::string& for the key
+// @param - TextureData& for the image, pointing into the mapped file
+// @return - bool for if the image was cached
+static bool LoadDecodedTexture(const std::string& key, TextureData& data)
+{
+	MappedFile file;
+	if (!DerivedDataCache::Get()->Load(key, file))
+	{
+		return false;
+	}
+
+	DecodedTextureHeader header = {};
+	if (file.GetSize() >= sizeof(header))
+	{
+		std::memcpy(&header, file.GetData(), sizeof(header));
+	}
+
+	TextureData cached;
+	cached.width = static_cast<int>(header.width);
+	cached.height = static_cast<int>(header.height);
+	cached.numChannels = static_cast<int>(header.numChannels);
+	cached.compression = static_cast<TextureCompression>(header.compression);
+	cached.numMips = static_cast<int>(header.numMips);
+
+	size_t size = cached.GetSize();
+	if (header.magic != DECODED_TEXTURE_MAGIC || header.version != DECODED_TEXTURE_VERSION || size == 0 || file.GetSize() != sizeof(header) + size)
+	{
+		LOG_WARNING("Decoded texture is corrupt, decoding again: " + key);
+		file.Close();
+		DerivedDataCache::Get()->Remove(key);
+		return false;
+	}
+
+	cached.pixels = const_cast<unsigned char*>(file.GetData() + sizeof(header));
+	cached.cachedFile = std::move(file);
+	data = std::move(cached);
+	return true;
+}
+
+// Makes the header for a decoded image
+// @param - const TextureData& for the image
+// @return - DecodedTextureHeader for the header
+static DecodedTextureHeader MakeDecodedTextureHeader(const TextureData& data)
+{
+	return { DECODED_TEXTURE_MAGIC, DECODED_TEXTURE_VERSION, static_cast<uint32_t>(data.width), static_cast<uint32_t>(data.height),
+		static_cast<uint32_t>(data.numChannels), static_cast<uint32_t>(data.compression), static_cast<uint32_t>(data.numMips) };
+}
+
+// Saves a decoded image to the derived data cache
+// @param - const std::string& for the key
+// @param - const TextureData& for the image
+static void SaveDecodedTexture(const std::string& key, const TextureData& data)
+{
+	DecodedTextureHeader header = MakeDecodedTextureHeader(data);
+
+	std::vector<unsigned char> buffer(sizeof(header) + data.GetSize());
+	std::memcpy(buffer.data(), &header, sizeof(header));
+	std::memcpy(buffer.data() + sizeof(header), data.pixels, data.GetSize());
+
+	DerivedDataCache::Get()->Save(key, buffer.data(), buffer.size());
+}
+
+// Block compresses a decoded image and its mip chain, and saves the blocks to the derived data cache
+// @param - const std::string& for the key
+// @param - const TextureData& for the uncompressed image
+// @param - TextureCompression for the format
+static void SaveCompressedTexture(const std::string& key, const TextureData& data, TextureCompression compression)
+{
+	std::vector<TextureMip> mips = BlockCompression::GetMipChain(compression, data.width, data.height);
+
+	TextureData compressed;
+	compressed.width = data.width;
+	compressed.height = data.height;
+	compressed.numChannels = data.numChannels;
+	compressed.compression = compression;
+	compressed.numMips = static_cast<int>(mips.size());
+	DecodedTextureHeader header = MakeDecodedTextureHeader(compressed);
+
+	std::vector<unsigned char> buffer(sizeof(header) + mips.back().offset + mips.back().size);
+	std::memcpy(buffer.data(), &header, sizeof(header));
+
+	// Each level is box filtered from the one above it, then encoded
+	std::vector<unsigned char> level = BlockCompression::ToRGBA(data.pixels, data.width, data.height, data.numChannels);
+	std::vector<unsigned char> smaller;
+	for (size_t i = 0; i < mips.size(); ++i)
+	{
+		BlockCompression::Encode(compression, level.data(), mips[i].width, mips[i].height, buffer.data() + sizeof(header) + mips[i].offset);
+
+		if (i + 1 < mips.size())
+		{
+			smaller.resize(static_cast<size_t>(mips[i + 1].width) * mips[i + 1].height * 4);
+			BlockCompression::Downsample(level.data(), mips[i].width, mips[i].height, smaller.data());
+			level.swap(smaller);
+		}
+	}
+
+	DerivedDataCache::Get()->Save(key, buffer.data(), buffer.size());
+}
+
+// Gets the OpenGL internal format of a block compressed texture
+// @param - TextureCompression for the format
+// @param - bool for if the colors are in sRGB
+// @return - GLenum for the internal format
+static GLenum GetCompressedInternalFormat(TextureCompression compression, bool isSRGB)
+{
+	switch (compression)
+	{
+	case TextureCompression::BC1:
+		return isSRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case TextureCompression::BC3:
+		return isSRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case TextureCompression::BC5:
+		return GL_COMPRESSED_RG_RGTC2;
+	case TextureCompression::BC7:
+		return isSRGB ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default:
+		return 0;
+	}
+}
+
+TextureData::TextureData() :
+	pixels(nullptr),
+	width(0),
+	height(0),
+	numChannels(0),
+	compression(TextureCompression::None),
+	numMips(1),
+	cachedFile()
+{
+}
+
+TextureData::TextureData(TextureData&& other) noexcept :
+	pixels(std::exchange(other.pixels, nullptr)),
+	width(std::exchange(other.width, 0)),
+	height(std::exchange(other.height, 0)),
+	numChannels(std::exchange(other.numChannels, 0)),
+	compression(std::exchange(other.compression, TextureCompression::None)),
+	numMips(std::exchange(other.numMips, 1)),
+	cachedFile(std::move(other.cachedFile))
+{
+}
+
+TextureData& TextureData::operator=(TextureData&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (!cachedFile.IsOpen())
+		{
+			stbi_image_free(pixels);
+		}
+		pixels = std::exchange(other.pixels, nullptr);
+		width = std::exchange(other.width, 0);
+		height = std::exchange(other.height, 0);
+		numChannels = std::exchange(other.numChannels, 0);
+		compression = std::exchange(other.compression, TextureCompression::None);
+		numMips = std::exchange(other.numMips, 1);
+		cachedFile = std::move(other.cachedFile);
+	}
+	return *this;
+}
+
+TextureData::~TextureData()
+{
+	// Pixels from the cache are unmapped with the file
+	if (!cachedFile.IsOpen())
+	{
+		stbi_image_free(pixels);
+	}
+}
+
+size_t TextureData::GetSize() const
+{
+	if (compression == TextureCompression::None)
+	{
+		return static_cast<size_t>(width) * height * numChannels;
+	}
+
+	std::vector<TextureMip> mips = BlockCompression::GetMipChain(compression, width, height);
+	if (numMips < 1 || numMips > static_cast<int>(mips.size()))
+	{
+		return 0;
+	}
+	return mips[numMips - 1].offset + mips[numMips - 1].size;
+}
 
 Texture::Texture(TextureType type) :
 	mName(),
@@ -10,7 +237,12 @@ Texture::Texture(TextureType type) :
 	mHeight(0),
 	mNumChannels(0),
 	mTextureUnit(static_cast<int>(type)),
-	mType(type)
+	mType(type),
+	mNumMips(1),
+	mResidentMip(0),
+	mRequestedMip(1),
+	mMemorySize(0),
+	mStreamer(nullptr)
 {
 	// Create texture object
 	glGenTextures(1, &mTextureID);
@@ -25,17 +257,48 @@ Texture::Texture(const std::string& textureFile, TextureType type) :
 	mHeight(0),
 	mNumChannels(0),
 	mTextureUnit(static_cast<int>(type)),
-	mType(type)
+	mType(type),
+	mNumMips(1),
+	mResidentMip(0),
+	mRequestedMip(1),
+	mMemorySize(0),
+	mStreamer(nullptr)
 {
 	// Create texture object
 	glGenTextures(1, &mTextureID);
 
-	LoadTexture();
+	LoadTexture(Decode(textureFile, type), 0);
+}
+
+Texture::Texture(const std::string& textureFile, TextureType type, const TextureData& data, int firstMip) :
+	mName(textureFile),
+	mTextureID(0),
+	mWidth(0),
+	mHeight(0),
+	mNumChannels(0),
+	mTextureUnit(static_cast<int>(type)),
+	mType(type),
+	mNumMips(1),
+	mResidentMip(0),
+	mRequestedMip(1),
+	mMemorySize(0),
+	mStreamer(nullptr)
+{
+	// Create texture object
+	glGenTextures(1, &mTextureID);
+
+	LoadTexture(data, firstMip);
 }
 
 Texture::~Texture()
 {
 	std::cout << "Deleted texture: \"" << mName << "\"\n";
+
+	if (mStreamer)
+	{
+		mStreamer->Remove(this);
+	}
+
 	glDeleteTextures(1, &mTextureID);
 }
 
@@ -139,10 +402,16 @@ void Texture::GenerateTexture(GLenum target, int width, int height, GLenum dataT
 	// - Last argument is the actual image data
 	glTexImage2D(target, 0, internalFormat, width, height, 0, dataFormat, dataType, data);
 
+	size_t channelSize = dataType == GL_FLOAT ? sizeof(float) : 1;
+	mMemorySize = static_cast<size_t>(width) * height * numChannels * channelSize;
+
 	if (generatesMipMap)
 	{
 		// Automatically generate all the required mipmaps for the currently bound texture
 		glGenerateMipmap(GL_TEXTURE_2D);
+
+		// The mips add up to a third of the full size level
+		mMemorySize += mMemorySize / 3;
 	}
 
 	// Unbind
@@ -158,36 +427,213 @@ void Texture::BindTexture() const
 	glBindTexture(GL_TEXTURE_2D, mTextureID);
 }
 
-void Texture::LoadTexture()
+TextureData Texture::Decode(const std::string& textureFile, TextureType type)
 {
-	// Load in texture file with stbi_load:
-	unsigned char* data = stbi_load(mName.c_str(), &mWidth, &mHeight, &mNumChannels, 0);
+	TextureData data;
+
+	MappedFile file;
+	if (!file.Open(textureFile))
+	{
+		return data;
+	}
+
+	// Sprites and fonts are drawn top down, everything else expects OpenGL's bottom up rows
+	bool flipTexture = type != TextureType::Sprite && type != TextureType::Font;
+
+	// The header is enough to know the number of channels, and with it the compression
+	int width = 0;
+	int height = 0;
+	int numChannels = 0;
+	stbi_info_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &width, &height, &numChannels);
+	TextureCompression compression = GetCompression(type, numChannels);
+
+	// Decoded images are cached by the file's contents and the settings they were decoded with
+	uint64_t hash = DerivedDataCache::HashBytes(file.GetData(), file.GetSize());
+	hash = DerivedDataCache::CombineHash(hash, DECODED_TEXTURE_VERSION);
+	hash = DerivedDataCache::CombineHash(hash, flipTexture ? 1 : 0);
+	hash = DerivedDataCache::CombineHash(hash, static_cast<uint64_t>(compression));
+	std::string key = DerivedDataCache::MakeKey("texture", hash);
+	if (LoadDecodedTexture(key, data))
+	{
+		return data;
+	}
+
+	// stb_image's flip setting is global, so decode unflipped on this thread and flip the rows here instead
+	stbi_set_flip_vertically_on_load_thread(false);
+	data.pixels = stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &data.width, &data.height, &data.numChannels, 0);
 
-	if (data)
+	if (data.pixels && flipTexture)
+	{
+		size_t rowSize = static_cast<size_t>(data.width) * data.numChannels;
+		std::vector<unsigned char> row(rowSize);
+		for (int y = 0; y < data.height / 2; ++y)
+		{
+			unsigned char* top = data.pixels + rowSize * y;
+			unsigned char* bottom = data.pixels + rowSize * (data.height - 1 - y);
+			std::memcpy(row.data(), top, rowSize);
+			std::memcpy(top, bottom, rowSize);
+			std::memcpy(bottom, row.data(), rowSize);
+		}
+	}
+
+	if (!data.pixels)
+	{
+		return data;
+	}
+
+	if (compression == TextureCompression::None)
+	{
+		SaveDecodedTexture(key, data);
+		return data;
+	}
+
+	// Compressed blocks are used straight from the cache file. If it couldn't be written,
+	// fall back to the uncompressed image and let OpenGL generate the mips.
+	SaveCompressedTexture(key, data, compression);
+	TextureData compressed;
+	if (LoadDecodedTexture(key, compressed))
+	{
+		return compressed;
+	}
+
+	LOG_WARNING("Couldn't cache compressed texture, using it uncompressed: " + textureFile);
+	return data;
+}
+
+TextureCompression Texture::GetCompression(TextureType type, int numChannels)
+{
+	switch (type)
+	{
+	case TextureType::Diffuse:
+		return TextureCompression::BC7;
+	case TextureType::Specular:
+	case TextureType::Emission:
+		return numChannels == 4 ? TextureCompression::BC3 : TextureCompression::BC1;
+	case TextureType::Normal:
+		return TextureCompression::BC5;
+	default:
+		return TextureCompression::None;
+	}
+}
+
+void Texture::LoadTexture(const TextureData& data, int firstMip)
+{
+	if (data.pixels)
 	{
 		std::cout << "Loading texture: " << mName << "\n";
 
 		LOG_DEBUG("Loading texture file: " + mName);
 
+		mWidth = data.width;
+		mHeight = data.height;
+		mNumChannels = data.numChannels;
+
+		if (data.compression != TextureCompression::None)
+		{
+			mNumMips = data.numMips;
+			mRequestedMip = mNumMips;
+			SetResidentMips(data, firstMip);
+			return;
+		}
+
 		bool generatesMipMap = true;
-		bool flipTexture = true;
 		GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR;
 		if (mType == TextureType::Sprite || mType == TextureType::Font)
 		{
 			generatesMipMap = false;
-			flipTexture = false;
 			minFilter = GL_LINEAR;
 		}
 
-		GenerateTexture(GL_TEXTURE_2D, mWidth, mHeight, GL_UNSIGNED_BYTE, data, generatesMipMap, 
-			flipTexture, mNumChannels, GL_REPEAT, GL_REPEAT, minFilter, GL_LINEAR);
+		// Rows were already flipped by Decode()
+		GenerateTexture(GL_TEXTURE_2D, mWidth, mHeight, GL_UNSIGNED_BYTE, data.pixels, generatesMipMap,
+			false, mNumChannels, GL_REPEAT, GL_REPEAT, minFilter, GL_LINEAR);
 	}
 	else
 	{
 		LOG_WARNING("Failed to load texture: " + mName);
 		std::cout << "Failed to load texture: " << mName << "\n";
 	}
+}
+
+void Texture::SetResidentMips(const TextureData& data, int firstMip)
+{
+	firstMip = std::clamp(firstMip, 0, data.numMips - 1);
+
+	// Upload into a new texture so the old levels are freed when it's deleted
+	unsigned int oldTextureID = mTextureID;
+	glGenTextures(1, &mTextureID);
+	BindTexture();
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, data.numMips - 1 - firstMip);
+
+	// Color textures are stored in sRGB, data textures are linear
+	bool isSRGB = mType == TextureType::Diffuse || mType == TextureType::Emission;
+	GLenum internalFormat = GetCompressedInternalFormat(data.compression, isSRGB);
+
+	// The mips were built when the texture was cooked, so each level's blocks are uploaded as is.
+	// Texture coordinates are normalized, so a smaller level 0 just samples blurrier.
+	std::vector<TextureMip> mips = BlockCompression::GetMipChain(data.compression, data.width, data.height);
+	mMemorySize = 0;
+	for (int level = firstMip; level < data.numMips; ++level)
+	{
+		const TextureMip& mip = mips[level];
+		glCompressedTexImage2D(GL_TEXTURE_2D, level - firstMip, internalFormat, mip.width, mip.height, 0,
+			static_cast<GLsizei>(mip.size), data.pixels + mip.offset);
+		mMemorySize += mip.size;
+	}
+
+	// Unbind
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glDeleteTextures(1, &oldTextureID);
+	mResidentMip = firstMip;
+}
 
-	// Free image data
-	stbi_image_free(data);
+bool Texture::Reload(const TextureData& data, int firstMip)
+{
+	if (!data.pixels)
+	{
+		LOG_WARNING("Failed to reload texture: " + mName);
+		return false;
+	}
+
+	// Start from a new texture object, since the image's size and format may have changed
+	glDeleteTextures(1, &mTextureID);
+	glGenTextures(1, &mTextureID);
+
+	mNumMips = 1;
+	mResidentMip = 0;
+	mRequestedMip = 1;
+	mMemorySize = 0;
+
+	LoadTexture(data, firstMip);
+	return true;
+}
+
+void Texture::RequestScreenSize(float pixels)
+{
+	if (mNumMips <= 1 || pixels <= 0.0f)
+	{
+		return;
+	}
+
+	// Each mip level halves the texels across, so the level whose size matches the screen size is log2 of the ratio
+	int mip = 0;
+	float size = static_cast<float>(std::max(mWidth, mHeight));
+	if (size > pixels)
+	{
+		mip = static_cast<int>(std::floor(std::log2(size / pixels))) - TEXTURE_STREAMING_MIP_BIAS;
+	}
+	mRequestedMip = std::min(mRequestedMip, std::clamp(mip, 0, mNumMips - 1));
+}
+
+int Texture::TakeRequestedMip()
+{
+	int mip = mRequestedMip;
+	mRequestedMip = mNumMips;
+	return mip;
 }
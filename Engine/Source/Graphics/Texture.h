@@ -1,6 +1,10 @@
 #pragma once
 #include <string>
 #include <glad/glad.h>
+#include "../Util/MappedFile.h"
+#include "BlockCompression.h"
+
+class TextureStreamer;
 
 // Enum class for texture types and its corresponding texture unit
 enum class TextureType
@@ -18,6 +22,32 @@ enum class TextureType
 	Font = 10,				// Texture unit 10 is used to sample from a texture that is used for fonts
 };
 
+// Struct for an image decoded from a file that hasn't been uploaded to OpenGL yet.
+// Owns its pixels, so it can only be moved. Images loaded from the derived data cache
+// point straight into the mapped cache file instead of being copied. Compressed images hold
+// every mip level's blocks one after another, laid out by BlockCompression::GetMipChain().
+struct TextureData
+{
+	TextureData();
+	TextureData(TextureData&& other) noexcept;
+	TextureData& operator=(TextureData&& other) noexcept;
+	TextureData(const TextureData&) = delete;
+	TextureData& operator=(const TextureData&) = delete;
+	~TextureData();
+
+	// Gets the size of the pixels (or every mip level's blocks if compressed) in bytes
+	// @return - size_t for the number of bytes
+	size_t GetSize() const;
+
+	unsigned char* pixels;				// decoded pixels (nullptr if the file couldn't be decoded, read only if cachedFile is open)
+	int width;							// width in pixels
+	int height;							// height in pixels
+	int numChannels;					// number of color channels in the source image
+	TextureCompression compression;		// block format of the pixels (None for plain 8 bit channels)
+	int numMips;						// number of mip levels in the pixels (1 if uncompressed, OpenGL generates the rest)
+	MappedFile cachedFile;				// derived data cache file the pixels point into
+};
+
 // The Texture class helps load image files with the
 // stb_image loader and saves image details. All texture
 // objects are referenced with an integer and provides
@@ -34,8 +64,31 @@ public:
 	// @param - const std::string& for the texture file name
 	// @param - TextureType for the type used for the texture
 	Texture(const std::string& textureFile, TextureType type);
+	// Texture constructor: Creates an OpenGL texture object from an image that was already decoded
+	// @param - const std::string& for the texture file name
+	// @param - TextureType for the type used for the texture
+	// @param - const TextureData& for the decoded image
+	// @param - int for the largest mip level to upload if the image is compressed (defaults to 0 for every level)
+	Texture(const std::string& textureFile, TextureType type, const TextureData& data, int firstMip = 0);
+	// Texture destructor: Deletes the OpenGL texture and stops streaming it
 	~Texture();
 
+	// Decodes an image file with stb_image, flipped the way the texture type expects. Texture types that are
+	// mip mapped are block compressed with their whole mip chain (see GetCompression()). Decoded images are
+	// kept in the derived data cache, keyed by the file's contents, the flip, and the compression, so later
+	// decodes of the same file just map the cached blocks. Doesn't make any OpenGL calls so it can run on a worker thread.
+	// @param - const std::string& for the texture file name
+	// @param - TextureType for the type the image will be used as
+	// @return - TextureData for the decoded image
+	static TextureData Decode(const std::string& textureFile, TextureType type);
+
+	// Gets the block format a texture type is compressed to: BC7 for diffuse maps, BC1 for specular and emission
+	// maps (BC3 if they have alpha), and BC5 for normal maps. Sprites and fonts stay uncompressed.
+	// @param - TextureType for the type the image will be used as
+	// @param - int for the number of channels in the image
+	// @return - TextureCompression for the format
+	static TextureCompression GetCompression(TextureType type, int numChannels);
+
 	// Generates a texture to the currently bound texture
 	// @param - GLenum for target texture. Typically use GL_TEXTURE_2D for textures, frame buffers and shadow maps (TextureTypes 1-5, 7, 9, 10)
 	// and use GL_TEXTURE_CUBE_MAP_POSITIVE_X for cube maps, point shadow maps (TextureType 6, 8)
@@ -54,6 +107,27 @@ public:
 	void GenerateTexture(GLenum target, int width, int height, GLenum dataType, const void* data,
 		bool generatesMipMap, bool flipTexture, int numChannels, GLenum wrapS, GLenum wrapT, GLenum minFilter, GLenum maxFilter);
 
+	// Replaces the uploaded levels of a compressed texture with the mip levels from firstMip down to 1x1.
+	// OpenGL can't free single levels, so this makes a new texture object sized to the levels and deletes the old one.
+	// @param - const TextureData& for the compressed image
+	// @param - int for the largest mip level to upload
+	void SetResidentMips(const TextureData& data, int firstMip);
+
+	// Uploads a decoded image again after the texture's file changed, keeping the same Texture so materials still use it
+	// @param - const TextureData& for the decoded image
+	// @param - int for the largest mip level to upload if the image is compressed
+	// @return - bool for if the image had pixels (the old image stays if it didn't)
+	bool Reload(const TextureData& data, int firstMip);
+
+	// Asks for the texture to be sharp enough for something covering a number of pixels on screen.
+	// Streamed textures load the matching mip level, other textures ignore it.
+	// @param - float for how many pixels across the texture covers on screen (0 or less doesn't ask for anything)
+	void RequestScreenSize(float pixels);
+
+	// Gets the finest mip level asked for since the last call, and forgets the requests
+	// @return - int for the mip level (GetNumMips() if nothing asked)
+	int TakeRequestedMip();
+
 	// Bind it to so any subsequent texture commands will use the currently bound texture
 	// Binding after activating a texture unit will bind the texture to that unit
 	// There is a minimum of 16 texture units to use (GL_TEXTURE0 to GL_TEXTURE15)
@@ -87,10 +161,27 @@ public:
 	// @return - TextureType mType
 	TextureType GetType() const { return mType; }
 
+	// Gets the number of mip levels the texture's image has (1 if OpenGL generated them)
+	// @return - int for the number of levels
+	int GetNumMips() const { return mNumMips; }
+
+	// Gets the largest mip level that's uploaded
+	// @return - int for the level (0 is full size)
+	int GetResidentMip() const { return mResidentMip; }
+
+	// Gets the number of bytes of video memory the texture's uploaded levels use
+	// @return - size_t for the number of bytes
+	size_t GetMemorySize() const { return mMemorySize; }
+
+	// Sets the streamer the texture's mips are streamed by, which is told when the texture is deleted
+	// @param - TextureStreamer* for the streamer (nullptr if it isn't streamed)
+	void SetStreamer(TextureStreamer* streamer) { mStreamer = streamer; }
+
 private:
-	// Binds a texture and uses stbi to load a texture based off the texture's file name.
-	// Then the texture and mipmaps are generated based off of texture type
-	void LoadTexture();
+	// Generates the texture and mipmaps from a decoded image based off of texture type
+	// @param - const TextureData& for the decoded image
+	// @param - int for the largest mip level to upload if the image is compressed
+	void LoadTexture(const TextureData& data, int firstMip);
 
 	// Texture name (file path to the texture)
 	std::string mName;
@@ -112,4 +203,19 @@ private:
 
 	// Type of the texture
 	TextureType mType;
+
+	// Number of mip levels in the image (1 if OpenGL generated them)
+	int mNumMips;
+
+	// Largest mip level that's uploaded
+	int mResidentMip;
+
+	// Finest mip level asked for by RequestScreenSize() since the last TakeRequestedMip()
+	int mRequestedMip;
+
+	// Number of bytes of video memory the uploaded levels use
+	size_t mMemorySize;
+
+	// Streamer the texture is streamed by (nullptr if it isn't streamed)
+	TextureStreamer* mStreamer;
 };
@@ -0,0 +1,170 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <glad/glad.h>
+#include "../Util/Logger.h"
+#include "stb_image.h"
+#include "Texture.h"
+
+// The packer is compiled static into this file, so the functions the atlas doesn't call (stbrp_setup_heuristic) would warn
+#if defined(_MSC_VER)
+#pragma warning (push)
+#pragma warning (disable: 4505)	// unreferenced function with internal linkage has been removed
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../EngineUI/imstb_rectpack.h"
+
+#if defined(_MSC_VER)
+#pragma warning (pop)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+TextureAtlas::TextureAtlas(const std::string& name, int pageSize, int padding) :
+	mImages(),
+	mPages(),
+	mRegions(),
+	mName(name),
+	mPageSize(pageSize),
+	mPadding(padding)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	std::cout << "Deleted texture atlas: \"" << mName << "\"\n";
+
+	DeletePages();
+}
+
+bool TextureAtlas::AddImage(const std::string& fileName)
+{
+	int width = 0;
+	int height = 0;
+	int numChannels = 0;
+
+	// Sprites are not flipped when they are loaded as separate textures either.
+	// Only this thread's setting is changed so textures decoding on loader threads aren't affected.
+	stbi_set_flip_vertically_on_load_thread(false);
+	unsigned char* data = stbi_load(fileName.c_str(), &width, &height, &numChannels, 4);
+
+	if (!data)
+	{
+		LOG_WARNING("Failed to load atlas image: " + fileName);
+		return false;
+	}
+
+	if (width + mPadding > mPageSize || height + mPadding > mPageSize)
+	{
+		LOG_WARNING("Atlas image " + fileName + " is larger than the atlas page size");
+		stbi_image_free(data);
+		return false;
+	}
+
+	AtlasImage image;
+	image.name = fileName;
+	image.pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+	image.width = width;
+	image.height = height;
+	mImages.emplace_back(std::move(image));
+
+	stbi_image_free(data);
+
+	return true;
+}
+
+bool TextureAtlas::Build()
+{
+	DeletePages();
+	mRegions.clear();
+
+	std::vector<stbrp_rect> rects(mImages.size());
+	for (size_t i = 0; i < mImages.size(); ++i)
+	{
+		rects[i].id = static_cast<int>(i);
+		rects[i].w = mImages[i].width + mPadding;
+		rects[i].h = mImages[i].height + mPadding;
+		rects[i].was_packed = 0;
+	}
+
+	std::vector<stbrp_node> nodes(mPageSize);
+	std::vector<unsigned char> pagePixels(static_cast<size_t>(mPageSize) * mPageSize * 4);
+	float pageScale = 1.0f / static_cast<float>(mPageSize);
+
+	// Fill a page with whatever still fits, then start a new page for the rest
+	while (!rects.empty())
+	{
+		stbrp_context context;
+		stbrp_init_target(&context, mPageSize, mPageSize, nodes.data(), static_cast<int>(nodes.size()));
+		stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()));
+
+		Texture* page = new Texture(TextureType::Sprite);
+		std::fill(pagePixels.begin(), pagePixels.end(), static_cast<unsigned char>(0));
+
+		std::vector<stbrp_rect> remaining;
+		for (const stbrp_rect& rect : rects)
+		{
+			if (!rect.was_packed)
+			{
+				remaining.emplace_back(rect);
+				continue;
+			}
+
+			const AtlasImage& image = mImages[rect.id];
+			size_t rowSize = static_cast<size_t>(image.width) * 4;
+			for (int row = 0; row < image.height; ++row)
+			{
+				unsigned char* dst = &pagePixels[(static_cast<size_t>(rect.y + row) * mPageSize + rect.x) * 4];
+				std::memcpy(dst, &image.pixels[row * rowSize], rowSize);
+			}
+
+			AtlasRegion region = {};
+			region.texture = page;
+			region.uvRect = glm::vec4(rect.x * pageScale, rect.y * pageScale, image.width * pageScale, image.height * pageScale);
+			region.size = glm::vec2(image.width, image.height);
+			mRegions[image.name] = region;
+		}
+
+		page->GenerateTexture(GL_TEXTURE_2D, mPageSize, mPageSize, GL_UNSIGNED_BYTE, pagePixels.data(),
+			false, false, 4, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+		mPages.emplace_back(page);
+
+		// Images are checked against the page size when added, so an empty page means something went wrong
+		if (remaining.size() == rects.size())
+		{
+			LOG_ERROR("Could not pack the remaining images into atlas: " + mName);
+			return false;
+		}
+
+		rects.swap(remaining);
+	}
+
+	std::cout << "Built texture atlas: " << mName << " with " << mImages.size() << " images on " << mPages.size() << " pages\n";
+
+	return true;
+}
+
+const AtlasRegion* TextureAtlas::GetRegion(const std::string& fileName) const
+{
+	auto iter = mRegions.find(fileName);
+	if (iter != mRegions.end())
+	{
+		return &iter->second;
+	}
+	return nullptr;
+}
+
+void TextureAtlas::DeletePages()
+{
+	for (Texture* page : mPages)
+	{
+		delete page;
+	}
+	mPages.clear();
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Texture;
+
+// Default width/height of an atlas page
+const int ATLAS_PAGE_SIZE = 2048;
+
+// Default number of empty pixels kept between images on a page
+const int ATLAS_PADDING = 2;
+
+// Struct for an image's location within a texture
+struct AtlasRegion
+{
+	Texture* texture;	// texture (atlas page) that holds the image
+	glm::vec4 uvRect;	// xy = uv offset, zw = uv scale of the image within the texture
+	glm::vec2 size;		// image's width and height in pixels
+};
+
+// TextureAtlas packs many small images into one or more large textures (pages) so
+// that sprites sharing a page can be drawn together. Images are added by file name
+// and packed with stb_rect_pack when Build() is called. Each image can then be
+// looked up by its file name to get its page and uv sub-rect.
+class TextureAtlas
+{
+public:
+	// TextureAtlas constructor
+	// @param - const std::string& for the atlas' name
+	// @param - int for the width/height of each page
+	// @param - int for the number of empty pixels between images
+	TextureAtlas(const std::string& name, int pageSize = ATLAS_PAGE_SIZE, int padding = ATLAS_PADDING);
+	~TextureAtlas();
+
+	// Loads an image's pixels so it gets packed on the next Build()
+	// @param - const std::string& for the image's file name
+	// @return - bool for if the image was loaded
+	bool AddImage(const std::string& fileName);
+
+	// Packs every added image into as many pages as needed and uploads the pages to the GPU.
+	// Images that were already packed by an earlier Build() are packed again along with the new ones.
+	// @return - bool for if every image fit on a page
+	bool Build();
+
+	// Gets an image's region by file name
+	// @param - const std::string& for the image's file name
+	// @return - const AtlasRegion* for the region, nullptr if the image was not packed
+	const AtlasRegion* GetRegion(const std::string& fileName) const;
+
+	// Gets the atlas' name
+	// @return - const std::string& for the name
+	const std::string& GetName() const { return mName; }
+
+	// Gets the number of pages
+	// @return - size_t for the number of pages
+	size_t GetNumPages() const { return mPages.size(); }
+
+	// Gets a page's texture
+	// @param - size_t for the page's index
+	// @return - Texture* for the page
+	Texture* GetPage(size_t page) const { return mPages[page]; }
+
+private:
+	// Struct for an image's pixels waiting to be packed
+	struct AtlasImage
+	{
+		std::string name;
+		std::vector<unsigned char> pixels; // RGBA pixels
+		int width;
+		int height;
+	};
+
+	// Deletes every page's texture
+	void DeletePages();
+
+	// Images added to the atlas
+	std::vector<AtlasImage> mImages;
+
+	// Textures for each page
+	std::vector<Texture*> mPages;
+
+	// Map of packed images by file name
+	std::unordered_map<std::string, AtlasRegion> mRegions;
+
+	// Atlas' name
+	std::string mName;
+
+	// Width/height of a page
+	int mPageSize;
+
+	// Empty pixels between images
+	int mPadding;
+};
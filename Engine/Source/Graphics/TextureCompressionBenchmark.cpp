@@ -0,0 +1,117 @@
+#include "TextureCompressionBenchmark.h"
+#include <chrono>
+#include <cmath>
+#include "stb_image.h"
+
+namespace TextureCompressionBenchmark
+{
+	// Struct for an image to compress
+	struct Image
+	{
+		std::vector<unsigned char> rgba;
+		int width;
+		int height;
+	};
+
+	// Gets the number of channels a format stores (BC1 ignores alpha, BC5 only has red and green)
+	// @param - TextureCompression for the format
+	// @return - int for the number of channels compared
+	static int GetNumComparedChannels(TextureCompression compression)
+	{
+		switch (compression)
+		{
+		case TextureCompression::BC1:
+			return 3;
+		case TextureCompression::BC5:
+			return 2;
+		default:
+			return 4;
+		}
+	}
+
+	std::vector<TextureCompressionBenchmarkResult> Run(const std::vector<std::string>& textureFiles)
+	{
+		static const TextureCompression FORMATS[] = { TextureCompression::BC1, TextureCompression::BC3, TextureCompression::BC5, TextureCompression::BC7 };
+
+		std::vector<Image> images;
+		for (const std::string& fileName : textureFiles)
+		{
+			Image image = {};
+			int numChannels = 0;
+			unsigned char* pixels = stbi_load(fileName.c_str(), &image.width, &image.height, &numChannels, 0);
+			if (pixels)
+			{
+				image.rgba = BlockCompression::ToRGBA(pixels, image.width, image.height, numChannels);
+				images.emplace_back(std::move(image));
+			}
+			stbi_image_free(pixels);
+		}
+
+		std::vector<TextureCompressionBenchmarkResult> results;
+		for (TextureCompression compression : FORMATS)
+		{
+			TextureCompressionBenchmarkResult result = {};
+			result.compression = compression;
+
+			int numChannels = GetNumComparedChannels(compression);
+			double squaredError = 0.0;
+			size_t numSamples = 0;
+
+			for (const Image& image : images)
+			{
+				std::vector<unsigned char> blocks(BlockCompression::GetCompressedSize(compression, image.width, image.height));
+
+				auto start = std::chrono::high_resolution_clock::now();
+				BlockCompression::Encode(compression, image.rgba.data(), image.width, image.height, blocks.data());
+				auto end = std::chrono::high_resolution_clock::now();
+				result.encodeMs += std::chrono::duration<double, std::milli>(end - start).count();
+
+				std::vector<unsigned char> decoded(image.rgba.size());
+				BlockCompression::Decode(compression, blocks.data(), image.width, image.height, decoded.data());
+
+				for (size_t i = 0; i < decoded.size(); i += 4)
+				{
+					for (int c = 0; c < numChannels; ++c)
+					{
+						double diff = static_cast<double>(decoded[i + c]) - image.rgba[i + c];
+						squaredError += diff * diff;
+					}
+				}
+
+				result.numPixels += static_cast<size_t>(image.width) * image.height;
+				result.compressedSize += blocks.size();
+				numSamples += static_cast<size_t>(image.width) * image.height * numChannels;
+			}
+
+			if (result.encodeMs > 0.0)
+			{
+				result.megapixelsPerSecond = result.numPixels / (result.encodeMs * 1000.0);
+			}
+
+			// A perfect match has no error, report it as the best 8 bit images can do
+			double meanSquaredError = numSamples > 0 ? squaredError / numSamples : 0.0;
+			result.psnr = meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+
+			results.push_back(result);
+		}
+
+		return results;
+	}
+
+	const char* GetName(TextureCompression compression)
+	{
+		switch (compression)
+		{
+		case TextureCompression::BC1:
+			return "BC1";
+		case TextureCompression::BC3:
+			return "BC3";
+		case TextureCompression::BC5:
+			return "BC5";
+		case TextureCompression::BC7:
+			return "BC7";
+		default:
+			return "None";
+		}
+	}
+}
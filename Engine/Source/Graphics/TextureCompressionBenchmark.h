@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "BlockCompression.h"
+
+// Struct for the results of compressing images to one block format
+struct TextureCompressionBenchmarkResult
+{
+	TextureCompression compression;	// block format
+	size_t numPixels;				// number of pixels encoded
+	size_t compressedSize;			// size of the blocks in bytes
+	double encodeMs;				// milliseconds to encode every image
+	double megapixelsPerSecond;		// encode throughput
+	double psnr;					// peak signal to noise ratio of the decoded images in dB, over the channels the format stores
+};
+
+namespace TextureCompressionBenchmark
+{
+	// Encodes each image (mip 0 only) to BC1, BC3, BC5, and BC7 on one thread, then decodes the blocks to measure
+	// how close they are to the original. Doesn't use OpenGL, so it can run without a window.
+	// @param - const std::vector<std::string>& for the image files
+	// @return - std::vector<TextureCompressionBenchmarkResult> for the results of each format
+	std::vector<TextureCompressionBenchmarkResult> Run(const std::vector<std::string>& textureFiles);
+
+	// Gets the name of a block format for logging
+	// @param - TextureCompression for the format
+	// @return - const char* for the name
+	const char* GetName(TextureCompression compression);
+}
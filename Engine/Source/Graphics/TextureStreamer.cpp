@@ -0,0 +1,259 @@
+#include "TextureStreamer.h"
+#include <algorithm>
+#include <iostream>
+
+// Bytes between reads when paging a mip level in, small enough to touch every page
+static const size_t READ_STRIDE = 4096;
+
+// Lowers an atomic mip level if the new level is sharper
+// @param - std::atomic<int>& for the level
+// @param - int for the new level
+static void LowerMip(std::atomic<int>& mip, int newMip)
+{
+	int current = mip.load();
+	while (newMip < current && !mip.compare_exchange_weak(current, newMip))
+	{
+	}
+}
+
+void TextureStreamer::ReadJob::DoJob()
+{
+	std::vector<TextureMip> mips = BlockCompression::GetMipChain(mData->compression, mData->width, mData->height);
+
+	// Smallest levels first, since they're uploaded first
+	for (int mip = mLastMip - 1; mip >= mFirstMip; --mip)
+	{
+		const volatile unsigned char* bytes = mData->pixels + mips[mip].offset;
+		unsigned char sum = 0;
+		for (size_t i = 0; i < mips[mip].size; i += READ_STRIDE)
+		{
+			sum += bytes[i];
+		}
+		(void)sum;
+
+		LowerMip(*mReadMip, mip);
+	}
+}
+
+TextureStreamer::TextureStreamer(size_t budget) :
+	mTextures(),
+	mJobManager(1),
+	mBudget(budget),
+	mResidentSize(0),
+	mFrame(0)
+{
+	mJobManager.Begin();
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	std::cout << "Deleted TextureStreamer\n";
+
+	mJobManager.End();
+
+	for (auto& t : mTextures)
+	{
+		t.first->SetStreamer(nullptr);
+	}
+}
+
+int TextureStreamer::GetMinResidentMip(const TextureData& data)
+{
+	std::vector<TextureMip> mips = BlockCompression::GetMipChain(data.compression, data.width, data.height);
+
+	int numMips = std::min(data.numMips, static_cast<int>(mips.size()));
+	for (int mip = 0; mip < numMips; ++mip)
+	{
+		if (std::max(mips[mip].width, mips[mip].height) <= TEXTURE_STREAMING_MIN_SIZE)
+		{
+			return mip;
+		}
+	}
+	return std::max(numMips - 1, 0);
+}
+
+void TextureStreamer::Add(Texture* texture, TextureData&& data)
+{
+	StreamedTexture streamed = {};
+	streamed.texture = texture;
+	streamed.mips = BlockCompression::GetMipChain(data.compression, data.width, data.height);
+	streamed.minResidentMip = GetMinResidentMip(data);
+	streamed.wantedMip = streamed.minResidentMip;
+	streamed.readingMip = texture->GetResidentMip();
+	streamed.readMip = std::make_shared<std::atomic<int>>(texture->GetResidentMip());
+	streamed.lastRequestFrame = mFrame;
+	streamed.data = std::make_shared<const TextureData>(std::move(data));
+
+	mResidentSize += GetResidentSize(streamed, texture->GetResidentMip());
+	mTextures[texture] = std::move(streamed);
+
+	texture->SetStreamer(this);
+}
+
+void TextureStreamer::Remove(Texture* texture)
+{
+	auto iter = mTextures.find(texture);
+	if (iter != mTextures.end())
+	{
+		// A read job still running keeps its own reference to the data
+		mResidentSize -= GetResidentSize(iter->second, texture->GetResidentMip());
+		mTextures.erase(iter);
+	}
+}
+
+size_t TextureStreamer::Update(size_t byteBudget)
+{
+	++mFrame;
+
+	std::vector<StreamedTexture*> wantSharper;
+	for (auto& t : mTextures)
+	{
+		StreamedTexture& streamed = t.second;
+		Texture* texture = streamed.texture;
+
+		int requestedMip = texture->TakeRequestedMip();
+		if (requestedMip < texture->GetNumMips())
+		{
+			streamed.lastRequestFrame = mFrame;
+			streamed.wantedMip = std::min(requestedMip, streamed.minResidentMip);
+		}
+		else if (mFrame - streamed.lastRequestFrame > TEXTURE_STREAMING_UNSEEN_FRAMES)
+		{
+			// Not drawn in a while, so the sharper mips are free to evict
+			streamed.wantedMip = streamed.minResidentMip;
+		}
+
+		if (streamed.wantedMip < texture->GetResidentMip())
+		{
+			wantSharper.push_back(&streamed);
+
+			// Start reading in every level it's missing, from the smallest
+			if (streamed.wantedMip < streamed.readingMip)
+			{
+				mJobManager.AddJob(new ReadJob(streamed.data, streamed.wantedMip, streamed.readingMip, streamed.readMip));
+				streamed.readingMip = streamed.wantedMip;
+			}
+		}
+	}
+
+	// The budget might have been lowered
+	if (mResidentSize > mBudget)
+	{
+		Evict(0);
+	}
+
+	// Textures furthest from what they want go first, then the most recently drawn
+	std::sort(wantSharper.begin(), wantSharper.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+		int aMissing = a->texture->GetResidentMip() - a->wantedMip;
+		int bMissing = b->texture->GetResidentMip() - b->wantedMip;
+		if (aMissing != bMissing)
+		{
+			return aMissing > bMissing;
+		}
+		return a->lastRequestFrame > b->lastRequestFrame;
+		});
+
+	size_t uploaded = 0;
+	for (StreamedTexture* streamed : wantSharper)
+	{
+		// One level at a time, so every texture gets sharper before any gets to full size
+		int currentMip = streamed->texture->GetResidentMip();
+		int mip = currentMip - 1;
+		if (streamed->readMip->load() > mip)
+		{
+			continue;
+		}
+
+		// The whole chain is uploaded again into a texture sized for it
+		size_t size = GetResidentSize(*streamed, mip);
+		if (uploaded > 0 && uploaded + size > byteBudget)
+		{
+			break;
+		}
+
+		size_t growth = size - GetResidentSize(*streamed, currentMip);
+		if (mResidentSize + growth > mBudget && !Evict(growth))
+		{
+			continue;
+		}
+
+		uploaded += SetResidentMip(*streamed, mip);
+	}
+
+	return uploaded;
+}
+
+size_t TextureStreamer::GetResidentSize(const StreamedTexture& streamed, int mip) const
+{
+	const TextureMip& last = streamed.mips[streamed.data->numMips - 1];
+	return last.offset + last.size - streamed.mips[mip].offset;
+}
+
+size_t TextureStreamer::SetResidentMip(StreamedTexture& streamed, int mip)
+{
+	size_t oldSize = GetResidentSize(streamed, streamed.texture->GetResidentMip());
+	streamed.texture->SetResidentMips(*streamed.data, mip);
+
+	size_t newSize = GetResidentSize(streamed, mip);
+	mResidentSize = mResidentSize - oldSize + newSize;
+	return newSize;
+}
+
+bool TextureStreamer::Evict(size_t size)
+{
+	std::vector<StreamedTexture*> candidates;
+	for (auto& t : mTextures)
+	{
+		if (t.second.texture->GetResidentMip() < t.second.wantedMip)
+		{
+			candidates.push_back(&t.second);
+		}
+	}
+
+	// Least recently drawn first
+	std::sort(candidates.begin(), candidates.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+		return a->lastRequestFrame < b->lastRequestFrame;
+		});
+
+	for (StreamedTexture* streamed : candidates)
+	{
+		if (mResidentSize + size <= mBudget)
+		{
+			break;
+		}
+
+		SetResidentMip(*streamed, streamed->wantedMip);
+
+		// The pages of the dropped levels may not stay in memory, so read them in again when they're wanted
+		streamed->readingMip = streamed->wantedMip;
+		streamed->readMip->store(streamed->wantedMip);
+	}
+
+	// Sharper mips only wait for room, but if what's already uploaded is over the budget,
+	// drop a level at a time from the least recently drawn textures until it fits
+	while (size == 0 && mResidentSize > mBudget)
+	{
+		StreamedTexture* victim = nullptr;
+		for (auto& t : mTextures)
+		{
+			StreamedTexture& streamed = t.second;
+			if (streamed.texture->GetResidentMip() < streamed.minResidentMip &&
+				(!victim || streamed.lastRequestFrame < victim->lastRequestFrame))
+			{
+				victim = &streamed;
+			}
+		}
+
+		if (!victim)
+		{
+			break;
+		}
+
+		int mip = victim->texture->GetResidentMip() + 1;
+		SetResidentMip(*victim, mip);
+		victim->readingMip = mip;
+		victim->readMip->store(mip);
+	}
+
+	return mResidentSize + size <= mBudget;
+}
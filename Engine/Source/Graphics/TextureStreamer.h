@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "../Multithreading/JobManager.h"
+#include "Texture.h"
+
+// Default number of bytes of video memory streamed textures can use
+const size_t TEXTURE_STREAMING_BUDGET = static_cast<size_t>(256) * 1024 * 1024;
+
+// Default number of bytes streamed in per frame by TextureStreamer::Update()
+const size_t TEXTURE_STREAMING_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
+// Mip levels this many pixels across or smaller are always resident, so a texture can be drawn as soon as it's loaded
+const int TEXTURE_STREAMING_MIN_SIZE = 64;
+
+// Number of levels sharper than the screen size estimate to stream in, since texture coordinates often tile across a mesh
+const int TEXTURE_STREAMING_MIP_BIAS = 1;
+
+// Number of frames a texture can go without being drawn before its sharper mips can be evicted
+const uint64_t TEXTURE_STREAMING_UNSEEN_FRAMES = 120;
+
+// TextureStreamer keeps block compressed textures only as sharp as they're drawn. Textures start with just their
+// smallest mips uploaded, and the renderer asks for sharper levels based on how big meshes are on screen
+// (Texture::RequestScreenSize()). Each frame, the textures that want sharper mips stream in one level at a time,
+// biggest difference first, and the textures holding sharper mips than they want (or that haven't been drawn in a while)
+// are evicted down when the budget is full. The mip chains stay memory mapped from the derived data cache, and a
+// worker thread reads a level's pages in before the render thread uploads it, so uploads don't wait on the disk.
+class TextureStreamer
+{
+public:
+	// TextureStreamer constructor starts the worker thread
+	// @param - size_t for the number of bytes of video memory streamed textures can use
+	TextureStreamer(size_t budget = TEXTURE_STREAMING_BUDGET);
+	~TextureStreamer();
+
+	// Gets the largest mip level that's always resident for an image
+	// @param - const TextureData& for the compressed image
+	// @return - int for the mip level
+	static int GetMinResidentMip(const TextureData& data);
+
+	// Starts streaming a texture that was created with its mips from GetMinResidentMip() uploaded
+	// @param - Texture* for the texture
+	// @param - TextureData&& for the texture's compressed image, kept to upload sharper mips from
+	void Add(Texture* texture, TextureData&& data);
+
+	// Stops streaming a texture (called when it's deleted)
+	// @param - Texture* for the texture
+	void Remove(Texture* texture);
+
+	// Takes the mip levels the renderer asked for this frame, evicts mips to fit the budget, and uploads
+	// sharper mips whose pages have been read in until the upload budget runs out. Call once per frame on the render thread.
+	// @param - size_t for the number of bytes that can be uploaded (at least one upload happens if any are ready)
+	// @return - size_t for the number of bytes uploaded
+	size_t Update(size_t byteBudget = TEXTURE_STREAMING_UPLOAD_BUDGET);
+
+	// Sets the number of bytes of video memory streamed textures can use. Mips are evicted next Update() if it's already over.
+	// @param - size_t for the number of bytes
+	void SetBudget(size_t budget) { mBudget = budget; }
+
+	// Gets the number of bytes of video memory streamed textures can use
+	// @return - size_t for the number of bytes
+	size_t GetBudget() const { return mBudget; }
+
+	// Gets the number of bytes of video memory the streamed textures' uploaded mips use
+	// @return - size_t for the number of bytes
+	size_t GetResidentSize() const { return mResidentSize; }
+
+	// Gets the number of textures being streamed
+	// @return - size_t for the number of textures
+	size_t GetNumTextures() const { return mTextures.size(); }
+
+private:
+	// Struct for a texture being streamed
+	struct StreamedTexture
+	{
+		Texture* texture;							// texture the mips are uploaded to
+		std::shared_ptr<const TextureData> data;	// compressed mip chain (shared with read jobs so it stays mapped while they run)
+		std::vector<TextureMip> mips;				// where each mip level is in the data
+		std::shared_ptr<std::atomic<int>> readMip;	// largest mip level whose pages have been read in
+		int minResidentMip;							// largest mip level that's always resident
+		int wantedMip;								// mip level the renderer wants resident
+		int readingMip;								// largest mip level a read job has been started for
+		uint64_t lastRequestFrame;					// frame the texture was last drawn
+	};
+
+	// Job that reads a range of a texture's mip levels so their pages are in memory before they're uploaded
+	class ReadJob : public JobManager::Job
+	{
+	public:
+		ReadJob(std::shared_ptr<const TextureData> data, int firstMip, int lastMip, std::shared_ptr<std::atomic<int>> readMip) :
+			JobManager::Job(true),
+			mData(std::move(data)),
+			mFirstMip(firstMip),
+			mLastMip(lastMip),
+			mReadMip(std::move(readMip))
+		{}
+
+		void DoJob() override;
+
+	private:
+		std::shared_ptr<const TextureData> mData;
+		int mFirstMip;
+		int mLastMip;
+		std::shared_ptr<std::atomic<int>> mReadMip;
+	};
+
+	// Gets the bytes a texture uses with mips from a level down uploaded
+	// @param - const StreamedTexture& for the texture
+	// @param - int for the largest uploaded mip level
+	// @return - size_t for the number of bytes
+	size_t GetResidentSize(const StreamedTexture& streamed, int mip) const;
+
+	// Uploads a texture's mips from a level down, keeping the resident size up to date
+	// @param - StreamedTexture& for the texture
+	// @param - int for the largest mip level to upload
+	// @return - size_t for the number of bytes uploaded
+	size_t SetResidentMip(StreamedTexture& streamed, int mip);
+
+	// Evicts sharper mips than textures want, least recently drawn first, until some bytes are free.
+	// With no bytes asked for, it also evicts mips textures do want if the uploaded mips are over the budget.
+	// @param - size_t for the number of bytes that need to fit in the budget (0 to just get under it)
+	// @return - bool for if they fit
+	bool Evict(size_t size);
+
+	// Textures being streamed
+	std::unordered_map<Texture*, StreamedTexture> mTextures;
+
+	// Worker thread that reads mips in
+	JobManager mJobManager;
+
+	// Number of bytes of video memory streamed textures can use
+	size_t mBudget;
+
+	// Number of bytes the streamed textures' uploaded mips use
+	size_t mResidentSize;
+
+	// Number of times Update() was called
+	uint64_t mFrame;
+};
@@ -1,4 +1,5 @@
 #include "UniformBuffer.h"
+#include <cstring>
 #include <iostream>
 #include <glad/glad.h>
 #include "Shader.h"
@@ -7,7 +8,9 @@ UniformBuffer::UniformBuffer(size_t bufferSize, BufferBindingPoint bindingPoint,
 	mBufferID(0),
 	mBufferSize(bufferSize),
 	mBindingPoint(static_cast<unsigned int>(bindingPoint)),
-	mBufferName(bufferName)
+	mBufferName(bufferName),
+	mUploadedData(bufferSize),
+	mHasData(false)
 {
 	glGenBuffers(1, &mBufferID);
 	glBindBuffer(GL_UNIFORM_BUFFER, mBufferID);
@@ -34,14 +37,38 @@ void UniformBuffer::LinkShader(Shader* shader)
 	glUniformBlockBinding(shaderID, uniformBlockIndex, mBindingPoint);
 }
 
-void UniformBuffer::UpdateBufferData(const void* data) const
+void UniformBuffer::UpdateBufferData(const void* data)
 {
-	// Bind buffer to update data
-	glBindBuffer(GL_UNIFORM_BUFFER, mBufferID);
-	// Update the data
-	glBufferSubData(GL_UNIFORM_BUFFER, 0, mBufferSize, data);
-	// Unbind
-	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	// Find the first and last bytes that changed since the last upload
+	size_t first = 0;
+	size_t last = mBufferSize;
+	if (mHasData)
+	{
+		while (first < mBufferSize && bytes[first] == mUploadedData[first])
+		{
+			++first;
+		}
+		while (last > first && bytes[last - 1] == mUploadedData[last - 1])
+		{
+			--last;
+		}
+	}
+
+	if (first < last)
+	{
+		std::memcpy(mUploadedData.data() + first, bytes + first, last - first);
+		mHasData = true;
+
+		// Bind buffer to update data
+		glBindBuffer(GL_UNIFORM_BUFFER, mBufferID);
+		// Update only the changed range
+		glBufferSubData(GL_UNIFORM_BUFFER, first, last - first, bytes + first);
+		// Unbind
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
 	// Binding to shader binding point
 	glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<unsigned int>(mBindingPoint), mBufferID);
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <vector>
 
 class Shader;
 
@@ -11,6 +13,8 @@ enum class BufferBindingPoint
 	Skeleton = 3,
 	Shadow = 4,
 	PointShadow = 5,
+	Cascade = 6,
+	Cluster = 7,
 };
 
 // UniformBuffer class helps abstract an OpenGL uniform buffer object. Use
@@ -29,9 +33,10 @@ public:
 	// @param - Shader* for the shader to link to
 	void LinkShader(Shader* shader);
 
-	// Updates the uniform buffer's data
+	// Updates the uniform buffer's data. Only the range of bytes that changed since the last update is uploaded,
+	// and nothing is uploaded if the data is the same.
 	// @param - const void* for the new data
-	void UpdateBufferData(const void* data) const;
+	void UpdateBufferData(const void* data);
 
 	unsigned int GetBindingPoint() const { return mBindingPoint; }
 
@@ -47,4 +52,10 @@ private:
 
 	// The buffer's uniform block name in the shader
 	const char* mBufferName;
+
+	// Copy of the data last uploaded, used to find the bytes that changed
+	std::vector<unsigned char> mUploadedData;
+
+	// Bool for if anything has been uploaded yet
+	bool mHasData;
 };
@@ -1,5 +1,8 @@
 #include "VertexBuffer.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 VertexBuffer::VertexBuffer(const void* vertices, const void* indices, size_t vertexSize, size_t indexSize,
 	size_t vertexCount, size_t indexCount, VertexLayout vertexLayout) :
@@ -10,6 +13,9 @@ VertexBuffer::VertexBuffer(const void* vertices, const void* indices, size_t ver
 	mLastAttribIndex(0),
 	mVertexCount(vertexCount),
 	mIndexCount(indexCount),
+	mVertexSize(vertexSize),
+	mIndexSize(indices ? indexSize : 0),
+	mVertexLayout(vertexLayout),
 	mDrawIndexed(false),
 	mDrawInstanced(false)
 {
@@ -55,6 +61,55 @@ VertexBuffer::~VertexBuffer()
 	glDeleteBuffers(1, &mIndexBufferID);
 }
 
+bool VertexBuffer::HasData(const void* vertices, const void* indices, size_t vertexSize, size_t indexSize) const
+{
+	if (!indices)
+	{
+		indexSize = 0;
+	}
+	if (vertexSize != mVertexSize || indexSize != mIndexSize)
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> data(std::max(vertexSize, indexSize));
+	if (vertexSize > 0)
+	{
+		glGetNamedBufferSubData(mVertexBufferID, 0, vertexSize, data.data());
+		if (std::memcmp(data.data(), vertices, vertexSize) != 0)
+		{
+			return false;
+		}
+	}
+	if (indexSize > 0)
+	{
+		glGetNamedBufferSubData(mIndexBufferID, 0, indexSize, data.data());
+		if (std::memcmp(data.data(), indices, indexSize) != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+VertexBuffer* VertexBuffer::Copy() const
+{
+	std::vector<unsigned char> vertices(mVertexSize);
+	std::vector<unsigned char> indices(mIndexSize);
+	if (mVertexSize > 0)
+	{
+		glGetNamedBufferSubData(mVertexBufferID, 0, mVertexSize, vertices.data());
+	}
+	if (mIndexSize > 0)
+	{
+		glGetNamedBufferSubData(mIndexBufferID, 0, mIndexSize, indices.data());
+	}
+
+	return new VertexBuffer(vertices.data(), mDrawIndexed ? indices.data() : nullptr, mVertexSize, mIndexSize,
+		mVertexCount, mIndexCount, mVertexLayout);
+}
+
 void VertexBuffer::SetVertexAttributePointers(VertexLayout layout)
 {
 	switch (layout)
@@ -139,3 +194,19 @@ void VertexBuffer::Draw() const
 
 	glBindVertexArray(0);
 }
+
+void VertexBuffer::DrawInstanced(unsigned int numInstances) const
+{
+	SetActive();
+
+	if (mDrawIndexed)
+	{
+		glDrawElementsInstanced(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0, numInstances);
+	}
+	else
+	{
+		glDrawArraysInstanced(GL_TRIANGLES, 0, mVertexCount, numInstances);
+	}
+
+	glBindVertexArray(0);
+}
@@ -36,6 +36,11 @@ public:
 	// Sets the VAO as active, then draws the vertices, based on if it has indices or not
 	void Draw() const;
 
+	// Sets the VAO as active, then draws several instances of the vertices in one call.
+	// Unlike Draw(), this does not need MakeInstance() since no per instance attributes are used.
+	// @param - unsigned int for the number of instances
+	void DrawInstanced(unsigned int numInstances) const;
+
 	// Binds the Vertex Array Object, setting this VAO as the current one.
 	// This is set BEFORE every time the vertices are being drawn.
 	void SetActive() const { glBindVertexArray(mVaoID); }
@@ -46,6 +51,24 @@ public:
 	size_t GetNumberOfVertices() const { return mVertexCount; }
 	size_t GetNumberOfIndices() const { return mIndexCount; }
 
+	// Gets the number of bytes the vertex and index buffers use
+	// @return - size_t for the number of bytes
+	size_t GetSize() const { return mVertexSize + mIndexSize; }
+
+	// Checks if the buffers hold exactly the given vertices and indices by reading them back from the GPU.
+	// This stalls until the buffers are readable, so only use it while loading.
+	// @param - const void* for the vertex data
+	// @param - const void* for the index data
+	// @param - size_t for the size in bytes of the vertex array
+	// @param - size_t for the size in bytes of the index array
+	// @return - bool for if the sizes and bytes all match
+	bool HasData(const void* vertices, const void* indices, size_t vertexSize, size_t indexSize) const;
+
+	// Creates a new vertex buffer with the same vertices and indices, read back from the GPU.
+	// The copy isn't instanced. This stalls until the buffers are readable, so only use it while loading.
+	// @return - VertexBuffer* for the copy
+	VertexBuffer* Copy() const;
+
 private:
 	// ID for the Vertex Array Object
 	unsigned int mVaoID;
@@ -68,6 +91,15 @@ private:
 	// Number of indices
 	size_t mIndexCount;
 
+	// Size in bytes of the vertex buffer
+	size_t mVertexSize;
+
+	// Size in bytes of the index buffer
+	size_t mIndexSize;
+
+	// Layout of the vertices
+	VertexLayout mVertexLayout;
+
 	// Bool for if the vertex array uses index based drawing
 	bool mDrawIndexed;
 
@@ -0,0 +1,43 @@
+#include "AssetId.h"
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+#include "../Util/Logger.h"
+
+// Interned names by hash. Assets can be stored from worker threads, so the table is locked.
+static std::mutex s_InternMutex;
+static std::unordered_map<uint64_t, std::string> s_InternedNames;
+
+AssetId AssetId::Intern(std::string_view name)
+{
+	AssetId id(name);
+
+	std::lock_guard<std::mutex> lock(s_InternMutex);
+	auto iter = s_InternedNames.find(id.mHash);
+	if (iter == s_InternedNames.end())
+	{
+		s_InternedNames.emplace(id.mHash, std::string(name));
+	}
+	else if (iter->second != name)
+	{
+		LOG_ERROR("Asset names have the same id: " + iter->second + " and " + std::string(name));
+	}
+
+	return id;
+}
+
+std::string AssetId::GetName() const
+{
+	{
+		std::lock_guard<std::mutex> lock(s_InternMutex);
+		auto iter = s_InternedNames.find(mHash);
+		if (iter != s_InternedNames.end())
+		{
+			return iter->second;
+		}
+	}
+
+	char hex[19] = {};
+	std::snprintf(hex, sizeof(hex), "0x%016llx", static_cast<unsigned long long>(mHash));
+	return hex;
+}
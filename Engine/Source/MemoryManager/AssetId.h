@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// AssetId is an asset's name hashed into 64 bits, so cache lookups compare integers instead of hashing and comparing paths.
+// Names convert to AssetIds implicitly. Literals can be hashed at compile time with "name"_id, and
+// names that are stored in the AssetManager are interned with AssetId::Intern() so they can be looked up again for logging.
+class AssetId
+{
+public:
+	// Empty AssetId that no asset uses
+	constexpr AssetId() : mHash(0) {}
+
+	// AssetId constructor hashes a name (64 bit FNV-1a)
+	// @param - std::string_view for the name
+	constexpr AssetId(std::string_view name) : mHash(Hash(name)) {}
+
+	// @param - const char* for the name
+	constexpr AssetId(const char* name) : mHash(Hash(name)) {}
+
+	// @param - const std::string& for the name
+	AssetId(const std::string& name) : mHash(Hash(name)) {}
+
+	// Hashes a name and remembers it, so GetName() can find it. Logs an error if another name has the same hash.
+	// @param - std::string_view for the name
+	// @return - AssetId for the name
+	static AssetId Intern(std::string_view name);
+
+	// Gets the name an AssetId was interned with
+	// @return - std::string for the name (the hash in hex if it wasn't interned)
+	std::string GetName() const;
+
+	// Gets the hash
+	// @return - uint64_t for the hash
+	constexpr uint64_t GetHash() const { return mHash; }
+
+	// Gets if the id was made from a name
+	// @return - bool for if it isn't empty
+	constexpr bool IsValid() const { return mHash != 0; }
+
+	constexpr bool operator==(const AssetId& other) const { return mHash == other.mHash; }
+	constexpr bool operator!=(const AssetId& other) const { return mHash != other.mHash; }
+
+private:
+	// Hashes a name with 64 bit FNV-1a
+	// @param - std::string_view for the name
+	// @return - uint64_t for the hash
+	static constexpr uint64_t Hash(std::string_view name)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : name)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Hashed name
+	uint64_t mHash;
+};
+
+// Hashes a literal into an AssetId at compile time
+// @param - const char* for the literal
+// @param - size_t for the literal's length
+// @return - AssetId for the literal
+consteval AssetId operator""_id(const char* name, size_t length)
+{
+	return AssetId(std::string_view(name, length));
+}
+
+// The hash is already well mixed, so unordered maps use it as is
+template <>
+struct std::hash<AssetId>
+{
+	size_t operator()(const AssetId& id) const { return static_cast<size_t>(id.GetHash()); }
+};
@@ -0,0 +1,116 @@
+#include "AssetLoadBenchmark.h"
+#include <chrono>
+#include <thread>
+#include "../Graphics/ModelLoader.h"
+#include "../Graphics/Texture.h"
+#include "../Multithreading/JobManager.h"
+#include "DerivedDataCache.h"
+
+namespace AssetLoadBenchmark
+{
+	// Job that decodes a texture and throws the result away
+	class DecodeJob : public JobManager::Job
+	{
+	public:
+		DecodeJob(const std::string& fileName, TextureType type) :
+			JobManager::Job(true),
+			mFileName(fileName),
+			mType(type)
+		{}
+
+		void DoJob() override
+		{
+			Texture::Decode(mFileName, mType);
+		}
+
+	private:
+		std::string mFileName;
+		TextureType mType;
+	};
+
+	// Job that imports a model, then queues a job for each of its textures and throws the model away
+	class ImportJob : public JobManager::Job
+	{
+	public:
+		ImportJob(JobManager* jobManager, const std::string& fileName) :
+			JobManager::Job(true),
+			mJobManager(jobManager),
+			mFileName(fileName)
+		{}
+
+		void DoJob() override
+		{
+			ModelLoader::ImportedModel* imported = ModelLoader::Import(mFileName);
+			if (imported)
+			{
+				for (const ModelLoader::ImportedTexture& texture : imported->textures)
+				{
+					mJobManager->AddJob(new DecodeJob(texture.fileName, texture.type));
+				}
+			}
+			delete imported;
+		}
+
+	private:
+		JobManager* mJobManager;
+		std::string mFileName;
+	};
+
+	AssetLoadBenchmarkResult Run(const std::vector<std::string>& modelFiles, const std::vector<std::pair<std::string, TextureType>>& textureFiles, unsigned int numThreads)
+	{
+		AssetLoadBenchmarkResult result = {};
+		result.numModels = modelFiles.size();
+		result.numTextures = textureFiles.size();
+		result.numThreads = numThreads > 0 ? numThreads : std::thread::hardware_concurrency();
+
+		// Both runs import and decode everything from the source files. With the cache on, the first
+		// run would fill it and the second would only read cooked models and compressed textures back.
+		DerivedDataCache* cache = DerivedDataCache::Get();
+		bool wasCacheEnabled = cache->IsEnabled();
+		cache->SetEnabled(false);
+
+		// Load everything on this thread
+		auto start = std::chrono::high_resolution_clock::now();
+		for (const std::string& fileName : modelFiles)
+		{
+			ModelLoader::ImportedModel* imported = ModelLoader::Import(fileName);
+			if (imported)
+			{
+				for (const ModelLoader::ImportedTexture& texture : imported->textures)
+				{
+					Texture::Decode(texture.fileName, texture.type);
+				}
+			}
+			delete imported;
+		}
+		for (const auto& textureFile : textureFiles)
+		{
+			Texture::Decode(textureFile.first, textureFile.second);
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		result.serialMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+		// Load everything again as jobs, starting the biggest (models) first
+		JobManager jobManager(result.numThreads);
+		jobManager.Begin();
+
+		start = std::chrono::high_resolution_clock::now();
+		for (const std::string& fileName : modelFiles)
+		{
+			jobManager.AddJob(new ImportJob(&jobManager, fileName));
+		}
+		for (const auto& textureFile : textureFiles)
+		{
+			jobManager.AddJob(new DecodeJob(textureFile.first, textureFile.second));
+		}
+		jobManager.WaitForJobs();
+		end = std::chrono::high_resolution_clock::now();
+		result.parallelMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+		jobManager.End();
+
+		cache->SetEnabled(wasCacheEnabled);
+
+		return result;
+	}
+}
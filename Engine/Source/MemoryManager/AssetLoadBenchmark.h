@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../Graphics/Texture.h"
+
+// Struct for the results of an asset load benchmark
+struct AssetLoadBenchmarkResult
+{
+	size_t numModels;			// number of model files imported
+	size_t numTextures;			// number of texture files decoded
+	unsigned int numThreads;	// number of worker threads used for the parallel run
+	double serialMs;			// milliseconds to import/decode everything on one thread
+	double parallelMs;			// milliseconds to import/decode everything across the worker threads
+};
+
+namespace AssetLoadBenchmark
+{
+	// Times importing models and decoding their textures and the given textures (everything the AssetLoader
+	// does on its workers) on one thread, then again as jobs spread over a JobManager's worker threads. The derived data
+	// cache is turned off for both runs, so each one loads from the source files like a first launch. Nothing is uploaded
+	// so no OpenGL context is needed.
+	// @param - const std::vector<std::string>& for the model files to import
+	// @param - const std::vector<std::pair<std::string, TextureType>>& for the texture files to decode and their types
+	// @param - unsigned int for the number of worker threads (0 for one per thread available on the cpu)
+	// @return - AssetLoadBenchmarkResult for the timings
+	AssetLoadBenchmarkResult Run(const std::vector<std::string>& modelFiles, const std::vector<std::pair<std::string, TextureType>>& textureFiles, unsigned int numThreads = 0);
+}
@@ -0,0 +1,282 @@
+#include "AssetLoader.h"
+#include <iostream>
+#include <thread>
+#include "../Util/Logger.h"
+#include "AssetManager.h"
+
+AssetLoader::AssetLoader(AssetManager* manager, unsigned int numThreads) :
+	mManager(manager),
+	mJobManager(numThreads > 0 ? numThreads : std::thread::hardware_concurrency()),
+	mReady(),
+	mReadyMutex(),
+	mReadyCondition(),
+	mTextureCallbacks(),
+	mWaitingModels(),
+	mModelCallbacks()
+{
+	mJobManager.Begin();
+}
+
+AssetLoader::~AssetLoader()
+{
+	std::cout << "Deleted AssetLoader\n";
+
+	Shutdown();
+}
+
+void AssetLoader::Shutdown()
+{
+	// Finish any running jobs before freeing what they produced
+	mJobManager.WaitForJobs();
+	mJobManager.End();
+
+	std::lock_guard<std::mutex> lock(mReadyMutex);
+	for (ReadyLoad& load : mReady)
+	{
+		delete load.model;
+	}
+	mReady.clear();
+
+	for (auto& waiting : mWaitingModels)
+	{
+		delete waiting.second.model;
+	}
+	mWaitingModels.clear();
+
+	mTextureCallbacks.clear();
+	mModelCallbacks.clear();
+}
+
+void AssetLoader::LoadTexture(const std::string& textureFileName, TextureType type, std::function<void(Texture*)> onLoaded)
+{
+	// Already cached, nothing to load
+	Texture* texture = mManager->LoadTexture(textureFileName);
+	if (texture)
+	{
+		if (onLoaded)
+		{
+			onLoaded(texture);
+		}
+		return;
+	}
+
+	auto iter = mTextureCallbacks.find(textureFileName);
+	bool isLoading = iter != mTextureCallbacks.end();
+
+	std::vector<std::function<void(Texture*)>>& callbacks = mTextureCallbacks[textureFileName];
+	if (onLoaded)
+	{
+		callbacks.emplace_back(onLoaded);
+	}
+
+	if (!isLoading)
+	{
+		mJobManager.AddJob(new TextureJob(this, textureFileName, type));
+	}
+}
+
+void AssetLoader::LoadModel(const std::string& modelFileName, std::function<void(Model*)> onLoaded)
+{
+	// Already cached, nothing to load
+	Model* model = mManager->LoadCachedModel(modelFileName);
+	if (model)
+	{
+		if (onLoaded)
+		{
+			onLoaded(model);
+		}
+		return;
+	}
+
+	auto iter = mModelCallbacks.find(modelFileName);
+	bool isLoading = iter != mModelCallbacks.end();
+
+	std::vector<std::function<void(Model*)>>& callbacks = mModelCallbacks[modelFileName];
+	if (onLoaded)
+	{
+		callbacks.emplace_back(onLoaded);
+	}
+
+	if (!isLoading)
+	{
+		mJobManager.AddJob(new ModelJob(this, modelFileName));
+	}
+}
+
+size_t AssetLoader::ProcessUploads(size_t byteBudget)
+{
+	size_t uploaded = 0;
+
+	while (true)
+	{
+		ReadyLoad load;
+		{
+			std::lock_guard<std::mutex> lock(mReadyMutex);
+			if (mReady.empty())
+			{
+				break;
+			}
+
+			// Always upload at least one load so a load bigger than the budget still gets through
+			if (uploaded > 0 && uploaded + mReady.front().size > byteBudget)
+			{
+				break;
+			}
+
+			load = std::move(mReady.front());
+			mReady.pop_front();
+		}
+
+		Upload(load);
+		uploaded += load.size;
+	}
+
+	return uploaded;
+}
+
+void AssetLoader::WaitForAll()
+{
+	while (GetNumPending() > 0)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mReadyMutex);
+			mReadyCondition.wait(lock, [this]() {
+				return !mReady.empty();
+			});
+		}
+
+		ProcessUploads(SIZE_MAX);
+	}
+}
+
+void AssetLoader::PushReady(ReadyLoad& load)
+{
+	{
+		std::lock_guard<std::mutex> lock(mReadyMutex);
+		mReady.emplace_back(std::move(load));
+	}
+	mReadyCondition.notify_all();
+}
+
+void AssetLoader::LoadModelTextures(const std::string& modelFileName, ModelLoader::ImportedModel* imported)
+{
+	// Count one extra texture while requesting so textures that are already cached can't queue the model early
+	mWaitingModels[modelFileName] = { imported, imported->textures.size() + 1 };
+
+	for (const ModelLoader::ImportedTexture& texture : imported->textures)
+	{
+		LoadTexture(texture.fileName, texture.type, [this, modelFileName](Texture*) {
+			OnModelTextureLoaded(modelFileName);
+		});
+	}
+
+	// The textures stay undecoded in the imported model, the materials find them in the cache when the model is finished
+
+	OnModelTextureLoaded(modelFileName);
+}
+
+void AssetLoader::OnModelTextureLoaded(const std::string& modelFileName)
+{
+	auto iter = mWaitingModels.find(modelFileName);
+	if (iter == mWaitingModels.end() || --iter->second.numTextures > 0)
+	{
+		return;
+	}
+
+	ReadyLoad load;
+	load.fileName = modelFileName;
+	load.type = ReadyLoadType::Model;
+	load.textureType = TextureType::None;
+	load.model = iter->second.model;
+	load.size = ModelLoader::GetUploadSize(load.model);
+	mWaitingModels.erase(iter);
+
+	PushReady(load);
+}
+
+void AssetLoader::Upload(ReadyLoad& load)
+{
+	switch (load.type)
+	{
+	case ReadyLoadType::Texture:
+	{
+		// Another load might have cached the same file first
+		Texture* texture = mManager->LoadTexture(load.fileName);
+		if (!texture)
+		{
+			texture = mManager->CreateTexture(load.fileName, load.textureType, std::move(load.texture));
+			mManager->SaveTexture(load.fileName, texture);
+		}
+
+		auto iter = mTextureCallbacks.find(load.fileName);
+		if (iter != mTextureCallbacks.end())
+		{
+			std::vector<std::function<void(Texture*)>> callbacks = std::move(iter->second);
+			mTextureCallbacks.erase(iter);
+			for (auto& callback : callbacks)
+			{
+				callback(texture);
+			}
+		}
+		break;
+	}
+	case ReadyLoadType::ModelImported:
+	case ReadyLoadType::Model:
+	{
+		if (load.type == ReadyLoadType::ModelImported && load.model && !mManager->LoadCachedModel(load.fileName))
+		{
+			LoadModelTextures(load.fileName, load.model);
+			break;
+		}
+
+		Model* model = mManager->LoadCachedModel(load.fileName);
+		if (model)
+		{
+			delete load.model;
+		}
+		else if (load.model)
+		{
+			model = ModelLoader::Finish(load.model, mManager);
+			mManager->SaveModel(load.fileName, model);
+		}
+		load.model = nullptr;
+
+		auto iter = mModelCallbacks.find(load.fileName);
+		if (iter != mModelCallbacks.end())
+		{
+			std::vector<std::function<void(Model*)>> callbacks = std::move(iter->second);
+			mModelCallbacks.erase(iter);
+			for (auto& callback : callbacks)
+			{
+				callback(model);
+			}
+		}
+		break;
+	}
+	}
+}
+
+void AssetLoader::TextureJob::DoJob()
+{
+	ReadyLoad load;
+	load.fileName = mFileName;
+	load.type = ReadyLoadType::Texture;
+	load.textureType = mType;
+	load.texture = Texture::Decode(mFileName, mType);
+	load.model = nullptr;
+	load.size = load.texture.GetSize();
+
+	mLoader->PushReady(load);
+}
+
+void AssetLoader::ModelJob::DoJob()
+{
+	ReadyLoad load;
+	load.fileName = mFileName;
+	load.type = ReadyLoadType::ModelImported;
+	load.textureType = TextureType::None;
+	load.model = ModelLoader::Import(mFileName);
+	load.size = 0;
+
+	mLoader->PushReady(load);
+}
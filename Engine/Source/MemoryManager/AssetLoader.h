@@ -0,0 +1,168 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../Graphics/ModelLoader.h"
+#include "../Graphics/Texture.h"
+#include "../Multithreading/JobManager.h"
+
+class AssetManager;
+class Model;
+
+// AssetLoader loads textures and models in the background for the AssetManager. File reading,
+// image decoding, and Assimp parsing run as jobs on the loader's own worker threads. Finished jobs
+// queue their results, and the render thread uploads them to OpenGL a budgeted amount per frame,
+// then caches them and calls back anything that asked for them. A model's textures are loaded as
+// their own texture loads once it's imported, so they decode in parallel and share loads with
+// every other request for the same file. Loading runs on its own JobManager
+// so JobManager::WaitForJobs() on the engine's job manager doesn't wait on a long model import.
+class AssetLoader
+{
+public:
+	// AssetLoader constructor starts the worker threads
+	// @param - AssetManager* for the manager that caches the loaded assets
+	// @param - unsigned int for the number of worker threads (0 for one per thread available on the cpu)
+	AssetLoader(AssetManager* manager, unsigned int numThreads = 0);
+	~AssetLoader();
+
+	// Stops the worker threads and frees anything that hasn't been uploaded
+	void Shutdown();
+
+	// Starts loading a texture in the background. Only one load runs per file name.
+	// @param - const std::string& for the texture file name
+	// @param - TextureType for the type
+	// @param - std::function<void(Texture*)> called on the render thread once the texture is cached (can be empty)
+	void LoadTexture(const std::string& textureFileName, TextureType type, std::function<void(Texture*)> onLoaded);
+
+	// Starts loading a model in the background. Only one load runs per file name.
+	// @param - const std::string& for the model file name
+	// @param - std::function<void(Model*)> called on the render thread once the model is cached (can be empty)
+	void LoadModel(const std::string& modelFileName, std::function<void(Model*)> onLoaded);
+
+	// Uploads finished loads until the budget runs out. At least one load is uploaded if any are ready.
+	// Must be called on the render thread.
+	// @param - size_t for the number of bytes that can be uploaded
+	// @return - size_t for the number of bytes uploaded
+	size_t ProcessUploads(size_t byteBudget);
+
+	// Blocks until every requested load is uploaded and cached. Must be called on the render thread.
+	void WaitForAll();
+
+	// Gets the number of requested textures and models that aren't cached yet
+	// @return - size_t for the number of loads
+	size_t GetNumPending() const { return mTextureCallbacks.size() + mModelCallbacks.size(); }
+
+	// Gets the job manager that runs the load jobs
+	// @return - JobManager* for the loader's job manager
+	JobManager* GetJobManager() { return &mJobManager; }
+
+private:
+	// Enum class for what a finished load holds
+	enum class ReadyLoadType
+	{
+		Texture,		// a decoded texture
+		ModelImported,	// an imported model whose textures haven't been requested yet
+		Model			// an imported model whose textures are all cached
+	};
+
+	// Struct for a load that finished on a worker and is waiting to be uploaded
+	struct ReadyLoad
+	{
+		std::string fileName;					// file name the asset is cached by
+		ReadyLoadType type;						// what the load holds
+		TextureType textureType;				// type of a texture
+		TextureData texture;					// decoded texture
+		ModelLoader::ImportedModel* model;		// imported model (nullptr if the import failed)
+		size_t size;							// bytes that will be uploaded
+	};
+
+	// Job that decodes a texture on a worker thread
+	class TextureJob : public JobManager::Job
+	{
+	public:
+		TextureJob(AssetLoader* loader, const std::string& fileName, TextureType type) :
+			JobManager::Job(true),
+			mLoader(loader),
+			mFileName(fileName),
+			mType(type)
+		{}
+
+		void DoJob() override;
+
+	private:
+		AssetLoader* mLoader;
+		std::string mFileName;
+		TextureType mType;
+	};
+
+	// Job that imports a model on a worker thread
+	class ModelJob : public JobManager::Job
+	{
+	public:
+		ModelJob(AssetLoader* loader, const std::string& fileName) :
+			JobManager::Job(true),
+			mLoader(loader),
+			mFileName(fileName)
+		{}
+
+		void DoJob() override;
+
+	private:
+		AssetLoader* mLoader;
+		std::string mFileName;
+	};
+
+	// Struct for an imported model waiting on its textures
+	struct WaitingModel
+	{
+		ModelLoader::ImportedModel* model;	// imported model
+		size_t numTextures;					// number of textures that aren't cached yet
+	};
+
+	// Adds a finished load to the ready queue
+	// @param - ReadyLoad& for the load (moved from)
+	void PushReady(ReadyLoad& load);
+
+	// Starts loading the textures of an imported model. The model is queued to be finished once they're all cached.
+	// @param - const std::string& for the model file name
+	// @param - ModelLoader::ImportedModel* for the imported model
+	void LoadModelTextures(const std::string& modelFileName, ModelLoader::ImportedModel* imported);
+
+	// Counts one of a waiting model's textures as cached, and queues the model once none are left
+	// @param - const std::string& for the model file name
+	void OnModelTextureLoaded(const std::string& modelFileName);
+
+	// Uploads and caches a finished load, then calls back anything waiting on it
+	// @param - ReadyLoad& for the load
+	void Upload(ReadyLoad& load);
+
+	// Manager the loaded assets are cached in
+	AssetManager* mManager;
+
+	// Worker threads that run the load jobs
+	JobManager mJobManager;
+
+	// Loads that finished on a worker, in the order they finished (shared with the workers)
+	std::deque<ReadyLoad> mReady;
+
+	// Mutex to protect the ready queue
+	std::mutex mReadyMutex;
+
+	// Condition used to wake up WaitForAll() when a load finishes
+	std::condition_variable mReadyCondition;
+
+	// Callbacks of each texture that's loading, by file name (render thread only)
+	std::unordered_map<std::string, std::vector<std::function<void(Texture*)>>> mTextureCallbacks;
+
+	// Imported models waiting on their textures, by file name (render thread only)
+	std::unordered_map<std::string, WaitingModel> mWaitingModels;
+
+	// Callbacks of each model that's loading, by file name (render thread only)
+	std::unordered_map<std::string, std::vector<std::function<void(Model*)>>> mModelCallbacks;
+};
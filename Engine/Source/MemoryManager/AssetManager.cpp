@@ -1,18 +1,25 @@
 #include "AssetManager.h"
+#include <algorithm>
 #include <iostream>
 #include "../Util/Logger.h"
 #include "../Graphics/ModelLoader.h"
+#include "AssetLoader.h"
 
 AssetManager::AssetManager() :
+	mLoader(new AssetLoader(this)),
+	mStreamer(new TextureStreamer()),
+	mWatcher(new FileWatcher()),
 	mShaderCache(new Cache<Shader>(this)),
-	mTextureCache(new Cache<Texture>(this)),
+	mTextureCache(new Cache<Texture>(this, [](const Texture* texture) { return texture->GetMemorySize(); })),
+	mTextureAtlasCache(new Cache<TextureAtlas>(this)),
 	mMaterialCache(new Cache<Material>(this)),
-	mMeshCache(new Cache<Mesh>(this)),
+	mMeshCache(new Cache<Mesh>(this, [](const Mesh* mesh) { return mesh->GetMemorySize(); })),
 	mModelCache(new Cache<Model>(this)),
 	mAnimationCache(new Cache<Animation>(this)),
 	mShaderProgramCache(new Cache<ShaderProgram>(this)),
 	mSfxCache(new Cache<SFX>(this)),
-	mMusicCache(new Cache<Music>(this))
+	mMusicCache(new Cache<Music>(this)),
+	mDeduplicateMeshes(true)
 {
 }
 
@@ -25,37 +32,94 @@ void AssetManager::Shutdown()
 {
 	std::cout << "Shutdown asset manager\n";
 
-	delete mShaderCache;
-	delete mTextureCache;
-	delete mMaterialCache;
-	delete mMeshCache;
+	// Stop loading before the caches loads are saved into are deleted
+	delete mLoader;
+	mLoader = nullptr;
+
+	delete mWatcher;
+	mWatcher = nullptr;
+
+	// Assets release what they reference when they're deleted, so the caches go from models down to shaders
 	delete mModelCache;
+	delete mMeshCache;
+	delete mMaterialCache;
+	delete mTextureAtlasCache;
+	delete mTextureCache;
 	delete mAnimationCache;
+	delete mShaderCache;
 	delete mShaderProgramCache;
 	delete mSfxCache;
 	delete mMusicCache;
+
+	// Deleted textures tell the streamer, so it goes last
+	delete mStreamer;
+	mStreamer = nullptr;
 }
 
 void AssetManager::Clear()
 {
-	mShaderCache->Clear();
-	mTextureCache->Clear();
-	mMaterialCache->Clear();
-	mMeshCache->Clear();
+	// Models first, so the meshes, materials, and textures they release can be cleared after them
 	mModelCache->Clear();
+	mMeshCache->Clear();
+	mMaterialCache->Clear();
+	mTextureAtlasCache->Clear();
+	mTextureCache->Clear();
 	mAnimationCache->Clear();
+	mShaderCache->Clear();
 	mShaderProgramCache->Clear();
 	mSfxCache->Clear();
 	mMusicCache->Clear();
 }
 
-Shader* AssetManager::LoadShader(const std::string& shaderName)
+void AssetManager::TrimCaches()
+{
+	// Models go first so the meshes and materials they let go of can be trimmed after them
+	mModelCache->Trim();
+	mMeshCache->Trim();
+	mMaterialCache->Trim();
+	mTextureAtlasCache->Trim();
+	mTextureCache->Trim();
+	mAnimationCache->Trim();
+	mShaderCache->Trim();
+	mShaderProgramCache->Trim();
+	mSfxCache->Trim();
+	mMusicCache->Trim();
+}
+
+CacheBase* AssetManager::GetCache(AssetType type)
+{
+	switch (type)
+	{
+	case AssetType::Shader:
+		return mShaderCache;
+	case AssetType::Texture:
+		return mTextureCache;
+	case AssetType::TextureAtlas:
+		return mTextureAtlasCache;
+	case AssetType::Material:
+		return mMaterialCache;
+	case AssetType::Mesh:
+		return mMeshCache;
+	case AssetType::Model:
+		return mModelCache;
+	case AssetType::Animation:
+		return mAnimationCache;
+	case AssetType::ShaderProgram:
+		return mShaderProgramCache;
+	case AssetType::SFX:
+		return mSfxCache;
+	default:
+		return mMusicCache;
+	}
+}
+
+Shader* AssetManager::LoadShader(AssetId shaderName)
 {
 	Shader* shader = mShaderCache->Get(shaderName);
 
 	if (!shader)
 	{
-		LOG_WARNING("Could not find shader name: " + shaderName);
+		LOG_WARNING("Could not find shader name: " + shaderName.GetName());
 	}
 
 	return shader;
@@ -75,19 +139,156 @@ Shader* AssetManager::LoadShader(const std::string& name, const char* vertexFile
 	return shader;
 }
 
+Shader* AssetManager::LoadComputeShader(const std::string& name, const char* computeFile)
+{
+	Shader* shader = mShaderCache->Get(name);
+
+	if (!shader)
+	{
+		shader = new Shader(this, name, computeFile);
+
+		SaveShader(name, shader);
+	}
+
+	return shader;
+}
+
+void AssetManager::SaveTexture(const std::string& textureFileName, Texture* texture)
+{
+	mTextureCache->StoreCache(AssetId::Intern(textureFileName), texture);
+	mWatcher->Watch(textureFileName);
+}
+
 Texture* AssetManager::LoadTexture(const std::string& textureFileName, TextureType type)
 {
 	Texture* texture = mTextureCache->Get(textureFileName);
 
 	if (!texture)
 	{
-		texture = new Texture(textureFileName, type);
+		texture = CreateTexture(textureFileName, type, Texture::Decode(textureFileName, type));
 		SaveTexture(textureFileName, texture);
 	}
 
 	return texture;
 }
 
+Texture* AssetManager::CreateTexture(const std::string& textureFileName, TextureType type, TextureData&& data)
+{
+	if (data.compression == TextureCompression::None || !data.pixels)
+	{
+		return new Texture(textureFileName, type, data);
+	}
+
+	Texture* texture = new Texture(textureFileName, type, data, TextureStreamer::GetMinResidentMip(data));
+	mStreamer->Add(texture, std::move(data));
+	return texture;
+}
+
+void AssetManager::LoadTextureAsync(const std::string& textureFileName, TextureType type, std::function<void(Texture*)> onLoaded)
+{
+	mLoader->LoadTexture(textureFileName, type, onLoaded);
+}
+
+TextureAtlas* AssetManager::LoadTextureAtlas(const std::string& atlasName, const std::vector<std::string>& imageFileNames)
+{
+	TextureAtlas* atlas = mTextureAtlasCache->Get(atlasName);
+
+	if (!atlas)
+	{
+		atlas = new TextureAtlas(atlasName);
+		for (const std::string& fileName : imageFileNames)
+		{
+			atlas->AddImage(fileName);
+		}
+		atlas->Build();
+
+		SaveTextureAtlas(atlasName, atlas);
+	}
+
+	return atlas;
+}
+
+void AssetManager::SaveMaterial(const std::string& materialName, Material* material)
+{
+	AssetHandle<Material> handle = mMaterialCache->StoreCache(AssetId::Intern(materialName), material);
+	if (!handle.IsValid())
+	{
+		return;
+	}
+
+	AcquireMaterialAssets(handle, material);
+}
+
+void AssetManager::UpdateMaterial(const std::string& materialName)
+{
+	AssetHandle<Material> handle = mMaterialCache->GetHandle(AssetId::Intern(materialName));
+	Material* material = mMaterialCache->Get(handle);
+	if (!material)
+	{
+		return;
+	}
+
+	mMaterialCache->ReleaseDependencies(handle);
+	AcquireMaterialAssets(handle, material);
+}
+
+void AssetManager::AcquireMaterialAssets(AssetHandle<Material> handle, Material* material)
+{
+	for (Texture* texture : material->GetTextures())
+	{
+		AssetHandle<Texture> textureHandle = mTextureCache->Acquire(texture);
+		if (textureHandle.IsValid())
+		{
+			mMaterialCache->AddDependency(handle, [this, textureHandle]() { mTextureCache->Release(textureHandle); });
+		}
+	}
+
+	AssetHandle<Shader> shaderHandle = mShaderCache->Acquire(material->GetShader());
+	if (shaderHandle.IsValid())
+	{
+		mMaterialCache->AddDependency(handle, [this, shaderHandle]() { mShaderCache->Release(shaderHandle); });
+	}
+}
+
+void AssetManager::SaveMesh(const std::string& meshName, Mesh* mesh)
+{
+	AssetHandle<Mesh> handle = mMeshCache->StoreCache(AssetId::Intern(meshName), mesh);
+	if (!handle.IsValid())
+	{
+		return;
+	}
+
+	AssetHandle<Material> materialHandle = mMaterialCache->Acquire(mesh->GetMaterial());
+	if (materialHandle.IsValid())
+	{
+		mMeshCache->AddDependency(handle, [this, materialHandle]() { mMaterialCache->Release(materialHandle); });
+	}
+}
+
+void AssetManager::SaveModel(const std::string& modelName, Model* model)
+{
+	AssetHandle<Model> handle = mModelCache->StoreCache(AssetId::Intern(modelName), model);
+	if (!handle.IsValid())
+	{
+		return;
+	}
+
+	AcquireMeshes(handle, model);
+	mWatcher->Watch(modelName);
+}
+
+void AssetManager::AcquireMeshes(AssetHandle<Model> handle, Model* model)
+{
+	for (Mesh* mesh : model->GetMeshes())
+	{
+		AssetHandle<Mesh> meshHandle = mMeshCache->Acquire(mesh);
+		if (meshHandle.IsValid())
+		{
+			mModelCache->AddDependency(handle, [this, meshHandle]() { mMeshCache->Release(meshHandle); });
+		}
+	}
+}
+
 Model* AssetManager::LoadModel(const std::string& modelName)
 {
 	Model* model = mModelCache->Get(modelName);
@@ -102,6 +303,42 @@ Model* AssetManager::LoadModel(const std::string& modelName)
 	return model;
 }
 
+void AssetManager::LoadModelAsync(const std::string& modelName, std::function<void(Model*)> onLoaded)
+{
+	mLoader->LoadModel(modelName, onLoaded);
+}
+
+size_t AssetManager::ProcessAsyncLoads(size_t byteBudget)
+{
+	return mLoader->ProcessUploads(byteBudget);
+}
+
+void AssetManager::WaitForAsyncLoads()
+{
+	mLoader->WaitForAll();
+}
+
+size_t AssetManager::UpdateTextureStreaming(size_t byteBudget)
+{
+	return mStreamer->Update(byteBudget);
+}
+
+size_t AssetManager::GetNumAsyncLoads() const
+{
+	return mLoader->GetNumPending();
+}
+
+JobManager* AssetManager::GetLoadJobManager()
+{
+	return mLoader->GetJobManager();
+}
+
+void AssetManager::SaveShaderProgram(const std::string& shaderFileName, ShaderProgram* program)
+{
+	mShaderProgramCache->StoreCache(AssetId::Intern(shaderFileName), program);
+	mWatcher->Watch(shaderFileName);
+}
+
 ShaderProgram* AssetManager::LoadShaderProgram(const std::string& shaderFileName)
 {
 	ShaderProgram* shaderProgram = mShaderProgramCache->Get(shaderFileName);
@@ -140,3 +377,157 @@ Music* AssetManager::LoadMusic(const std::string& fileName)
 
 	return music;
 }
+
+size_t AssetManager::ReloadChangedFiles()
+{
+	size_t numReloaded = 0;
+
+	for (const std::string& fileName : mWatcher->GetChangedFiles())
+	{
+		LOG_DEBUG("File changed: " + fileName);
+
+		if (ReloadShaderProgram(fileName))
+		{
+			++numReloaded;
+		}
+		if (mTextureCache->Get(fileName) && ReloadTexture(fileName))
+		{
+			++numReloaded;
+		}
+		if (mModelCache->Get(fileName) && ReloadModel(fileName))
+		{
+			++numReloaded;
+		}
+	}
+
+	return numReloaded;
+}
+
+bool AssetManager::ReloadShaderProgram(const std::string& shaderFileName)
+{
+	// Shader programs are usually cleared once their shaders are linked, so the shaders that use
+	// the file are found by their program files instead of through the shader program cache
+	AssetId programId(shaderFileName);
+	std::vector<Shader*> shaders;
+	mShaderCache->ForEach([programId, &shaders](Shader* shader) {
+		const std::vector<std::string>& programFiles = shader->GetProgramFiles();
+		if (std::any_of(programFiles.begin(), programFiles.end(), [programId](const std::string& file) { return AssetId(file) == programId; }))
+		{
+			shaders.emplace_back(shader);
+		}
+		});
+
+	if (shaders.empty())
+	{
+		return false;
+	}
+
+	ShaderProgram* program = mShaderProgramCache->Get(programId);
+	if (program && !program->Reload())
+	{
+		LOG_WARNING("Shader program didn't compile, keeping the last one: " + shaderFileName);
+		return false;
+	}
+
+	// Relinking compiles any of the shaders' programs that were cleared, which only need to live until they're linked
+	std::vector<AssetId> clearedPrograms;
+	for (Shader* shader : shaders)
+	{
+		for (const std::string& file : shader->GetProgramFiles())
+		{
+			if (!mShaderProgramCache->Get(file))
+			{
+				clearedPrograms.emplace_back(file);
+			}
+		}
+	}
+
+	bool isLinked = true;
+	for (Shader* shader : shaders)
+	{
+		isLinked &= shader->Relink(this);
+	}
+
+	for (AssetId file : clearedPrograms)
+	{
+		mShaderProgramCache->Delete(file);
+	}
+
+	if (!isLinked)
+	{
+		LOG_WARNING("Shader program didn't compile or link, keeping the last one: " + shaderFileName);
+	}
+
+	return isLinked;
+}
+
+bool AssetManager::ReloadTexture(const std::string& textureFileName)
+{
+	Texture* texture = mTextureCache->Get(textureFileName);
+	if (!texture)
+	{
+		return false;
+	}
+
+	TextureData data = Texture::Decode(textureFileName, texture->GetType());
+	if (!data.pixels)
+	{
+		LOG_WARNING("Couldn't decode texture, keeping the last one: " + textureFileName);
+		return false;
+	}
+
+	// The streamer is holding the old image's mips
+	mStreamer->Remove(texture);
+	texture->SetStreamer(nullptr);
+
+	if (data.compression == TextureCompression::None)
+	{
+		return texture->Reload(data, 0);
+	}
+
+	texture->Reload(data, TextureStreamer::GetMinResidentMip(data));
+	mStreamer->Add(texture, std::move(data));
+	return true;
+}
+
+bool AssetManager::ReloadModel(const std::string& modelName)
+{
+	AssetHandle<Model> handle = mModelCache->GetHandle(modelName);
+	Model* model = mModelCache->Get(handle);
+	if (!model)
+	{
+		return false;
+	}
+
+	ModelLoader::ImportedModel* imported = ModelLoader::Import(modelName);
+	if (!imported)
+	{
+		LOG_WARNING("Couldn't import model, keeping the last one: " + modelName);
+		return false;
+	}
+
+	// Forget the old meshes so new ones are built. Other models that share them keep them until they're released.
+	// The materials stay cached and are updated in place, so changes the game made to them aren't lost.
+	for (Mesh* mesh : model->GetMeshes())
+	{
+		mMeshCache->Delete(mesh);
+	}
+
+	// An instanced model draws its own copies of the meshes, so the cached ones are forgotten by key too
+	for (unsigned int meshIndex = 0; meshIndex < imported->meshes.size(); ++meshIndex)
+	{
+		mMeshCache->Delete(ModelLoader::GetMeshKey(modelName, meshIndex));
+	}
+
+	ModelLoader::DecodeTextures(imported, this);
+	Model* newModel = ModelLoader::Finish(imported, this, true);
+
+	// The old meshes go to the new model, which is deleted, then the cached model lets go of them
+	model->SwapMeshes(*newModel);
+	delete newModel;
+
+	mModelCache->ReleaseDependencies(handle);
+	AcquireMeshes(handle, model);
+
+	return true;
+}
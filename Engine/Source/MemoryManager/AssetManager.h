@@ -1,21 +1,50 @@
 #pragma once
 #include "Cache.h"
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include "../Animation/Animation.h"
 #include "../Audio/Sound.h"
 #include "../Graphics/Shader.h"
 #include "../Graphics/ShaderProgram.h"
 #include "../Graphics/Texture.h"
+#include "../Graphics/TextureAtlas.h"
+#include "../Graphics/TextureStreamer.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/Mesh.h"
 #include "../Graphics/Model.h"
+#include "../Util/FileWatcher.h"
 
+class AssetLoader;
+class JobManager;
 class Renderer;
+class TextureStreamer;
+
+// Default number of bytes uploaded to OpenGL per frame by AssetManager::ProcessAsyncLoads()
+const size_t ASYNC_UPLOAD_BUDGET = 8 * 1024 * 1024;
+
+// Enum class for the kinds of assets the AssetManager caches
+enum class AssetType
+{
+	Shader,
+	Texture,
+	TextureAtlas,
+	Material,
+	Mesh,
+	Model,
+	Animation,
+	ShaderProgram,
+	SFX,
+	Music
+};
 
 // The AssetManager is a singleton class that helps load assets on demand
 // and cache them so that subsequent loads will return the cached asset
 // instead of having to load them again. This manager provides fucntions
-// to help save/load assets when needed.
+// to help save/load assets when needed. Assets are saved by name and
+// looked up by AssetId, so lookups on hot paths can use "name"_id.
 class AssetManager
 {
 public:
@@ -27,18 +56,55 @@ public:
 
 	// Goes to each of the asset caches and calls the cache's Clear()
 	void Clear();
+
+	// Sets the number of bytes a type of asset can use before TrimCaches() deletes the least recently used assets nothing references.
+	// Textures and meshes are measured by their video memory, other assets count as 0 bytes.
+	// @param - AssetType for the type of asset
+	// @param - size_t for the number of bytes (0 for no limit, the default)
+	void SetCacheBudget(AssetType type, size_t budget) { GetCache(type)->SetBudget(budget); }
+
+	// Gets the number of bytes a type of asset can use
+	// @param - AssetType for the type of asset
+	// @return - size_t for the number of bytes (0 for no limit)
+	size_t GetCacheBudget(AssetType type) { return GetCache(type)->GetBudget(); }
+
+	// Gets the number of bytes a type of asset's cached assets use
+	// @param - AssetType for the type of asset
+	// @return - size_t for the number of bytes
+	size_t GetCacheSize(AssetType type) { return GetCache(type)->GetSize(); }
+
+	// Gets the number of cached assets of a type
+	// @param - AssetType for the type of asset
+	// @return - size_t for the number of assets
+	size_t GetNumCachedAssets(AssetType type) { return GetCache(type)->GetNumAssets(); }
+
+	// Deletes the least recently used unreferenced assets of every cache that is over its budget.
+	// Sprites, fonts, and materials made in code can use textures without referencing them, so only call this
+	// at a point where everything still in use holds a reference (see Acquire() and AssetReferences), like after a level has loaded.
+	void TrimCaches();
+
+	// Takes a reference to a cached asset, so TrimCaches() keeps it until the reference is released
+	// @param - const T* for the asset
+	// @return - AssetHandle<T> to release the reference with (empty if the asset isn't cached)
+	template <class T>
+	AssetHandle<T> Acquire(const T* asset) { return GetTypedCache<T>()->Acquire(asset); }
+
+	// Gives back a reference taken with Acquire()
+	// @param - AssetHandle<T> for the reference
+	template <class T>
+	void Release(AssetHandle<T> handle) { GetTypedCache<T>()->Release(handle); }
 	
 	// Saves a shader into the shader cache's map
 	// @param - const std::string& for the shader's name.
 	// @param - Shader* for the shader that is being saved.
-	void SaveShader(const std::string& shaderName, Shader* shader) { mShaderCache->StoreCache(shaderName, shader); }
+	void SaveShader(const std::string& shaderName, Shader* shader) { mShaderCache->StoreCache(AssetId::Intern(shaderName), shader); }
 
 	// Loads a shader from the shader cache's map if it exists, nullptr if not.
 	// Ownership of any Shader* returned from this method is handled by the AssetManager. Don't need to free memory manually.
 	// Call AssetManager::DeleteShader() if you need to delete/remove a shader by name
-	// @param - const std::string& for the shader's name.
+	// @param - AssetId for the shader's name.
 	// @return - Shader* for the desired shader retrieved from the shader cache map
-	Shader* LoadShader(const std::string& shaderName);
+	Shader* LoadShader(AssetId shaderName);
 
 	// Creates and returns a shader, saving it in the shader cache's map if it doesn't exist.
 	// Ownership of any Shader* returned from this method is handled by the AssetManager. Don't need to free memory manually.
@@ -50,25 +116,32 @@ public:
 	// @return - Shader* for the newly created shader
 	Shader* LoadShader(const std::string& name, const char* vertexFile, const char* fragmentFile, const char* geometryFile = nullptr);
 
+	// Creates and returns a compute shader, saving it in the shader cache's map if it doesn't exist.
+	// Ownership of any Shader* returned from this method is handled by the AssetManager. Don't need to free memory manually.
+	// @param - const std::string& for the shader's name
+	// @param - const char* for the compute shader name/file path
+	// @return - Shader* for the newly created shader
+	Shader* LoadComputeShader(const std::string& name, const char* computeFile);
+
 	// Deletes/clears each element from the shader cache's map
 	void ClearShaders() { mShaderCache->Clear(); }
 
 	// Deletes a shader in the shader cache map by name
-	// @param - const std::string& for the shader name
-	void DeleteShader(const std::string& shaderName) { mShaderCache->Delete(shaderName); }
+	// @param - AssetId for the shader name
+	void DeleteShader(AssetId shaderName) { mShaderCache->Delete(shaderName); }
 
 
 	// Saves a texture into the texture cache's map
 	// @param - const std::string& for the texture's name.
 	// @param - Texture* for the texture that is being saved. 
-	void SaveTexture(const std::string& textureFileName, Texture* texture) { mTextureCache->StoreCache(textureFileName, texture); }
+	void SaveTexture(const std::string& textureFileName, Texture* texture);
 
 	// Loads a texture from the texture cache's map if it exists, nullptr if not.
 	// Ownership of any Texture* returned from this method is handled by the AssetManager. Don't need to free memory manually.
 	// Call AssetManager::DeleteTexture() if you need to delete/remove a texture by name
-	// @param - const std::string& for the texture name
+	// @param - AssetId for the texture name
 	// @return - Texture* for the desired texture
-	Texture* LoadTexture(const std::string& textureFileName) { return mTextureCache->Get(textureFileName); }
+	Texture* LoadTexture(AssetId textureFileName) { return mTextureCache->Get(textureFileName); }
 
 	// Creates and returns a texture, saving it in the texture cache's map if it doesn't exist.
 	// Ownership of any Texture* returned from this method is handled by the AssetManager. Don't need to free memory manually.
@@ -78,58 +151,121 @@ public:
 	// @return - Texture* for the desired texture
 	Texture* LoadTexture(const std::string& textureFileName, TextureType type);
 
+	// Creates a texture from a decoded image. Compressed images are uploaded with only their smallest mips,
+	// and the TextureStreamer streams in sharper ones as they're drawn. Doesn't cache the texture.
+	// @param - const std::string& for the texture name
+	// @param - TextureType for the type
+	// @param - TextureData&& for the decoded image (the streamer keeps compressed images)
+	// @return - Texture* for the new texture
+	Texture* CreateTexture(const std::string& textureFileName, TextureType type, TextureData&& data);
+
+	// Starts loading a texture on a worker thread. The texture is uploaded and cached by ProcessAsyncLoads() once it's decoded.
+	// @param - const std::string& for the texture name
+	// @param - TextureType for the type
+	// @param - std::function<void(Texture*)> called on the render thread once the texture is cached (defaults to nothing)
+	void LoadTextureAsync(const std::string& textureFileName, TextureType type, std::function<void(Texture*)> onLoaded = nullptr);
+
 	// Deletes/clears each element from the texture cache's map
-	void ClearTextures() { mShaderCache->Clear(); }
+	void ClearTextures() { mTextureCache->Clear(); }
+
+	// Streams texture mips in and out for what was drawn this frame. Call once per frame on the render thread after rendering.
+	// @param - size_t for the number of bytes that can be uploaded this frame (defaults to TEXTURE_STREAMING_UPLOAD_BUDGET)
+	// @return - size_t for the number of bytes uploaded
+	size_t UpdateTextureStreaming(size_t byteBudget = TEXTURE_STREAMING_UPLOAD_BUDGET);
+
+	// Gets the texture streamer
+	// @return - TextureStreamer* for the streamer
+	TextureStreamer* GetTextureStreamer() { return mStreamer; }
 
 	// Deletes a texture in the texture cache map by name
-	// @param - const std::string& for the texture name
-	void DeleteTexture(const std::string& textureName) { mTextureCache->Delete(textureName); }
+	// @param - AssetId for the texture name
+	void DeleteTexture(AssetId textureName) { mTextureCache->Delete(textureName); }
+
 
+	// Saves a texture atlas into the texture atlas cache's map
+	// @param - const std::string& for the atlas' name
+	// @param - TextureAtlas* for the atlas that is being saved
+	void SaveTextureAtlas(const std::string& atlasName, TextureAtlas* atlas) { mTextureAtlasCache->StoreCache(AssetId::Intern(atlasName), atlas); }
 
-	// Saves a material into the material cache's map
+	// Loads a texture atlas from the texture atlas cache's map if it exists, nullptr if not.
+	// Ownership of any TextureAtlas* returned from this method is handled by the AssetManager. Don't need to free memory manually.
+	// @param - AssetId for the atlas' name
+	// @return - TextureAtlas* for the desired atlas
+	TextureAtlas* LoadTextureAtlas(AssetId atlasName) { return mTextureAtlasCache->Get(atlasName); }
+
+	// Creates and returns a texture atlas with every image packed into its pages, saving it in the texture atlas cache's map if it doesn't exist.
+	// Ownership of any TextureAtlas* returned from this method is handled by the AssetManager. Don't need to free memory manually.
+	// @param - const std::string& for the atlas' name
+	// @param - const std::vector<std::string>& for the image file names to pack
+	// @return - TextureAtlas* for the desired atlas
+	TextureAtlas* LoadTextureAtlas(const std::string& atlasName, const std::vector<std::string>& imageFileNames);
+
+	// Deletes/clears each element from the texture atlas cache's map
+	void ClearTextureAtlases() { mTextureAtlasCache->Clear(); }
+
+	// Deletes a texture atlas in the texture atlas cache map by name
+	// @param - AssetId for the atlas name
+	void DeleteTextureAtlas(AssetId atlasName) { mTextureAtlasCache->Delete(atlasName); }
+
+
+	// Saves a material into the material cache's map. The material holds a reference to the cached textures
+	// and shader it has when saved, so they aren't deleted before it is.
 	// @param - const std::string& for the material's name
 	// @param - Material* for the material that is being saved
-	void SaveMaterial(const std::string& materialName, Material* material) { mMaterialCache->StoreCache(materialName, material); }
+	void SaveMaterial(const std::string& materialName, Material* material);
+
+	// Takes references to a cached material's textures and shader again after they were changed in place,
+	// releasing the ones it held before
+	// @param - const std::string& for the material's name
+	void UpdateMaterial(const std::string& materialName);
 
 	// Loads a material from the material cache's map if it exists, nullptr if not.
 	// Ownership of any Material* returned from this method is handled by the AssetManager. Don't need to free memory manually.
 	// Call AssetManager::DeleteMaterial() if you need to delete/remove a material by name
-	// @param - const std::string& for the material's name
+	// @param - AssetId for the material's name
 	// @return - Material* for the desired material retrieved from the material cache map
-	Material* LoadMaterial(const std::string& materialName) { return mMaterialCache->Get(materialName); }
+	Material* LoadMaterial(AssetId materialName) { return mMaterialCache->Get(materialName); }
 
 	// Deletes/clears each element from the material cache's map
 	void ClearMaterials() { mMaterialCache->Clear(); }
 
 	// Deletes a material in the material cache map by name
-	// @param - const std::string& for the material name
-	void DeleteMaterial(const std::string& materialName) { mMaterialCache->Delete(materialName); }
+	// @param - AssetId for the material name
+	void DeleteMaterial(AssetId materialName) { mMaterialCache->Delete(materialName); }
 
 
-	// Saves a mesh into the mesh cache's map
+	// Saves a mesh into the mesh cache's map. The mesh holds a reference to its cached material.
 	// @param - const std::string& for the mesh's name
 	// @param - Mesh* for the mesh that is being saved
-	void SaveMesh(const std::string& meshName, Mesh* mesh) { mMeshCache->StoreCache(meshName, mesh); }
+	void SaveMesh(const std::string& meshName, Mesh* mesh);
 
 	// Loads a mesh from the mesh cache's map if it exists, nullptr if not.
 	// Ownership of any Mesh* returned from this method is handled by the AssetManager. Don't need to free memory manually.
 	// Call AssetManager::DeleteMesh() if you need to delete/remove a mesh by name
-	// @param - const std::string& for the mesh's name
+	// @param - AssetId for the mesh's name
 	// @return - Mesh* for the desired mesh retrieved from the mesh cache map
-	Mesh* LoadMesh(const std::string& meshName) { return mMeshCache->Get(meshName); }
+	Mesh* LoadMesh(AssetId meshName) { return mMeshCache->Get(meshName); }
 
 	// Deletes/clears each element from the mesh cache's map
 	void ClearMesh() { mMeshCache->Clear(); }
 
+	// Sets if models that have the exact same mesh (same vertices, indices, and material) share it instead of each making a vertex buffer
+	// @param - bool for if meshes are shared (defaults to true)
+	void SetDeduplicateMeshes(bool deduplicate) { mDeduplicateMeshes = deduplicate; }
+
+	// Gets if models that have the exact same mesh share it
+	// @return - bool for if meshes are shared
+	bool GetDeduplicateMeshes() const { return mDeduplicateMeshes; }
+
 	// Deletes a mesh in the mesh cache map by name
-	// @param - const std::string& for the mesh name
-	void DeleteMesh(const std::string& meshName) { mMeshCache->Delete(meshName); }
+	// @param - AssetId for the mesh name
+	void DeleteMesh(AssetId meshName) { mMeshCache->Delete(meshName); }
 
 
-	// Saves a model into the model cache's map
+	// Saves a model into the model cache's map. The model holds a reference to its cached meshes.
 	// @param - const std::string& for the model's name
 	// @param - Model* for the model to save
-	void SaveModel(const std::string& modelName, Model* model) { mModelCache->StoreCache(modelName, model); }
+	void SaveModel(const std::string& modelName, Model* model);
 
 	// Loads a model from the model cache's map if it exists, nullptr if not.
 	// Ownership of any Model* returned from this method is handled by the AssetManager. Don't need to free memory manually.
@@ -138,38 +274,49 @@ public:
 	// @return - Model* for the desired model retrieved from the model cache map
 	Model* LoadModel(const std::string& modelName);
 
+	// Loads a model from the model cache's map if it exists, nullptr if not. Doesn't load the model if it isn't cached.
+	// @param - AssetId for the model's name
+	// @return - Model* for the cached model
+	Model* LoadCachedModel(AssetId modelName) { return mModelCache->Get(modelName); }
+
+	// Starts loading a model on a worker thread. Its file is parsed and its textures decoded in the background,
+	// then it's uploaded and cached by ProcessAsyncLoads().
+	// @param - const std::string& for the model's name
+	// @param - std::function<void(Model*)> called on the render thread once the model is cached (defaults to nothing)
+	void LoadModelAsync(const std::string& modelName, std::function<void(Model*)> onLoaded = nullptr);
+
 	// Deletes/clears each element from the model cache map
 	void ClearModels() { mModelCache->Clear(); }
 
 	// Deletes a model in the model cache map by name
-	// @param - const std::string& for the model name
-	void DeleteModel(const std::string& modelName) { mModelCache->Delete(modelName); }
+	// @param - AssetId for the model name
+	void DeleteModel(AssetId modelName) { mModelCache->Delete(modelName); }
 
 
 	// Saves an animation into the animation cache's map
 	// @param - const std::string& for the animation's name
 	// @param - Animation* for the animation to save
-	void SaveAnimation(const std::string& animationName, Animation* animation) { mAnimationCache->StoreCache(animationName, animation); }
+	void SaveAnimation(const std::string& animationName, Animation* animation) { mAnimationCache->StoreCache(AssetId::Intern(animationName), animation); }
 
 	// Loads an animation from the animation cache's map if it exists, nullptr if not.
 	// Ownership of any Animation* returned from this method is handled by the AssetManager. Don't need to free memory manually.
 	// Call AssetManager::DeleteAnimation() if you need to delete/remove a animation by name
-	// @param - const std::string& for the animation's name
+	// @param - AssetId for the animation's name
 	// @return - Animation* for the desired animation retrieved from the animation cache map
-	Animation* LoadAnimation(const std::string& animName) { return mAnimationCache->Get(animName); }
+	Animation* LoadAnimation(AssetId animName) { return mAnimationCache->Get(animName); }
 
 	// Deletes/clears each element from the animation cache map
 	void ClearAnimations() { mAnimationCache->Clear(); }
 
 	// Deletes an animation in the animation cache map by name
-	// @param - const std::string& for the animation name
-	void DeleteAnimation(const std::string& animationName) { mAnimationCache->Delete(animationName); }
+	// @param - AssetId for the animation name
+	void DeleteAnimation(AssetId animationName) { mAnimationCache->Delete(animationName); }
 
 
 	// Saves a ShaderProgram into the shader program cache's map
 	// @param - const std::string& for the shader's file name
 	// @param - ShaderProgram* for the shader program to save
-	void SaveShaderProgram(const std::string& shaderFileName, ShaderProgram* program) { mShaderProgramCache->StoreCache(shaderFileName, program); }
+	void SaveShaderProgram(const std::string& shaderFileName, ShaderProgram* program);
 	
 	// Loads an ShaderProgram from the ShaderProgram cache's map if it exists, nullptr if not.
 	// Ownership of any ShaderProgram* returned from this method is handled by the AssetManager. Don't need to free memory manually.
@@ -182,14 +329,14 @@ public:
 	void ClearShaderPrograms() { mShaderProgramCache->Clear(); }
 
 	// Deletes a shader program by name
-	// @param - const std::string& for the shader file name
-	void DeleteShaderProgram(const std::string& shaderFileName) { mShaderProgramCache->Delete(shaderFileName); }
+	// @param - AssetId for the shader file name
+	void DeleteShaderProgram(AssetId shaderFileName) { mShaderProgramCache->Delete(shaderFileName); }
 
 
 	// Saves an SFX into the sfx program cache's map
 	// @param - const std::string& for the SFX's file name
 	// @param - SFX* for the sfx to save
-	void SaveSFX(const std::string& fileName, SFX* sfx) { mSfxCache->StoreCache(fileName, sfx); }
+	void SaveSFX(const std::string& fileName, SFX* sfx) { mSfxCache->StoreCache(AssetId::Intern(fileName), sfx); }
 
 	// Loads an SFX file from SFX cache's map if it exists, nullptr if not.
 	// Ownership of any SFX* returned from this method is handled by the AssetManager. Don't need to free memory manually.
@@ -202,14 +349,14 @@ public:
 	void ClearSFX() { mSfxCache->Clear(); }
 
 	// Deletes an sfx by name
-	// @param - const std::string& for the sfx file name
-	void DeleteSfx(const std::string& fileName) { mSfxCache->Delete(fileName); }
+	// @param - AssetId for the sfx file name
+	void DeleteSfx(AssetId fileName) { mSfxCache->Delete(fileName); }
 
 
 	// Saves a Music into the music program cache's map
 	// @param - const std::string& for the music file name
 	// @param - Music* for the Music to save
-	void SaveMusic(const std::string& fileName, Music* music) { mMusicCache->StoreCache(fileName, music); }
+	void SaveMusic(const std::string& fileName, Music* music) { mMusicCache->StoreCache(AssetId::Intern(fileName), music); }
 
 	// Loads a music file from music cache's map if it exists, nullptr if not.
 	// Ownership of any Music* returned from this method is handled by the AssetManager. Don't need to free memory manually.
@@ -222,16 +369,105 @@ public:
 	void ClearMusic() { mMusicCache->Clear(); }
 
 	// Deletes a music by name
-	// @param - const std::string& for the music file name
-	void DeleteMusic(const std::string& fileName) { mMusicCache->Delete(fileName); }
+	// @param - AssetId for the music file name
+	void DeleteMusic(AssetId fileName) { mMusicCache->Delete(fileName); }
+
+
+	// Uploads assets that finished loading on worker threads, caches them, and calls their callbacks.
+	// Call once per frame on the render thread.
+	// @param - size_t for the number of bytes that can be uploaded this frame (defaults to ASYNC_UPLOAD_BUDGET)
+	// @return - size_t for the number of bytes uploaded
+	size_t ProcessAsyncLoads(size_t byteBudget = ASYNC_UPLOAD_BUDGET);
+
+	// Blocks until every async load is uploaded and cached, uploading them as they finish
+	void WaitForAsyncLoads();
+
+	// Gets the number of async loads that aren't cached yet
+	// @return - size_t for the number of loads
+	size_t GetNumAsyncLoads() const;
+
+	// Gets the job manager that runs async loads, so loading on the render thread can share its worker threads
+	// @return - JobManager* for the loader's job manager
+	JobManager* GetLoadJobManager();
+
+	// Reloads the shader programs, textures, and models whose files changed since the last call. Assets are rebuilt
+	// in place, so pointers and handles to them stay valid. Call once per frame on the render thread.
+	// @return - size_t for the number of assets reloaded
+	size_t ReloadChangedFiles();
+
+	// Compiles a shader program's file again and relinks every cached shader that uses it, even if the
+	// program was cleared after its shaders were linked. If it doesn't compile or link, the shaders keep the last working program.
+	// @param - const std::string& for the shader file name
+	// @return - bool for if a shader was relinked
+	bool ReloadShaderProgram(const std::string& shaderFileName);
+
+	// Decodes a cached texture's file again and uploads it to the same Texture
+	// @param - const std::string& for the texture file name
+	// @return - bool for if the file was decoded
+	bool ReloadTexture(const std::string& textureFileName);
+
+	// Imports a cached model's file again and swaps the new meshes into the same Model. The old meshes are freed once
+	// nothing references them. Materials keep their objects and settings and only get the file's textures again.
+	// The skeleton and animations aren't reloaded.
+	// @param - const std::string& for the model's file name
+	// @return - bool for if the file was imported
+	bool ReloadModel(const std::string& modelName);
+
+	// Gets the file watcher that finds the changed files for ReloadChangedFiles()
+	// @return - FileWatcher* for the watcher
+	FileWatcher* GetFileWatcher() { return mWatcher; }
 
 private:
+	// Gets the cache for a type of asset
+	// @param - AssetType for the type of asset
+	// @return - CacheBase* for the cache
+	CacheBase* GetCache(AssetType type);
+
+	// Gets the cache for a type of asset at compile time
+	// @return - Cache<T>* for the cache
+	template <class T>
+	Cache<T>* GetTypedCache()
+	{
+		if constexpr (std::is_same_v<T, Shader>) { return mShaderCache; }
+		else if constexpr (std::is_same_v<T, Texture>) { return mTextureCache; }
+		else if constexpr (std::is_same_v<T, TextureAtlas>) { return mTextureAtlasCache; }
+		else if constexpr (std::is_same_v<T, Material>) { return mMaterialCache; }
+		else if constexpr (std::is_same_v<T, Mesh>) { return mMeshCache; }
+		else if constexpr (std::is_same_v<T, Model>) { return mModelCache; }
+		else if constexpr (std::is_same_v<T, Animation>) { return mAnimationCache; }
+		else if constexpr (std::is_same_v<T, ShaderProgram>) { return mShaderProgramCache; }
+		else if constexpr (std::is_same_v<T, SFX>) { return mSfxCache; }
+		else { static_assert(std::is_same_v<T, Music>, "AssetManager has no cache for this type"); return mMusicCache; }
+	}
+
+	// Takes references to a cached material's textures and shader, released when the material is deleted
+	// @param - AssetHandle<Material> for the material
+	// @param - Material* for the material
+	void AcquireMaterialAssets(AssetHandle<Material> handle, Material* material);
+
+	// Takes references to a cached model's meshes, released when the model is deleted
+	// @param - AssetHandle<Model> for the model
+	// @param - Model* for the model
+	void AcquireMeshes(AssetHandle<Model> handle, Model* model);
+
+	// Loads assets on worker threads
+	AssetLoader* mLoader;
+
+	// Streams texture mips by how they're drawn
+	TextureStreamer* mStreamer;
+
+	// Watches the files of cached shader programs, textures, and models
+	FileWatcher* mWatcher;
+
 	// Shader cache
 	Cache<Shader>* mShaderCache;
 
 	// Texture cache
 	Cache<Texture>* mTextureCache;
 
+	// Texture atlas cache
+	Cache<TextureAtlas>* mTextureAtlasCache;
+
 	// Material cache
 	Cache<Material>* mMaterialCache;
 
@@ -252,4 +488,7 @@ private:
 
 	// Music sound track cache
 	Cache<Music>* mMusicCache;
+
+	// If models that have the exact same mesh share it
+	bool mDeduplicateMeshes;
 };
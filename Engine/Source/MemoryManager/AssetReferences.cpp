@@ -0,0 +1,24 @@
+#include "AssetReferences.h"
+#include <string>
+#include "../Util/Logger.h"
+
+AssetReferences::AssetReferences()
+{
+}
+
+AssetReferences::~AssetReferences()
+{
+	if (!mReleases.empty())
+	{
+		LOG_WARNING("Asset references deleted while still holding " + std::to_string(mReleases.size()) + " assets");
+	}
+}
+
+void AssetReferences::ReleaseAll()
+{
+	for (const std::function<void()>& release : mReleases)
+	{
+		release();
+	}
+	mReleases.clear();
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "AssetManager.h"
+
+// AssetReferences holds references to the cached assets something keeps pointers to (like a game or a level),
+// so AssetManager::TrimCaches() can't delete them while they're in use. ReleaseAll() gives them back, and has to be
+// called before the AssetManager shuts down.
+class AssetReferences
+{
+public:
+	AssetReferences();
+	~AssetReferences();
+
+	// Takes a reference to a cached asset
+	// @param - AssetManager* for the asset manager that cached the asset
+	// @param - T* for the asset
+	// @return - T* for the same asset, so loads can be wrapped in Hold()
+	template <class T>
+	T* Hold(AssetManager* assetManager, T* asset)
+	{
+		AssetHandle<T> handle = assetManager->Acquire(asset);
+		if (handle.IsValid())
+		{
+			mReleases.emplace_back([assetManager, handle]() { assetManager->Release(handle); });
+		}
+		return asset;
+	}
+
+	// Gives back every reference that's held
+	void ReleaseAll();
+
+	// Gets the number of references that are held
+	// @return - size_t for the number of references
+	size_t GetNumHeld() const { return mReleases.size(); }
+
+private:
+	// Functions that give back each reference
+	std::vector<std::function<void()>> mReleases;
+};
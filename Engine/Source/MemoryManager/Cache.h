@@ -1,85 +1,484 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <list>
 #include <string>
 #include <unordered_map>
-#include <iostream>
+#include <vector>
+#include "../Util/Logger.h"
+#include "AssetId.h"
 
 class AssetManager;
 
+// Handle to an asset stored in a Cache. Each slot in a cache counts how many times it's been reused (its generation),
+// and a handle remembers the generation it was made with, so a handle to a deleted asset never finds whatever replaced it.
+template <class T>
+struct AssetHandle
+{
+	uint32_t index = 0;			// slot in the cache
+	uint32_t generation = 0;	// generation of the slot when the handle was made (0 for an empty handle)
+
+	// Gets if the handle was ever set (it can still be stale)
+	// @return - bool for if the handle was set
+	bool IsValid() const { return generation != 0; }
+};
+
+// CacheBase is the part of a Cache that doesn't depend on the asset type, so the AssetManager
+// can budget and report on every cache the same way.
+class CacheBase
+{
+public:
+	virtual ~CacheBase() = default;
+
+	// Sets the number of bytes the cache's unreferenced assets can use before Trim() deletes the least recently used
+	// @param - size_t for the number of bytes (0 for no limit)
+	virtual void SetBudget(size_t budget) = 0;
+
+	// Gets the number of bytes the cache's assets can use
+	// @return - size_t for the number of bytes (0 for no limit)
+	virtual size_t GetBudget() const = 0;
+
+	// Gets the number of bytes the cache's assets use
+	// @return - size_t for the number of bytes
+	virtual size_t GetSize() const = 0;
+
+	// Gets the number of assets in the cache (including deleted assets that are still referenced)
+	// @return - size_t for the number of assets
+	virtual size_t GetNumAssets() const = 0;
+
+	// Deletes the least recently used unreferenced assets until the cache fits its budget
+	virtual void Trim() = 0;
+};
+
 // Cache is a template class used by the AssetManager.
 // It helps store assets into its respective templated map
-// for on demand storing and loading
+// for on demand storing and loading.
+//
+// Assets live in slots and can be referred to by AssetId, pointer, or AssetHandle. Anything that keeps an asset
+// around takes a reference with Acquire() and gives it back with Release(). Deleting an asset that's still
+// referenced only forgets its name, and the asset is freed when the last reference is released, so assets
+// that point to it never dangle. Trim() deletes the least recently used unreferenced assets when the cache is over
+// its budget. It only runs when asked to, since loaders and raw pointer users can hold an asset for a while before
+// (or without ever) acquiring it. Raw pointers from Get() are only safe across a Trim() while a reference is held.
 template <class T>
-class Cache
+class Cache : public CacheBase
 {
 public:
 	// Cache constructor
 	// @param - AssetManager* for the manager
-	Cache(AssetManager* manager) : mManager(manager)
+	// @param - std::function<size_t(const T*)> for measuring an asset's size in bytes (assets count as 0 bytes if empty)
+	Cache(AssetManager* manager, std::function<size_t(const T*)> getSize = nullptr) :
+		mManager(manager),
+		mSlots(),
+		mFreeSlots(),
+		mNames(),
+		mAssets(),
+		mLru(),
+		mGetSize(getSize),
+		mBudget(0)
 	{
 	}
 
 	~Cache()
 	{
 		std::cout << "Delete cache" << std::endl;
-		Clear();
+
+		// Everything goes, referenced or not
+		for (uint32_t i = 0; i < mSlots.size(); ++i)
+		{
+			if (mSlots[i].asset)
+			{
+				Free(i);
+			}
+		}
 	}
 
 	// StoreCache takes in a key and value pair and stores them
 	// into the templated asset's asset map if it doesn't exist.
-	// @param - const std::string& for the asset's name
+	// An asset that's already stored gets the id as another name instead.
+	// @param - AssetId for the asset's id
 	// @param - T* for the templated asset that's going to be stored
-	void StoreCache(const std::string& key, T* asset)
+	// @return - AssetHandle<T> for the stored asset (empty if it wasn't newly stored: if the id was
+	// already taken the caller still owns the asset, if the asset was already stored it just has another id now)
+	AssetHandle<T> StoreCache(AssetId key, T* asset)
 	{
-		if (mAssetMap.find(key) == mAssetMap.end())
+		if (mNames.find(key) != mNames.end() || !asset)
 		{
-			mAssetMap[key] = asset;
+			return AssetHandle<T>();
 		}
+
+		auto stored = mAssets.find(asset);
+		if (stored != mAssets.end())
+		{
+			mSlots[stored->second].ids.emplace_back(key);
+			mNames[key] = stored->second;
+			return AssetHandle<T>();
+		}
+
+		uint32_t index = 0;
+		if (!mFreeSlots.empty())
+		{
+			index = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(mSlots.size());
+			mSlots.emplace_back();
+			mSlots[index].generation = 1;
+		}
+
+		Slot& slot = mSlots[index];
+		slot.asset = asset;
+		slot.ids = { key };
+		slot.refCount = 0;
+		mLru.emplace_back(index);
+		slot.lruIter = std::prev(mLru.end());
+
+		mNames[key] = index;
+		mAssets[asset] = index;
+
+		return { index, slot.generation };
 	}
 
-	// Retrieves an asset of type T* from the asset map by name, returns nullptr if it doesn't exist
-	// @param - const std::string& for the asset's name
+	// Retrieves an asset of type T* from the asset map by id, returns nullptr if it doesn't exist
+	// @param - AssetId for the asset's id
 	// @return - T* for the templated data
-	T* Get(const std::string& name)
+	T* Get(AssetId id)
 	{
-		auto iter = mAssetMap.find(name);
+		auto iter = mNames.find(id);
 
-		if (iter != mAssetMap.end())
+		if (iter != mNames.end())
 		{
-			return iter->second;
+			Touch(iter->second);
+			return mSlots[iter->second].asset;
 		}
 		return nullptr;
 	}
 
-	// Loops through and calls delete on each element in the asset map, then clears the map
+	// Retrieves an asset by handle
+	// @param - AssetHandle<T> for the handle
+	// @return - T* for the asset (nullptr if the handle is stale)
+	T* Get(AssetHandle<T> handle)
+	{
+		if (!IsLive(handle))
+		{
+			return nullptr;
+		}
+
+		Touch(handle.index);
+		return mSlots[handle.index].asset;
+	}
+
+	// Gets a handle to an asset by id without taking a reference
+	// @param - AssetId for the asset's id
+	// @return - AssetHandle<T> for the asset (empty if it doesn't exist)
+	AssetHandle<T> GetHandle(AssetId id) const
+	{
+		auto iter = mNames.find(id);
+		if (iter == mNames.end())
+		{
+			return AssetHandle<T>();
+		}
+		return { iter->second, mSlots[iter->second].generation };
+	}
+
+	// Takes a reference to an asset so it isn't freed until it's released
+	// @param - AssetHandle<T> for the asset
+	// @return - AssetHandle<T> for the asset (empty if the handle is stale)
+	AssetHandle<T> Acquire(AssetHandle<T> handle)
+	{
+		if (!IsLive(handle))
+		{
+			return AssetHandle<T>();
+		}
+
+		++mSlots[handle.index].refCount;
+		Touch(handle.index);
+		return handle;
+	}
+
+	// Takes a reference to an asset by id
+	// @param - AssetId for the asset's id
+	// @return - AssetHandle<T> for the asset (empty if it doesn't exist)
+	AssetHandle<T> Acquire(AssetId id)
+	{
+		return Acquire(GetHandle(id));
+	}
+
+	// Takes a reference to an asset by pointer
+	// @param - const T* for the asset
+	// @return - AssetHandle<T> for the asset (empty if it isn't in this cache)
+	AssetHandle<T> Acquire(const T* asset)
+	{
+		auto iter = mAssets.find(asset);
+		if (iter == mAssets.end())
+		{
+			return AssetHandle<T>();
+		}
+		return Acquire(AssetHandle<T>{ iter->second, mSlots[iter->second].generation });
+	}
+
+	// Gives back a reference. An asset that was deleted while referenced is freed with its last reference.
+	// @param - AssetHandle<T> for the asset
+	void Release(AssetHandle<T> handle)
+	{
+		if (!IsLive(handle) || mSlots[handle.index].refCount == 0)
+		{
+			return;
+		}
+
+		Slot& slot = mSlots[handle.index];
+		if (--slot.refCount == 0 && slot.ids.empty())
+		{
+			Free(handle.index);
+		}
+	}
+
+	// Gets the number of references to an asset
+	// @param - AssetId for the asset's id
+	// @return - uint32_t for the number of references
+	uint32_t GetRefCount(AssetId id) const
+	{
+		auto iter = mNames.find(id);
+		return iter != mNames.end() ? mSlots[iter->second].refCount : 0;
+	}
+
+	// Adds something to do when an asset is freed, like releasing the assets it references
+	// @param - AssetHandle<T> for the asset
+	// @param - std::function<void()> for the function to call after the asset is deleted
+	void AddDependency(AssetHandle<T> handle, std::function<void()> release)
+	{
+		if (IsLive(handle))
+		{
+			mSlots[handle.index].dependencies.emplace_back(std::move(release));
+		}
+	}
+
+	// Releases everything an asset depended on now, instead of when it's freed (used when an asset is rebuilt in place)
+	// @param - AssetHandle<T> for the asset
+	void ReleaseDependencies(AssetHandle<T> handle)
+	{
+		if (IsLive(handle))
+		{
+			std::vector<std::function<void()>> dependencies = std::move(mSlots[handle.index].dependencies);
+			mSlots[handle.index].dependencies.clear();
+
+			for (auto& release : dependencies)
+			{
+				release();
+			}
+		}
+	}
+
+	// Calls a function on every asset that can be found by id
+	// @param - const std::function<void(T*)>& for the function
+	void ForEach(const std::function<void(T*)>& function)
+	{
+		for (Slot& slot : mSlots)
+		{
+			if (slot.asset && !slot.ids.empty())
+			{
+				function(slot.asset);
+			}
+		}
+	}
+
+	// Deletes every asset that isn't referenced. Referenced assets are forgotten by id and freed when they're released.
 	void Clear()
 	{
-		for (auto& a : mAssetMap)
+		for (uint32_t i = 0; i < mSlots.size(); ++i)
+		{
+			if (mSlots[i].asset && !mSlots[i].ids.empty())
+			{
+				Forget(i);
+			}
+		}
+	}
+
+	// Removes an asset by id, and free the memory. If it's still referenced, it's only forgotten by all of its ids
+	// and freed when the last reference is released.
+	// @param - AssetId for the asset's id
+	void Delete(AssetId id)
+	{
+		auto iter = mNames.find(id);
+		if (iter != mNames.end())
+		{
+			Forget(iter->second);
+		}
+	}
+
+	// Removes an asset by pointer, the same way as Delete() by id
+	// @param - const T* for the asset
+	void Delete(const T* asset)
+	{
+		auto iter = mAssets.find(asset);
+		if (iter != mAssets.end() && !mSlots[iter->second].ids.empty())
+		{
+			Forget(iter->second);
+		}
+	}
+
+	// Deletes the least recently used unreferenced assets until the cache fits its budget.
+	// Only call this when nothing is holding an unreferenced asset, like between frames or levels.
+	void Trim() override
+	{
+		if (mBudget == 0)
+		{
+			return;
+		}
+
+		size_t size = GetSize();
+		auto iter = mLru.begin();
+		while (size > mBudget && iter != mLru.end())
 		{
-			delete a.second;
+			uint32_t index = *iter;
+			++iter;
+
+			Slot& slot = mSlots[index];
+			if (slot.refCount == 0)
+			{
+				size -= GetAssetSize(slot.asset);
+				Free(index);
+			}
 		}
-		mAssetMap.clear();
 	}
 
-	// Removes an asset by name, and free the memory
-	// @param - const std::string& for the asset name
-	void Delete(const std::string& name)
+	void SetBudget(size_t budget) override
+	{
+		mBudget = budget;
+	}
+
+	size_t GetBudget() const override { return mBudget; }
+
+	size_t GetSize() const override
 	{
-		auto iter = mAssetMap.find(name);
-		if (iter != mAssetMap.end())
+		size_t size = 0;
+		for (const Slot& slot : mSlots)
 		{
-			delete iter->second;
-			mAssetMap.erase(iter);
+			if (slot.asset)
+			{
+				size += GetAssetSize(slot.asset);
+			}
 		}
+		return size;
 	}
 
-	// Gets the asset map as a reference (data can change)
-	// @returns - std::unordered_map<std::string, T*>& for the reference of the asset map
-	std::unordered_map<std::string, T*>& GetAssetMap() { return mAssetMap; }
+	size_t GetNumAssets() const override { return mAssets.size(); }
 
 private:
+	// Struct for an asset's place in the cache
+	struct Slot
+	{
+		T* asset = nullptr;									// asset (nullptr if the slot is free)
+		std::vector<AssetId> ids;							// ids the asset can be found by (empty once it's deleted)
+		uint32_t generation = 0;							// number of times the slot was used, for spotting stale handles
+		uint32_t refCount = 0;								// number of references taken with Acquire()
+		std::list<uint32_t>::iterator lruIter;				// position in the least recently used list
+		std::vector<std::function<void()>> dependencies;	// functions to call after the asset is freed
+	};
+
+	// Gets if a handle points to a live asset
+	// @param - AssetHandle<T> for the handle
+	// @return - bool for if the handle's slot still holds the asset it was made for
+	bool IsLive(AssetHandle<T> handle) const
+	{
+		return handle.index < mSlots.size() && mSlots[handle.index].generation == handle.generation && mSlots[handle.index].asset;
+	}
+
+	// Marks an asset as the most recently used
+	// @param - uint32_t for the slot
+	void Touch(uint32_t index)
+	{
+		mLru.splice(mLru.end(), mLru, mSlots[index].lruIter);
+	}
+
+	// Measures an asset
+	// @param - const T* for the asset
+	// @return - size_t for the number of bytes
+	size_t GetAssetSize(const T* asset) const
+	{
+		return mGetSize ? mGetSize(asset) : 0;
+	}
+
+	// Forgets an asset's id, freeing it unless it's referenced
+	// @param - uint32_t for the slot
+	void Forget(uint32_t index)
+	{
+		Slot& slot = mSlots[index];
+		AssetId id = !slot.ids.empty() ? slot.ids.front() : AssetId();
+		for (AssetId alias : slot.ids)
+		{
+			mNames.erase(alias);
+		}
+		slot.ids.clear();
+
+		if (slot.refCount == 0)
+		{
+			Free(index);
+		}
+		else
+		{
+			LOG_DEBUG("Deleted asset is still referenced, freeing it once it's released: " + id.GetName());
+		}
+	}
+
+	// Deletes a slot's asset, then releases what it depended on and bumps the slot's generation so old handles go stale
+	// @param - uint32_t for the slot
+	void Free(uint32_t index)
+	{
+		Slot& slot = mSlots[index];
+		T* asset = slot.asset;
+		std::vector<std::function<void()>> dependencies = std::move(slot.dependencies);
+
+		for (AssetId alias : slot.ids)
+		{
+			mNames.erase(alias);
+		}
+		mAssets.erase(asset);
+		mLru.erase(slot.lruIter);
+
+		slot.asset = nullptr;
+		slot.ids.clear();
+		slot.refCount = 0;
+		slot.dependencies.clear();
+		if (++slot.generation == 0)
+		{
+			slot.generation = 1;
+		}
+		mFreeSlots.emplace_back(index);
+
+		delete asset;
+
+		for (auto& release : dependencies)
+		{
+			release();
+		}
+	}
+
 	// Pointer to a static AssetManager
 	AssetManager* mManager;
 
-	// Unordered map for the cached assets
-	std::unordered_map<std::string, T*> mAssetMap;
+	// Slots the assets live in
+	std::vector<Slot> mSlots;
+
+	// Slots that can be reused
+	std::vector<uint32_t> mFreeSlots;
+
+	// Slots by asset id
+	std::unordered_map<AssetId, uint32_t> mNames;
+
+	// Slots by asset pointer
+	std::unordered_map<const T*, uint32_t> mAssets;
+
+	// Slots from least to most recently used
+	std::list<uint32_t> mLru;
+
+	// Measures an asset's size in bytes
+	std::function<size_t(const T*)> mGetSize;
+
+	// Number of bytes the assets can use (0 for no limit)
+	size_t mBudget;
 };
@@ -0,0 +1,310 @@
+#include "DerivedDataCache.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "../Util/Logger.h"
+
+// Multipliers used by the hash
+static const uint64_t HASH_PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+
+// Extension of the files entries are stored in
+static const std::string DERIVED_DATA_EXTENSION = ".ddc";
+
+// Rotates bits left
+// @param - uint64_t for the value
+// @param - int for the number of bits
+// @return - uint64_t for the rotated value
+static uint64_t RotateLeft(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+// Scrambles the bits of a hash so every input bit affects every output bit
+// @param - uint64_t for the hash
+// @return - uint64_t for the scrambled hash
+static uint64_t FinalizeHash(uint64_t hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+DerivedDataCache* DerivedDataCache::Get()
+{
+	static DerivedDataCache s_DerivedDataCache;
+
+	return &s_DerivedDataCache;
+}
+
+DerivedDataCache::DerivedDataCache() :
+	mEntries(),
+	mLru(),
+	mMutex(),
+	mSize(0),
+	mSizeLimit(DERIVED_DATA_CACHE_SIZE_LIMIT),
+	mNumWrites(0),
+	mIsEnabled(true)
+{
+	Scan();
+}
+
+DerivedDataCache::~DerivedDataCache()
+{
+	std::cout << "Deleted DerivedDataCache\n";
+}
+
+uint64_t DerivedDataCache::HashBytes(const void* data, size_t size, uint64_t seed)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t hash = seed ^ (static_cast<uint64_t>(size) * HASH_PRIME_1);
+
+	// Mix in 8 bytes at a time
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, bytes + i, 8);
+		hash ^= RotateLeft(word * HASH_PRIME_2, 31) * HASH_PRIME_1;
+		hash = RotateLeft(hash, 27) * HASH_PRIME_1 + HASH_PRIME_2;
+	}
+
+	// Then whatever is left
+	uint64_t tail = 0;
+	std::memcpy(&tail, bytes + i, size - i);
+	hash ^= RotateLeft(tail * HASH_PRIME_2, 31) * HASH_PRIME_1;
+
+	return FinalizeHash(hash);
+}
+
+bool DerivedDataCache::HashFile(const std::string& fileName, uint64_t& hash)
+{
+	MappedFile file;
+	if (!file.Open(fileName))
+	{
+		return false;
+	}
+
+	hash = HashBytes(file.GetData(), file.GetSize());
+	return true;
+}
+
+uint64_t DerivedDataCache::CombineHash(uint64_t hash, uint64_t value)
+{
+	return FinalizeHash(hash ^ (RotateLeft(value * HASH_PRIME_2, 31) * HASH_PRIME_1));
+}
+
+std::string DerivedDataCache::MakeKey(const std::string& kind, uint64_t hash)
+{
+	static const char HEX_DIGITS[] = "0123456789abcdef";
+
+	std::string key = kind + "_";
+	for (int shift = 60; shift >= 0; shift -= 4)
+	{
+		key += HEX_DIGITS[(hash >> shift) & 0xF];
+	}
+	return key;
+}
+
+bool DerivedDataCache::Load(const std::string& key, MappedFile& file)
+{
+	if (!mIsEnabled)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto iter = mEntries.find(key);
+	if (iter == mEntries.end())
+	{
+		return false;
+	}
+
+	std::string fileName = GetFileName(key);
+	if (!file.Open(fileName))
+	{
+		// Deleted from outside the engine
+		mSize -= iter->second.size;
+		mLru.erase(iter->second.lruIter);
+		mEntries.erase(iter);
+		return false;
+	}
+
+	// Mark as most recently used, and touch the file so the order carries over to the next launch
+	mLru.splice(mLru.end(), mLru, iter->second.lruIter);
+	std::error_code error;
+	std::filesystem::last_write_time(fileName, std::filesystem::file_time_type::clock::now(), error);
+
+	return true;
+}
+
+bool DerivedDataCache::Save(const std::string& key, const void* data, size_t size)
+{
+	if (!mIsEnabled)
+	{
+		return false;
+	}
+
+	std::string fileName = GetFileName(key);
+	std::string tempFileName;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		tempFileName = fileName + "." + std::to_string(mNumWrites++) + ".tmp";
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(DERIVED_DATA_CACHE_DIRECTORY, error);
+
+	// Write under a temporary name first so a crash or another writer never leaves a half written entry
+	{
+		std::ofstream outFile(tempFileName, std::ios::binary | std::ios::trunc);
+		outFile.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		if (!outFile)
+		{
+			LOG_WARNING("Couldn't write derived data: " + tempFileName);
+			outFile.close();
+			std::filesystem::remove(tempFileName, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempFileName, fileName, error);
+	if (error)
+	{
+		LOG_WARNING("Couldn't write derived data: " + fileName + " " + error.message());
+		std::filesystem::remove(tempFileName, error);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto iter = mEntries.find(key);
+	if (iter != mEntries.end())
+	{
+		mSize -= iter->second.size;
+		mLru.erase(iter->second.lruIter);
+		mEntries.erase(iter);
+	}
+
+	mLru.emplace_back(key);
+	mEntries[key] = { size, std::prev(mLru.end()) };
+	mSize += size;
+
+	Evict();
+
+	return true;
+}
+
+void DerivedDataCache::Remove(const std::string& key)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto iter = mEntries.find(key);
+	if (iter != mEntries.end())
+	{
+		mSize -= iter->second.size;
+		mLru.erase(iter->second.lruIter);
+		mEntries.erase(iter);
+	}
+
+	std::error_code error;
+	std::filesystem::remove(GetFileName(key), error);
+}
+
+void DerivedDataCache::SetSizeLimit(size_t sizeLimit)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	mSizeLimit = sizeLimit;
+	Evict();
+}
+
+size_t DerivedDataCache::GetSize()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	return mSize;
+}
+
+std::string DerivedDataCache::GetFileName(const std::string& key) const
+{
+	return DERIVED_DATA_CACHE_DIRECTORY + "/" + key + DERIVED_DATA_EXTENSION;
+}
+
+void DerivedDataCache::Scan()
+{
+	// Struct for a file found in the directory
+	struct ScannedFile
+	{
+		std::string key;
+		size_t size;
+		std::filesystem::file_time_type time;
+	};
+
+	std::vector<ScannedFile> files;
+
+	std::error_code error;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(DERIVED_DATA_CACHE_DIRECTORY, error))
+	{
+		const std::filesystem::path& path = entry.path();
+		if (!entry.is_regular_file(error))
+		{
+			continue;
+		}
+
+		// Clean up temporary files a crash left behind
+		if (path.extension() == ".tmp")
+		{
+			std::filesystem::remove(path, error);
+			continue;
+		}
+
+		if (path.extension() == DERIVED_DATA_EXTENSION)
+		{
+			files.push_back({ path.stem().string(), static_cast<size_t>(entry.file_size(error)), entry.last_write_time(error) });
+		}
+	}
+
+	// The least recently used entries were touched the longest ago
+	std::sort(files.begin(), files.end(), [](const ScannedFile& a, const ScannedFile& b) {
+		return a.time < b.time;
+		});
+
+	for (const ScannedFile& file : files)
+	{
+		mLru.emplace_back(file.key);
+		mEntries[file.key] = { file.size, std::prev(mLru.end()) };
+		mSize += file.size;
+	}
+
+	Evict();
+
+	if (!files.empty())
+	{
+		LOG_DEBUG("Derived data cache has " + std::to_string(mEntries.size()) + " entries (" + std::to_string(mSize / (1024 * 1024)) + " MB)");
+	}
+}
+
+void DerivedDataCache::Evict()
+{
+	while (mSize > mSizeLimit && !mLru.empty())
+	{
+		const std::string& key = mLru.front();
+
+		// A mapped file can't be deleted on some platforms, it's still forgotten and gets overwritten later
+		std::error_code error;
+		std::filesystem::remove(GetFileName(key), error);
+
+		auto iter = mEntries.find(key);
+		mSize -= iter->second.size;
+		mEntries.erase(iter);
+		mLru.pop_front();
+	}
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "../Util/MappedFile.h"
+
+// Directory derived data is cached in, relative to the working directory
+const std::string DERIVED_DATA_CACHE_DIRECTORY = "DerivedDataCache";
+
+// Default number of bytes the cache can hold before the least recently used entries are deleted
+const size_t DERIVED_DATA_CACHE_SIZE_LIMIT = static_cast<size_t>(1024) * 1024 * 1024;
+
+// DerivedDataCache stores data derived from asset files (cooked models, decoded textures) on disk so it
+// doesn't have to be derived again next launch. Entries are keyed by a hash of the source file's contents
+// combined with the settings used to derive it, so changing the file or the settings just misses the cache,
+// and the stale entry ages out. When the entries go over the size limit the least recently used ones are deleted.
+// Every function is thread safe so loaders can use the cache from worker threads.
+class DerivedDataCache
+{
+public:
+	// Gets the cache, scanning its directory the first time
+	// @return - DerivedDataCache* for the cache
+	static DerivedDataCache* Get();
+
+	// Hashes bytes (not cryptographic, only for spotting changed files)
+	// @param - const void* for the bytes
+	// @param - size_t for the number of bytes
+	// @param - uint64_t for the seed
+	// @return - uint64_t for the hash
+	static uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0);
+
+	// Hashes a file's contents, reading it through a memory mapping
+	// @param - const std::string& for the file name
+	// @param - uint64_t& for the hash
+	// @return - bool for if the file could be read
+	static bool HashFile(const std::string& fileName, uint64_t& hash);
+
+	// Mixes another value into a hash, used to add the settings data was derived with
+	// @param - uint64_t for the hash
+	// @param - uint64_t for the value
+	// @return - uint64_t for the combined hash
+	static uint64_t CombineHash(uint64_t hash, uint64_t value);
+
+	// Makes a cache key
+	// @param - const std::string& for the kind of data (used as the file name prefix)
+	// @param - uint64_t for the hash of the source and settings
+	// @return - std::string for the key
+	static std::string MakeKey(const std::string& kind, uint64_t hash);
+
+	// Maps a cached entry and marks it as the most recently used
+	// @param - const std::string& for the key
+	// @param - MappedFile& for the mapping
+	// @return - bool for if the entry is cached
+	bool Load(const std::string& key, MappedFile& file);
+
+	// Writes an entry, then deletes the least recently used entries until the cache fits its size limit
+	// @param - const std::string& for the key
+	// @param - const void* for the data
+	// @param - size_t for the number of bytes
+	// @return - bool for if the entry was written
+	bool Save(const std::string& key, const void* data, size_t size);
+
+	// Removes an entry, like one that turned out to be corrupt
+	// @param - const std::string& for the key
+	void Remove(const std::string& key);
+
+	// Sets how many bytes the cache can hold, deleting entries if it's already over
+	// @param - size_t for the number of bytes
+	void SetSizeLimit(size_t sizeLimit);
+
+	// Gets the number of bytes the cached entries use
+	// @return - size_t for the number of bytes
+	size_t GetSize();
+
+	// Turns the cache on or off. While it's off every load misses and nothing is saved, so
+	// everything is derived from its source, like on a first launch.
+	// @param - bool for if the cache is used
+	void SetEnabled(bool isEnabled) { mIsEnabled = isEnabled; }
+
+	// Gets if the cache is used
+	// @return - bool for if the cache is used
+	bool IsEnabled() const { return mIsEnabled; }
+
+private:
+	DerivedDataCache();
+	~DerivedDataCache();
+
+	// Struct for a cached entry
+	struct Entry
+	{
+		size_t size;								// size of the entry's file in bytes
+		std::list<std::string>::iterator lruIter;	// position in the least recently used list
+	};
+
+	// Gets the file an entry is stored in
+	// @param - const std::string& for the key
+	// @return - std::string for the file name
+	std::string GetFileName(const std::string& key) const;
+
+	// Adds the files already in the directory, oldest first
+	void Scan();
+
+	// Deletes least recently used entries until the cache fits its size limit (mutex must be locked)
+	void Evict();
+
+	// Entries by key
+	std::unordered_map<std::string, Entry> mEntries;
+
+	// Keys from least to most recently used
+	std::list<std::string> mLru;
+
+	// Mutex to protect the entries
+	std::mutex mMutex;
+
+	// Number of bytes the entries use
+	size_t mSize;
+
+	// Number of bytes the entries can use
+	size_t mSizeLimit;
+
+	// Number of entries written, used to give each write its own temporary file
+	uint64_t mNumWrites;
+
+	// Bool for if the cache is used (read by loader threads)
+	std::atomic<bool> mIsEnabled;
+};
@@ -1,10 +1,10 @@
 #include "JobManager.h"
 #include <iostream>
 
-JobManager::JobManager() :
+JobManager::JobManager(unsigned int numThreads) :
     mIsRunning(false),
     mNumJobs(0),
-    mNumThreads(std::thread::hardware_concurrency() / 2) // default to half the number of threads available on cpu
+    mNumThreads(numThreads > 0 ? numThreads : std::thread::hardware_concurrency() / 2) // default to half the number of threads available on cpu
 {
     // Ensure at least 1 worker thread on lower end systems
     if (mNumThreads == 0)
@@ -25,7 +25,9 @@ public:
 	private:
 	};
 
-    JobManager();
+    // JobManager constructor
+    // @param - unsigned int for the number of worker threads (0 for half the threads available on the cpu)
+    JobManager(unsigned int numThreads = 0);
 
     ~JobManager();
 
@@ -41,6 +43,10 @@ public:
     // Block and wait until all jobs are completed
     void WaitForJobs();
 
+    // Gets the number of worker threads
+    // @return - unsigned int for the number of threads
+    unsigned int GetNumThreads() const { return mNumThreads; }
+
 private:
     // Thread loop function that waits for a job in the queue. 
     // If there is one, it will execute that job and wait for the next one
@@ -0,0 +1,47 @@
+#include "ParticleBenchmark.h"
+#include <chrono>
+#include <vector>
+#include "ParticlePool.h"
+
+namespace ParticleBenchmark
+{
+	ParticleBenchmarkResult Run(size_t numParticles, int numFrames, float deltaTime)
+	{
+		ParticleEmitterSettings settings = GetDefaultEmitterSettings();
+		settings.gravity = glm::vec3(0.0f, -9.8f, 0.0f);
+		settings.drag = 0.1f;
+		// Keep every particle alive for the whole benchmark so the pool stays full
+		settings.minLifetime = deltaTime * static_cast<float>(numFrames) * 2.0f + 1.0f;
+		settings.maxLifetime = settings.minLifetime;
+
+		ParticlePool pool(numParticles);
+		pool.Emit(settings, numParticles);
+
+		std::vector<ParticleInstance> instances(numParticles);
+
+		std::chrono::nanoseconds simulateTime(0);
+		std::chrono::nanoseconds writeTime(0);
+
+		for (int frame = 0; frame < numFrames; ++frame)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			pool.Simulate(deltaTime, settings);
+			auto simulated = std::chrono::high_resolution_clock::now();
+			pool.WriteInstances(instances.data(), settings);
+			auto written = std::chrono::high_resolution_clock::now();
+
+			simulateTime += std::chrono::duration_cast<std::chrono::nanoseconds>(simulated - start);
+			writeTime += std::chrono::duration_cast<std::chrono::nanoseconds>(written - simulated);
+		}
+
+		ParticleBenchmarkResult result = {};
+		result.numParticles = pool.GetNumAlive();
+		result.numFrames = numFrames;
+		if (numFrames > 0)
+		{
+			result.simulateMs = static_cast<double>(simulateTime.count()) * 0.000001 / numFrames;
+			result.writeMs = static_cast<double>(writeTime.count()) * 0.000001 / numFrames;
+		}
+		return result;
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+
+// Struct for the results of a particle benchmark
+struct ParticleBenchmarkResult
+{
+	size_t numParticles;	// number of particles alive during the benchmark
+	int numFrames;			// number of frames simulated
+	double simulateMs;		// average milliseconds per frame spent in ParticlePool::Simulate()
+	double writeMs;			// average milliseconds per frame spent writing instance data
+};
+
+namespace ParticleBenchmark
+{
+	// Fills a ParticlePool with particles that outlive the benchmark, then times simulating
+	// and writing out their instance data for a number of frames. No OpenGL context is needed.
+	// @param - size_t for the number of particles
+	// @param - int for the number of frames to simulate
+	// @param - float for the delta time of each frame
+	// @return - ParticleBenchmarkResult for the average timings
+	ParticleBenchmarkResult Run(size_t numParticles, int numFrames, float deltaTime = 1.0f / 60.0f);
+}
@@ -0,0 +1,206 @@
+#include "ParticlePool.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PARTICLES_USE_SSE 1
+#endif
+
+ParticleEmitterSettings GetDefaultEmitterSettings()
+{
+	ParticleEmitterSettings settings = {};
+	settings.startColor = glm::vec4(1.0f, 0.6f, 0.2f, 1.0f);
+	settings.endColor = glm::vec4(1.0f, 0.1f, 0.0f, 0.0f);
+	settings.position = glm::vec3(0.0f);
+	settings.direction = glm::vec3(0.0f, 1.0f, 0.0f);
+	settings.gravity = glm::vec3(0.0f);
+	settings.spread = 0.3f;
+	settings.minSpeed = 1.0f;
+	settings.maxSpeed = 2.0f;
+	settings.minLifetime = 1.0f;
+	settings.maxLifetime = 2.0f;
+	settings.startSize = 0.2f;
+	settings.endSize = 0.0f;
+	settings.drag = 0.0f;
+	settings.emitRate = 0.0f;
+	settings.isPlanar = false;
+	return settings;
+}
+
+ParticlePool::ParticlePool(size_t capacity, uint32_t seed) :
+	mPositionX(),
+	mPositionY(),
+	mPositionZ(),
+	mVelocityX(),
+	mVelocityY(),
+	mVelocityZ(),
+	mAge(),
+	mInvLifetime(),
+	mRandom({ seed != 0 ? seed : 1u }),
+	mCapacity(capacity),
+	mNumAlive(0)
+{
+	// Pad to a multiple of 4 so every SSE group has valid memory behind it
+	size_t paddedCapacity = (capacity + 3) & ~static_cast<size_t>(3);
+
+	mPositionX.resize(paddedCapacity, 0.0f);
+	mPositionY.resize(paddedCapacity, 0.0f);
+	mPositionZ.resize(paddedCapacity, 0.0f);
+	mVelocityX.resize(paddedCapacity, 0.0f);
+	mVelocityY.resize(paddedCapacity, 0.0f);
+	mVelocityZ.resize(paddedCapacity, 0.0f);
+	mAge.resize(paddedCapacity, 1.0f);
+	mInvLifetime.resize(paddedCapacity, 0.0f);
+}
+
+ParticlePool::~ParticlePool()
+{
+}
+
+size_t ParticlePool::Emit(const ParticleEmitterSettings& settings, size_t count)
+{
+	count = std::min(count, mCapacity - mNumAlive);
+
+	for (size_t i = mNumAlive; i < mNumAlive + count; ++i)
+	{
+		glm::vec3 velocity = SampleVelocity(settings, mRandom);
+		float lifetime = mRandom.GetFloatRange(settings.minLifetime, settings.maxLifetime);
+
+		mPositionX[i] = settings.position.x;
+		mPositionY[i] = settings.position.y;
+		mPositionZ[i] = settings.position.z;
+		mVelocityX[i] = velocity.x;
+		mVelocityY[i] = velocity.y;
+		mVelocityZ[i] = velocity.z;
+		mAge[i] = 0.0f;
+		mInvLifetime[i] = lifetime > 0.0f ? 1.0f / lifetime : 1.0f;
+	}
+
+	mNumAlive += count;
+
+	return count;
+}
+
+void ParticlePool::Simulate(float deltaTime, const ParticleEmitterSettings& settings)
+{
+	Integrate(deltaTime, settings, 0, mNumAlive);
+
+	RemoveDead();
+}
+
+void ParticlePool::Integrate(float deltaTime, const ParticleEmitterSettings& settings, size_t begin, size_t end)
+{
+	end = std::min(end, mNumAlive);
+	if (begin >= end)
+	{
+		return;
+	}
+
+	float damping = std::max(0.0f, 1.0f - settings.drag * deltaTime);
+	glm::vec3 deltaVelocity = settings.gravity * deltaTime;
+
+	size_t i = begin;
+
+#ifdef PARTICLES_USE_SSE
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	const __m128 damp = _mm_set1_ps(damping);
+	const __m128 dvx = _mm_set1_ps(deltaVelocity.x);
+	const __m128 dvy = _mm_set1_ps(deltaVelocity.y);
+	const __m128 dvz = _mm_set1_ps(deltaVelocity.z);
+
+	// Integrate 4 particles at a time, the scalar loop below picks up the remainder
+	for (; i + 4 <= end; i += 4)
+	{
+		__m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&mVelocityX[i]), dvx), damp);
+		__m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&mVelocityY[i]), dvy), damp);
+		__m128 vz = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&mVelocityZ[i]), dvz), damp);
+		_mm_storeu_ps(&mVelocityX[i], vx);
+		_mm_storeu_ps(&mVelocityY[i], vy);
+		_mm_storeu_ps(&mVelocityZ[i], vz);
+
+		_mm_storeu_ps(&mPositionX[i], _mm_add_ps(_mm_loadu_ps(&mPositionX[i]), _mm_mul_ps(vx, dt)));
+		_mm_storeu_ps(&mPositionY[i], _mm_add_ps(_mm_loadu_ps(&mPositionY[i]), _mm_mul_ps(vy, dt)));
+		_mm_storeu_ps(&mPositionZ[i], _mm_add_ps(_mm_loadu_ps(&mPositionZ[i]), _mm_mul_ps(vz, dt)));
+
+		_mm_storeu_ps(&mAge[i], _mm_add_ps(_mm_loadu_ps(&mAge[i]), _mm_mul_ps(_mm_loadu_ps(&mInvLifetime[i]), dt)));
+	}
+#endif
+
+	for (; i < end; ++i)
+	{
+		mVelocityX[i] = (mVelocityX[i] + deltaVelocity.x) * damping;
+		mVelocityY[i] = (mVelocityY[i] + deltaVelocity.y) * damping;
+		mVelocityZ[i] = (mVelocityZ[i] + deltaVelocity.z) * damping;
+
+		mPositionX[i] += mVelocityX[i] * deltaTime;
+		mPositionY[i] += mVelocityY[i] * deltaTime;
+		mPositionZ[i] += mVelocityZ[i] * deltaTime;
+
+		mAge[i] += mInvLifetime[i] * deltaTime;
+	}
+}
+
+void ParticlePool::RemoveDead()
+{
+	size_t i = 0;
+	while (i < mNumAlive)
+	{
+		if (mAge[i] >= 1.0f)
+		{
+			// Move the last alive particle into this slot and check it next
+			--mNumAlive;
+			mPositionX[i] = mPositionX[mNumAlive];
+			mPositionY[i] = mPositionY[mNumAlive];
+			mPositionZ[i] = mPositionZ[mNumAlive];
+			mVelocityX[i] = mVelocityX[mNumAlive];
+			mVelocityY[i] = mVelocityY[mNumAlive];
+			mVelocityZ[i] = mVelocityZ[mNumAlive];
+			mAge[i] = mAge[mNumAlive];
+			mInvLifetime[i] = mInvLifetime[mNumAlive];
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void ParticlePool::WriteInstances(ParticleInstance* out, const ParticleEmitterSettings& settings) const
+{
+	float sizeDelta = settings.endSize - settings.startSize;
+	glm::vec4 colorDelta = settings.endColor - settings.startColor;
+
+	for (size_t i = 0; i < mNumAlive; ++i)
+	{
+		float age = mAge[i];
+
+		out[i].positionSize = glm::vec4(mPositionX[i], mPositionY[i], mPositionZ[i], settings.startSize + sizeDelta * age);
+		out[i].color = settings.startColor + colorDelta * age;
+	}
+}
+
+glm::vec3 ParticlePool::SampleVelocity(const ParticleEmitterSettings& settings, ParticleRandom& random)
+{
+	float speed = random.GetFloatRange(settings.minSpeed, settings.maxSpeed);
+
+	if (settings.isPlanar)
+	{
+		// Rotate the direction within the xy plane
+		float angle = std::atan2(settings.direction.y, settings.direction.x) + random.GetFloatRange(-settings.spread, settings.spread);
+		return glm::vec3(std::cos(angle), std::sin(angle), 0.0f) * speed;
+	}
+
+	// Pick a direction uniformly within the cone around the emitter's direction
+	float cosTheta = random.GetFloatRange(std::cos(settings.spread), 1.0f);
+	float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+	float phi = random.GetFloat() * glm::two_pi<float>();
+
+	const glm::vec3& dir = settings.direction;
+	glm::vec3 helper = std::abs(dir.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+	glm::vec3 tangent = glm::normalize(glm::cross(helper, dir));
+	glm::vec3 bitangent = glm::cross(dir, tangent);
+
+	return (tangent * (sinTheta * std::cos(phi)) + bitangent * (sinTheta * std::sin(phi)) + dir * cosTheta) * speed;
+}
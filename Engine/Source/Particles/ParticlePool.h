@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Struct for how an emitter spawns and ages its particles
+struct ParticleEmitterSettings
+{
+	glm::vec4 startColor;	// color of a particle when it spawns
+	glm::vec4 endColor;		// color of a particle when it dies
+	glm::vec3 position;		// position new particles spawn at
+	glm::vec3 direction;	// direction new particles move in (normalized)
+	glm::vec3 gravity;		// acceleration applied to every particle
+	float spread;			// half angle in radians of the cone around direction that particles spawn in
+	float minSpeed;			// slowest spawn speed
+	float maxSpeed;			// fastest spawn speed
+	float minLifetime;		// shortest lifetime in seconds
+	float maxLifetime;		// longest lifetime in seconds
+	float startSize;		// size of a particle when it spawns
+	float endSize;			// size of a particle when it dies
+	float drag;				// fraction of velocity lost every second
+	float emitRate;			// particles spawned per second
+	bool isPlanar;			// if particles only spawn moving in the xy plane (for 2D)
+};
+
+// Returns emitter settings with reasonable defaults
+// @return - ParticleEmitterSettings for the default settings
+ParticleEmitterSettings GetDefaultEmitterSettings();
+
+// Struct for a single particle's instance data that gets sent to the GPU
+struct ParticleInstance
+{
+	glm::vec4 positionSize;	// xyz = world position, w = size
+	glm::vec4 color;		// color of the particle
+};
+
+// Small xorshift random number generator so particles can spawn without locking the global Random generator
+struct ParticleRandom
+{
+	uint32_t state;
+
+	// Gets the next random float between 0.0f and 1.0f
+	// @return - float for the random value
+	float GetFloat()
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Gets the next random float in a range
+	// @param - float for the min value
+	// @param - float for the max value
+	// @return - float between min and max
+	float GetFloatRange(float min, float max)
+	{
+		return min + (max - min) * GetFloat();
+	}
+};
+
+// ParticlePool simulates a fixed number of particles on the CPU. Particles are stored as a
+// structure of arrays so the integration loop can run 4 particles at a time with SSE. Every
+// array is allocated once at the pool's capacity, so emitting and killing particles never
+// allocates. Alive particles are kept packed at the front of the arrays: dead particles are
+// swapped with the last alive particle. This class doesn't use OpenGL so it can be simulated
+// and benchmarked without a window.
+class ParticlePool
+{
+public:
+	// ParticlePool constructor:
+	// Allocates every array to fit the capacity (rounded up to a multiple of 4)
+	// @param - size_t for the max number of alive particles
+	// @param - uint32_t for the random seed (must not be 0)
+	ParticlePool(size_t capacity, uint32_t seed = 2463534242u);
+	~ParticlePool();
+
+	// Spawns particles from an emitter. Particles that don't fit in the pool are dropped.
+	// @param - const ParticleEmitterSettings& for the emitter
+	// @param - size_t for the number of particles to spawn
+	// @return - size_t for the number of particles that were spawned
+	size_t Emit(const ParticleEmitterSettings& settings, size_t count);
+
+	// Integrates every alive particle and removes the ones that reached the end of their lifetime
+	// @param - float for delta time
+	// @param - const ParticleEmitterSettings& for the emitter's gravity and drag
+	void Simulate(float deltaTime, const ParticleEmitterSettings& settings);
+
+	// Integrates a range of particles without removing dead ones. Ranges that don't
+	// overlap can be integrated on separate threads before calling RemoveDead().
+	// @param - float for delta time
+	// @param - const ParticleEmitterSettings& for the emitter's gravity and drag
+	// @param - size_t for the first particle
+	// @param - size_t for one past the last particle
+	void Integrate(float deltaTime, const ParticleEmitterSettings& settings, size_t begin, size_t end);
+
+	// Removes every particle that reached the end of its lifetime
+	void RemoveDead();
+
+	// Writes the instance data of every alive particle, interpolating size and color by age
+	// @param - ParticleInstance* for an array with room for GetNumAlive() instances
+	// @param - const ParticleEmitterSettings& for the emitter's sizes and colors
+	void WriteInstances(ParticleInstance* out, const ParticleEmitterSettings& settings) const;
+
+	// Kills every particle
+	void Clear() { mNumAlive = 0; }
+
+	// Gets the number of alive particles
+	// @return - size_t for the number of particles
+	size_t GetNumAlive() const { return mNumAlive; }
+
+	// Gets the max number of alive particles
+	// @return - size_t for the capacity
+	size_t GetCapacity() const { return mCapacity; }
+
+	// Gets the pool's random number generator
+	// @return - ParticleRandom& for the generator
+	ParticleRandom& GetRandom() { return mRandom; }
+
+	// Picks a random spawn velocity within an emitter's cone
+	// @param - const ParticleEmitterSettings& for the emitter
+	// @param - ParticleRandom& for the random number generator
+	// @return - glm::vec3 for the velocity
+	static glm::vec3 SampleVelocity(const ParticleEmitterSettings& settings, ParticleRandom& random);
+
+private:
+	// Positions
+	std::vector<float> mPositionX;
+	std::vector<float> mPositionY;
+	std::vector<float> mPositionZ;
+
+	// Velocities
+	std::vector<float> mVelocityX;
+	std::vector<float> mVelocityY;
+	std::vector<float> mVelocityZ;
+
+	// Normalized age (0 when spawned, 1 when dead)
+	std::vector<float> mAge;
+
+	// 1 / lifetime so age can advance with a multiply
+	std::vector<float> mInvLifetime;
+
+	// Random number generator used to spawn particles
+	ParticleRandom mRandom;
+
+	// Max number of particles
+	size_t mCapacity;
+
+	// Number of alive particles packed at the front of the arrays
+	size_t mNumAlive;
+};
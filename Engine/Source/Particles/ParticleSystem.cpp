@@ -0,0 +1,211 @@
+#include "ParticleSystem.h"
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <glad/glad.h>
+#include "../Graphics/Shader.h"
+#include "../Graphics/ShaderStorageBuffer.h"
+#include "../Util/Logger.h"
+
+// Number of particles each compute shader work group simulates (matches local_size_x)
+const unsigned int PARTICLE_WORK_GROUP_SIZE = 256;
+
+ParticleSystem::ParticleSystem(size_t capacity, ParticleSimulation simulation, Shader* computeShader) :
+	mPool(simulation == ParticleSimulation::Compute && computeShader ? 0 : capacity),
+	mSettings(GetDefaultEmitterSettings()),
+	mSpawnedParticles(),
+	mComputeShader(computeShader),
+	mVertexArray(0),
+	mQuadBuffer(0),
+	mInstanceBuffer(0),
+	mCapacity(capacity),
+	mNumInstances(0),
+	mSpawnCursor(0),
+	mEmitAccumulator(0.0f),
+	mSimulation(computeShader ? simulation : ParticleSimulation::CPU)
+{
+	if (simulation != mSimulation)
+	{
+		LOG_WARNING("Compute particle system has no compute shader, falling back to CPU simulation");
+	}
+
+	// Corners of a unit quad drawn as a triangle strip
+	glm::vec2 corners[] =
+	{
+		glm::vec2(-0.5f, -0.5f),
+		glm::vec2(0.5f, -0.5f),
+		glm::vec2(-0.5f, 0.5f),
+		glm::vec2(0.5f, 0.5f)
+	};
+
+	glGenVertexArrays(1, &mVertexArray);
+	glBindVertexArray(mVertexArray);
+
+	glGenBuffers(1, &mQuadBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, mQuadBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+
+	// The compute ring holds whole GpuParticles, only the first two members are read as instance data
+	GLsizei stride = mSimulation == ParticleSimulation::Compute ? sizeof(GpuParticle) : sizeof(ParticleInstance);
+
+	glGenBuffers(1, &mInstanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+	if (mSimulation == ParticleSimulation::Compute)
+	{
+		// Start with every particle dead (zero size and alpha)
+		std::vector<GpuParticle> particles(mCapacity, GpuParticle{ glm::vec4(0.0f), glm::vec4(0.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f) });
+		glBufferData(GL_ARRAY_BUFFER, mCapacity * sizeof(GpuParticle), particles.data(), GL_DYNAMIC_DRAW);
+	}
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, mCapacity * sizeof(ParticleInstance), NULL, GL_STREAM_DRAW);
+	}
+
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ParticleInstance, positionSize));
+	glVertexAttribDivisor(1, 1);
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(ParticleInstance, color));
+	glVertexAttribDivisor(2, 1);
+
+	glBindVertexArray(0);
+}
+
+ParticleSystem::~ParticleSystem()
+{
+	std::cout << "Deleted ParticleSystem\n";
+
+	glDeleteVertexArrays(1, &mVertexArray);
+	glDeleteBuffers(1, &mQuadBuffer);
+	glDeleteBuffers(1, &mInstanceBuffer);
+}
+
+void ParticleSystem::Update(float deltaTime)
+{
+	mEmitAccumulator += mSettings.emitRate * deltaTime;
+	if (mEmitAccumulator >= 1.0f)
+	{
+		size_t count = static_cast<size_t>(mEmitAccumulator);
+		mEmitAccumulator -= static_cast<float>(count);
+		Emit(mSettings, count);
+	}
+
+	if (mSimulation == ParticleSimulation::CPU)
+	{
+		mPool.Simulate(deltaTime, mSettings);
+		mNumInstances = mPool.GetNumAlive();
+
+		if (mNumInstances > 0)
+		{
+			// Orphan the old instance data and write the new data straight into the buffer
+			glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+			void* instances = glMapBufferRange(GL_ARRAY_BUFFER, 0, mNumInstances * sizeof(ParticleInstance), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+			if (instances)
+			{
+				mPool.WriteInstances(static_cast<ParticleInstance*>(instances), mSettings);
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+			}
+			else
+			{
+				mNumInstances = 0;
+			}
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+	}
+	else
+	{
+		// Copy the new particles into the ring, splitting the copy where the ring wraps
+		size_t numSpawned = mSpawnedParticles.size();
+		size_t offset = 0;
+		glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+		while (offset < numSpawned)
+		{
+			size_t count = std::min(numSpawned - offset, mCapacity - mSpawnCursor);
+			glBufferSubData(GL_ARRAY_BUFFER, mSpawnCursor * sizeof(GpuParticle), count * sizeof(GpuParticle), &mSpawnedParticles[offset]);
+			offset += count;
+			mSpawnCursor = (mSpawnCursor + count) % mCapacity;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		mSpawnedParticles.clear();
+
+		if (mNumInstances == 0)
+		{
+			return;
+		}
+
+		mComputeShader->SetActive();
+		mComputeShader->SetFloat("deltaTime", deltaTime);
+		mComputeShader->SetVec3("gravity", mSettings.gravity);
+		mComputeShader->SetFloat("drag", mSettings.drag);
+		mComputeShader->SetFloat("startSize", mSettings.startSize);
+		mComputeShader->SetFloat("endSize", mSettings.endSize);
+		mComputeShader->SetVec4("startColor", mSettings.startColor);
+		mComputeShader->SetVec4("endColor", mSettings.endColor);
+		mComputeShader->SetInt("numParticles", static_cast<int>(mNumInstances));
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<unsigned int>(StorageBindingPoint::Particles), mInstanceBuffer);
+		glDispatchCompute(static_cast<unsigned int>((mNumInstances + PARTICLE_WORK_GROUP_SIZE - 1) / PARTICLE_WORK_GROUP_SIZE), 1, 1);
+		// Make sure the simulation is finished before the ring is read as instance data
+		glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+	}
+}
+
+void ParticleSystem::Burst(size_t count)
+{
+	Emit(mSettings, count);
+}
+
+void ParticleSystem::Burst(size_t count, const glm::vec3& position)
+{
+	ParticleEmitterSettings settings = mSettings;
+	settings.position = position;
+	Emit(settings, count);
+}
+
+void ParticleSystem::Draw() const
+{
+	if (mNumInstances == 0)
+	{
+		return;
+	}
+
+	glBindVertexArray(mVertexArray);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(mNumInstances));
+	glBindVertexArray(0);
+}
+
+void ParticleSystem::Emit(const ParticleEmitterSettings& settings, size_t count)
+{
+	if (mSimulation == ParticleSimulation::CPU)
+	{
+		mPool.Emit(settings, count);
+	}
+	else
+	{
+		EmitCompute(settings, count);
+	}
+}
+
+void ParticleSystem::EmitCompute(const ParticleEmitterSettings& settings, size_t count)
+{
+	// Spawning more than the ring holds would only overwrite the new particles
+	count = std::min(count, mCapacity - std::min(mCapacity, mSpawnedParticles.size()));
+
+	ParticleRandom& random = mPool.GetRandom();
+	for (size_t i = 0; i < count; ++i)
+	{
+		float lifetime = random.GetFloatRange(settings.minLifetime, settings.maxLifetime);
+
+		GpuParticle particle = {};
+		particle.positionSize = glm::vec4(settings.position, settings.startSize);
+		particle.color = settings.startColor;
+		particle.velocityAge = glm::vec4(ParticlePool::SampleVelocity(settings, random), 0.0f);
+		particle.lifetime = glm::vec4(lifetime > 0.0f ? 1.0f / lifetime : 1.0f, 0.0f, 0.0f, 0.0f);
+		mSpawnedParticles.emplace_back(particle);
+	}
+
+	// Once the ring has wrapped every slot is drawn, dead slots have zero size
+	mNumInstances = std::min(mCapacity, mNumInstances + count);
+}
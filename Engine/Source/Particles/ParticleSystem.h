@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ParticlePool.h"
+
+class Shader;
+
+// Enum class for where a particle system is simulated
+enum class ParticleSimulation
+{
+	CPU,		// simulated by a ParticlePool and streamed to the GPU every frame
+	Compute		// simulated by a compute shader in a buffer that never leaves the GPU
+};
+
+// Struct for a particle simulated by a compute shader (std430 layout). The first two
+// members match ParticleInstance so the same buffer is read as instance data when drawing.
+struct GpuParticle
+{
+	glm::vec4 positionSize;	// xyz = world position, w = size
+	glm::vec4 color;		// color of the particle
+	glm::vec4 velocityAge;	// xyz = velocity, w = normalized age
+	glm::vec4 lifetime;		// x = 1 / lifetime
+};
+
+// ParticleSystem emits, simulates, and draws one emitter's particles as instanced camera facing quads.
+// With ParticleSimulation::CPU the particles live in a ParticlePool and their instance data is written
+// straight into a mapped vertex buffer every frame. With ParticleSimulation::Compute the particles live
+// in a ring of GpuParticles that a compute shader integrates in place. New particles are written into
+// the ring's next slots on the CPU, and the ring is drawn directly as instance data.
+class ParticleSystem
+{
+public:
+	// ParticleSystem constructor:
+	// Creates the quad, the instance buffer, and the vertex array used to draw the particles
+	// @param - size_t for the max number of particles
+	// @param - ParticleSimulation for where the particles are simulated (defaults to CPU)
+	// @param - Shader* for the compute shader used with ParticleSimulation::Compute (defaults to nullptr)
+	ParticleSystem(size_t capacity, ParticleSimulation simulation = ParticleSimulation::CPU, Shader* computeShader = nullptr);
+	~ParticleSystem();
+
+	// Emits particles at the emitter's rate and simulates every particle
+	// @param - float for delta time
+	void Update(float deltaTime);
+
+	// Emits a number of particles at once from the emitter's position
+	// @param - size_t for the number of particles
+	void Burst(size_t count);
+
+	// Emits a number of particles at once from a position
+	// @param - size_t for the number of particles
+	// @param - const glm::vec3& for the position
+	void Burst(size_t count, const glm::vec3& position);
+
+	// Draws every particle with one instanced draw call. The particle shader needs to be active.
+	void Draw() const;
+
+	// Gets the emitter's settings
+	// @return - ParticleEmitterSettings& for the settings
+	ParticleEmitterSettings& GetSettings() { return mSettings; }
+
+	// Gets the number of particle instances drawn by Draw()
+	// @return - size_t for the number of instances
+	size_t GetNumInstances() const { return mNumInstances; }
+
+	// Gets where the particles are simulated
+	// @return - ParticleSimulation for the simulation
+	ParticleSimulation GetSimulation() const { return mSimulation; }
+
+private:
+	// Emits particles from a set of settings into the pool or the GPU ring
+	// @param - const ParticleEmitterSettings& for the emitter
+	// @param - size_t for the number of particles
+	void Emit(const ParticleEmitterSettings& settings, size_t count);
+
+	// Writes new particles into the GPU ring, wrapping around to the start
+	// @param - const ParticleEmitterSettings& for the emitter
+	// @param - size_t for the number of particles
+	void EmitCompute(const ParticleEmitterSettings& settings, size_t count);
+
+	// Particles simulated on the CPU (empty with ParticleSimulation::Compute)
+	ParticlePool mPool;
+
+	// Emitter settings
+	ParticleEmitterSettings mSettings;
+
+	// New particles waiting to be written into the GPU ring
+	std::vector<GpuParticle> mSpawnedParticles;
+
+	// Compute shader used to simulate the GPU ring
+	Shader* mComputeShader;
+
+	// Vertex array object
+	unsigned int mVertexArray;
+
+	// Buffer for the quad's corners
+	unsigned int mQuadBuffer;
+
+	// Buffer for the instance data (or the GPU ring)
+	unsigned int mInstanceBuffer;
+
+	// Max number of particles
+	size_t mCapacity;
+
+	// Number of instances to draw
+	size_t mNumInstances;
+
+	// Next slot in the GPU ring to spawn a particle in
+	size_t mSpawnCursor;
+
+	// Fraction of a particle carried over between frames when emitting at a rate
+	float mEmitAccumulator;
+
+	// Where the particles are simulated
+	ParticleSimulation mSimulation;
+};
@@ -0,0 +1,183 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <iostream>
+#include <system_error>
+#include "Logger.h"
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher(bool usePolling) :
+	mFiles(),
+	mDirectories(),
+	mDirectoryWatches(),
+	mInotify(-1),
+	mLastPoll(std::chrono::steady_clock::now())
+{
+#ifdef __linux__
+	if (!usePolling)
+	{
+		mInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (mInotify < 0)
+		{
+			LOG_WARNING("Couldn't start inotify, polling watched files instead");
+		}
+	}
+#else
+	(void)usePolling;
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+	std::cout << "Deleted FileWatcher\n";
+
+#ifdef __linux__
+	if (mInotify >= 0)
+	{
+		close(mInotify);
+	}
+#endif
+}
+
+void FileWatcher::Watch(const std::string& fileName)
+{
+	std::string key = GetKey(fileName);
+	if (mFiles.find(key) != mFiles.end())
+	{
+		return;
+	}
+
+	// Assets named after something other than a file aren't watched
+	std::filesystem::file_time_type writeTime = GetWriteTime(fileName);
+	if (writeTime == std::filesystem::file_time_type::min())
+	{
+		return;
+	}
+
+	WatchedFile file = { fileName, writeTime, true };
+
+#ifdef __linux__
+	if (mInotify >= 0)
+	{
+		std::string directory = std::filesystem::path(key).parent_path().string();
+		if (directory.empty())
+		{
+			directory = ".";
+		}
+
+		auto iter = mDirectoryWatches.find(directory);
+		if (iter != mDirectoryWatches.end())
+		{
+			file.isPolled = false;
+		}
+		else
+		{
+			// Editors often save by renaming a new file over the old one, so the directory is watched instead of the file
+			int watch = inotify_add_watch(mInotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+			if (watch >= 0)
+			{
+				mDirectories[watch] = directory;
+				mDirectoryWatches[directory] = watch;
+				file.isPolled = false;
+			}
+		}
+	}
+#endif
+
+	mFiles[key] = file;
+}
+
+std::vector<std::string> FileWatcher::GetChangedFiles()
+{
+	std::vector<std::string> changed;
+
+	ReadEvents(changed);
+
+	auto now = std::chrono::steady_clock::now();
+	if (std::chrono::duration<float>(now - mLastPoll).count() >= FILE_WATCHER_POLL_INTERVAL)
+	{
+		mLastPoll = now;
+		PollFiles(changed);
+	}
+
+	// An editor can write a file more than once when saving
+	std::sort(changed.begin(), changed.end());
+	changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+	return changed;
+}
+
+std::string FileWatcher::GetKey(const std::string& fileName)
+{
+	return std::filesystem::path(fileName).lexically_normal().generic_string();
+}
+
+std::filesystem::file_time_type FileWatcher::GetWriteTime(const std::string& fileName)
+{
+	std::error_code error;
+	std::filesystem::file_time_type time = std::filesystem::last_write_time(fileName, error);
+	return error ? std::filesystem::file_time_type::min() : time;
+}
+
+void FileWatcher::ReadEvents(std::vector<std::string>& changed)
+{
+#ifdef __linux__
+	if (mInotify < 0)
+	{
+		return;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	while (true)
+	{
+		ssize_t length = read(mInotify, buffer, sizeof(buffer));
+		if (length <= 0)
+		{
+			break;
+		}
+
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			auto directory = mDirectories.find(event->wd);
+			if (directory == mDirectories.end() || event->len == 0)
+			{
+				continue;
+			}
+
+			auto file = mFiles.find(GetKey(directory->second + "/" + event->name));
+			if (file != mFiles.end())
+			{
+				file->second.writeTime = GetWriteTime(file->second.fileName);
+				changed.emplace_back(file->second.fileName);
+			}
+		}
+	}
+#else
+	(void)changed;
+#endif
+}
+
+void FileWatcher::PollFiles(std::vector<std::string>& changed)
+{
+	for (auto& f : mFiles)
+	{
+		WatchedFile& file = f.second;
+		if (!file.isPolled)
+		{
+			continue;
+		}
+
+		// A file that's missing is probably being replaced, so wait for it to come back
+		std::filesystem::file_time_type writeTime = GetWriteTime(file.fileName);
+		if (writeTime != file.writeTime && writeTime != std::filesystem::file_time_type::min())
+		{
+			file.writeTime = writeTime;
+			changed.emplace_back(file.fileName);
+		}
+	}
+}
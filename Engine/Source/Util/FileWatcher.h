@@ -0,0 +1,82 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Seconds between checking the watched files' timestamps when the watcher is polling
+const float FILE_WATCHER_POLL_INTERVAL = 0.5f;
+
+// FileWatcher reports when watched files are written. On Linux it listens to inotify events on the files' directories,
+// so it catches editors that save by writing a new file and renaming it over the old one. Anywhere else, or if inotify
+// can't watch a directory, it falls back to checking the files' last write times every FILE_WATCHER_POLL_INTERVAL seconds.
+class FileWatcher
+{
+public:
+	// FileWatcher constructor
+	// @param - bool for always polling timestamps instead of using inotify (defaults to false)
+	FileWatcher(bool usePolling = false);
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	// Starts watching a file. Files that don't exist aren't watched.
+	// @param - const std::string& for the file name
+	void Watch(const std::string& fileName);
+
+	// Gets the files that were written since the last call, each once. Doesn't block.
+	// @return - std::vector<std::string> for the file names, spelled the way they were watched
+	std::vector<std::string> GetChangedFiles();
+
+	// Gets if every file is polled because inotify isn't available
+	// @return - bool for if the watcher is polling
+	bool IsPolling() const { return mInotify < 0; }
+
+	// Gets the number of files being watched
+	// @return - size_t for the number of files
+	size_t GetNumFiles() const { return mFiles.size(); }
+
+private:
+	// Struct for a watched file
+	struct WatchedFile
+	{
+		std::string fileName;						// name the file was watched with
+		std::filesystem::file_time_type writeTime;	// last write time the last time it was checked
+		bool isPolled;								// if its timestamp is checked instead of getting inotify events
+	};
+
+	// Makes the key a file is stored under, so different spellings of a path match
+	// @param - const std::string& for the file name
+	// @return - std::string for the key
+	static std::string GetKey(const std::string& fileName);
+
+	// Gets a file's last write time
+	// @param - const std::string& for the file name
+	// @return - std::filesystem::file_time_type for the time (the minimum time if the file doesn't exist)
+	static std::filesystem::file_time_type GetWriteTime(const std::string& fileName);
+
+	// Reads the inotify events that are waiting and adds the watched files they're for
+	// @param - std::vector<std::string>& for the changed files
+	void ReadEvents(std::vector<std::string>& changed);
+
+	// Checks the polled files' timestamps and adds the ones that changed
+	// @param - std::vector<std::string>& for the changed files
+	void PollFiles(std::vector<std::string>& changed);
+
+	// Watched files by key
+	std::unordered_map<std::string, WatchedFile> mFiles;
+
+	// Watched directories by inotify watch descriptor
+	std::unordered_map<int, std::string> mDirectories;
+
+	// Inotify watch descriptors by directory
+	std::unordered_map<std::string, int> mDirectoryWatches;
+
+	// Inotify instance (-1 if polling)
+	int mInotify;
+
+	// Last time the polled files were checked
+	std::chrono::steady_clock::time_point mLastPoll;
+};
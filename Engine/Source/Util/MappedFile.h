@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// MappedFile maps a whole file into memory read-only, so its contents can be read
+// through a pointer without copying them into a buffer first. The pages are only
+// read from disk when they're touched. MappedFile is move-only and unmaps on destruction.
+class MappedFile
+{
+public:
+	MappedFile();
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+
+	// Maps a file, unmapping whatever was mapped before
+	// @param - const std::string& for the file name
+	// @return - bool for if the file was mapped (empty files can't be mapped)
+	bool Open(const std::string& fileName);
+
+	// Unmaps the file
+	void Close();
+
+	// Gets the start of the mapped file
+	// @return - const unsigned char* for the first byte (nullptr if nothing is mapped)
+	const unsigned char* GetData() const { return mData; }
+
+	// Gets the size of the mapped file
+	// @return - size_t for the number of bytes
+	size_t GetSize() const { return mSize; }
+
+	// Gets if a file is mapped
+	// @return - bool for if a file is mapped
+	bool IsOpen() const { return mData != nullptr; }
+
+private:
+	// Start of the mapped file
+	const unsigned char* mData;
+
+	// Size of the mapped file in bytes
+	size_t mSize;
+
+	// Platform handle for the file mapping (only used on Windows)
+	void* mMapping;
+};
@@ -62,10 +62,18 @@ void Profiler::Timer::Stop()
 	std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
 
 	mCurrentMs = std::chrono::duration<double, std::milli>(endTime - mStartTime).count();
+	mHasNewTime = true;
 }
 
 void Profiler::Timer::Reset()
 {
+	// Don't count the last time again
+	if (!mHasNewTime)
+	{
+		return;
+	}
+	mHasNewTime = false;
+
 	mTotalTime += mCurrentMs;
 
 	++mNumFrames;
@@ -25,7 +25,8 @@ public:
 
 		// Adds the total for this frame to the overall total and
 		// increases the number of frames count. It then updates the
-		// longest frame time
+		// longest frame time. Frames without a new time (a GPU zone whose
+		// queries aren't ready yet, or a timer that didn't run) are skipped.
 		void Reset();
 
 		// Gets the name of the timer
@@ -36,6 +37,14 @@ public:
 		// @return - double for the current frame's time
 		double GetTimeMs() const { return mCurrentMs; }
 
+		// Sets the latest frame's total for timers that aren't measured with Start()/Stop(), like GPU zones
+		// @param - double for the current frame's time in milliseconds
+		void SetTimeMs(double ms)
+		{
+			mCurrentMs = ms;
+			mHasNewTime = true;
+		}
+
 		// Gets the longest frame's total in milliseconds
 		// @return - double for the longest frame's time
 		double GetMaxMs() const { return mMaxMs; }
@@ -58,7 +67,8 @@ public:
 			mCurrentMs(0.0),
 			mMaxMs(0.0),
 			mTotalTime(0.0),
-			mNumFrames(0)
+			mNumFrames(0),
+			mHasNewTime(false)
 		{}
 		~Timer() {}
 
@@ -72,6 +82,8 @@ public:
 		double mTotalTime;
 		// How many frames this timer has been captured for this timer
 		int mNumFrames;
+		// If the timer got a new time since the last Reset()
+		bool mHasNewTime;
 		// Time of when this timer started
 		std::chrono::high_resolution_clock::time_point mStartTime;
 	};
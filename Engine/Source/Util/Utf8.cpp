@@ -0,0 +1,70 @@
+#include "Utf8.h"
+
+uint32_t Utf8::DecodeNext(const std::string& text, size_t& index)
+{
+	unsigned char lead = static_cast<unsigned char>(text[index]);
+
+	// Single byte ASCII
+	if (lead < 0x80)
+	{
+		++index;
+		return lead;
+	}
+
+	// Number of continuation bytes, the lead byte's payload, and the smallest codepoint that needs this many bytes
+	size_t numContinuation = 0;
+	uint32_t codepoint = 0;
+	uint32_t minCodepoint = 0;
+
+	if ((lead & 0xE0) == 0xC0)
+	{
+		numContinuation = 1;
+		codepoint = lead & 0x1F;
+		minCodepoint = 0x80;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		numContinuation = 2;
+		codepoint = lead & 0x0F;
+		minCodepoint = 0x800;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		numContinuation = 3;
+		codepoint = lead & 0x07;
+		minCodepoint = 0x10000;
+	}
+	else
+	{
+		++index;
+		return UTF8_REPLACEMENT_CHARACTER;
+	}
+
+	// Truncated sequence at the end of the string
+	if (index + numContinuation >= text.size())
+	{
+		++index;
+		return UTF8_REPLACEMENT_CHARACTER;
+	}
+
+	for (size_t i = 1; i <= numContinuation; ++i)
+	{
+		unsigned char next = static_cast<unsigned char>(text[index + i]);
+		if ((next & 0xC0) != 0x80)
+		{
+			++index;
+			return UTF8_REPLACEMENT_CHARACTER;
+		}
+		codepoint = (codepoint << 6) | (next & 0x3F);
+	}
+
+	// Reject overlong encodings, UTF-16 surrogates, and values past the Unicode range
+	if (codepoint < minCodepoint || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > UTF8_MAX_CODEPOINT)
+	{
+		++index;
+		return UTF8_REPLACEMENT_CHARACTER;
+	}
+
+	index += numContinuation + 1;
+	return codepoint;
+}
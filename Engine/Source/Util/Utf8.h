@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Codepoint used in place of invalid UTF-8 sequences
+const uint32_t UTF8_REPLACEMENT_CHARACTER = 0xFFFD;
+
+// Largest valid Unicode codepoint
+const uint32_t UTF8_MAX_CODEPOINT = 0x10FFFF;
+
+// Utf8 contains helpers to decode UTF-8 encoded strings into Unicode codepoints
+namespace Utf8
+{
+	// Decodes the codepoint that starts at index and moves index past it.
+	// Invalid, overlong, or truncated sequences decode to UTF8_REPLACEMENT_CHARACTER and skip one byte.
+	// @param - const std::string& for the UTF-8 string
+	// @param - size_t& for the index of the first byte, moved to the next codepoint's first byte
+	// @return - uint32_t for the codepoint
+	uint32_t DecodeNext(const std::string& text, size_t& index);
+}
@@ -10,8 +10,12 @@ in VS_OUT {
 uniform sampler2D screenTexture;
 // Uniform sampler for the blur framebuffer image
 uniform sampler2D blurTexture;
+// Part of the bloom chain's texture it covers (less than 1 when it's aliased onto a larger render target)
+uniform vec2 blurUvScale = vec2(1.0);
 // Toggle bloom
 uniform bool bloom;
+// How much of the bloom chain is added to the scene
+uniform float intensity;
 
 // Specify a vec4 output
 out vec4 fragColor;
@@ -23,8 +27,8 @@ void main()
 
     if(bloom)
     {
-        vec3 bloomColor = texture(blurTexture, fs_in.textureCoord).rgb;
-        color += bloomColor;
+        vec3 bloomColor = texture(blurTexture, fs_in.textureCoord * blurUvScale).rgb;
+        color += bloomColor * intensity;
     }
 
     // final output
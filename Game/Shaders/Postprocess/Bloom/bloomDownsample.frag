@@ -0,0 +1,93 @@
+// Specify OpenGL 4.5 with core functionality
+#version 450 core
+
+// Fragment shader input
+in VS_OUT {
+    vec2 textureCoord;
+} fs_in;
+
+// Uniform sampler for the previous (larger) level of the bloom chain
+uniform sampler2D screenTexture;
+// Part of screenTexture the level covers (less than 1 when it's aliased onto a larger render target)
+uniform vec2 screenUvScale = vec2(1.0);
+// Apply the threshold and firefly suppression (only for the first level sampled from the scene)
+uniform bool prefilter;
+// Brightness where bloom starts
+uniform float threshold;
+// Width of the soft transition around the threshold
+uniform float knee;
+
+// Downsampled color
+out vec4 fragColor;
+
+// Soft threshold so bloom fades in around the threshold instead of popping
+vec3 Threshold(vec3 color)
+{
+    float brightness = max(color.r, max(color.g, color.b));
+    float soft = clamp(brightness - threshold + knee, 0.0, 2.0 * knee);
+    soft = (soft * soft) / (4.0 * knee + 0.00001);
+    float contribution = max(soft, brightness - threshold) / max(brightness, 0.00001);
+    return color * contribution;
+}
+
+// Weights a box of 4 samples by its inverse luma so a single very bright pixel can't flicker
+vec3 KarisAverage(vec3 a, vec3 b, vec3 c, vec3 d)
+{
+    vec3 sum = (a + b + c + d) * 0.25;
+    float luma = dot(sum, vec3(0.2126, 0.7152, 0.0722));
+    return sum / (1.0 + luma);
+}
+
+// Samples the larger level, clamped to the part of the texture it covers
+vec3 Sample(vec2 uv)
+{
+    vec2 halfTexel = 0.5 / vec2(textureSize(screenTexture, 0));
+    return texture(screenTexture, clamp(uv, halfTexel, screenUvScale - halfTexel)).rgb;
+}
+
+void main()
+{
+    vec2 texel = 1.0 / vec2(textureSize(screenTexture, 0));
+    vec2 uv = fs_in.textureCoord * screenUvScale;
+
+    // 13 bilinear taps covering a 4x4 texel area of the larger level
+    // a - b - c
+    // - j - k -
+    // d - e - f
+    // - l - m -
+    // g - h - i
+    vec3 a = Sample(uv + texel * vec2(-2.0, 2.0));
+    vec3 b = Sample(uv + texel * vec2(0.0, 2.0));
+    vec3 c = Sample(uv + texel * vec2(2.0, 2.0));
+    vec3 d = Sample(uv + texel * vec2(-2.0, 0.0));
+    vec3 e = Sample(uv);
+    vec3 f = Sample(uv + texel * vec2(2.0, 0.0));
+    vec3 g = Sample(uv + texel * vec2(-2.0, -2.0));
+    vec3 h = Sample(uv + texel * vec2(0.0, -2.0));
+    vec3 i = Sample(uv + texel * vec2(2.0, -2.0));
+    vec3 j = Sample(uv + texel * vec2(-1.0, 1.0));
+    vec3 k = Sample(uv + texel * vec2(1.0, 1.0));
+    vec3 l = Sample(uv + texel * vec2(-1.0, -1.0));
+    vec3 m = Sample(uv + texel * vec2(1.0, -1.0));
+
+    vec3 color;
+    if (prefilter)
+    {
+        // Same 5 overlapping boxes, but each is weighted by its brightness
+        color = KarisAverage(j, k, l, m) * 0.5;
+        color += KarisAverage(a, b, d, e) * 0.125;
+        color += KarisAverage(b, c, e, f) * 0.125;
+        color += KarisAverage(d, e, g, h) * 0.125;
+        color += KarisAverage(e, f, h, i) * 0.125;
+        color = Threshold(color);
+    }
+    else
+    {
+        color = e * 0.125;
+        color += (a + c + g + i) * 0.03125;
+        color += (b + d + f + h) * 0.0625;
+        color += (j + k + l + m) * 0.125;
+    }
+
+    fragColor = vec4(max(color, vec3(0.0)), 1.0);
+}
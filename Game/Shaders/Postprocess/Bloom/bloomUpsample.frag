@@ -0,0 +1,48 @@
+// Specify OpenGL 4.5 with core functionality
+#version 450 core
+
+// Fragment shader input
+in VS_OUT {
+    vec2 textureCoord;
+} fs_in;
+
+// Uniform sampler for the smaller level that is being upsampled
+uniform sampler2D screenTexture;
+// Uniform sampler for this level's downsampled image
+uniform sampler2D blurTexture;
+// Part of each texture its level covers (less than 1 when it's aliased onto a larger render target)
+uniform vec2 screenUvScale = vec2(1.0);
+uniform vec2 blurUvScale = vec2(1.0);
+// Radius of the tent filter in texels of the smaller level
+uniform float filterRadius;
+
+// Upsampled color
+out vec4 fragColor;
+
+// Samples the smaller level, clamped to the part of the texture it covers
+vec3 Sample(vec2 uv)
+{
+    vec2 halfTexel = 0.5 / vec2(textureSize(screenTexture, 0));
+    return texture(screenTexture, clamp(uv, halfTexel, screenUvScale - halfTexel)).rgb;
+}
+
+void main()
+{
+    vec2 texel = filterRadius / vec2(textureSize(screenTexture, 0));
+    vec2 uv = fs_in.textureCoord * screenUvScale;
+
+    // 3x3 tent filter
+    vec3 color = Sample(uv) * 4.0;
+    color += Sample(uv + texel * vec2(0.0, 1.0)) * 2.0;
+    color += Sample(uv + texel * vec2(-1.0, 0.0)) * 2.0;
+    color += Sample(uv + texel * vec2(1.0, 0.0)) * 2.0;
+    color += Sample(uv + texel * vec2(0.0, -1.0)) * 2.0;
+    color += Sample(uv + texel * vec2(-1.0, 1.0));
+    color += Sample(uv + texel * vec2(1.0, 1.0));
+    color += Sample(uv + texel * vec2(-1.0, -1.0));
+    color += Sample(uv + texel * vec2(1.0, -1.0));
+    color *= 1.0 / 16.0;
+
+    // Add this level's detail back on top of the wider glow from below
+    fragColor = vec4(texture(blurTexture, fs_in.textureCoord * blurUvScale).rgb + color, 1.0);
+}
@@ -1,17 +1,29 @@
-// Specify OpenGL 4.2 with core functionality
-#version 420 core
+// Specify OpenGL 4.5 with core functionality
+#version 450 core
 
-in vec4 fragPos;
+#define MAX_POINT_SHADOWS 4
 
-uniform vec3 lightPos;
-uniform float farPlane;
+in vec3 fragPos;
+
+// Uniform buffer for point light shadows packed into an atlas
+layout (std140, binding = 5) uniform PointShadowBuffer
+{
+	mat4 faceViewProjections[MAX_POINT_SHADOWS * 6];
+	vec4 faceTiles[MAX_POINT_SHADOWS * 6];
+	vec4 shadowLightPositions[MAX_POINT_SHADOWS];
+};
+
+// Shadow slot of the light being rendered
+uniform int shadowSlot;
 
 void main()
 {
-    float lightDistance = length(fragPos.xyz - lightPos);
+    vec4 light = shadowLightPositions[shadowSlot];
+
+    float lightDistance = length(fragPos - light.xyz);
 
     // map to [0, 1] range by dividing by farPlane
-    lightDistance = lightDistance / farPlane;
+    lightDistance = lightDistance / light.w;
 
     // Write as modified depth
     gl_FragDepth = lightDistance;
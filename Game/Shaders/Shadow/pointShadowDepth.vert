@@ -1,11 +1,13 @@
-// Specify OpenGL 4.2 with core functionality
-#version 420 core
+// Specify OpenGL 4.5 with core functionality
+#version 450 core
 
 // Maximum number of bones a model can have
 const int MAX_BONES = 100;
 // Maximum number of bones that can affect a vertex
 const int MAX_BONE_INFLUENCE = 4;
 
+#define MAX_POINT_SHADOWS 4
+
 // position variable has attribute position 0
 layout (location = 0) in vec3 position;
 // boneIds variable has attribute position 5
@@ -19,11 +21,32 @@ layout (std140, binding = 3) uniform SkeletonBuffer
 	mat4 boneMatrices[MAX_BONES];
 };
 
+// Uniform buffer for point light shadows packed into an atlas
+layout (std140, binding = 5) uniform PointShadowBuffer
+{
+	mat4 faceViewProjections[MAX_POINT_SHADOWS * 6];
+	// xy = tile offset, zw = tile scale in the atlas' uv space
+	vec4 faceTiles[MAX_POINT_SHADOWS * 6];
+	// xyz = light position, w = far plane
+	vec4 shadowLightPositions[MAX_POINT_SHADOWS];
+};
+
 // Model matrix uniform
 uniform mat4 model;
 
 uniform bool isSkinned;
 
+// Shadow slot of the light being rendered
+uniform int shadowSlot;
+
+// Cube faces to draw, one per instance
+uniform int faces[6];
+
+out float gl_ClipDistance[4];
+
+// World space position for the light's distance
+out vec3 fragPos;
+
 void main()
 {
 	vec4 pos;
@@ -52,6 +75,22 @@ void main()
 		pos = vec4(position, 1.0);
 	}
 
-	// Multiply position by model matrix
-	gl_Position = model * pos;
+	vec4 worldPos = model * pos;
+	fragPos = worldPos.xyz;
+
+	// Each instance renders one cube face
+	int index = shadowSlot * 6 + faces[gl_InstanceID];
+	vec4 clipPos = faceViewProjections[index] * worldPos;
+
+	// Clip against the face's own frustum since the tile is only part of the atlas
+	gl_ClipDistance[0] = clipPos.w + clipPos.x;
+	gl_ClipDistance[1] = clipPos.w - clipPos.x;
+	gl_ClipDistance[2] = clipPos.w + clipPos.y;
+	gl_ClipDistance[3] = clipPos.w - clipPos.y;
+
+	// Move the face's [-1, 1] clip space into its tile of the atlas
+	vec4 tile = faceTiles[index];
+	clipPos.xy = clipPos.xy * tile.zw + (tile.zw + 2.0 * tile.xy - 1.0) * clipPos.w;
+
+	gl_Position = clipPos;
 }
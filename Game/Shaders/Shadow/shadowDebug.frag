@@ -7,20 +7,12 @@ in VS_OUT {
     vec2 textureCoord;
 } fs_in;
 
-uniform sampler2D depthMap;
-uniform float nearPlane;
-uniform float farPlane;
-
-// required when using a perspective projection matrix
-float LinearizeDepth(float depth)
-{
-    float z = depth * 2.0 - 1.0; // Back to NDC 
-    return (2.0 * nearPlane * farPlane) / (farPlane + nearPlane - z * (farPlane - nearPlane));	
-}
+uniform sampler2DArray depthMap;
+// cascade to show
+uniform int layer;
 
 void main()
 {             
-    float depthValue = texture(depthMap, fs_in.textureCoord).r;
-    //fragColor = vec4(vec3(LinearizeDepth(depthValue) / farPlane), 1.0); // perspective
+    float depthValue = texture(depthMap, vec3(fs_in.textureCoord, layer)).r;
     fragColor = vec4(vec3(depthValue), 1.0); // orthographic
 }
\ No newline at end of file
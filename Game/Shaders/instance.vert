@@ -30,8 +30,6 @@ out VS_OUT {
 	vec3 fragPos;
 	// Pass the CameraBuffer's viewPos to fragment shader
 	vec3 viewPosition;
-	// fragment's position in light space
-	vec4 fragPosLightSpace;
 	// Tangent, Bitangent, Normal matrix for normal mapping
 	mat3 TBN;
 } vs_out;
@@ -1,8 +1,10 @@
 // Specify OpenGL 4.5 with core functionality
 #version 450 core
 
-#define MAX_LIGHTS 10
 #define MAX_DIR_LIGHTS 1
+#define MAX_CASCADES 4
+#define MAX_POINT_SHADOWS 4
+#define SPOT_LIGHT_FLAG 0x80000000u
 
 // Struct to define a different number of texture units
 // Add more samplers to this struct when needed
@@ -12,7 +14,8 @@ struct TextureSamplers
     sampler2D specular;
 	sampler2D emission;
 	sampler2D normal;
-	sampler2D shadow;
+	sampler2DArray shadow;
+	sampler2D pointShadow;
 };
 
 // Struct to define light data
@@ -34,6 +37,8 @@ struct PointLight
     float constant;
     float linear;
     float quadratic;
+	int shadowSlot;
+	float radius;
 };
 
 // Struct for directional light
@@ -54,6 +59,7 @@ struct SpotLight
     float constant;
     float linear;
     float quadratic;
+	float radius;
 };
 
 in VS_OUT {
@@ -61,18 +67,50 @@ in VS_OUT {
 	vec2 textureCoord;
 	vec3 fragPos;
 	vec3 viewPosition;
-	vec4 fragPosLightSpace;
 	mat3 TBN;
 } fs_in;
 
-// Uniform buffer for lights
+// Uniform buffer for directional lights
 layout (std140, binding = 1) uniform LightBuffer
 {
-	SpotLight spotlights[MAX_LIGHTS];
-	PointLight pointLights[MAX_LIGHTS];
 	DirectionalLight directionalLight[MAX_DIR_LIGHTS];
 };
 
+// Uniform buffer for the light cluster grid
+layout (std140, binding = 7) uniform ClusterBuffer
+{
+	mat4 clusterView;
+	// xyz = number of clusters along each axis
+	uvec4 clusterGridSize;
+	// x = slice scale, y = slice bias
+	vec4 clusterSliceParams;
+	// xy = screen size in pixels
+	vec4 clusterScreenSize;
+};
+
+// Storage buffers for point/spot lights
+layout (std430, binding = 0) readonly buffer PointLightBuffer
+{
+	PointLight pointLights[];
+};
+
+layout (std430, binding = 1) readonly buffer SpotLightBuffer
+{
+	SpotLight spotlights[];
+};
+
+// x = offset, y = count of each cluster's lights in clusterLightIndices
+layout (std430, binding = 2) readonly buffer ClusterRangeBuffer
+{
+	uvec2 clusterRanges[];
+};
+
+// Packed light indices of every cluster, spot lights have SPOT_LIGHT_FLAG set
+layout (std430, binding = 3) readonly buffer ClusterLightIndexBuffer
+{
+	uint clusterLightIndices[];
+};
+
 // Uniform buffer for materials
 layout (std140, binding = 2) uniform MaterialBuffer
 {
@@ -86,51 +124,158 @@ layout (std140, binding = 2) uniform MaterialBuffer
 	bool hasNormalTexture;
 };
 
+// Uniform buffer for the directional light's shadow cascades
+layout (std140, binding = 6) uniform CascadeBuffer
+{
+	mat4 cascadeLightSpace[MAX_CASCADES];
+	// x = view space distance where the cascade ends, y = cascade's depth range
+	vec4 cascadeSplits[MAX_CASCADES];
+	mat4 cameraView;
+	int numCascades;
+};
+
+// Uniform buffer for point light shadows packed into an atlas
+layout (std140, binding = 5) uniform PointShadowBuffer
+{
+	mat4 faceViewProjections[MAX_POINT_SHADOWS * 6];
+	// xy = tile offset, zw = tile scale in the atlas' uv space
+	vec4 faceTiles[MAX_POINT_SHADOWS * 6];
+	// xyz = light position, w = far plane
+	vec4 shadowLightPositions[MAX_POINT_SHADOWS];
+};
+
 // Uniform for the 2D texture samplers
 uniform TextureSamplers textureSamplers;
 
 // Final vector4 fragment color output
 out vec4 fragColor;
 
-vec3 CalculatePhongLighting(LightData light, vec3 lightDir, vec3 normal, vec3 viewDir);
+vec3 CalculatePhongLighting(LightData light, vec3 lightDir, vec3 normal, vec3 viewDir, float shadow);
 vec3 CalculatePointLight(PointLight light, vec3 normal, vec3 viewDir, vec3 fragPos);
 vec3 CalculateDirLight(DirectionalLight light, vec3 normal, vec3 viewDir);
 vec3 CalculateSpotLight(SpotLight light, vec3 normal, vec3 viewDir, vec3 fragPos);
 
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 lightDir, vec3 normal)
+// Finds the cluster that a fragment is in from its screen position and view space depth
+uint GetClusterIndex(vec3 fragPos)
 {
+    float depth = -(clusterView * vec4(fragPos, 1.0)).z;
+    uint slice = uint(max(log(depth) * clusterSliceParams.x + clusterSliceParams.y, 0.0));
+    slice = min(slice, clusterGridSize.z - 1u);
+
+    uvec2 tile = uvec2(gl_FragCoord.xy / clusterScreenSize.xy * vec2(clusterGridSize.xy));
+    tile = min(tile, clusterGridSize.xy - 1u);
+
+    return tile.x + clusterGridSize.x * (tile.y + clusterGridSize.y * slice);
+}
+
+// Smoothly fades a light to zero at its radius so it doesn't pop at cluster edges
+float RangeFalloff(float dist, float radius)
+{
+    float ratio = dist / radius;
+    float falloff = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return falloff * falloff;
+}
+
+float ShadowCalculation(vec3 fragPos, vec3 lightDir, vec3 normal)
+{
+    // pick the cascade that covers the fragment's view space depth
+    float depth = abs((cameraView * vec4(fragPos, 1.0)).z);
+    int cascade = -1;
+    for(int i = 0; i < numCascades; ++i)
+    {
+        if(depth < cascadeSplits[i].x)
+        {
+            cascade = i;
+            break;
+        }
+    }
+
+    // no shadow past the last cascade
+    if(cascade == -1)
+        return 0.0;
+
+    vec4 fragPosLightSpace = cascadeLightSpace[cascade] * vec4(fragPos, 1.0);
     // perform perspective divide
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     // transform to [0,1] range
     projCoords = projCoords * 0.5 + 0.5;
-    // get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(textureSamplers.shadow, projCoords.xy).r; 
+
+    // keep the shadow at 0.0 when outside the far_plane region of the light's frustum.
+    if(projCoords.z > 1.0)
+        return 0.0;
+
     // get depth of current fragment from light's perspective
     float currentDepth = projCoords.z;
 
-    float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.005);
-    // check whether current frag pos is in shadow
-    // float shadow = currentDepth - bias > closestDepth  ? 1.0 : 0.0;
+    // bias in world units, converted into the cascade's depth range
+    float bias = max(0.5 * (1.0 - dot(normal, lightDir)), 0.05) / cascadeSplits[cascade].y;
     // PCF
     float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(textureSamplers.shadow, 0);
+    vec2 texelSize = 1.0 / vec2(textureSize(textureSamplers.shadow, 0).xy);
     for(int x = -1; x <= 1; ++x)
     {
         for(int y = -1; y <= 1; ++y)
         {
-            float pcfDepth = texture(textureSamplers.shadow, projCoords.xy + vec2(x, y) * texelSize).r; 
+            float pcfDepth = texture(textureSamplers.shadow, vec3(projCoords.xy + vec2(x, y) * texelSize, cascade)).r; 
             shadow += currentDepth - bias > pcfDepth  ? 1.0 : 0.0;        
         }    
     }
     shadow /= 9.0;
-    
-    // keep the shadow at 0.0 when outside the far_plane region of the light's frustum.
-    if(projCoords.z > 1.0)
-        shadow = 0.0;
         
     return shadow;
 }
 
+float PointShadowCalculation(int slot, vec3 fragPos, vec3 lightDir, vec3 normal)
+{
+    if(slot < 0)
+        return 0.0;
+
+    vec4 light = shadowLightPositions[slot];
+    vec3 lightToFrag = fragPos - light.xyz;
+
+    // distance from the light in [0, 1] range, same as what was written to the atlas
+    float currentDepth = length(lightToFrag) / light.w;
+    if(currentDepth > 1.0)
+        return 0.0;
+
+    // pick the cube face by the largest axis (+X, -X, +Y, -Y, +Z, -Z)
+    vec3 absDir = abs(lightToFrag);
+    int face;
+    if(absDir.x >= absDir.y && absDir.x >= absDir.z)
+        face = lightToFrag.x > 0.0 ? 0 : 1;
+    else if(absDir.y >= absDir.z)
+        face = lightToFrag.y > 0.0 ? 2 : 3;
+    else
+        face = lightToFrag.z > 0.0 ? 4 : 5;
+
+    int index = slot * 6 + face;
+    vec4 clipPos = faceViewProjections[index] * vec4(fragPos, 1.0);
+    vec2 faceUV = clipPos.xy / clipPos.w * 0.5 + 0.5;
+
+    // move into the face's tile and keep the PCF taps inside it
+    vec4 tile = faceTiles[index];
+    vec2 texelSize = 1.0 / vec2(textureSize(textureSamplers.pointShadow, 0));
+    vec2 tileMin = tile.xy + texelSize * 0.5;
+    vec2 tileMax = tile.xy + tile.zw - texelSize * 0.5;
+    vec2 uv = tile.xy + faceUV * tile.zw;
+
+    // bias in world units, converted into the light's depth range
+    float bias = max(0.5 * (1.0 - dot(normal, lightDir)), 0.05) / light.w;
+    float shadow = 0.0;
+    for(int x = -1; x <= 1; ++x)
+    {
+        for(int y = -1; y <= 1; ++y)
+        {
+            vec2 sampleUV = clamp(uv + vec2(x, y) * texelSize, tileMin, tileMax);
+            float pcfDepth = texture(textureSamplers.pointShadow, sampleUV).r;
+            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
+        }
+    }
+    shadow /= 9.0;
+
+    return shadow;
+}
+
 void main()
 {
 	vec3 lightResult = vec3(0.0, 0.0, 0.0);
@@ -141,10 +286,10 @@ void main()
 	// Use normal map normals
 	if(hasNormalTexture)
 	{
-		// Sample the normal in tangent space
-		norm = texture(textureSamplers.normal, fs_in.textureCoord).rgb;
-		// map to [0, 1]
-		norm = (norm * 2.0 - 1.0);
+		// Sample the normal in tangent space. Only x and y are stored (normal maps are BC5 compressed),
+		// so map them to [-1, 1] and rebuild z from the normal being unit length
+		vec2 normalXY = texture(textureSamplers.normal, fs_in.textureCoord).rg * 2.0 - 1.0;
+		norm = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
 		// transform the normal with TBN matrix and normalize to get new normal vector
 		norm = normalize(fs_in.TBN * norm);
 	}
@@ -161,17 +306,20 @@ void main()
 		}
 	}
 	
-	for(int i = 0; i < MAX_LIGHTS; ++i)
+	// Only shade the point/spot lights binned into this fragment's cluster
+	uvec2 cluster = clusterRanges[GetClusterIndex(fs_in.fragPos)];
+	for(uint i = 0u; i < cluster.y; ++i)
 	{
-		// Calculate lighting from point lights
-		if(pointLights[i].data.isEnabled)
+		uint lightIndex = clusterLightIndices[cluster.x + i];
+		if((lightIndex & SPOT_LIGHT_FLAG) != 0u)
 		{
-			lightResult += CalculatePointLight(pointLights[i], norm, viewDir, fs_in.fragPos);
+			// Calculate lighting from spot lights
+			lightResult += CalculateSpotLight(spotlights[lightIndex & ~SPOT_LIGHT_FLAG], norm, viewDir, fs_in.fragPos);
 		}
-		// Calculate lighting from spot lights
-		if(spotlights[i].data.isEnabled)
+		else
 		{
-			lightResult += CalculateSpotLight(spotlights[i], norm, viewDir, fs_in.fragPos);
+			// Calculate lighting from point lights
+			lightResult += CalculatePointLight(pointLights[lightIndex], norm, viewDir, fs_in.fragPos);
 		}
 	}
 
@@ -202,7 +350,7 @@ void main()
 	fragColor = vec4(color, 1.0);
 }
 
-vec3 CalculatePhongLighting(LightData light, vec3 lightDir, vec3 normal, vec3 viewDir)
+vec3 CalculatePhongLighting(LightData light, vec3 lightDir, vec3 normal, vec3 viewDir, float shadow)
 {
 	// Ambient light
 	// Apply ambient intensity to the light's color to get ambient light
@@ -253,16 +401,8 @@ vec3 CalculatePhongLighting(LightData light, vec3 lightDir, vec3 normal, vec3 vi
 		specularLight *= texture(textureSamplers.specular, fs_in.textureCoord).xyz;
 	}
 
-	// Combine three lights to get phong lighting
-	vec3 phong = ambientLight + diffuseLight + specularLight;
-
-	// Apply shadows for this light
-	if(light.usesShadow)
-	{
-		float shadow = ShadowCalculation(fs_in.fragPosLightSpace, lightDir, normal);                      
-		vec3 lighting = (ambientLight + (1.0 - shadow) * (diffuseLight + specularLight));
-		return lighting;
-	}
+	// Combine three lights to get phong lighting, with the light's shadow removing diffuse and specular
+	vec3 phong = ambientLight + (1.0 - shadow) * (diffuseLight + specularLight);
 
 	return phong;
 }
@@ -275,13 +415,19 @@ vec3 CalculatePointLight(PointLight light, vec3 normal, vec3 viewDir, vec3 fragP
 	// Calculate attentuation
 	//float attenuation = 1.0 / (light.constant + light.linear * dist + light.quadratic * (dist * dist));
 	
-	float attenuation = 1.0 / (dist * dist);
+	float attenuation = 1.0 / (dist * dist) * RangeFalloff(dist, light.radius);
 
 	// Calculate the direction from fragment's position to the light source's position
 	vec3 lightDir = normalize(light.position - fragPos);
 
+	float shadow = 0.0;
+	if(light.data.usesShadow)
+	{
+		shadow = PointShadowCalculation(light.shadowSlot, fragPos, lightDir, normal);
+	}
+
 	// Calculate phong lighting
-	vec3 phong = CalculatePhongLighting(light.data, lightDir, normal, viewDir);
+	vec3 phong = CalculatePhongLighting(light.data, lightDir, normal, viewDir, shadow);
 
 	// Add attenuation
 	phong *= attenuation;
@@ -294,8 +440,14 @@ vec3 CalculateDirLight(DirectionalLight light, vec3 normal, vec3 viewDir)
     // Calculate the direction from the fragment's position to the light source
     vec3 lightDir = normalize(-light.direction);
 
+    float shadow = 0.0;
+    if(light.data.usesShadow)
+    {
+        shadow = ShadowCalculation(fs_in.fragPos, lightDir, normal);
+    }
+
     // Calculate phong lighting
-    vec3 phong = CalculatePhongLighting(light.data, lightDir, normal, viewDir);
+    vec3 phong = CalculatePhongLighting(light.data, lightDir, normal, viewDir, shadow);
 
     return phong;
 }
@@ -320,9 +472,9 @@ vec3 CalculateSpotLight(SpotLight light, vec3 normal, vec3 viewDir, vec3 fragPos
     // Calculate attenuation
     //float attenuation = 1.0 / (light.constant + light.linear * dist + light.quadratic * (dist * dist));
 
-	float attenuation = 1.0 / (dist * dist);
+	float attenuation = 1.0 / (dist * dist) * RangeFalloff(dist, light.radius);
 
-    vec3 phong = CalculatePhongLighting(light.data, lightDir, normal, viewDir);
+    vec3 phong = CalculatePhongLighting(light.data, lightDir, normal, viewDir, 0.0);
 
     phong *= attenuation * intensity;
 
@@ -19,12 +19,6 @@ layout (std140, binding = 0) uniform CameraBuffer
     vec3 viewPos;
 };
 
-// Uniform buffer for light space matrix for shadow map's light perspective
-layout (std140, binding = 4) uniform ShadowBuffer
-{
-	mat4 lightSpace;
-};
-
 // Model matrix uniform
 uniform mat4 model;
 
@@ -37,8 +31,6 @@ out VS_OUT {
 	vec3 fragPos;
 	// Pass the CameraBuffer's viewPos to fragment shader
 	vec3 viewPosition;
-	// fragment's position in light space
-	vec4 fragPosLightSpace;
 	// Tangent, Bitangent, Normal matrix for normal mapping
 	mat3 TBN;
 } vs_out;
@@ -61,8 +53,6 @@ void main()
 
 	vs_out.viewPosition = viewPos;
 
-	vs_out.fragPosLightSpace = lightSpace * vec4(vs_out.fragPos, 1.0);
-
 	vec3 T = normalize(vec3(model * vec4(tangent,   0.0)));
 	vec3 B = normalize(vec3(model * vec4(bitangent, 0.0)));
 	vec3 N = normalize(vec3(model * vec4(inNormal,    0.0)));
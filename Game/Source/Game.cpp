@@ -1,6 +1,8 @@
 #include "Game.h"
 #include <chrono>
 #include <iostream>
+#include <string>
+#include <utility>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -9,13 +11,16 @@
 #include "3dPrimitives/Plane.h"
 #include "3dPrimitives/Sphere.h"
 #include "Components/AnimationComponent3D.h"
+#include "Components/ParticleComponent.h"
 #include "Entity/Entity.h"
 #include "Graphics/Camera.h"
 #include "Graphics/FrameBuffer.h"
 #include "Graphics/FrameBufferMultiSampled.h"
+#include "Graphics/GpuProfiler.h"
 #include "Graphics/Material.h"
 #include "Graphics/MaterialCubeMap.h"
 #include "Graphics/Model.h"
+#include "Graphics/PointShadowMap.h"
 #include "Graphics/Renderer.h"
 #include "Graphics/Shader.h"
 #include "Graphics/ShadowMap.h"
@@ -30,12 +35,8 @@
 #include "Util/Random.h"
 #include "EngineContext.h"
 
-float size = 30.0f;
-float near = 1.0f;
-float far = 40.0f;
-glm::vec3 pos(0.0f);
-glm::vec3 lightDir(-0.05f, -1.0f, -0.2f);
-float dist = 10.0f;
+float shadowDistance = 150.0f;
+int debugCascade = 0;
 
 const int WINDOW_WIDTH = 1280;
 const int WINDOW_HEIGHT = 720;
@@ -45,18 +46,46 @@ double MOUSE_SENSITIVITY = 0.05;
 bool IS_FULLSCREEN = false;
 const char* TITLE = "Game";
 SDL_bool MOUSE_CAPTURED = SDL_TRUE;
+// Number of levels in the bloom chain, starting at half resolution
+const int BLOOM_MIPS = 6;
+// Video memory the textures and meshes nothing references can use once the level has loaded
+const size_t TEXTURE_CACHE_BUDGET = 512 * 1024 * 1024;
+const size_t MESH_CACHE_BUDGET = 256 * 1024 * 1024;
+
+// Models loaded at startup
+const std::vector<std::string> MODEL_FILES =
+{
+	"Assets/models/vampire/dancing_vampire.dae",
+	"Assets/models/Sponza/sponza.obj",
+	"Assets/models/SquidwardDance/Rumba Dancing.dae",
+	"Assets/models/MissFortune/MissFortune.dae",
+	"Assets/models/MissFortune2/MissFortune2.dae"
+};
+
+// Textures loaded at startup
+const std::vector<std::pair<std::string, TextureType>> TEXTURE_FILES =
+{
+	{ "Assets/matrix.jpg", TextureType::Emission },
+	{ "Assets/container2.png", TextureType::Diffuse },
+	{ "Assets/container2_specular.png", TextureType::Specular },
+	{ "Assets/lightSphere.png", TextureType::Diffuse },
+	{ "Assets/wood.png", TextureType::Diffuse },
+	{ "Assets/brickwall.jpg", TextureType::Diffuse },
+	{ "Assets/brickwall_normal.jpg", TextureType::Normal }
+};
 
 Game::Game() :
 	mEngine(RendererMode::MODE_3D),
 	mConsole(),
 	mLights(),
+	mAssetReferences(),
 	mSkybox(nullptr),
 	mMainFrameBuffer(nullptr),
-	mBloomMaskFrameBuffer(nullptr),
-	mBloomBlurHorizontalFrameBuffer(nullptr),
-	mBloomBlurVerticalFrameBuffer(nullptr),
-	mBloomBlendFrameBuffer(nullptr),
+	mPostProcessGraph(),
+	mSceneTarget(INVALID_RENDER_GRAPH_RESOURCE),
+	mScreenTarget(INVALID_RENDER_GRAPH_RESOURCE),
 	mShadowIndex(0),
+	mPointShadowIndex(0),
 	mIsRunning(true),
 	hdr(false),
 	bloom(false)
@@ -98,10 +127,8 @@ bool Game::Init()
 
 	// Create frame buffers
 	mMainFrameBuffer = renderer->CreateMultiSampledFrameBuffer(width, height, renderer->GetNumSubsamples(), assetManager->LoadShader("hdrGamma"));
-	mBloomMaskFrameBuffer = renderer->CreateFrameBuffer(width / 2, height / 2, assetManager->LoadShader("bloomMask"));
-	mBloomBlurHorizontalFrameBuffer = renderer->CreateFrameBuffer(width / 4, height / 4, assetManager->LoadShader("bloomBlurHorizontal"));
-	mBloomBlurVerticalFrameBuffer = renderer->CreateFrameBuffer(width / 4, height / 4, assetManager->LoadShader("bloomBlurVertical"));
-	mBloomBlendFrameBuffer = renderer->CreateFrameBuffer(width, height, assetManager->LoadShader("bloomBlend"));
+
+	BuildPostProcessGraph(engineContext);
 
 	LoadGameData(engineContext.sceneManager, assetManager);
 
@@ -112,6 +139,8 @@ void Game::Shutdown()
 {
 	delete mSkybox;
 
+	mAssetReferences.ReleaseAll();
+
 	mEngine.Shutdown();
 }
 
@@ -124,17 +153,23 @@ void Game::LoadShaders(AssetManager* assetManager) const
 	assetManager->LoadShader("instance", "Shaders/instance.vert", "Shaders/phong.frag");
 	assetManager->LoadShader("shadowDepth", "Shaders/Shadow/shadowDepth.vert", "Shaders/Shadow/shadowDepth.frag");
 	assetManager->LoadShader("shadowDebug", "Shaders/screen.vert", "Shaders/Shadow/shadowDebug.frag");
-	assetManager->LoadShader("pointShadowDepth", "Shaders/Shadow/pointShadowDepth.vert", "Shaders/Shadow/pointShadowDepth.frag", "Shaders/Shadow/pointShadowDepth.geom");
+	assetManager->LoadShader("pointShadowDepth", "Shaders/Shadow/pointShadowDepth.vert", "Shaders/Shadow/pointShadowDepth.frag");
 	//assetManager->LoadShader("invertedColor", "Shaders/screen.vert", "Shaders/Postprocess/invertedColor.frag");
 	//assetManager->LoadShader("grayScale", "Shaders/screen.vert", "Shaders/Postprocess/grayScale.frag");
 	//assetManager->LoadShader("sharpenKernel", "Shaders/screen.vert", "Shaders/Postprocess/sharpenKernel.frag");
 	//assetManager->LoadShader("blurKernel", "Shaders/screen.vert", "Shaders/Postprocess/blurKernel.frag");
 	//assetManager->LoadShader("edgeDetectKernel", "Shaders/screen.vert", "Shaders/Postprocess/edgeDetectKernel.frag");
 	assetManager->LoadShader("copyScreen", "Shaders/screen.vert", "Shaders/copyScreen.frag");
-	assetManager->LoadShader("bloomMask", "Shaders/screen.vert", "Shaders/Postprocess/Bloom/bloomMask.frag");
-	assetManager->LoadShader("bloomBlurHorizontal", "Shaders/screen.vert", "Shaders/Postprocess/Bloom/bloomBlurHorizontal.frag");
-	assetManager->LoadShader("bloomBlurVertical", "Shaders/screen.vert", "Shaders/Postprocess/Bloom/bloomBlurVertical.frag");
-	assetManager->LoadShader("bloomBlend", "Shaders/screen.vert", "Shaders/Postprocess/Bloom/bloomBlend.frag");
+	Shader* bloomDownsampleShader = assetManager->LoadShader("bloomDownsample", "Shaders/screen.vert", "Shaders/Postprocess/Bloom/bloomDownsample.frag");
+	bloomDownsampleShader->SetActive();
+	bloomDownsampleShader->SetFloat("threshold", 1.0f);
+	bloomDownsampleShader->SetFloat("knee", 0.5f);
+	Shader* bloomUpsampleShader = assetManager->LoadShader("bloomUpsample", "Shaders/screen.vert", "Shaders/Postprocess/Bloom/bloomUpsample.frag");
+	bloomUpsampleShader->SetActive();
+	bloomUpsampleShader->SetFloat("filterRadius", 1.0f);
+	Shader* bloomBlendShader = assetManager->LoadShader("bloomBlend", "Shaders/screen.vert", "Shaders/Postprocess/Bloom/bloomBlend.frag");
+	bloomBlendShader->SetActive();
+	bloomBlendShader->SetFloat("intensity", 1.0f / BLOOM_MIPS);
 	Shader* hdrGammaShader = assetManager->LoadShader("hdrGamma", "Shaders/screen.vert", "Shaders/hdrGamma.frag");
 	hdrGammaShader->SetActive();
 	hdrGammaShader->SetBool("hdr", hdr);
@@ -142,6 +177,8 @@ void Game::LoadShaders(AssetManager* assetManager) const
 	assetManager->LoadShader("reflection", "Shaders/EnvironmentMapping/environmentMap.vert", "Shaders/EnvironmentMapping/reflection.frag");
 	assetManager->LoadShader("refraction", "Shaders/EnvironmentMapping/environmentMap.vert", "Shaders/EnvironmentMapping/refraction.frag");
 	assetManager->LoadShader("skybox", "Shaders/skybox.vert", "Shaders/skybox.frag");
+	assetManager->LoadShader("particle", "Shaders/particle.vert", "Shaders/particle.frag");
+	assetManager->LoadComputeShader("particleSimulate", "Shaders/particleSimulate.comp");
 }
 
 void Game::LoadAssets(AssetManager* assetManager) const
@@ -151,6 +188,18 @@ void Game::LoadAssets(AssetManager* assetManager) const
 
 void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 {
+	// Parse the models and decode the textures on worker threads, uploading each one as it finishes.
+	// Everything below finds them in the cache.
+	for (const std::string& modelFile : MODEL_FILES)
+	{
+		assetManager->LoadModelAsync(modelFile);
+	}
+	for (const auto& textureFile : TEXTURE_FILES)
+	{
+		assetManager->LoadTextureAsync(textureFile.first, textureFile.second);
+	}
+	assetManager->WaitForAsyncLoads();
+
 	Texture* texture = assetManager->LoadTexture("Assets/matrix.jpg", TextureType::Emission);
 	Texture* texture3 = assetManager->LoadTexture("Assets/container2.png", TextureType::Diffuse);
 	Texture* texture4 = assetManager->LoadTexture("Assets/container2_specular.png", TextureType::Specular);
@@ -163,6 +212,7 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	lightSphereMaterial->SetShader(assetManager->LoadShader("texture"));
 	lightSphereMaterial->AddTexture(assetManager->LoadTexture("Assets/lightSphere.png"));
 	assetManager->SaveMaterial("lightSphere", lightSphereMaterial);
+	mAssetReferences.Hold<Material>(assetManager, lightSphereMaterial);
 
 	// Skybox
 	std::vector<std::string> faceNames
@@ -181,11 +231,13 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	reflectiveMat->SetCubeMap(sky);
 	reflectiveMat->SetShader(assetManager->LoadShader("reflection"));
 	assetManager->SaveMaterial("reflection", reflectiveMat);
+	mAssetReferences.Hold<Material>(assetManager, reflectiveMat);
 
 	MaterialCubeMap* refractiveMat = new MaterialCubeMap();
 	refractiveMat->SetCubeMap(sky);
 	refractiveMat->SetShader(assetManager->LoadShader("refraction"));
 	assetManager->SaveMaterial("refraction", refractiveMat);
+	mAssetReferences.Hold<Material>(assetManager, refractiveMat);
 
 	//Texture* rockTexture = assetManager->LoadTexture("Assets/models/rock/rock.png");
 	//rockTexture->SetType(TextureType::Diffuse);
@@ -244,10 +296,10 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	for (size_t i = 0; i < 10; ++i)
 	{
 		Entity* vampire = sceneManager->InstantiateEntity();
-		Model* vampireModel = assetManager->LoadModel("Assets/models/vampire/dancing_vampire.dae");
+		Model* vampireModel = mAssetReferences.Hold(assetManager, assetManager->LoadModel("Assets/models/vampire/dancing_vampire.dae"));
 		if (vampireModel->HasAnimations())
 		{
-			AnimationComponent3D* animComp = new AnimationComponent3D(vampire, vampireModel->GetSkeleton(), mEngine.GetContext().renderer->GetUniformBuffer("SkeletonBuffer"));
+			AnimationComponent3D* animComp = new AnimationComponent3D(vampire, vampireModel->GetSkeleton(), mEngine.GetContext().renderer->GetUniformRing());
 		}
 		vampire->SetModel(vampireModel);
 		vampire->SetScale3D(0.05f);
@@ -257,7 +309,7 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	}
 
 	Entity* sponza = sceneManager->InstantiateEntity();
-	Model* sponzaModel = assetManager->LoadModel("Assets/models/Sponza/sponza.obj");
+	Model* sponzaModel = mAssetReferences.Hold(assetManager, assetManager->LoadModel("Assets/models/Sponza/sponza.obj"));
 	sponza->SetModel(sponzaModel);
 	sponza->SetPosition3D(glm::vec3(0.0f, -5.0, 0.0f));
 	sponza->SetScale3D(0.125);
@@ -284,10 +336,10 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	//AddGameEntity(mCube);
 
 	Entity* squidward = sceneManager->InstantiateEntity();
-	Model* squidwardModel = assetManager->LoadModel("Assets/models/SquidwardDance/Rumba Dancing.dae");
+	Model* squidwardModel = mAssetReferences.Hold(assetManager, assetManager->LoadModel("Assets/models/SquidwardDance/Rumba Dancing.dae"));
 	if (squidwardModel->HasAnimations())
 	{
-		AnimationComponent3D* animComp = new AnimationComponent3D(squidward, squidwardModel->GetSkeleton(), mEngine.GetContext().renderer->GetUniformBuffer("SkeletonBuffer"));
+		AnimationComponent3D* animComp = new AnimationComponent3D(squidward, squidwardModel->GetSkeleton(), mEngine.GetContext().renderer->GetUniformRing());
 	}
 	squidward->SetModel(squidwardModel);
 	squidward->SetPosition3D(glm::vec3(0.0f, -5.0f, -15.0f));
@@ -297,14 +349,14 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	squidward2->SetModel(squidwardModel);
 	if (squidwardModel->HasAnimations())
 	{
-		AnimationComponent3D* animComp = new AnimationComponent3D(squidward2, squidwardModel->GetSkeleton(), mEngine.GetContext().renderer->GetUniformBuffer("SkeletonBuffer"));
+		AnimationComponent3D* animComp = new AnimationComponent3D(squidward2, squidwardModel->GetSkeleton(), mEngine.GetContext().renderer->GetUniformRing());
 	}
 	squidward2->SetPosition3D(glm::vec3(10.0f, -5.0f, -15.0f));
 	squidward2->SetScale3D(0.35f);
 
 
 	//squidward->SetMaterialShader("tt", refractiveShader);
-	Material* m = squidward->GetModel()->GetMaterial("ttmat");
+	Material* m = mAssetReferences.Hold(assetManager, squidward->GetModel()->GetMaterial("ttmat"));
 	//m->AddTexture(texture);
 	m->SetSpecularIntensity(0.0f);
 
@@ -327,28 +379,42 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	//AddGameEntity(cube2);
 
 	Entity* fortune2 = sceneManager->InstantiateEntity();
-	Model* fortuneModel2 = assetManager->LoadModel("Assets/models/MissFortune/MissFortune.dae");
+	Model* fortuneModel2 = mAssetReferences.Hold(assetManager, assetManager->LoadModel("Assets/models/MissFortune/MissFortune.dae"));
 	if (fortuneModel2->HasAnimations())
 	{
-		AnimationComponent3D* animComp = new AnimationComponent3D(fortune2, fortuneModel2->GetSkeleton(), mEngine.GetContext().renderer->GetUniformBuffer("SkeletonBuffer"));
+		AnimationComponent3D* animComp = new AnimationComponent3D(fortune2, fortuneModel2->GetSkeleton(), mEngine.GetContext().renderer->GetUniformRing());
 	}
 	fortune2->SetModel(fortuneModel2);
 	fortune2->SetPosition3D(glm::vec3(-5.0f, -5.0f, -25.0f));
 	fortune2->SetScale3D(0.25f);
 
 	Entity* fortune = sceneManager->InstantiateEntity();
-	Model* fortuneModel = assetManager->LoadModel("Assets/models/MissFortune2/MissFortune2.dae");
+	Model* fortuneModel = mAssetReferences.Hold(assetManager, assetManager->LoadModel("Assets/models/MissFortune2/MissFortune2.dae"));
 	if (fortuneModel->HasAnimations())
 	{
-		AnimationComponent3D* animComp = new AnimationComponent3D(fortune, fortuneModel->GetSkeleton(), mEngine.GetContext().renderer->GetUniformBuffer("SkeletonBuffer"));
+		AnimationComponent3D* animComp = new AnimationComponent3D(fortune, fortuneModel->GetSkeleton(), mEngine.GetContext().renderer->GetUniformRing());
 	}
 	fortune->SetModel(fortuneModel);
 	fortune->SetPosition3D(glm::vec3(5.0f, -5.0f, -25.0f));
 	fortune->SetScale3D(0.25f);
 
-	//glm::vec3 lightPosition(1.0f, 10.0f, 3.0f);
-	glm::vec3 lightPosition = lightDir * -dist;
-	pos = lightPosition;
+	// Spark fountain simulated by a compute shader
+	Entity* fountain = sceneManager->InstantiateEntity();
+	fountain->SetPosition3D(glm::vec3(0.0f, -5.0f, -20.0f));
+	ParticleComponent* fountainParticles = new ParticleComponent(fountain, mEngine.GetContext().renderer, 65536, ParticleSimulation::Compute, assetManager->LoadShader("particleSimulate"));
+	ParticleEmitterSettings& fountainSettings = fountainParticles->GetSettings();
+	fountainSettings.startColor = glm::vec4(4.0f, 2.0f, 0.5f, 1.0f);
+	fountainSettings.endColor = glm::vec4(1.0f, 0.2f, 0.0f, 0.0f);
+	fountainSettings.gravity = glm::vec3(0.0f, -9.8f, 0.0f);
+	fountainSettings.spread = 0.35f;
+	fountainSettings.minSpeed = 8.0f;
+	fountainSettings.maxSpeed = 12.0f;
+	fountainSettings.minLifetime = 1.5f;
+	fountainSettings.maxLifetime = 2.5f;
+	fountainSettings.startSize = 0.1f;
+	fountainSettings.endSize = 0.02f;
+	fountainSettings.emitRate = 20000.0f;
+	mEngine.GetContext().renderer->SetParticleShader(assetManager->LoadShader("particle"));
 
 	DirectionalLight* dirLight = mLights.AllocateDirectionalLight(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec3(-0.2f, -1.0f, -0.3f));
 	dirLight->data.usesShadow = true;
@@ -356,6 +422,7 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	PointLight* pointLight = mLights.AllocatePointLight(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec3(1.0f, 3.0f, 60.0f), 1.0f, 0.014f, 0.0007f);
 	pointLight->data.diffuseIntensity = 70.0f;
 	pointLight->data.specularIntensity = 50.0f;
+	pointLight->data.usesShadow = true;
 	Sphere* lightSphere = new Sphere(0.5f, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
 	lightSphere->SetMaterial(lightSphereMaterial);
 	lightSphere->SetPosition3D(glm::vec3(1.0f, 3.0f, 60.0f));
@@ -371,6 +438,7 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 	PointLight* pointLight2 = mLights.AllocatePointLight(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec3(0.0f, 3.0f, -120.0f), 1.0f, 0.014f, 0.0007f);
 	pointLight2->data.diffuseIntensity = 70.0f;
 	pointLight2->data.specularIntensity = 900.0f;
+	pointLight2->data.usesShadow = true;
 	Sphere* lightSphere3 = new Sphere(0.5f, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
 	lightSphere3->SetMaterial(lightSphereMaterial);
 	lightSphere3->SetPosition3D(glm::vec3(0.0f, 3.0f, -120.0f));
@@ -378,8 +446,16 @@ void Game::LoadGameData(SceneManager* sceneManager, AssetManager* assetManager)
 
 	mShadowIndex = mEngine.GetContext().renderer->CreateShadowMap((assetManager->LoadShader("shadowDepth")));
 
+	// 64 MB depth atlas shared by all point light shadows
+	mPointShadowIndex = mEngine.GetContext().renderer->CreatePointShadowMap(assetManager->LoadShader("pointShadowDepth"), 4096 * 4096 * sizeof(float));
+
 	// Since all ShaderProgram objects are attached to a Shader object, it's safe to de-allocate them here
 	assetManager->ClearShaderPrograms();
+
+	// Everything the level uses holds a reference now, so anything else over the budget can go
+	assetManager->SetCacheBudget(AssetType::Texture, TEXTURE_CACHE_BUDGET);
+	assetManager->SetCacheBudget(AssetType::Mesh, MESH_CACHE_BUDGET);
+	assetManager->TrimCaches();
 }
 
 void Game::Run()
@@ -404,7 +480,16 @@ void Game::Run()
 
 		Update(deltaTime, engineContext);
 
+		// Upload a frame's worth of any assets that finished loading in the background
+		engineContext.assetManager->ProcessAsyncLoads();
+
+		// Rebuild any shaders, textures, or models whose files were saved
+		engineContext.assetManager->ReloadChangedFiles();
+
 		Render(engineContext);
+
+		// Stream texture mips in and out for what was just drawn
+		engineContext.assetManager->UpdateTextureStreaming();
 	}
 }
 
@@ -606,8 +691,8 @@ void Game::ProcessInput(const EngineContext& engineContext)
 	}
 
 	// HDR/Exposure
-	Shader* shader = engineContext.assetManager->LoadShader("hdrGamma");
-	Shader* bloomAdd = engineContext.assetManager->LoadShader("bloomBlend");
+	Shader* shader = engineContext.assetManager->LoadShader("hdrGamma"_id);
+	Shader* bloomAdd = engineContext.assetManager->LoadShader("bloomBlend"_id);
 
 	// Toggle hdr
 	if (input->IsKeyLeadingEdge(SDL_SCANCODE_H))
@@ -623,6 +708,8 @@ void Game::ProcessInput(const EngineContext& engineContext)
 
 		bloomAdd->SetActive();
 		bloomAdd->SetBool("bloom", bloom);
+
+		BuildPostProcessGraph(engineContext);
 	}
 	// Exposure levels
 	if (input->IsKeyPressed(SDL_SCANCODE_0))
@@ -657,31 +744,20 @@ void Game::ProcessInput(const EngineContext& engineContext)
 	}
 
 	// Shadow debug inputs
+	ShadowMap* shadowMap = engineContext.renderer->GetShadowMap(mShadowIndex);
 	if (input->IsKeyLeadingEdge(SDL_SCANCODE_UP))
 	{
-		size += 10.0f;
+		shadowDistance += 10.0f;
+		shadowMap->SetShadowDistance(shadowDistance);
 	}
-	if (input->IsKeyLeadingEdge(SDL_SCANCODE_DOWN))
+	if (input->IsKeyLeadingEdge(SDL_SCANCODE_DOWN) && shadowDistance > 10.0f)
 	{
-		size -= 10.0f;
-	}
-	if (input->IsKeyLeadingEdge(SDL_SCANCODE_LEFT))
-	{
-		far -= 10.0f;
-	}
-	if (input->IsKeyLeadingEdge(SDL_SCANCODE_RIGHT))
-	{
-		far += 10.0f;
+		shadowDistance -= 10.0f;
+		shadowMap->SetShadowDistance(shadowDistance);
 	}
 	if (input->IsKeyLeadingEdge(SDL_SCANCODE_L))
 	{
-		dist -= 10.0f;
-		pos = (lightDir * -dist);
-	}
-	if (input->IsKeyLeadingEdge(SDL_SCANCODE_K))
-	{
-		dist += 10.0f;
-		pos = (lightDir * -dist);
+		debugCascade = (debugCascade + 1) % shadowMap->GetNumCascades();
 	}
 
 	if (input->IsKeyPressed(SDL_SCANCODE_KP_0))
@@ -773,25 +849,60 @@ void Game::Render(const EngineContext& engineContext)
 
 	renderer->GetCamera()->SetBuffer();
 
-	mLights.SetBuffer();
-
 	renderer->ClearBuffers();
 
 	ShadowMap* shadowMap = renderer->GetShadowMap(mShadowIndex);
 
 	{
 		PROFILE_SCOPE(RENDER_SHADOW_MAP);
+		PROFILE_GPU_SCOPE(RENDER_SHADOW_MAP);
 
-		//std::cout << size << " " << near << " " << far << " " << pos.x << " " << pos.y << " " << pos.z << "\n";
+		// Fit the cascades to the camera and cull the casters for each of them
+		const std::vector<Entity*>& entities = engineContext.sceneManager->GetCurrentScene()->GetEntities();
+		shadowMap->Update(renderer->GetCamera(), mLights.GetLights().directionalLight[0].direction, entities, engineContext.jobManager);
 
-		// Render to shadow map
-		shadowMap->SetActive(size, near, far, pos, glm::vec3(0.0f, 0.0f, 0.0f));
-		RenderScene(engineContext, shadowMap->GetShader());
+		// Render each cascade to the shadow map
+		for (int i = 0; i < shadowMap->GetNumCascades(); ++i)
+		{
+			shadowMap->SetActive(i);
+			for (auto e : shadowMap->GetCasters(i))
+			{
+				renderer->RenderEntity3D(e, shadowMap->GetShader());
+			}
+		}
 
 		// End shadow render pass
 		shadowMap->End(renderer->GetWidth(), renderer->GetHeight());
-		shadowMap->BindShadowMapToShader(engineContext.assetManager->LoadShader("phong"), "textureSamplers.shadow");
-		shadowMap->BindShadowMapToShader(engineContext.assetManager->LoadShader("skinned"), "textureSamplers.shadow");
+		shadowMap->BindShadowMapToShader(engineContext.assetManager->LoadShader("phong"_id), "textureSamplers.shadow");
+		shadowMap->BindShadowMapToShader(engineContext.assetManager->LoadShader("skinned"_id), "textureSamplers.shadow");
+		shadowMap->BindShadowMapToShader(engineContext.assetManager->LoadShader("instance"_id), "textureSamplers.shadow");
+	}
+
+	PointShadowMap* pointShadowMap = renderer->GetPointShadowMap(mPointShadowIndex);
+
+	{
+		PROFILE_SCOPE(RENDER_POINT_SHADOW_MAP);
+		PROFILE_GPU_SCOPE(RENDER_POINT_SHADOW_MAP);
+
+		// Pick the shadowed point lights and cull casters per cube face
+		const std::vector<Entity*>& entities = engineContext.sceneManager->GetCurrentScene()->GetEntities();
+		pointShadowMap->Update(renderer->GetCamera()->GetPosition(), mLights.GetLights(), entities, engineContext.jobManager);
+
+		// Render every light's faces into the atlas
+		pointShadowMap->SetActive();
+		pointShadowMap->DrawCasters(renderer);
+
+		pointShadowMap->End(renderer->GetWidth(), renderer->GetHeight());
+		pointShadowMap->BindShadowMapToShader(engineContext.assetManager->LoadShader("phong"_id), "textureSamplers.pointShadow");
+		pointShadowMap->BindShadowMapToShader(engineContext.assetManager->LoadShader("skinned"_id), "textureSamplers.pointShadow");
+		pointShadowMap->BindShadowMapToShader(engineContext.assetManager->LoadShader("instance"_id), "textureSamplers.pointShadow");
+	}
+
+	{
+		PROFILE_SCOPE(CLUSTER_LIGHTS);
+
+		// Bin the lights into clusters after the point shadows picked their slots
+		mLights.SetBuffer(renderer, engineContext.jobManager);
 	}
 
 	// Draw to main multisampled frame buffer
@@ -801,29 +912,19 @@ void Game::Render(const EngineContext& engineContext)
 	RenderScene(engineContext);
 	
 	mMainFrameBuffer->BlitBuffers();
-	// Use the multisampled texture and mask off dark spots
-	mBloomMaskFrameBuffer->SetActive();
-	mBloomMaskFrameBuffer->Draw(mMainFrameBuffer->GetTexture());
-	// Use the masked off texture and blur horizontally and readjust shader width
-	mBloomBlurHorizontalFrameBuffer->SetActive();
-	mBloomBlurHorizontalFrameBuffer->GetShader()->SetFloat("width", static_cast<float>(renderer->GetWidth() / 4));
-	mBloomBlurHorizontalFrameBuffer->Draw(mBloomMaskFrameBuffer->GetTexture());
-	// Use the horizontally blurred texture to blur vertically to create the blurred image and readjust shader height
-	mBloomBlurVerticalFrameBuffer->SetActive();
-	mBloomBlurVerticalFrameBuffer->GetShader()->SetFloat("height", static_cast<float>(renderer->GetHeight() / 4));
-	mBloomBlurVerticalFrameBuffer->Draw(mBloomBlurHorizontalFrameBuffer->GetTexture());
-	// Use the multisampled texture and the blurred texture to additively blend them
-	mBloomBlendFrameBuffer->SetActive();
-	renderer->CreateBlend(mBloomBlendFrameBuffer->GetShader(), mMainFrameBuffer->GetTexture(), mBloomBlurVerticalFrameBuffer->GetTexture(), static_cast<int>(TextureType::FrameBuffer));
-	mBloomBlendFrameBuffer->Draw(mMainFrameBuffer->GetTexture());
-	// Draw the final image
-	renderer->SetDefaultFrameBuffer();
-	// Set the main frame buffer's shader active here (since SetDefaultFrameBuffer() does not activate a shader) and add HDR/gamma correction
-	mMainFrameBuffer->GetShader()->SetActive();
-	mMainFrameBuffer->Draw(mBloomBlendFrameBuffer->GetTexture());
-
-
-	shadowMap->DrawDebug(engineContext.assetManager->LoadShader("shadowDebug"));
+
+	{
+		PROFILE_SCOPE(POST_PROCESS);
+		PROFILE_GPU_SCOPE(POST_PROCESS);
+
+		// Run bloom and HDR/gamma correction on the resolved scene texture. The imported targets are updated
+		// every frame since resizing the window recreates the main frame buffer's texture.
+		mPostProcessGraph.SetImportedTarget(mSceneTarget, RenderGraphTarget{ 0, mMainFrameBuffer->GetTexture(), renderer->GetWidth(), renderer->GetHeight() });
+		mPostProcessGraph.SetImportedTarget(mScreenTarget, RenderGraphTarget{ 0, 0, renderer->GetWidth(), renderer->GetHeight() });
+		renderer->ExecuteRenderGraph(mPostProcessGraph);
+	}
+
+	shadowMap->DrawDebug(engineContext.assetManager->LoadShader("shadowDebug"_id), debugCascade);
 	glViewport(0, 0, renderer->GetWidth(), renderer->GetHeight());
 
 	engineContext.engineUI->Render();
@@ -834,6 +935,7 @@ void Game::Render(const EngineContext& engineContext)
 void Game::RenderScene(const EngineContext& engineContext)
 {
 	PROFILE_SCOPE(RENDER_SCENE_NORMAL);
+	PROFILE_GPU_SCOPE(RENDER_SCENE_NORMAL);
 
 
 	const std::vector<Entity*>& entities = engineContext.sceneManager->GetCurrentScene()->GetEntities();
@@ -846,20 +948,84 @@ void Game::RenderScene(const EngineContext& engineContext)
 	Camera* camera = engineContext.renderer->GetCamera();
 
 	mSkybox->Draw(camera->GetViewMatrix(), camera->GetProjectionMatrix());
+
+	engineContext.renderer->DrawParticles();
 }
 
-void Game::RenderScene(const EngineContext& engineContext, Shader* shader)
+void Game::BuildPostProcessGraph(const EngineContext& engineContext)
 {
-	const std::vector<Entity*>& entities = engineContext.sceneManager->GetCurrentScene()->GetEntities();
+	Renderer* renderer = engineContext.renderer;
+	AssetManager* assetManager = engineContext.assetManager;
 
-	for (auto e : entities)
+	mPostProcessGraph.Clear();
+
+	mSceneTarget = mPostProcessGraph.ImportTarget("scene", RenderGraphTarget{ 0, 0, renderer->GetWidth(), renderer->GetHeight() });
+	mScreenTarget = mPostProcessGraph.ImportTarget("screen", RenderGraphTarget{ 0, 0, renderer->GetWidth(), renderer->GetHeight() });
+	mPostProcessGraph.MarkOutput(mScreenTarget);
+
+	// Progressively downsample the scene, then tent filter back up, adding each level's detail on the way.
+	// Each level has a quarter of the pixels of the one above it, so the glow can get as wide as the
+	// smallest level while the smaller levels add little on top of the cost of the first one.
+	std::vector<RenderGraphResource> bloomDown(BLOOM_MIPS);
+	std::vector<RenderGraphResource> bloomUp(BLOOM_MIPS);
+	float scale = 1.0f;
+	for (int i = 0; i < BLOOM_MIPS; ++i)
 	{
-		engineContext.renderer->RenderEntity3D(e, shader);
+		scale *= 0.5f;
+		bloomDown[i] = mPostProcessGraph.CreateTexture("bloomDown" + std::to_string(i), RenderGraphTextureDesc{ scale, RenderGraphFormat::RGB16F });
+
+		// The smallest level has nothing below it to upsample
+		bloomUp[i] = i < BLOOM_MIPS - 1 ? mPostProcessGraph.CreateTexture("bloomUp" + std::to_string(i), RenderGraphTextureDesc{ scale, RenderGraphFormat::RGB16F }) : bloomDown[i];
 	}
+	RenderGraphResource bloomBlend = mPostProcessGraph.CreateTexture("bloomBlend", RenderGraphTextureDesc{ 1.0f, RenderGraphFormat::RGB16F });
 
-	Camera* camera = engineContext.renderer->GetCamera();
+	// 13 tap downsample. The first level also thresholds the scene and suppresses fireflies.
+	Shader* downsampleShader = assetManager->LoadShader("bloomDownsample"_id);
+	for (int i = 0; i < BLOOM_MIPS; ++i)
+	{
+		RenderGraphResource input = i == 0 ? mSceneTarget : bloomDown[i - 1];
+		bool prefilter = i == 0;
+		mPostProcessGraph.AddPass("bloomDownsample" + std::to_string(i), { input }, bloomDown[i], [renderer, downsampleShader, prefilter](const RenderGraphPassContext& context) {
+			downsampleShader->SetActive();
+			downsampleShader->SetBool("prefilter", prefilter);
+			downsampleShader->SetVec2("screenUvScale", context.inputUvScales[0]);
+			renderer->DrawScreenQuad(downsampleShader, context.inputs[0]);
+		});
+	}
 
-	mSkybox->Draw(camera->GetViewMatrix(), camera->GetProjectionMatrix());
+	// Tent upsample each level and add it to the next larger downsampled level
+	Shader* upsampleShader = assetManager->LoadShader("bloomUpsample"_id);
+	for (int i = BLOOM_MIPS - 2; i >= 0; --i)
+	{
+		mPostProcessGraph.AddPass("bloomUpsample" + std::to_string(i), { bloomUp[i + 1], bloomDown[i] }, bloomUp[i], [renderer, upsampleShader](const RenderGraphPassContext& context) {
+			renderer->CreateBlend(upsampleShader, context.inputs[0], context.inputs[1], static_cast<int>(TextureType::FrameBuffer));
+			upsampleShader->SetVec2("screenUvScale", context.inputUvScales[0]);
+			upsampleShader->SetVec2("blurUvScale", context.inputUvScales[1]);
+			renderer->DrawScreenQuad(upsampleShader, context.inputs[0]);
+		});
+	}
+
+	// Use the scene texture and the bloom chain to additively blend them
+	Shader* blendShader = assetManager->LoadShader("bloomBlend"_id);
+	mPostProcessGraph.AddPass("bloomBlend", { mSceneTarget, bloomUp[0] }, bloomBlend, [renderer, blendShader](const RenderGraphPassContext& context) {
+		renderer->CreateBlend(blendShader, context.inputs[0], context.inputs[1], static_cast<int>(TextureType::FrameBuffer));
+		blendShader->SetVec2("blurUvScale", context.inputUvScales[1]);
+		renderer->DrawScreenQuad(blendShader, context.inputs[0]);
+	});
+
+	// Draw the final image with HDR/gamma correction. Without bloom nothing reads the bloom passes so they get culled.
+	Shader* hdrGammaShader = assetManager->LoadShader("hdrGamma"_id);
+	mPostProcessGraph.AddPass("hdrGamma", { bloom ? bloomBlend : mSceneTarget }, mScreenTarget, [renderer, hdrGammaShader](const RenderGraphPassContext& context) {
+		renderer->DrawScreenQuad(hdrGammaShader, context.inputs[0]);
+	});
+
+	if (mPostProcessGraph.Compile())
+	{
+		int width = renderer->GetWidth();
+		int height = renderer->GetHeight();
+		LOG_DEBUG("Post process graph: " + std::to_string(mPostProcessGraph.GetExecutionOrder().size()) + " passes, " + std::to_string(mPostProcessGraph.GetPhysicalTextures().size()) + " targets, "
+			+ std::to_string(mPostProcessGraph.CalculatePhysicalMemory(width, height) / 1024) + " KB instead of " + std::to_string(mPostProcessGraph.CalculateUnaliasedMemory(width, height) / 1024) + " KB without aliasing");
+	}
 }
 
 void Game::ResizeWindow(const SDL_Event& event, const EngineContext& engineContext)
@@ -2,15 +2,15 @@
 #include <vector>
 #include <SDL2/SDL.h>
 #include "Graphics/Lights.h"
+#include "Graphics/RenderGraph.h"
+#include "MemoryManager/AssetReferences.h"
 #include "Engine.h"
 #include "Util/Console.h"
 
 class AssetManager;
 class Entity;
-class FrameBuffer;
 class FrameBufferMultiSampled;
 class SceneManager;
-class Shader;
 class Skybox;
 
 // Game class handles all of the game logic. Game specific code should be added to this class
@@ -60,7 +60,10 @@ public:
 
 	void RenderScene(const EngineContext& engineContext);
 
-	void RenderScene(const EngineContext& engineContext, Shader* shader);
+	// Declares the post process passes (bloom, then HDR/gamma correction to the screen) in the post process graph.
+	// The bloom passes are only declared as inputs when bloom is on, so the graph culls them when it's off.
+	// @param - const EngineContext& for the engine context
+	void BuildPostProcessGraph(const EngineContext& engineContext);
 
 	// Resizes the window, updates viewport, and resizes all frame buffers
 	// @param - const SDL_Event& for the resize window event
@@ -77,24 +80,29 @@ private:
 	// Game's lighting
 	Lights mLights;
 
+	// References to the cached assets the game keeps pointers to, so trimming the caches can't delete them
+	AssetReferences mAssetReferences;
+
 	// Skybox
 	Skybox* mSkybox;
 
 	// The main multi sampled frame buffer
 	FrameBufferMultiSampled* mMainFrameBuffer;
-	// Frame buffer for bloom masking
-	FrameBuffer* mBloomMaskFrameBuffer;
-	// Frame buffer for horizontal blurring
-	FrameBuffer* mBloomBlurHorizontalFrameBuffer;
-	// Frame buffer for vertical blurring
-	FrameBuffer* mBloomBlurVerticalFrameBuffer;
-	// Frame buffer for bloom blending
-	FrameBuffer* mBloomBlendFrameBuffer;
+
+	// Post process passes that run after the scene is drawn to mMainFrameBuffer
+	RenderGraph mPostProcessGraph;
+	// The main frame buffer's resolved texture imported into the post process graph
+	RenderGraphResource mSceneTarget;
+	// The default frame buffer imported into the post process graph
+	RenderGraphResource mScreenTarget;
 
 	std::vector<class Entity*> vampires;
 
 	size_t mShadowIndex;
 
+	// Index to the renderer's point shadow map
+	size_t mPointShadowIndex;
+
 	// Bool to check if the game is running.
 	bool mIsRunning;
 
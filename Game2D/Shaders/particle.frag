@@ -0,0 +1,19 @@
+// Specify OpenGL 4.5 with core functionality
+#version 450 core
+
+// Fragment shader input
+in VS_OUT {
+	vec2 textureCoord;
+	vec4 color;
+} fs_in;
+
+// Final fragment color
+out vec4 fragColor;
+
+void main()
+{
+	// Fade out towards the edge of the quad for a soft round particle
+	float falloff = 1.0 - smoothstep(0.0, 0.5, length(fs_in.textureCoord - 0.5));
+
+	fragColor = vec4(fs_in.color.rgb, fs_in.color.a * falloff);
+}
@@ -0,0 +1,31 @@
+// Specify OpenGL 4.5 with core functionality
+#version 450 core
+
+// Quad corner has attribute position 0
+layout (location = 0) in vec2 corner;
+// Per instance position (xyz) and size (w) has attribute position 1
+layout (location = 1) in vec4 positionSize;
+// Per instance color has attribute position 2
+layout (location = 2) in vec4 color;
+
+// View projection matrix uniform
+uniform mat4 viewProjection;
+// Camera's right and up axes used to face the quad towards the camera
+uniform vec3 cameraRight;
+uniform vec3 cameraUp;
+
+// Vertex shader output
+out VS_OUT {
+	vec2 textureCoord;
+	vec4 color;
+} vs_out;
+
+void main()
+{
+	vec3 position = positionSize.xyz + (cameraRight * corner.x + cameraUp * corner.y) * positionSize.w;
+
+	gl_Position = viewProjection * vec4(position, 1.0);
+
+	vs_out.textureCoord = corner + 0.5;
+	vs_out.color = color;
+}
@@ -6,8 +6,6 @@ layout (location = 0) in vec2 position;
 // texture variable has attribute position 1
 layout (location = 1) in vec2 uv;
 
-// Model matrix uniform
-uniform mat4 model;
 // Projection matrix uniform
 uniform mat4 projection;
 
@@ -19,7 +17,7 @@ out VS_OUT {
 
 void main()
 {
-	gl_Position = projection * model * vec4(position, 0.0, 1.0);
+	gl_Position = projection * vec4(position, 0.0, 1.0);
 	
 	vs_out.textureCoord = uv;
 }
@@ -8,6 +8,8 @@ layout (location = 1) in vec2 uv;
 
 // Projection matrix uniform
 uniform mat4 projection;
+// Screen position of the string (vertices are laid out at the origin)
+uniform vec2 textOffset;
 
 // Vertex shader output
 out VS_OUT {
@@ -17,7 +19,7 @@ out VS_OUT {
 
 void main()
 {
-	gl_Position = projection * vec4(position, 0.0, 1.0);
+	gl_Position = projection * vec4(position + textOffset, 0.0, 1.0);
 	
 	vs_out.textureCoord = uv;
 }
@@ -5,6 +5,7 @@
 #include "Audio/Sound.h"
 #include "Components/CollisionComponent.h"
 #include "Components/MoveComponent2D.h"
+#include "Components/ParticleComponent.h"
 #include "Components/SpriteComponent.h"
 #include "EngineUI/EngineUI.h"
 #include "Entity/Entity.h"
@@ -12,6 +13,7 @@
 #include "Graphics/Renderer2D.h"
 #include "Graphics/Text.h"
 #include "Graphics/Texture.h"
+#include "Graphics/TextureAtlas.h"
 #include "MemoryManager/AssetManager.h"
 #include "Multithreading/JobManager.h"
 #include "Physics/Physics.h"
@@ -31,11 +33,19 @@ double MOUSE_SENSITIVITY = 0.05;
 bool IS_FULLSCREEN = false;
 const char* TITLE = "Game2D";
 SDL_bool MOUSE_CAPTURED = SDL_FALSE;
+// Number of sprites spawned by the sprite stress test (toggled with B)
+const int NUM_STRESS_SPRITES = 100000;
+// Video memory the textures nothing references can use once the game data has loaded
+const size_t TEXTURE_CACHE_BUDGET = 128 * 1024 * 1024;
 
 Game::Game() :
 	mEngine(RendererMode::MODE_2D),
 	mConsole(),
+	mAssetReferences(),
 	mBackground(nullptr),
+	mStressSprites(),
+	mStressSpritesVisible(false),
+	mLogSpriteStats(false),
 	mIsRunning(true)
 {
 }
@@ -65,11 +75,17 @@ bool Game::Init()
 
 	LoadGameData(engineContext);
 
+	// Everything the game uses holds a reference now, so anything else over the budget can go
+	assetManager->SetCacheBudget(AssetType::Texture, TEXTURE_CACHE_BUDGET);
+	assetManager->TrimCaches();
+
 	return true;
 }
 
 void Game::Shutdown()
 {
+	mAssetReferences.ReleaseAll();
+
 	mEngine.Shutdown();
 }
 
@@ -78,15 +94,13 @@ void Game::LoadShaders(AssetManager* assetManager) const
 	assetManager->LoadShader("sprite", "Shaders/sprite.vert", "Shaders/sprite.frag");
 	assetManager->LoadShader("text", "Shaders/text.vert", "Shaders/text.frag");
 	assetManager->LoadShader("uiBox", "Shaders/uiBox.vert", "Shaders/uiBox.frag");
+	assetManager->LoadShader("particle", "Shaders/particle.vert", "Shaders/particle.frag");
 }
 
 void Game::LoadAssets(AssetManager* assetManager) const
 {
-	assetManager->LoadTexture("Assets/Ship.png", TextureType::Sprite);
-	assetManager->LoadTexture("Assets/ShipThrust.png", TextureType::Sprite);
-	assetManager->LoadTexture("Assets/Laser.png", TextureType::Sprite);
-	assetManager->LoadTexture("Assets/Asteroid.png", TextureType::Sprite);
-	assetManager->LoadTexture("Assets/Stars.png", TextureType::Sprite);
+	// Pack every sprite into one atlas so they can be batched together
+	assetManager->LoadTextureAtlas("sprites", { "Assets/Ship.png", "Assets/ShipThrust.png", "Assets/Laser.png", "Assets/Asteroid.png", "Assets/Stars.png" });
 	assetManager->LoadSFX("Assets/Sounds/ShipThrust.wav");
 	assetManager->LoadSFX("Assets/Sounds/Shoot.wav");
 	assetManager->LoadSFX("Assets/Sounds/AsteroidExplode.wav");
@@ -99,18 +113,23 @@ void Game::LoadGameData(const EngineContext& engineContext)
 
 	SceneManager* sceneManager = engineContext.sceneManager;
 
+	TextureAtlas* spriteAtlas = mAssetReferences.Hold(assetManager, assetManager->LoadTextureAtlas("sprites"));
+
+	// Sounds are played by name, so hold them for as long as the game runs
+	mAssetReferences.Hold(assetManager, assetManager->LoadSFX("Assets/Sounds/ShipThrust.wav"));
+	mAssetReferences.Hold(assetManager, assetManager->LoadSFX("Assets/Sounds/Shoot.wav"));
+	mAssetReferences.Hold(assetManager, assetManager->LoadSFX("Assets/Sounds/AsteroidExplode.wav"));
+
 	Ship* ship = new Ship();
 	ship->SetPosition2D(glm::vec2(200.0f, 200.0f));
 
 	// Set ship sprite component
 	SpriteComponent* shipSpriteComp = new SpriteComponent(ship, engineContext.renderer->GetRenderer2D());
-	// Load texture from cache
-	Texture* shipSprite = assetManager->LoadTexture("Assets/Ship.png");
-	shipSpriteComp->AddSprite(shipSprite);
-	// Load second texture from cache
-	shipSpriteComp->AddSprite(assetManager->LoadTexture("Assets/ShipThrust.png"));
+	// Add the ship's sprites from the atlas
+	shipSpriteComp->AddSprite("Assets/Ship.png", spriteAtlas->GetRegion("Assets/Ship.png"));
+	shipSpriteComp->AddSprite("Assets/ShipThrust.png", spriteAtlas->GetRegion("Assets/ShipThrust.png"));
 	// Set the sprite
-	shipSpriteComp->SetSprite(shipSprite);
+	shipSpriteComp->SetSprite(shipSpriteComp->GetSprite("Assets/Ship.png"));
 	ship->SetSpriteComp(shipSpriteComp);
 	sceneManager->AddEntity(ship);
 
@@ -123,6 +142,41 @@ void Game::LoadGameData(const EngineContext& engineContext)
 	shipHitBox->SetBoxSize(glm::vec2(100.0f, 90.0f));
 	ship->SetCollisionComp(shipHitBox);
 
+	// Ship exhaust particles behind the ship
+	ParticleComponent* shipThrust = new ParticleComponent(ship, engineContext.renderer, 2048);
+	shipThrust->SetOffset(glm::vec3(-45.0f, 0.0f, 0.0f));
+	shipThrust->SetDirection(glm::vec3(-1.0f, 0.0f, 0.0f));
+	ParticleEmitterSettings& thrustSettings = shipThrust->GetSettings();
+	thrustSettings.startColor = glm::vec4(1.0f, 0.7f, 0.3f, 1.0f);
+	thrustSettings.endColor = glm::vec4(1.0f, 0.1f, 0.0f, 0.0f);
+	thrustSettings.spread = 0.25f;
+	thrustSettings.minSpeed = 150.0f;
+	thrustSettings.maxSpeed = 250.0f;
+	thrustSettings.minLifetime = 0.2f;
+	thrustSettings.maxLifetime = 0.5f;
+	thrustSettings.startSize = 16.0f;
+	thrustSettings.endSize = 4.0f;
+	thrustSettings.isPlanar = true;
+	ship->SetThrustParticles(shipThrust);
+
+	// Asteroid explosion particles, burst by the ship's lasers wherever an asteroid is hit
+	Entity* explosions = sceneManager->InstantiateEntity();
+	ParticleComponent* explosionParticles = new ParticleComponent(explosions, engineContext.renderer, 8192);
+	explosionParticles->SetFollowsOwner(false);
+	ParticleEmitterSettings& explosionSettings = explosionParticles->GetSettings();
+	explosionSettings.startColor = glm::vec4(1.0f, 0.9f, 0.6f, 1.0f);
+	explosionSettings.endColor = glm::vec4(0.6f, 0.2f, 0.1f, 0.0f);
+	explosionSettings.spread = glm::pi<float>();
+	explosionSettings.minSpeed = 50.0f;
+	explosionSettings.maxSpeed = 300.0f;
+	explosionSettings.minLifetime = 0.4f;
+	explosionSettings.maxLifetime = 1.0f;
+	explosionSettings.startSize = 12.0f;
+	explosionSettings.endSize = 2.0f;
+	explosionSettings.drag = 2.0f;
+	explosionSettings.isPlanar = true;
+	ship->SetExplosionParticles(explosionParticles);
+
 	// Fire off loop sfx so this sound chunk can pause/resume later
 	engineContext.audio->PlaySFX(assetManager->LoadSFX("Assets/Sounds/ShipThrust.wav"), -1, -1);
 	// Pause sound immediately
@@ -142,8 +196,8 @@ void Game::LoadGameData(const EngineContext& engineContext)
 
 		// Asteroid sprite component
 		SpriteComponent* asteroidSpriteComp = new SpriteComponent(asteroid, engineContext.renderer->GetRenderer2D());
-		Texture* asteroidSprite = assetManager->LoadTexture("Assets/Asteroid.png");
-		asteroidSpriteComp->AddSprite(asteroidSprite);
+		const AtlasRegion* asteroidSprite = spriteAtlas->GetRegion("Assets/Asteroid.png");
+		asteroidSpriteComp->AddSprite("Assets/Asteroid.png", asteroidSprite);
 		asteroidSpriteComp->SetSprite(asteroidSprite);
 
 		// Asteroid move component
@@ -152,7 +206,7 @@ void Game::LoadGameData(const EngineContext& engineContext)
 		asteroidMove->SetMovementSpeed(Random::GetFloatRange(50.0f, 150.0f));
 
 		// Asteroid collision component
-		CircleComponent* asteroidColl = new CircleComponent(asteroid, engineContext.physics, asteroidSprite->GetWidth() * 0.5f);
+		CircleComponent* asteroidColl = new CircleComponent(asteroid, engineContext.physics, asteroidSprite->size.x * 0.5f);
 		// Set on collide
 		asteroidColl->SetOnCollision([asteroid](Entity* other, const CollisionResult& result) {
 			// If collided with another asteroid, create a new rotation
@@ -166,7 +220,7 @@ void Game::LoadGameData(const EngineContext& engineContext)
 		sceneManager->AddEntity(asteroid);
 	}
 
-	Music* music = assetManager->LoadMusic("Assets/Sounds/AllTheThingsYouAre.mp3");
+	Music* music = mAssetReferences.Hold(assetManager, assetManager->LoadMusic("Assets/Sounds/AllTheThingsYouAre.mp3"));
 	music->SetVolume(90);
 	music->Play(-1);
 
@@ -178,7 +232,7 @@ void Game::LoadGameData(const EngineContext& engineContext)
 	mBackground = sceneManager->InstantiateEntity();
 	mBackground->SetPosition2D(glm::vec2(static_cast<float>(renderer->GetWidth() / 2), static_cast<float>(renderer->GetHeight() / 2)));
 	SpriteComponent* backgroundSC = new SpriteComponent(mBackground, renderer2D, 50);
-	backgroundSC->AddSprite(assetManager->LoadTexture("Assets/Stars.png", TextureType::Sprite));
+	backgroundSC->AddSprite("Assets/Stars.png", spriteAtlas->GetRegion("Assets/Stars.png"));
 	backgroundSC->SetSprite(backgroundSC->GetSprite("Assets/Stars.png"));
 	// Sprite background resize
 	SpriteComponent* bgSprite = mBackground->GetComponent<SpriteComponent>();
@@ -191,9 +245,10 @@ void Game::LoadGameData(const EngineContext& engineContext)
 	renderer2D->SetSpriteShader(assetManager->LoadShader("sprite"));
 	renderer2D->SetTextShader(assetManager->LoadShader("text"));
 	renderer2D->SetUIBoxShader(assetManager->LoadShader("uiBox"));
+	renderer->SetParticleShader(assetManager->LoadShader("particle"));
 
 	// Set font
-	renderer2D->GetTextRenderer()->LoadFont("Assets/Fonts/arial.ttf", 16);
+	renderer2D->GetTextRenderer()->LoadFont("Assets/Fonts/arial.ttf", 16, engineContext.jobManager);
 }
 
 void Game::Run()
@@ -259,6 +314,11 @@ void Game::ProcessInput(const EngineContext& engineContext)
 		mIsRunning = false;
 	}
 
+	if (input->IsKeyLeadingEdge(SDL_SCANCODE_B))
+	{
+		ToggleSpriteStressTest(engineContext);
+	}
+
 	const std::vector<Entity*>& entities = engineContext.sceneManager->GetCurrentScene()->GetEntities();
 
 	for (auto e : entities)
@@ -269,6 +329,41 @@ void Game::ProcessInput(const EngineContext& engineContext)
 	mConsole.ProcessInput(input);
 }
 
+void Game::ToggleSpriteStressTest(const EngineContext& engineContext)
+{
+	mStressSpritesVisible = !mStressSpritesVisible;
+
+	if (mStressSprites.empty())
+	{
+		Renderer* renderer = engineContext.renderer;
+		const AtlasRegion* asteroidSprite = engineContext.assetManager->LoadTextureAtlas("sprites")->GetRegion("Assets/Asteroid.png");
+
+		mStressSprites.reserve(NUM_STRESS_SPRITES);
+		for (int i = 0; i < NUM_STRESS_SPRITES; ++i)
+		{
+			Entity* e = engineContext.sceneManager->InstantiateEntity();
+			e->SetPosition2D(Random::GetVector2(glm::vec2(0.0f, 0.0f), glm::vec2(renderer->GetWidth(), renderer->GetHeight())));
+			e->SetRotation2D(glm::angleAxis(glm::radians(Random::GetFloatRange(0.0f, 360.0f)), glm::vec3(0.0f, 0.0f, 1.0f)));
+
+			SpriteComponent* sc = new SpriteComponent(e, renderer->GetRenderer2D());
+			sc->AddSprite("Assets/Asteroid.png", asteroidSprite);
+			sc->SetSprite(asteroidSprite);
+			sc->SetSize(glm::vec2(16.0f, 16.0f));
+
+			mStressSprites.emplace_back(e);
+		}
+	}
+	else
+	{
+		for (Entity* e : mStressSprites)
+		{
+			e->GetComponent<SpriteComponent>()->SetIsVisible(mStressSpritesVisible);
+		}
+	}
+
+	mLogSpriteStats = true;
+}
+
 void Game::ProcessMouseInput(InputSystem* input)
 {
 	Sint32 scroll = input->GetMouseScrollDir();
@@ -403,7 +498,17 @@ void Game::Render(const EngineContext& engineContext)
 
 	renderer->ClearBuffers();
 
-	renderer->Draw2D();
+	{
+		PROFILE_SCOPE(DRAW_2D);
+		renderer->Draw2D();
+	}
+
+	if (mLogSpriteStats)
+	{
+		Renderer2D* renderer2D = renderer->GetRenderer2D();
+		LOG_DEBUG("Sprites drawn: " + std::to_string(renderer2D->GetNumSpritesDrawn()) + ", draw calls: " + std::to_string(renderer2D->GetNumSpriteDrawCalls()));
+		mLogSpriteStats = false;
+	}
 
 	ui->Render();
 
@@ -1,5 +1,7 @@
 #pragma once
+#include <vector>
 #include "Engine.h"
+#include "MemoryManager/AssetReferences.h"
 #include "Util/Console.h"
 
 class AssetManager;
@@ -40,6 +42,11 @@ public:
 	// @param - const EngineContext& for the engine context
 	void ProcessInput(const EngineContext& engineContext);
 
+	// Spawns NUM_STRESS_SPRITES asteroid sprites the first time it is called to stress test
+	// the sprite batcher, then toggles their visibility on every call after that
+	// @param - const EngineContext& for the engine context
+	void ToggleSpriteStressTest(const EngineContext& engineContext);
+
 	// Processes and handles any mouse movement, clicks, and scrolls
 	// @param - Mouse* for the mouse
 	void ProcessMouseInput(InputSystem* input);
@@ -65,8 +72,20 @@ private:
 	// Console for game info/debugging
 	Console mConsole;
 
+	// References to the cached assets the game keeps pointers to, so trimming the caches can't delete them
+	AssetReferences mAssetReferences;
+
 	Entity* mBackground;
 
+	// Entities spawned by the sprite stress test
+	std::vector<Entity*> mStressSprites;
+
+	// Bool to check if the stress test's sprites are visible
+	bool mStressSpritesVisible;
+
+	// Bool to log the sprite batcher's stats after the next frame is drawn
+	bool mLogSpriteStats;
+
 	// Bool to check if the game is running.
 	bool mIsRunning;
 };
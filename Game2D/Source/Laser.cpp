@@ -3,14 +3,15 @@
 #include "Audio/AudioSystem.h"
 #include "Components/CollisionComponent.h"
 #include "Components/MoveComponent2D.h"
+#include "Components/ParticleComponent.h"
 #include "Components/SpriteComponent.h"
-#include "Graphics/Texture.h"
+#include "Graphics/TextureAtlas.h"
 #include "MemoryManager/AssetManager.h"
 #include "Util/Logger.h"
 #include "Asteroid.h"
 #include "Engine.h"
 
-Laser::Laser(const EngineContext& engineContext) :
+Laser::Laser(const EngineContext& engineContext, ParticleComponent* explosionParticles) :
 	Entity(),
 	mLaserSprite(new SpriteComponent(this, engineContext.renderer->GetRenderer2D())),
 	mLaserMovement(new MoveComponent2D(this)),
@@ -18,9 +19,9 @@ Laser::Laser(const EngineContext& engineContext) :
 	//mEngine(&engineContext),
 	mLaserDecay(0.0f)
 {
-	// Add and set laser sprite texture
-	Texture* laserSprite = engineContext.assetManager->LoadTexture("Assets/Laser.png", TextureType::Sprite);
-	mLaserSprite->AddSprite(laserSprite);
+	// Add and set laser sprite from the sprite atlas
+	const AtlasRegion* laserSprite = engineContext.assetManager->LoadTextureAtlas("sprites")->GetRegion("Assets/Laser.png");
+	mLaserSprite->AddSprite("Assets/Laser.png", laserSprite);
 	mLaserSprite->SetSprite(laserSprite);
 
 	// Set laser speed
@@ -30,13 +31,17 @@ Laser::Laser(const EngineContext& engineContext) :
 	mBox->SetBoxSize(glm::vec2(30.0f, 10.0f));
 
 	// Set on collision callback
-	mBox->SetOnCollision([this, engineContext](Entity* other, const CollisionResult& result) {
+	mBox->SetOnCollision([this, engineContext, explosionParticles](Entity* other, const CollisionResult& result) {
 		// If collided with asteroid, destroy the asteroid and this laser
 		Asteroid* asteroid = dynamic_cast<Asteroid*>(other);
 		if (asteroid)
 		{
 			engineContext.audio->PlaySFX(engineContext.assetManager->LoadSFX("Assets/Sounds/AsteroidExplode.wav"));
 			asteroid->SetEntityState(EntityState::Destroy);
+			if (explosionParticles)
+			{
+				explosionParticles->GetParticleSystem()->Burst(200, asteroid->GetPosition3D());
+			}
 			mState = EntityState::Destroy;
 
 			LOG_DEBUG("Laser hit Asteroid");
@@ -5,12 +5,16 @@
 class OBBComponent2D;
 class Engine;
 class MoveComponent2D;
+class ParticleComponent;
 class SpriteComponent;
 
 class Laser : public Entity
 {
 public:
-	Laser(const EngineContext& engineContext);
+	// Laser constructor
+	// @param - const EngineContext& for the engine context
+	// @param - ParticleComponent* for the particles that burst when an asteroid is hit (can be nullptr)
+	Laser(const EngineContext& engineContext, ParticleComponent* explosionParticles);
 	~Laser();
 
 	// OnUpdate override
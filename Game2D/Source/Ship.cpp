@@ -1,6 +1,7 @@
 #include "Ship.h"
 #include "Audio/AudioSystem.h"
 #include "Components/MoveComponent2D.h"
+#include "Components/ParticleComponent.h"
 #include "Components/SpriteComponent.h"
 #include "Input/Keyboard.h"
 #include "Util/Logger.h"
@@ -12,6 +13,8 @@ Ship::Ship() :
 	mSprite(nullptr),
 	mMovement(nullptr),
 	mCollisionBox(nullptr),
+	mThrustParticles(nullptr),
+	mExplosionParticles(nullptr),
 	mLaserCooldown(1.0f)
 {
 }
@@ -49,6 +52,11 @@ void Ship::OnProcessInput(const InputSystem* input, const EngineContext& engineC
 		engineContext.audio->PauseSFX(engineContext.assetManager->LoadSFX("Assets/Sounds/ShipThrust.wav"));
 	}
 
+	if (mThrustParticles)
+	{
+		mThrustParticles->GetSettings().emitRate = moveSpeed > 0.0f ? 400.0f : 0.0f;
+	}
+
 	float rotationSpeed = 0.0f;
 	if (input->IsKeyPressed(SDL_SCANCODE_A))
 	{
@@ -63,7 +71,7 @@ void Ship::OnProcessInput(const InputSystem* input, const EngineContext& engineC
 	{
 		engineContext.audio->PlaySFX(engineContext.assetManager->LoadSFX("Assets/Sounds/Shoot.wav"));
 
-		Laser* laser = new Laser(engineContext);
+		Laser* laser = new Laser(engineContext, mExplosionParticles);
 		laser->SetPosition2D(mPosition);
 		laser->SetRotation2D(mRotation);
 		engineContext.sceneManager->AddEntity(laser);
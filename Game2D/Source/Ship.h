@@ -4,6 +4,7 @@
 class CollisionComponent;
 class Engine;
 class MoveComponent2D;
+class ParticleComponent;
 class SpriteComponent;
 
 class Ship : public Entity
@@ -25,6 +26,8 @@ public:
 	void SetSpriteComp(SpriteComponent* comp) { mSprite = comp; }
 	void SetMoveComp(MoveComponent2D* comp) { mMovement = comp; }
 	void SetCollisionComp(CollisionComponent* comp) { mCollisionBox = comp; }
+	void SetThrustParticles(ParticleComponent* comp) { mThrustParticles = comp; }
+	void SetExplosionParticles(ParticleComponent* comp) { mExplosionParticles = comp; }
 
 private:
 	SpriteComponent* mSprite;
@@ -33,5 +36,11 @@ private:
 
 	CollisionComponent* mCollisionBox;
 
+	// Exhaust emitted while thrusting
+	ParticleComponent* mThrustParticles;
+
+	// Explosions spawned by this ship's lasers
+	ParticleComponent* mExplosionParticles;
+
 	float mLaserCooldown;
 };